@@ -0,0 +1,125 @@
+#include "../ff/core/geometry.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/scene/scene.h"
+#include "../ff/scene/sceneBVH.h"
+#include "../ff/camera/perspectiveCamera.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/math/frustum.h"
+#include "../ff/tools/timer.h"
+
+//视锥体剪裁对比测试：
+//城市网格场景(约20万个mesh)，相机位于街道上，只有很小一部分物体可见，
+//比较逐个物体的包围球测试与SceneBVH层次化剪裁的耗时
+
+static const uint32_t GRID_SIZE = 450;
+static const float GRID_SPACING = 4.0f;
+static const uint32_t FRAME_COUNT = 20;
+
+static ff::Geometry::Ptr createBoxGeometry()
+{
+	std::vector<float> positions =
+	{
+		-0.5f, 0.0f, -0.5f,		0.5f, 0.0f, -0.5f,		0.5f, 0.0f, 0.5f,		-0.5f, 0.0f, 0.5f,
+		-0.5f, 3.0f, -0.5f,		0.5f, 3.0f, -0.5f,		0.5f, 3.0f, 0.5f,		-0.5f, 3.0f, 0.5f,
+	};
+
+	auto geometry = ff::Geometry::create();
+	geometry->setAttribute("position", ff::Attributef::create(positions, 3));
+
+	return geometry;
+}
+
+int main()
+{
+	auto geometry = createBoxGeometry();
+	auto material = ff::MeshBasicMaterial::create();
+
+	auto scene = ff::Scene::create();
+	std::vector<ff::Mesh::Ptr> meshes;
+
+	//每行一个分组节点，模拟按街区组织的场景层级
+	for (uint32_t row = 0; row < GRID_SIZE; ++row)
+	{
+		auto block = ff::Object3D::create();
+		scene->addChild(block);
+
+		for (uint32_t column = 0; column < GRID_SIZE; ++column)
+		{
+			auto mesh = ff::Mesh::create(geometry, material);
+			mesh->setPosition(column * GRID_SPACING, 0.0f, row * GRID_SPACING);
+			block->addChild(mesh);
+			meshes.push_back(mesh);
+		}
+	}
+
+	auto camera = ff::PerspectiveCamera::create(0.1f, 200.0f, 16.0f / 9.0f, 60.0f);
+	camera->setPosition(GRID_SIZE * GRID_SPACING * 0.5f, 1.7f, GRID_SIZE * GRID_SPACING * 0.5f);
+
+	scene->updateWorldMatrix(true, true);
+
+	auto frustum = ff::Frustum::create();
+	auto bvh = ff::SceneBVH::create();
+
+	ff::Timer timer;
+	timer.reset();
+	bvh->build(scene);
+	auto buildTime = timer.elapsed_micro();
+
+	int64_t linearTime = 0;
+	int64_t bvhTime = 0;
+	int64_t refitTime = 0;
+	uint32_t linearVisible = 0;
+	uint32_t bvhVisible = 0;
+
+	for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		//相机原地转动，并且每帧有1%的物体发生移动
+		camera->rotateY(360.0f / FRAME_COUNT);
+		camera->updateWorldMatrix(true, true);
+
+		for (size_t i = frame; i < meshes.size(); i += 100)
+		{
+			auto position = meshes[i]->getPosition();
+			meshes[i]->setPosition(position.x, (frame % 2) ? 0.5f : 0.0f, position.z);
+		}
+		scene->updateWorldMatrix(true, true);
+
+		glm::mat4 viewProjection = camera->getProjectionMatrix() * camera->getWorldMatrixInverse();
+		frustum->setFromProjectionMatrix(viewProjection);
+
+		//1 逐个物体的包围球测试
+		timer.reset();
+		linearVisible = 0;
+		for (auto& mesh : meshes)
+		{
+			if (frustum->intersectObject(mesh.get()))
+			{
+				linearVisible++;
+			}
+		}
+		linearTime += timer.elapsed_micro();
+
+		//2 BVH增量refit + 层次化剪裁
+		timer.reset();
+		bvh->update(scene);
+		refitTime += timer.elapsed_micro();
+
+		bvh->cull(frustum);
+		bvhTime += timer.elapsed_micro();
+		bvhVisible = bvh->getCullInfo().m_objectsVisible;
+	}
+
+	const auto& cullInfo = bvh->getCullInfo();
+
+	std::cout << "meshes: " << meshes.size() << "  bvh nodes: " << bvh->getNodeCount()
+		<< "  build: " << buildTime / 1000.0 << " ms" << std::endl;
+	std::cout << "linear sphere test: " << linearTime / 1000.0 / FRAME_COUNT << " ms/frame"
+		<< "  visible: " << linearVisible << std::endl;
+	std::cout << "bvh refit + cull:   " << bvhTime / 1000.0 / FRAME_COUNT << " ms/frame"
+		<< " (refit " << refitTime / 1000.0 / FRAME_COUNT << " ms)"
+		<< "  visible: " << bvhVisible
+		<< "  nodes visited: " << cullInfo.m_nodesVisited
+		<< "  objects tested: " << cullInfo.m_objectsTested << std::endl;
+
+	return 0;
+}
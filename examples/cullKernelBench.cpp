@@ -0,0 +1,198 @@
+#include "../ff/math/frustum.h"
+#include "../ff/math/cullingKernel.h"
+#include "../ff/camera/perspectiveCamera.h"
+#include "../ff/tools/timer.h"
+
+#include <random>
+
+//批量剪裁内核测试：
+//1 随机生成大量包围球/AABB(SoA)，在多个随机视锥体、多种平面掩码、非对齐的起始下标下，
+//  比较SIMD版本与标量版本写出的可见性位图是否逐位一致
+//2 统计两种实现的吞吐量(每秒测试的包围球/包围盒数)
+
+static const uint32_t OBJECT_COUNT = 1 << 20;
+static const uint32_t FRUSTUM_COUNT = 16;
+static const uint32_t REPEAT_COUNT = 10;
+
+struct SoABounds
+{
+	std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+	std::vector<float> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+};
+
+static SoABounds createBounds(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> size(0.1f, 10.0f);
+
+	SoABounds bounds;
+	for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+	{
+		glm::vec3 center(position(random), position(random) * 0.1f, position(random));
+		glm::vec3 halfExtent(size(random), size(random), size(random));
+
+		bounds.m_centerX.push_back(center.x);
+		bounds.m_centerY.push_back(center.y);
+		bounds.m_centerZ.push_back(center.z);
+		bounds.m_radius.push_back(glm::length(halfExtent));
+
+		bounds.m_minX.push_back(center.x - halfExtent.x);
+		bounds.m_minY.push_back(center.y - halfExtent.y);
+		bounds.m_minZ.push_back(center.z - halfExtent.z);
+		bounds.m_maxX.push_back(center.x + halfExtent.x);
+		bounds.m_maxY.push_back(center.y + halfExtent.y);
+		bounds.m_maxZ.push_back(center.z + halfExtent.z);
+	}
+
+	return bounds;
+}
+
+static std::vector<ff::Frustum::Ptr> createFrustums(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+
+	std::vector<ff::Frustum::Ptr> frustums;
+	for (uint32_t i = 0; i < FRUSTUM_COUNT; ++i)
+	{
+		auto camera = ff::PerspectiveCamera::create(0.1f, 300.0f, 16.0f / 9.0f, 60.0f);
+		camera->setPosition(position(random), 2.0f, position(random));
+		camera->rotateY(angle(random));
+		camera->updateWorldMatrix(true, true);
+
+		glm::mat4 viewProjection = camera->getProjectionMatrix() * camera->getWorldMatrixInverse();
+
+		auto frustum = ff::Frustum::create();
+		frustum->setFromProjectionMatrix(viewProjection);
+		frustums.push_back(frustum);
+	}
+
+	return frustums;
+}
+
+int main()
+{
+	std::mt19937 random(7);
+	auto bounds = createBounds(random);
+	auto frustums = createFrustums(random);
+
+	std::cout << "simd width: " << ff::CullingKernel::getSimdWidth() << "  objects: " << OBJECT_COUNT << std::endl;
+
+	auto wordCount = ff::CullingKernel::getWordCount(OBJECT_COUNT);
+	std::vector<uint64_t> simdBits(wordCount), scalarBits(wordCount);
+
+	//1 结果比对：不同视锥体、平面掩码、起始下标与长度
+	uint32_t mismatches = 0;
+	uint32_t cases = 0;
+	std::uniform_int_distribution<uint32_t> offset(0, 67);
+	for (const auto& frustum : frustums)
+	{
+		const auto& planes = frustum->getPlaneData();
+		for (uint32_t planeMask : { ff::CullingKernel::AllPlanes, 0x0fu, 0x30u, 0x15u, 0u })
+		{
+			uint32_t begin = offset(random);
+			uint32_t count = OBJECT_COUNT - begin - offset(random);
+
+			std::fill(simdBits.begin(), simdBits.end(), 0);
+			std::fill(scalarBits.begin(), scalarBits.end(), 0);
+			auto simdVisible = ff::CullingKernel::cullSpheres(planes, planeMask,
+				bounds.m_centerX.data(), bounds.m_centerY.data(), bounds.m_centerZ.data(), bounds.m_radius.data(),
+				begin, count, simdBits.data());
+			auto scalarVisible = ff::CullingKernel::cullSpheresScalar(planes, planeMask,
+				bounds.m_centerX.data(), bounds.m_centerY.data(), bounds.m_centerZ.data(), bounds.m_radius.data(),
+				begin, count, scalarBits.data());
+			mismatches += (simdBits != scalarBits || simdVisible != scalarVisible) ? 1 : 0;
+
+			std::fill(simdBits.begin(), simdBits.end(), 0);
+			std::fill(scalarBits.begin(), scalarBits.end(), 0);
+			simdVisible = ff::CullingKernel::cullBoxes(planes, planeMask,
+				bounds.m_minX.data(), bounds.m_minY.data(), bounds.m_minZ.data(),
+				bounds.m_maxX.data(), bounds.m_maxY.data(), bounds.m_maxZ.data(),
+				begin, count, simdBits.data());
+			scalarVisible = ff::CullingKernel::cullBoxesScalar(planes, planeMask,
+				bounds.m_minX.data(), bounds.m_minY.data(), bounds.m_minZ.data(),
+				bounds.m_maxX.data(), bounds.m_maxY.data(), bounds.m_maxZ.data(),
+				begin, count, scalarBits.data());
+			mismatches += (simdBits != scalarBits || simdVisible != scalarVisible) ? 1 : 0;
+
+			cases += 2;
+		}
+	}
+
+	//与Frustum原有的逐个测试接口比较
+	uint32_t frustumMismatches = 0;
+	std::fill(simdBits.begin(), simdBits.end(), 0);
+	ff::CullingKernel::cullSpheres(frustums[0]->getPlaneData(), ff::CullingKernel::AllPlanes,
+		bounds.m_centerX.data(), bounds.m_centerY.data(), bounds.m_centerZ.data(), bounds.m_radius.data(),
+		0, OBJECT_COUNT, simdBits.data());
+	for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+	{
+		ff::Sphere sphere(glm::vec3(bounds.m_centerX[i], bounds.m_centerY[i], bounds.m_centerZ[i]), bounds.m_radius[i]);
+		if (frustums[0]->intersectSphere(sphere) != ff::CullingKernel::testBit(simdBits.data(), i))
+		{
+			frustumMismatches++;
+		}
+	}
+
+	std::cout << "parity cases: " << cases << "  mismatches: " << mismatches
+		<< "  frustum api mismatches: " << frustumMismatches << std::endl;
+
+	//2 吞吐量
+	ff::Timer timer;
+	uint64_t visible = 0;
+	auto measure = [&](auto&& kernel) {
+		timer.reset();
+		for (uint32_t repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+		{
+			for (const auto& frustum : frustums)
+			{
+				std::fill(simdBits.begin(), simdBits.end(), 0);
+				visible += kernel(frustum->getPlaneData(), simdBits.data());
+			}
+		}
+		double seconds = timer.elapsed_micro() / 1000000.0;
+		return static_cast<double>(OBJECT_COUNT) * REPEAT_COUNT * FRUSTUM_COUNT / seconds / 1000000.0;
+	};
+
+	auto sphereSimd = measure([&](const ff::FrustumPlanes& planes, uint64_t* bits) {
+		return ff::CullingKernel::cullSpheres(planes, ff::CullingKernel::AllPlanes,
+			bounds.m_centerX.data(), bounds.m_centerY.data(), bounds.m_centerZ.data(), bounds.m_radius.data(),
+			0, OBJECT_COUNT, bits);
+	});
+	auto sphereScalar = measure([&](const ff::FrustumPlanes& planes, uint64_t* bits) {
+		return ff::CullingKernel::cullSpheresScalar(planes, ff::CullingKernel::AllPlanes,
+			bounds.m_centerX.data(), bounds.m_centerY.data(), bounds.m_centerZ.data(), bounds.m_radius.data(),
+			0, OBJECT_COUNT, bits);
+	});
+	auto boxSimd = measure([&](const ff::FrustumPlanes& planes, uint64_t* bits) {
+		return ff::CullingKernel::cullBoxes(planes, ff::CullingKernel::AllPlanes,
+			bounds.m_minX.data(), bounds.m_minY.data(), bounds.m_minZ.data(),
+			bounds.m_maxX.data(), bounds.m_maxY.data(), bounds.m_maxZ.data(),
+			0, OBJECT_COUNT, bits);
+	});
+	auto boxScalar = measure([&](const ff::FrustumPlanes& planes, uint64_t* bits) {
+		return ff::CullingKernel::cullBoxesScalar(planes, ff::CullingKernel::AllPlanes,
+			bounds.m_minX.data(), bounds.m_minY.data(), bounds.m_minZ.data(),
+			bounds.m_maxX.data(), bounds.m_maxY.data(), bounds.m_maxZ.data(),
+			0, OBJECT_COUNT, bits);
+	});
+
+	//逐个物体通过Sphere对象测试，即原先Frustum::intersectSphere的用法
+	timer.reset();
+	for (const auto& frustum : frustums)
+	{
+		for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+		{
+			ff::Sphere sphere(glm::vec3(bounds.m_centerX[i], bounds.m_centerY[i], bounds.m_centerZ[i]), bounds.m_radius[i]);
+			visible += frustum->intersectSphere(sphere) ? 1 : 0;
+		}
+	}
+	double perObject = static_cast<double>(OBJECT_COUNT) * FRUSTUM_COUNT / (timer.elapsed_micro() / 1000000.0) / 1000000.0;
+
+	std::cout << "spheres  simd: " << sphereSimd << " M/s  scalar: " << sphereScalar << " M/s"
+		<< "  frustum api: " << perObject << " M/s" << std::endl;
+	std::cout << "boxes    simd: " << boxSimd << " M/s  scalar: " << boxScalar << " M/s" << std::endl;
+	std::cout << "checksum: " << visible << std::endl;
+
+	return 0;
+}
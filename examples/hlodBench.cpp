@@ -0,0 +1,178 @@
+#include "../ff/geometries/boxGeometry.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/objects/hlod.h"
+#include "../ff/scene/scene.h"
+#include "../ff/camera/perspectiveCamera.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/math/frustum.h"
+#include "../ff/tools/hlodBuilder.h"
+#include "../ff/tools/jobSystem.h"
+#include "../ff/tools/timer.h"
+
+//HLOD测试：
+//约5万个建筑组成的园区，先以64为单元生成第一层HLOD，再以256为单元合并第一层的代理生成第二层，
+//相机位于园区一角看向对角，按Renderer::projectObject的规则遍历场景(视锥体剪裁、HLOD选择)，
+//统计有无HLOD时的drawCall数，其中距离相机超过DISTANT_RANGE的部分单独统计
+
+static const uint32_t GRID_SIZE = 224;
+static const float GRID_SPACING = 8.0f;
+static const float DISTANT_RANGE = 300.0f;
+
+struct DrawStats
+{
+	uint64_t m_draws{ 0 };
+	uint64_t m_distantDraws{ 0 };
+	uint64_t m_triangles{ 0 };
+	uint64_t m_proxies{ 0 };
+};
+
+static void countDraws(
+	const ff::Object3D::Ptr& root,
+	const ff::Frustum::Ptr& frustum,
+	const ff::LOD::View& view,
+	bool useHLOD,
+	DrawStats& stats)
+{
+	auto draw = [&](ff::RenderableObject* renderable) {
+		if (!frustum->intersectObject(renderable))
+		{
+			return;
+		}
+
+		stats.m_draws++;
+		stats.m_triangles += renderable->getGeometry()->getIndex()->getCount() / 3;
+
+		float distance = glm::length(renderable->getWorldBoundingSphere().m_center - view.m_cameraPosition);
+		stats.m_distantDraws += distance > DISTANT_RANGE ? 1 : 0;
+	};
+
+	std::vector<ff::Object3D*> stack{ root.get() };
+	while (!stack.empty())
+	{
+		auto current = stack.back();
+		stack.pop_back();
+
+		if (!current->m_visible)
+		{
+			continue;
+		}
+
+		if (current->m_isHLOD && useHLOD)
+		{
+			auto hlod = static_cast<ff::HLOD*>(current);
+			if (hlod->update(view))
+			{
+				stats.m_proxies++;
+				draw(hlod->getProxy().get());
+				continue;
+			}
+		}
+		else if (current->m_isRenderableObject)
+		{
+			draw(static_cast<ff::RenderableObject*>(current));
+		}
+
+		for (const auto& child : current->getChildren())
+		{
+			stack.push_back(child.get());
+		}
+	}
+}
+
+int main()
+{
+	auto material = ff::MeshBasicMaterial::create();
+
+	//几种高度的建筑共享几何体，每个面2x2细分
+	std::vector<ff::Geometry::Ptr> buildings;
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		buildings.push_back(ff::BoxGeometry::create(5.0f, 4.0f + i * 6.0f, 5.0f, 2, 2, 2));
+	}
+
+	auto scene = ff::Scene::create();
+	float half = GRID_SIZE * GRID_SPACING * 0.5f;
+	uint64_t sourceTriangles = 0;
+	for (uint32_t row = 0; row < GRID_SIZE; ++row)
+	{
+		for (uint32_t column = 0; column < GRID_SIZE; ++column)
+		{
+			uint32_t type = (row * 7 + column * 13) % buildings.size();
+			auto mesh = ff::Mesh::create(buildings[type], material);
+			mesh->setPosition(column * GRID_SPACING - half, 2.0f + type * 3.0f, row * GRID_SPACING - half);
+			scene->addChild(mesh);
+
+			sourceTriangles += buildings[type]->getIndex()->getCount() / 3;
+		}
+	}
+
+	uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto jobSystem = threads > 1 ? ff::JobSystem::create(threads) : nullptr;
+
+	ff::HLODBuilder::Desc desc;
+	desc.m_material = material;
+
+	ff::Timer timer;
+	timer.reset();
+
+	desc.m_cellSize = 64.0f;
+	desc.m_screenSize = 320.0f;
+	auto firstLevel = ff::HLODBuilder::build(scene, desc, jobSystem);
+	double firstSeconds = timer.elapsed_micro() / 1000000.0;
+
+	timer.reset();
+	desc.m_cellSize = 256.0f;
+	desc.m_screenSize = 480.0f;
+	auto secondLevel = ff::HLODBuilder::build(scene, desc, jobSystem);
+	double secondSeconds = timer.elapsed_micro() / 1000000.0;
+
+	uint64_t firstTriangles = 0;
+	for (const auto& hlod : firstLevel)
+	{
+		firstTriangles += hlod->getProxy()->getGeometry()->getIndex()->getCount() / 3;
+	}
+
+	uint64_t secondTriangles = 0;
+	for (const auto& hlod : secondLevel)
+	{
+		secondTriangles += hlod->getProxy()->getGeometry()->getIndex()->getCount() / 3;
+	}
+
+	std::cout << "objects: " << GRID_SIZE * GRID_SIZE << "  triangles: " << sourceTriangles << "  threads: " << threads << std::endl;
+	std::cout << "level 1: " << firstLevel.size() << " proxies, " << firstTriangles << " triangles, build " << firstSeconds * 1000.0 << " ms" << std::endl;
+	std::cout << "level 2: " << secondLevel.size() << " proxies, " << secondTriangles << " triangles, build " << secondSeconds * 1000.0 << " ms" << std::endl;
+
+	auto camera = ff::PerspectiveCamera::create(0.1f, 5000.0f, 16.0f / 9.0f, 60.0f);
+	auto frustum = ff::Frustum::create();
+	float viewportHeight = 1080.0f;
+
+	//园区一角，分别从低处与高处看向对角
+	for (float height : { 2.0f, 60.0f })
+	{
+		camera->setRotateAroundAxis(glm::vec3(0.0f, 1.0f, 0.0f), 45.0f);
+		camera->setPosition(half, height, half);
+		camera->updateWorldMatrix(true, true);
+
+		glm::mat4 viewProjection = camera->getProjectionMatrix() * camera->getWorldMatrixInverse();
+		frustum->setFromProjectionMatrix(viewProjection);
+		auto view = ff::LOD::makeView(camera, viewportHeight);
+
+		for (bool useHLOD : { false, true })
+		{
+			DrawStats stats;
+
+			timer.reset();
+			countDraws(scene, frustum, view, useHLOD, stats);
+			auto time = timer.elapsed_micro();
+
+			std::cout << "height: " << height << (useHLOD ? "  hlod" : "  full")
+				<< "  draws: " << stats.m_draws
+				<< "  distant draws: " << stats.m_distantDraws
+				<< "  proxies: " << stats.m_proxies
+				<< "  triangles: " << stats.m_triangles
+				<< "  traverse: " << time / 1000.0 << " ms" << std::endl;
+		}
+	}
+
+	return 0;
+}
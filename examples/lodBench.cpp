@@ -0,0 +1,121 @@
+#include "../ff/geometries/planeGeometry.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/objects/lod.h"
+#include "../ff/scene/scene.h"
+#include "../ff/camera/perspectiveCamera.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/math/frustum.h"
+#include "../ff/tools/timer.h"
+
+//LOD测试：
+//大片地表物体(每个3个级别)，相机贴近地面前进并前后抖动，
+//统计视锥体内物体使用全精度与按投影大小选择级别时提交的三角形数，以及有无滞后时的级别切换次数
+
+static const uint32_t GRID_SIZE = 200;
+static const float GRID_SPACING = 10.0f;
+static const uint32_t FRAME_COUNT = 120;
+
+static uint32_t triangleCount(const ff::RenderableObject::Ptr& object)
+{
+	return object->getGeometry()->getIndex()->getCount() / 3;
+}
+
+int main()
+{
+	auto material = ff::MeshBasicMaterial::create();
+
+	//高中低三个级别共享几何体
+	ff::Geometry::Ptr levels[3] =
+	{
+		ff::PlaneGeometry::create(4.0f, 4.0f, 32.0f, 32.0f),
+		ff::PlaneGeometry::create(4.0f, 4.0f, 8.0f, 8.0f),
+		ff::PlaneGeometry::create(4.0f, 4.0f, 1.0f, 1.0f),
+	};
+	float thresholds[3] = { 120.0f, 24.0f, 4.0f };
+
+	auto camera = ff::PerspectiveCamera::create(0.1f, 5000.0f, 16.0f / 9.0f, 60.0f);
+	auto frustum = ff::Frustum::create();
+	float viewportHeight = 1080.0f;
+
+	for (float hysteresis : { 0.0f, 0.1f })
+	{
+		auto scene = ff::Scene::create();
+		std::vector<ff::LOD::Ptr> lods;
+
+		float half = GRID_SIZE * GRID_SPACING * 0.5f;
+		for (uint32_t row = 0; row < GRID_SIZE; ++row)
+		{
+			for (uint32_t column = 0; column < GRID_SIZE; ++column)
+			{
+				auto lod = ff::LOD::create();
+				for (uint32_t i = 0; i < 3; ++i)
+				{
+					lod->addLevel(ff::Mesh::create(levels[i], material), thresholds[i]);
+				}
+
+				lod->rotateX(-90.0f);
+				lod->setPosition(column * GRID_SPACING - half, 0.0f, row * GRID_SPACING - half);
+				lod->setHysteresis(hysteresis);
+				scene->addChild(lod);
+				lods.push_back(lod);
+			}
+		}
+
+		scene->updateWorldMatrix(true, true);
+
+		uint64_t fullTriangles = 0;
+		uint64_t lodTriangles = 0;
+		uint64_t culled = 0;
+		uint64_t switches = 0;
+		int64_t time = 0;
+
+		for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			//向前推进的同时前后抖动，模拟手持相机
+			float z = half - frame * 4.0f + std::sin(frame * 1.7f) * 3.0f;
+			camera->setPosition(0.0f, 6.0f, z);
+			camera->setRotateAroundAxis(glm::vec3(1.0f, 0.0f, 0.0f), -8.0f);
+			camera->updateWorldMatrix(true, true);
+
+			glm::mat4 viewProjection = camera->getProjectionMatrix() * camera->getWorldMatrixInverse();
+			frustum->setFromProjectionMatrix(viewProjection);
+			auto view = ff::LOD::makeView(camera, viewportHeight);
+
+			ff::Timer timer;
+			timer.reset();
+			for (auto& lod : lods)
+			{
+				const auto& finest = lod->getLevels()[0].m_object;
+				if (!frustum->intersectObject(finest.get()))
+				{
+					continue;
+				}
+
+				auto level = lod->update(view);
+				switches += lod->hasSwitched() ? 1 : 0;
+
+				fullTriangles += triangleCount(finest);
+				if (level == ff::LOD::Culled)
+				{
+					culled++;
+				}
+				else
+				{
+					lodTriangles += triangleCount(lod->getLevels()[level].m_object);
+				}
+			}
+			time += timer.elapsed_micro();
+		}
+
+		std::cout << "hysteresis: " << hysteresis
+			<< "  select: " << time / 1000.0 / FRAME_COUNT << " ms/frame"
+			<< "  triangles full: " << fullTriangles / FRAME_COUNT
+			<< "  lod: " << lodTriangles / FRAME_COUNT
+			<< "  culled: " << culled / FRAME_COUNT
+			<< "  switches: " << switches << std::endl;
+	}
+
+	std::cout << "objects: " << GRID_SIZE * GRID_SIZE << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include "../ff/scene/sceneSnapshot.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/tools/timer.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+//内存映射加载测试：
+//生成一份约750MB顶点数据的场景快照，分别以Copy与Map模式加载，
+//统计加载耗时、加载后与“上传”(顺序读取全部顶点数据，模拟glBufferData)之后的进程私有内存
+
+static const uint32_t PART_COUNT = 100;
+static const uint32_t VERTICES_PER_PART = 256 * 1024;
+
+static const char* SNAPSHOT_PATH = "mappedLoadBench.ffs";
+
+//进程私有(匿名)内存，映射文件的页面不计入
+static double privateMB()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS_EX counters{};
+	K32GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters));
+	return counters.PrivateUsage / 1024.0 / 1024.0;
+#else
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.rfind("RssAnon:", 0) == 0)
+		{
+			return std::stod(line.substr(8)) / 1024.0;
+		}
+	}
+	return 0.0;
+#endif
+}
+
+static void writeSnapshot()
+{
+	auto scene = ff::Scene::create();
+	auto material = ff::MeshBasicMaterial::create();
+
+	for (uint32_t part = 0; part < PART_COUNT; ++part)
+	{
+		std::vector<float> positions(VERTICES_PER_PART * 3);
+		std::vector<float> normals(VERTICES_PER_PART * 3);
+		std::vector<uint32_t> indices(VERTICES_PER_PART / 2 * 3);
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			positions[i] = static_cast<float>((i * 7 + part) % 1000) * 0.01f;
+			normals[i] = 1.0f;
+		}
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			indices[i] = static_cast<uint32_t>((i * 31) % VERTICES_PER_PART);
+		}
+
+		auto geometry = ff::Geometry::create();
+		geometry->setAttribute("position", ff::Attributef::create(std::move(positions), 3));
+		geometry->setAttribute("normal", ff::Attributef::create(std::move(normals), 3));
+		geometry->setIndex(ff::Attributei::create(std::move(indices), 1));
+
+		scene->addChild(ff::Mesh::create(geometry, material));
+	}
+
+	ff::SceneSnapshot::save(scene, SNAPSHOT_PATH);
+}
+
+//与上传GPU一样顺序读取所有Attribute
+static double touchAll(const ff::Scene::Ptr& scene)
+{
+	double sum = 0.0;
+	for (const auto& child : scene->getChildren())
+	{
+		auto geometry = std::static_pointer_cast<ff::Mesh>(child)->getGeometry();
+		for (const auto& attribute : geometry->getAttributes())
+		{
+			for (float value : attribute.second->getData())
+			{
+				sum += value;
+			}
+		}
+
+		for (uint32_t value : geometry->getIndex()->getData())
+		{
+			sum += value;
+		}
+	}
+
+	return sum;
+}
+
+int main()
+{
+	writeSnapshot();
+
+	std::ifstream file(SNAPSHOT_PATH, std::ios::binary | std::ios::ate);
+	std::cout << "snapshot: " << file.tellg() / 1024 / 1024 << " MB" << std::endl;
+
+	double checksums[2] = {};
+	for (auto mode : { ff::SceneSnapshot::LoadMode::Copy, ff::SceneSnapshot::LoadMode::Map })
+	{
+		bool map = mode == ff::SceneSnapshot::LoadMode::Map;
+		double baseline = privateMB();
+
+		ff::Timer timer;
+		timer.reset();
+		auto scene = ff::SceneSnapshot::load(SNAPSHOT_PATH, mode);
+		double loadMs = timer.elapsed_micro() / 1000.0;
+		double loaded = privateMB() - baseline;
+
+		timer.reset();
+		checksums[map ? 1 : 0] = touchAll(scene);
+		double touchMs = timer.elapsed_micro() / 1000.0;
+		double touched = privateMB() - baseline;
+
+		std::cout << (map ? "map " : "copy") << "  load: " << loadMs << " ms"
+			<< "  private after load: " << loaded << " MB"
+			<< "  read all: " << touchMs << " ms"
+			<< "  private after read: " << touched << " MB" << std::endl;
+	}
+
+	std::remove(SNAPSHOT_PATH);
+
+	bool same = checksums[0] == checksums[1];
+	std::cout << "data: " << (same ? "identical" : "DIFFERENT") << std::endl;
+
+	return same ? 0 : 1;
+}
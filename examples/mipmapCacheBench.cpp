@@ -0,0 +1,113 @@
+#include "../ff/loader/mipmapCache.h"
+#include "../ff/loader/textureLoader.h"
+#include "../ff/tools/timer.h"
+#include <filesystem>
+#include <chrono>
+
+//mipmap缓存测试：
+//生成IMAGE_COUNT张图片，对比
+//  1 每次运行都解码图片并生成mip链(相当于原来的解码 + glGenerateMipmap)
+//  2 首次运行时并行烘焙缓存
+//  3 之后的运行直接从缓存顺序读取完整的mip链
+//并检查每张图片都被烘焙并从缓存命中，且读出的各级数据与现场生成的一致
+//图片与缓存都放在系统临时目录下本次运行独有的子目录中，结束时删除
+
+static const uint32_t IMAGE_COUNT = 48;
+static const uint32_t IMAGE_SIZE = 1024;
+
+static std::filesystem::path g_directory;
+
+static std::string imagePath(uint32_t index)
+{
+	return (g_directory / ("image_" + std::to_string(index) + ".ppm")).string();
+}
+
+static void writeImages()
+{
+	std::vector<byte> pixels(IMAGE_SIZE * IMAGE_SIZE * 3);
+	for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+	{
+		for (size_t p = 0; p < pixels.size(); ++p)
+		{
+			pixels[p] = static_cast<byte>((p * (i + 3)) >> 5);
+		}
+
+		std::ofstream stream(imagePath(i), std::ios::binary);
+		stream << "P6\n" << IMAGE_SIZE << " " << IMAGE_SIZE << "\n255\n";
+		stream.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+	}
+}
+
+int main()
+{
+	auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+	g_directory = std::filesystem::temp_directory_path() / ("mipmapCacheBench_" + std::to_string(stamp));
+	std::filesystem::create_directories(g_directory);
+
+	writeImages();
+
+	std::vector<std::string> paths;
+	for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+	{
+		paths.push_back(imagePath(i));
+	}
+
+	uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto jobSystem = threads > 1 ? ff::JobSystem::create(threads) : nullptr;
+	auto mipmapCache = ff::MipmapCache::create((g_directory / "cache").string());
+
+	ff::Timer timer;
+
+	//1 每次运行都解码并生成
+	timer.reset();
+	std::vector<ff::Source::Ptr> decoded;
+	for (const auto& path : paths)
+	{
+		auto source = ff::TextureLoader::decode(path);
+		ff::MipmapCache::buildMipmaps(*source);
+		decoded.push_back(source);
+	}
+	double decodeMs = timer.elapsed_micro() / 1000.0;
+
+	//2 首次运行烘焙
+	timer.reset();
+	uint32_t baked = mipmapCache->bake(paths, jobSystem);
+	double bakeMs = timer.elapsed_micro() / 1000.0;
+
+	//3 从缓存读取
+	timer.reset();
+	std::vector<ff::Source::Ptr> cached;
+	for (const auto& path : paths)
+	{
+		cached.push_back(mipmapCache->loadImage(path));
+	}
+	double loadMs = timer.elapsed_micro() / 1000.0;
+
+	bool same = true;
+	uint64_t bytes = 0;
+	for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+	{
+		same = same && cached[i] != nullptr && cached[i]->m_data == decoded[i]->m_data && cached[i]->m_mipmaps == decoded[i]->m_mipmaps;
+
+		//缓存文件不存在时tellg返回-1
+		auto size = std::ifstream(mipmapCache->getPath(ff::MipmapCache::makeKey(ff::MipmapCache::hashFile(paths[i]), ff::TextureFormat::RGBA, ff::DataType::UnsignedByteType)), std::ios::binary | std::ios::ate).tellg();
+		if (size > 0)
+		{
+			bytes += static_cast<uint64_t>(size);
+		}
+	}
+
+	//没有烘焙或没有命中时，比较的只是两次现场生成的数据
+	bool complete = baked == IMAGE_COUNT && mipmapCache->getHits() == IMAGE_COUNT;
+
+	std::cout << "images: " << IMAGE_COUNT << " x " << IMAGE_SIZE << "^2  levels: " << decoded[0]->m_mipmaps.size() + 1
+		<< "  cache: " << bytes / 1024 / 1024 << " MB  threads: " << threads << std::endl;
+	std::cout << "decode + build mips: " << decodeMs << " ms" << std::endl;
+	std::cout << "bake (first run):    " << bakeMs << " ms  baked: " << baked << std::endl;
+	std::cout << "load from cache:     " << loadMs << " ms  hits: " << mipmapCache->getHits() << "  misses: " << mipmapCache->getMisses() << std::endl;
+	std::cout << "mip chains: " << (same ? "identical" : "DIFFERENT") << "  cache: " << (complete ? "complete" : "INCOMPLETE") << std::endl;
+
+	std::filesystem::remove_all(g_directory);
+
+	return same && complete ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+#include "../ff/loader/modelLoader.h"
+
+//模型加载测试：
+//对同一个模型分别串行(jobSystem为nullptr)与并行加载若干次，输出各阶段耗时的平均值
+//用法：modelLoadBench <模型路径> [次数]
+
+static const char* DEFAULT_MODEL = "assets/models/robot/robot.fbx";
+
+int main(int argc, char** argv)
+{
+	std::string path = argc > 1 ? argv[1] : DEFAULT_MODEL;
+	uint32_t runs = argc > 2 ? static_cast<uint32_t>(std::max(std::atoi(argv[2]), 1)) : 5;
+
+	uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto jobSystem = ff::JobSystem::create(threads);
+
+	for (bool parallel : { false, true })
+	{
+		ff::ModelLoader::Stats total;
+		ff::ModelLoader::Stats stats;
+
+		for (uint32_t run = 0; run < runs; ++run)
+		{
+			auto model = ff::ModelLoader::load(path, parallel ? jobSystem : nullptr, &stats);
+			if (model == nullptr)
+			{
+				return 1;
+			}
+
+			total.m_importMs += stats.m_importMs;
+			total.m_meshMs += stats.m_meshMs;
+			total.m_textureMs += stats.m_textureMs;
+			total.m_sceneMs += stats.m_sceneMs;
+			total.m_totalMs += stats.m_totalMs;
+		}
+
+		if (!parallel)
+		{
+			std::cout << "nodes: " << stats.m_nodes << "  meshes: " << stats.m_meshes << "  vertices: " << stats.m_vertices
+				<< "  triangles: " << stats.m_triangles << "  bones: " << stats.m_bones
+				<< "  textures: " << stats.m_textures << " (" << stats.m_textureRefs << " references)" << std::endl;
+		}
+
+		std::cout << (parallel ? "parallel (" + std::to_string(threads) + " threads)" : std::string("serial"))
+			<< "  import: " << total.m_importMs / runs << " ms"
+			<< "  meshes: " << total.m_meshMs / runs << " ms"
+			<< "  textures: " << total.m_textureMs / runs << " ms"
+			<< "  scene: " << total.m_sceneMs / runs << " ms"
+			<< "  total: " << total.m_totalMs / runs << " ms" << std::endl;
+	}
+
+	return 0;
+}
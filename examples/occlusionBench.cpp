@@ -0,0 +1,186 @@
+#include "../ff/geometries/boxGeometry.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/scene/scene.h"
+#include "../ff/camera/perspectiveCamera.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/math/frustum.h"
+#include "../ff/render/occlusionCuller.h"
+#include "../ff/tools/jobSystem.h"
+#include "../ff/tools/timer.h"
+
+//CPU遮挡剪裁测试：
+//城市街区场景，每个街区一栋大楼(遮挡体)，大楼之间散布大量小物体，相机位于街道上。
+//统计视锥体剪裁之后仍然可见的物体中有多少被遮挡剔除，以及1~N个线程下光栅化+测试的耗时；
+//并检查相机正前方街道上的物体没有被误剔除，且剔除结果与线程数无关
+
+static const uint32_t BLOCK_COUNT = 24;
+static const float BLOCK_SPACING = 30.0f;
+static const float BUILDING_SIZE = 22.0f;
+static const uint32_t PROPS_PER_BLOCK = 120;
+static const uint32_t FRAME_COUNT = 36;
+
+int main()
+{
+	auto buildingGeometry = ff::BoxGeometry::create(BUILDING_SIZE, 40.0f, BUILDING_SIZE);
+	auto propGeometry = ff::BoxGeometry::create(1.0f, 1.0f, 1.0f);
+	auto material = ff::MeshBasicMaterial::create();
+
+	auto scene = ff::Scene::create();
+	std::vector<ff::Mesh::Ptr> buildings;
+	std::vector<ff::Mesh::Ptr> props;
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> offset(-BLOCK_SPACING * 0.5f, BLOCK_SPACING * 0.5f);
+
+	float half = BLOCK_COUNT * BLOCK_SPACING * 0.5f;
+	for (uint32_t row = 0; row < BLOCK_COUNT; ++row)
+	{
+		for (uint32_t column = 0; column < BLOCK_COUNT; ++column)
+		{
+			float x = column * BLOCK_SPACING - half;
+			float z = row * BLOCK_SPACING - half;
+
+			auto building = ff::Mesh::create(buildingGeometry, material);
+			building->setPosition(x, 20.0f, z);
+			building->m_isOccluder = true;
+			scene->addChild(building);
+			buildings.push_back(building);
+
+			//小物体散布在大楼外侧的街道上
+			for (uint32_t i = 0; i < PROPS_PER_BLOCK; ++i)
+			{
+				float px = offset(random);
+				float pz = offset(random);
+				if (std::abs(px) < BUILDING_SIZE * 0.5f + 1.0f && std::abs(pz) < BUILDING_SIZE * 0.5f + 1.0f)
+				{
+					px = px < 0.0f ? px - BUILDING_SIZE * 0.5f : px + BUILDING_SIZE * 0.5f;
+				}
+
+				auto prop = ff::Mesh::create(propGeometry, material);
+				prop->setPosition(x + px, 0.5f, z + pz);
+				scene->addChild(prop);
+				props.push_back(prop);
+			}
+		}
+	}
+
+	//相机正前方街道上的物体，任何朝向下都不应被剔除
+	std::vector<ff::Mesh::Ptr> streetProps;
+	float streetX = BLOCK_SPACING * 0.5f;
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		auto prop = ff::Mesh::create(propGeometry, material);
+		prop->setPosition(streetX, 0.5f, 4.0f + i * 6.0f);
+		scene->addChild(prop);
+		streetProps.push_back(prop);
+	}
+
+	scene->updateWorldMatrix(true, true);
+
+	auto camera = ff::PerspectiveCamera::create(0.1f, 1000.0f, 16.0f / 9.0f, 60.0f);
+	camera->setPosition(streetX, 1.7f, 0.0f);
+
+	auto frustum = ff::Frustum::create();
+	auto culler = ff::OcclusionCuller::create(320, 180);
+
+	uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+
+	//第一次运行的剔除结果作为基准
+	std::vector<std::vector<uint8_t>> reference(FRAME_COUNT);
+	bool consistent = true;
+	uint32_t streetCulled = 0;
+
+	for (auto threads : threadCounts)
+	{
+		auto jobSystem = threads > 1 ? ff::JobSystem::create(threads) : nullptr;
+
+		int64_t time = 0;
+		uint64_t frustumVisible = 0;
+		uint64_t culled = 0;
+		uint64_t triangles = 0;
+
+		for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			//只在半个圆周内转动，保证街道上的物体始终在视野中
+			camera->setRotateAroundAxis(glm::vec3(0.0f, 1.0f, 0.0f), 180.0f + (frame * 60.0f / FRAME_COUNT) - 30.0f);
+			camera->updateWorldMatrix(true, true);
+
+			glm::mat4 viewProjection = camera->getProjectionMatrix() * camera->getWorldMatrixInverse();
+			frustum->setFromProjectionMatrix(viewProjection);
+
+			culler->begin(viewProjection);
+			for (auto& building : buildings)
+			{
+				if (frustum->intersectObject(building.get()))
+				{
+					culler->addOccluder(building.get());
+				}
+			}
+
+			std::vector<uint32_t> indices;
+			std::vector<uint32_t> streetIndices;
+			for (auto& prop : props)
+			{
+				if (frustum->intersectObject(prop.get()))
+				{
+					indices.push_back(culler->addOccludee(prop->getWorldBoundingBox()));
+				}
+			}
+			for (auto& prop : streetProps)
+			{
+				if (frustum->intersectObject(prop.get()))
+				{
+					streetIndices.push_back(culler->addOccludee(prop->getWorldBoundingBox()));
+				}
+			}
+
+			ff::Timer timer;
+			timer.reset();
+			culler->cull(jobSystem);
+			time += timer.elapsed_micro();
+
+			const auto& cullInfo = culler->getCullInfo();
+			frustumVisible += cullInfo.m_occludeesTested;
+			culled += cullInfo.m_occludeesCulled;
+			triangles += cullInfo.m_occluderTriangles;
+
+			for (auto index : streetIndices)
+			{
+				streetCulled += culler->isOccluded(index) ? 1 : 0;
+			}
+
+			std::vector<uint8_t> result(cullInfo.m_occludeesTested);
+			for (uint32_t i = 0; i < cullInfo.m_occludeesTested; ++i)
+			{
+				result[i] = culler->isOccluded(i) ? 1 : 0;
+			}
+
+			if (reference[frame].empty())
+			{
+				reference[frame] = std::move(result);
+			}
+			else if (reference[frame] != result)
+			{
+				consistent = false;
+			}
+		}
+
+		std::cout << "threads: " << threads
+			<< "  occlusion: " << time / 1000.0 / FRAME_COUNT << " ms/frame"
+			<< "  occluder triangles: " << triangles / FRAME_COUNT
+			<< "  frustum visible: " << frustumVisible / FRAME_COUNT
+			<< "  culled: " << culled / FRAME_COUNT << std::endl;
+	}
+
+	std::cout << "objects: " << props.size() + streetProps.size() << "  occluders: " << buildings.size()
+		<< "  buffer: " << culler->getWidth() << "x" << culler->getHeight() << std::endl;
+	std::cout << "street props culled: " << streetCulled << (streetCulled == 0 ? " (OK)" : " (ERROR)") << std::endl;
+	std::cout << "results across thread counts: " << (consistent ? "identical" : "MISMATCH") << std::endl;
+
+	return (consistent && streetCulled == 0) ? 0 : 1;
+}
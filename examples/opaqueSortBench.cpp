@@ -0,0 +1,152 @@
+#include "../ff/render/driver/driverRenderList.h"
+#include "../ff/tools/timer.h"
+#include <random>
+
+//不透明物体排序方式测试：
+//OBJECT_COUNT个物体随机分布在相机前方，每个物体有自己的program/贴图/材质/几何体，按三种方式排序后依次"绘制"，统计
+//  1 相邻两次绘制之间program、贴图、材质与VAO的切换次数(与DriverInfo::m_stateChanges、m_textureBinding.m_binds对应)
+//  2 在GRID_WIDTH x GRID_HEIGHT的粗粒度深度缓冲上模拟early-z：通过深度测试而被着色的格子数 / 最终可见的格子数
+//物体在屏幕上的尺寸与距离成反比
+
+static const uint32_t OBJECT_COUNT = 20000;
+static const uint32_t PROGRAM_COUNT = 12;
+static const uint32_t TEXTURE_COUNT = 200;
+static const uint32_t MATERIAL_COUNT = 800;
+static const uint32_t GEOMETRY_COUNT = 300;
+static const int GRID_WIDTH = 320;
+static const int GRID_HEIGHT = 180;
+static const float NEAR_DISTANCE = 2.0f;
+static const float FAR_DISTANCE = 1000.0f;
+static const float FOOTPRINT = 60.0f;	//距离为1时物体覆盖的格子边长
+
+struct SceneObject
+{
+	ff::SortKeyInput	m_input{};
+	int					m_x{ 0 };
+	int					m_y{ 0 };
+	int					m_size{ 1 };
+};
+
+struct MaterialState
+{
+	uint32_t	m_program{ 0 };
+	uint32_t	m_texture{ 0 };
+};
+
+int main()
+{
+	std::mt19937 random(3);
+
+	std::vector<MaterialState> materials(MATERIAL_COUNT);
+	for (auto& material : materials)
+	{
+		material.m_program = 1 + random() % PROGRAM_COUNT;
+		material.m_texture = 100 + random() % TEXTURE_COUNT;
+	}
+
+	//距离按对数均匀分布，近处物体少而大，远处物体多而小
+	std::uniform_real_distribution<float> logDistance(std::log(NEAR_DISTANCE), std::log(FAR_DISTANCE));
+	std::vector<SceneObject> objects(OBJECT_COUNT);
+	for (auto& object : objects)
+	{
+		uint32_t material = random() % MATERIAL_COUNT;
+
+		object.m_input.m_material = 1000 + material;
+		object.m_input.m_program = materials[material].m_program;
+		object.m_input.m_texture = materials[material].m_texture;
+		object.m_input.m_vao = 5000 + random() % GEOMETRY_COUNT;
+		object.m_input.m_depth = std::exp(logDistance(random));
+
+		object.m_size = std::clamp(static_cast<int>(FOOTPRINT / object.m_input.m_depth), 1, GRID_HEIGHT);
+		object.m_x = static_cast<int>(random() % GRID_WIDTH) - object.m_size / 2;
+		object.m_y = static_cast<int>(random() % GRID_HEIGHT) - object.m_size / 2;
+	}
+
+	struct Mode
+	{
+		const char*			m_name;
+		ff::OpaqueSortMode	m_mode;
+	};
+	const Mode modes[] = {
+		{ "front-to-back", ff::OpaqueSortMode::FrontToBack },
+		{ "state-sorted ", ff::OpaqueSortMode::StateSorted },
+		{ "hybrid       ", ff::OpaqueSortMode::Hybrid },
+	};
+
+	//所有物体覆盖的格子数 / 屏幕格子数
+	uint64_t area = 0;
+	for (const auto& object : objects)
+	{
+		area += static_cast<uint64_t>(object.m_size) * object.m_size;
+	}
+
+	std::cout << "objects: " << OBJECT_COUNT << "  programs: " << PROGRAM_COUNT << "  textures: " << TEXTURE_COUNT
+		<< "  materials: " << MATERIAL_COUNT << "  geometries: " << GEOMETRY_COUNT
+		<< "  depth complexity: " << static_cast<double>(area) / (GRID_WIDTH * GRID_HEIGHT) << std::endl;
+
+	std::vector<ff::SortEntry> entries;
+	std::vector<ff::SortEntry> scratch;
+	std::vector<float> depthBuffer(static_cast<size_t>(GRID_WIDTH) * GRID_HEIGHT);
+
+	bool ok = true;
+	for (const auto& mode : modes)
+	{
+		auto layout = ff::SortKeyLayout::opaque(mode.m_mode);
+
+		ff::Timer timer;
+		timer.reset();
+
+		entries.clear();
+		for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+		{
+			entries.push_back({ ff::DriverRenderList::makeSortKey(layout, objects[i].m_input), i });
+		}
+		ff::radixSort(entries, scratch);
+
+		double sortMs = timer.elapsed_micro() / 1000.0;
+
+		uint32_t programs = 0, textures = 0, materialChanges = 0, vaos = 0;
+		ff::SortKeyInput current;
+		std::fill(depthBuffer.begin(), depthBuffer.end(), FLT_MAX);
+		uint64_t shaded = 0;
+
+		for (const auto& entry : entries)
+		{
+			const auto& object = objects[entry.m_index];
+			const auto& input = object.m_input;
+
+			programs += input.m_program != current.m_program ? 1 : 0;
+			textures += input.m_texture != current.m_texture ? 1 : 0;
+			materialChanges += input.m_material != current.m_material ? 1 : 0;
+			vaos += input.m_vao != current.m_vao ? 1 : 0;
+			current = input;
+
+			for (int y = std::max(object.m_y, 0); y < std::min(object.m_y + object.m_size, GRID_HEIGHT); ++y)
+			{
+				for (int x = std::max(object.m_x, 0); x < std::min(object.m_x + object.m_size, GRID_WIDTH); ++x)
+				{
+					float& depth = depthBuffer[static_cast<size_t>(y) * GRID_WIDTH + x];
+					if (input.m_depth < depth)
+					{
+						depth = input.m_depth;
+						shaded++;
+					}
+				}
+			}
+		}
+
+		uint64_t covered = 0;
+		for (auto depth : depthBuffer)
+		{
+			covered += depth < FLT_MAX ? 1 : 0;
+		}
+
+		std::cout << mode.m_name << "  sort: " << sortMs << " ms"
+			<< "  programs: " << programs << "  textures: " << textures << "  materials: " << materialChanges << "  vaos: " << vaos
+			<< "  overdraw: " << static_cast<double>(shaded) / std::max<uint64_t>(covered, 1) << std::endl;
+
+		ok = ok && entries.size() == OBJECT_COUNT;
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#include "../ff/core/geometry.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/camera/perspectiveCamera.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/math/frustum.h"
+#include "../ff/render/driver/driverRenderList.h"
+#include "../ff/tools/jobSystem.h"
+#include "../ff/tools/timer.h"
+#include <random>
+
+//多线程构建渲染列表测试：
+//OBJECT_COUNTS个mesh随机分布在相机周围，每帧对所有物体做 视锥体剪裁 -> 计算z与排序键 -> 压入 -> 排序，对比
+//  1 在调用线程上逐个压入(Renderer原来的projectRenderable)
+//  2 按GRAIN_SIZE切分区间，在JobSystem上剪裁并压入各自的局部列表，再按区间顺序合并(Renderer::projectRenderables)
+//两种方式都在调用线程上做一次"提交"：按帧去重的geometry查找，对应DriverObjects::update
+//检查两种方式排序后的列表完全相同
+
+static const uint32_t OBJECT_COUNTS[] = { 100000, 400000 };
+static const uint32_t GEOMETRY_COUNT = 64;
+static const uint32_t MATERIAL_COUNT = 256;
+static const uint32_t GRAIN_SIZE = 1024;
+static const uint32_t FRAME_COUNT = 10;
+static const float WORLD_SIZE = 1000.0f;
+
+static ff::Geometry::Ptr createBoxGeometry()
+{
+	std::vector<float> positions =
+	{
+		-0.5f, 0.0f, -0.5f,		0.5f, 0.0f, -0.5f,		0.5f, 0.0f, 0.5f,		-0.5f, 0.0f, 0.5f,
+		-0.5f, 3.0f, -0.5f,		0.5f, 3.0f, -0.5f,		0.5f, 3.0f, 0.5f,		-0.5f, 3.0f, 0.5f,
+	};
+
+	auto geometry = ff::Geometry::create();
+	geometry->setAttribute("position", ff::Attributef::create(positions, 3));
+	geometry->computeBoundingSphere();
+
+	return geometry;
+}
+
+//调用线程上的提交，每个geometry每帧只"上传"一次
+struct Committer
+{
+	std::unordered_map<ID, uint32_t>	m_updateMap{};
+	uint32_t							m_frame{ 0 };
+	uint32_t							m_uploads{ 0 };
+
+	bool commit(ff::RenderableObject* object)
+	{
+		auto& frame = m_updateMap[object->getGeometry()->getID()];
+		if (frame != m_frame)
+		{
+			frame = m_frame;
+			m_uploads++;
+		}
+
+		return true;
+	}
+};
+
+int main()
+{
+	std::mt19937 random(7);
+
+	std::vector<ff::Geometry::Ptr> geometries;
+	for (uint32_t i = 0; i < GEOMETRY_COUNT; ++i)
+	{
+		geometries.push_back(createBoxGeometry());
+	}
+
+	std::vector<ff::Material::Ptr> materials;
+	for (uint32_t i = 0; i < MATERIAL_COUNT; ++i)
+	{
+		auto material = ff::MeshBasicMaterial::create();
+		material->m_transparent = i % 16 == 0;
+		materials.push_back(material);
+	}
+
+	uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+	auto jobSystem = ff::JobSystem::create(threadCount);
+
+	auto camera = ff::PerspectiveCamera::create(0.1f, WORLD_SIZE, 16.0f / 9.0f, 75.0f);
+	camera->setPosition(0.0f, 2.0f, 0.0f);
+
+	auto frustum = ff::Frustum::create();
+
+	bool ok = true;
+	for (auto count : OBJECT_COUNTS)
+	{
+		std::uniform_real_distribution<float> position(-WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		std::vector<ff::Mesh::Ptr> meshes;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			auto mesh = ff::Mesh::create(geometries[random() % GEOMETRY_COUNT], materials[random() % MATERIAL_COUNT]);
+			mesh->setPosition(position(random), 0.0f, position(random));
+			mesh->updateWorldMatrix(false, false);
+			meshes.push_back(mesh);
+		}
+
+		auto serialList = ff::DriverRenderList::create();
+		auto parallelList = ff::DriverRenderList::create();
+		Committer serialCommitter;
+		Committer parallelCommitter;
+
+		ff::Timer timer;
+		double serialMs = 0.0;
+		double parallelMs = 0.0;
+		double commitMs = 0.0;
+		bool same = true;
+
+		for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			camera->rotateY(360.0f / FRAME_COUNT);
+			camera->updateWorldMatrix(true, true);
+
+			glm::mat4 viewMatrix = camera->getProjectionMatrix() * camera->getWorldMatrixInverse();
+			frustum->setFromProjectionMatrix(viewMatrix);
+
+			auto project = [&](ff::Mesh* mesh, float& z) {
+				if (!frustum->intersectObject(mesh))
+				{
+					return false;
+				}
+
+				z = (viewMatrix * glm::vec4(mesh->getWorldPosition(), 1.0f)).z;
+				return true;
+			};
+
+			//1 串行
+			serialCommitter.m_frame = frame + 1;
+			timer.reset();
+
+			serialList->init();
+			for (const auto& mesh : meshes)
+			{
+				float z = 0.0f;
+				if (project(mesh.get(), z) && serialCommitter.commit(mesh.get()))
+				{
+					serialList->push(mesh.get(), mesh->getGeometry().get(), mesh->getMaterial().get(), 0, z);
+				}
+			}
+			serialList->sort();
+
+			serialMs += timer.elapsed_micro() / 1000.0;
+
+			//2 并行剪裁 + 局部列表 + 串行提交
+			parallelCommitter.m_frame = frame + 1;
+			timer.reset();
+
+			parallelList->init();
+			parallelList->initPartials((count + GRAIN_SIZE - 1) / GRAIN_SIZE);
+			jobSystem->parallelFor(count, GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+				const uint32_t range = begin / GRAIN_SIZE;
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const auto& mesh = meshes[i];
+
+					float z = 0.0f;
+					if (project(mesh.get(), z))
+					{
+						parallelList->pushPartial(range, mesh.get(), mesh->getGeometry().get(), mesh->getMaterial().get(), 0, z);
+					}
+				}
+			});
+
+			ff::Timer commitTimer;
+			commitTimer.reset();
+			parallelList->mergePartials([&parallelCommitter](const ff::RenderItem& item) {
+				return parallelCommitter.commit(item.m_object);
+			});
+			commitMs += commitTimer.elapsed_micro() / 1000.0;
+
+			parallelList->sort();
+
+			parallelMs += timer.elapsed_micro() / 1000.0;
+
+			auto compare = [](const ff::RenderItemSpan& a, const ff::RenderItemSpan& b) {
+				return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const ff::RenderItem& x, const ff::RenderItem& y) {
+					return x.m_id == y.m_id && x.m_sortKey == y.m_sortKey;
+				});
+			};
+			same = same
+				&& compare(serialList->getOpaques(), parallelList->getOpaques())
+				&& compare(serialList->getTransparents(), parallelList->getTransparents());
+		}
+
+		ok = ok && same && serialCommitter.m_uploads == parallelCommitter.m_uploads;
+
+		std::cout << "objects: " << count << "  threads: " << threadCount
+			<< "  visible: " << serialList->getOpaques().size() + serialList->getTransparents().size()
+			<< "  serial: " << serialMs / FRAME_COUNT << " ms/frame"
+			<< "  parallel: " << parallelMs / FRAME_COUNT << " ms/frame (commit " << commitMs / FRAME_COUNT << " ms)"
+			<< "  speedup: " << serialMs / std::max(parallelMs, 1e-6) << "x"
+			<< "  lists: " << (same ? "identical" : "DIFFERENT") << std::endl;
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+#include "../ff/render/driver/driverRenderList.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/material/meshBasicMaterial.h"
+#include "../ff/tools/timer.h"
+#include <atomic>
+#include <random>
+
+//渲染列表构建测试：
+//OBJECT_COUNTS个物体共享少量几何体与材质，每帧 init -> push -> sort -> finish，对比
+//  1 原来的方式：RenderItem在堆上，通过shared_ptr缓存，每个RenderItem再持有object/geometry/material三个shared_ptr
+//  2 RenderItem按值连续存储，只保存裸指针
+//统计热身之后每帧的堆分配次数，以及构建完成后列表持有的材质引用数(每个引用的增减都是一次原子操作)
+
+static const uint32_t OBJECT_COUNTS[] = { 10000, 100000 };
+static const uint32_t GEOMETRY_COUNT = 256;
+static const uint32_t MATERIAL_COUNT = 64;
+static const uint32_t FRAME_COUNT = 20;
+
+static std::atomic<uint64_t> g_allocations{ 0 };
+
+void* operator new(size_t size)
+{
+	g_allocations++;
+	if (void* p = std::malloc(size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+//原来的渲染列表
+struct LegacyItem
+{
+	using Ptr = std::shared_ptr<LegacyItem>;
+
+	ID							m_id{ 0 };
+	float						m_z{ 0 };
+	ff::RenderableObject::Ptr	m_object{ nullptr };
+	ff::Material::Ptr			m_material{ nullptr };
+	ff::Geometry::Ptr			m_geometry{ nullptr };
+	uint32_t					m_groupOrder{ 0 };
+};
+
+class LegacyList
+{
+public:
+	void init()
+	{
+		m_index = 0;
+		m_opaques.clear();
+	}
+
+	void push(const ff::RenderableObject::Ptr& object, const ff::Geometry::Ptr& geometry, const ff::Material::Ptr& material, float z)
+	{
+		LegacyItem::Ptr item = nullptr;
+		if (m_index >= m_cache.size())
+		{
+			item = std::make_shared<LegacyItem>();
+			m_cache.push_back(item);
+		}
+		else
+		{
+			item = m_cache[m_index];
+		}
+
+		item->m_id = object->getID();
+		item->m_object = object;
+		item->m_geometry = geometry;
+		item->m_material = material;
+		item->m_z = z;
+		m_index++;
+
+		m_opaques.push_back(item);
+	}
+
+	void sort()
+	{
+		std::sort(m_opaques.begin(), m_opaques.end(), [](const LegacyItem::Ptr& a, const LegacyItem::Ptr& b) {
+			if (a->m_groupOrder != b->m_groupOrder)
+			{
+				return a->m_groupOrder > b->m_groupOrder;
+			}
+			else if (a->m_z != b->m_z)
+			{
+				return a->m_z < b->m_z;
+			}
+			return a->m_id > b->m_id;
+		});
+	}
+
+	void finish()
+	{
+		for (size_t i = m_index; i < m_cache.size(); ++i)
+		{
+			m_cache[i]->m_object = nullptr;
+			m_cache[i]->m_geometry = nullptr;
+			m_cache[i]->m_material = nullptr;
+		}
+	}
+
+	//渲染时按值拷贝列表，与原来的Renderer::renderScene一致
+	std::vector<LegacyItem::Ptr> getOpaques() const { return m_opaques; }
+
+private:
+	uint32_t						m_index{ 0 };
+	std::vector<LegacyItem::Ptr>	m_opaques{};
+	std::vector<LegacyItem::Ptr>	m_cache{};
+};
+
+int main()
+{
+	std::mt19937 random(5);
+
+	std::vector<ff::Geometry::Ptr> geometries;
+	for (uint32_t i = 0; i < GEOMETRY_COUNT; ++i)
+	{
+		geometries.push_back(ff::Geometry::create());
+	}
+
+	std::vector<ff::Material::Ptr> materials;
+	for (uint32_t i = 0; i < MATERIAL_COUNT; ++i)
+	{
+		materials.push_back(ff::MeshBasicMaterial::create());
+	}
+
+	bool ok = true;
+	for (auto count : OBJECT_COUNTS)
+	{
+		std::vector<ff::Mesh::Ptr> meshes;
+		std::vector<float> depths;
+		std::uniform_real_distribution<float> depth(0.5f, 500.0f);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			meshes.push_back(ff::Mesh::create(geometries[random() % GEOMETRY_COUNT], materials[random() % MATERIAL_COUNT]));
+			depths.push_back(-depth(random));
+		}
+
+		ff::Timer timer;
+		long baseRefs = materials[0].use_count();
+
+		//1 原来的方式
+		LegacyList legacy;
+		double legacyMs = 0.0;
+		uint64_t legacyAllocations = 0;
+		for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			uint64_t allocations = g_allocations;
+			timer.reset();
+
+			legacy.init();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const auto& mesh = meshes[i];
+				legacy.push(mesh, mesh->getGeometry(), mesh->getMaterial(), depths[i]);
+			}
+			legacy.sort();
+			legacy.finish();
+			auto opaques = legacy.getOpaques();
+
+			legacyMs += timer.elapsed_micro() / 1000.0;
+			if (frame > 0)
+			{
+				legacyAllocations += g_allocations - allocations;
+			}
+		}
+		long legacyRefs = materials[0].use_count() - baseRefs;
+
+		//2 按值存储的RenderItem
+		auto list = ff::DriverRenderList::create();
+		baseRefs = materials[0].use_count();
+		double podMs = 0.0;
+		uint64_t podAllocations = 0;
+		for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			uint64_t allocations = g_allocations;
+			timer.reset();
+
+			list->init();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const auto& mesh = meshes[i];
+				list->push(mesh.get(), mesh->getGeometry().get(), mesh->getMaterial().get(), 0, depths[i]);
+			}
+			list->sort();
+			list->finish();
+			auto opaques = list->getOpaques();
+
+			podMs += timer.elapsed_micro() / 1000.0;
+			if (frame > 0)
+			{
+				podAllocations += g_allocations - allocations;
+			}
+			ok = ok && opaques.size() == count;
+		}
+
+		long podRefs = materials[0].use_count() - baseRefs;
+		ok = ok && podAllocations == 0 && podRefs == 0;
+
+		std::cout << "objects: " << count
+			<< "  legacy: " << legacyMs / FRAME_COUNT << " ms/frame, " << legacyAllocations / (FRAME_COUNT - 1) << " allocations/frame"
+			<< "  pod: " << podMs / FRAME_COUNT << " ms/frame, " << podAllocations / (FRAME_COUNT - 1) << " allocations/frame"
+			<< "  refs to one material held by the list: legacy " << legacyRefs << ", pod " << podRefs << std::endl;
+	}
+
+	return ok ? 0 : 1;
+}
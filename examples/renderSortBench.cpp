@@ -0,0 +1,167 @@
+#include "../ff/render/driver/driverRenderList.h"
+#include "../ff/tools/timer.h"
+#include <random>
+
+//渲染列表排序测试：
+//对ITEM_COUNTS个渲染项，对比
+//  1 原来的方式：std::sort + std::function比较函数
+//  2 预先计算64位排序键，对(键, 下标)做基数排序，再按结果重排RenderItem
+//第二种计时包含计算排序键的时间，并检查结果按键有序、与按键稳定排序的结果一致
+
+static const uint32_t ITEM_COUNTS[] = { 10000, 100000, 1000000 };
+static const uint32_t PROGRAM_COUNT = 24;
+static const uint32_t MATERIAL_COUNT = 500;
+static const uint32_t VAO_COUNT = 2000;
+static const uint32_t REPEAT = 5;
+
+struct ItemState
+{
+	uint32_t	m_program{ 0 };
+	uint32_t	m_material{ 0 };
+	uint32_t	m_vao{ 0 };
+};
+
+//原来的比较函数：groupOrder大的在前，其次z小的在前，最后id大的在前
+static bool smallerZFirstSort(const ff::RenderItem& item0, const ff::RenderItem& item1)
+{
+	if (item0.m_groupOrder != item1.m_groupOrder)
+	{
+		return item0.m_groupOrder > item1.m_groupOrder;
+	}
+	else if (item0.m_z != item1.m_z)
+	{
+		return item0.m_z < item1.m_z;
+	}
+	else
+	{
+		return item0.m_id > item1.m_id;
+	}
+}
+
+static ff::SortKeyInput makeInput(const ff::RenderItem& item, const ItemState& state)
+{
+	ff::SortKeyInput input;
+	input.m_groupOrder = item.m_groupOrder;
+	input.m_program = state.m_program;
+	input.m_material = state.m_material;
+	input.m_vao = state.m_vao;
+	input.m_depth = -item.m_z;
+
+	return input;
+}
+
+int main()
+{
+	std::mt19937 random(11);
+	auto layout = ff::SortKeyLayout::opaque(ff::OpaqueSortMode::StateSorted);
+
+	bool ok = true;
+	for (auto count : ITEM_COUNTS)
+	{
+		std::vector<ff::RenderItem> items;
+		std::vector<ItemState> states;
+		std::uniform_real_distribution<float> depth(0.5f, 500.0f);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ff::RenderItem item;
+			item.m_id = i + 1;
+			item.m_z = -depth(random);
+			item.m_groupOrder = random() % 8 == 0 ? 1 : 0;
+			items.push_back(item);
+
+			ItemState state;
+			state.m_program = 1 + random() % PROGRAM_COUNT;
+			state.m_material = 1000 + random() % MATERIAL_COUNT;
+			state.m_vao = 5000 + random() % VAO_COUNT;
+			states.push_back(state);
+		}
+
+		ff::Timer timer;
+
+		//1 比较函数排序
+		double compareMs = 0.0;
+		for (uint32_t repeat = 0; repeat < REPEAT; ++repeat)
+		{
+			auto list = items;
+			ff::RenderListSortFunction sortFunction = smallerZFirstSort;
+
+			timer.reset();
+			std::sort(list.begin(), list.end(), sortFunction);
+			compareMs += timer.elapsed_micro() / 1000.0;
+		}
+
+		//2 排序键 + 基数排序，缓冲区跨次复用
+		std::vector<ff::SortEntry> entries;
+		std::vector<ff::SortEntry> scratch;
+		std::vector<ff::RenderItem> sorted;
+		std::vector<ff::RenderItem> list;
+		double radixMs = 0.0;
+		for (uint32_t repeat = 0; repeat < REPEAT; ++repeat)
+		{
+			list = items;
+
+			timer.reset();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const auto& state = states[i];
+				list[i].m_sortKey = ff::DriverRenderList::makeSortKey(layout, makeInput(list[i], state));
+			}
+
+			entries.clear();
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				entries.push_back({ list[i].m_sortKey, i });
+			}
+			ff::radixSort(entries, scratch);
+
+			sorted.resize(count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				sorted[i] = list[entries[i].m_index];
+			}
+			list.swap(sorted);
+			radixMs += timer.elapsed_micro() / 1000.0;
+		}
+
+		//与按键稳定排序的结果比较
+		auto expected = items;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const auto& state = states[i];
+			expected[i].m_sortKey = ff::DriverRenderList::makeSortKey(layout, makeInput(expected[i], state));
+		}
+		std::stable_sort(expected.begin(), expected.end(), [](const ff::RenderItem& a, const ff::RenderItem& b) {
+			return a.m_sortKey < b.m_sortKey;
+		});
+		bool same = std::equal(expected.begin(), expected.end(), list.begin(), [](const ff::RenderItem& a, const ff::RenderItem& b) {
+			return a.m_id == b.m_id;
+		});
+		ok = ok && same;
+
+		//按提交顺序绘制时program与材质切换的次数
+		auto countSwitches = [&](const std::vector<ff::RenderItem>& order) {
+			uint32_t switches = 0;
+			uint32_t program = 0, material = 0;
+			for (const auto& item : order)
+			{
+				const auto& state = states[item.m_id - 1];
+				switches += (state.m_program != program ? 1 : 0) + (state.m_material != material ? 1 : 0);
+				program = state.m_program;
+				material = state.m_material;
+			}
+			return switches;
+		};
+
+		auto byDepth = items;
+		std::sort(byDepth.begin(), byDepth.end(), smallerZFirstSort);
+
+		std::cout << "items: " << count
+			<< "  compare sort: " << compareMs / REPEAT << " ms"
+			<< "  key + radix sort: " << radixMs / REPEAT << " ms"
+			<< "  speedup: " << compareMs / std::max(radixMs, 1e-6) << "x"
+			<< "  state switches (depth / key): " << countSwitches(byDepth) << " / " << countSwitches(list)
+			<< "  order: " << (same ? "stable by key" : "WRONG") << std::endl;
+	}
+
+	return ok ? 0 : 1;
+}
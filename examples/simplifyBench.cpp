@@ -0,0 +1,156 @@
+#include "../ff/core/geometry.h"
+#include "../ff/tools/meshSimplifier.h"
+#include "../ff/tools/jobSystem.h"
+#include "../ff/tools/timer.h"
+
+//网格简化测试：
+//生成一批带uv缝线与极点的起伏球体(模拟大量CAD零件)，每个零件生成50%/20%/5%三个级别，
+//统计1~N个线程下的吞吐(输入三角形/秒)、每级的三角形数与误差，并检查缝线两侧的顶点没有被混用
+
+static const uint32_t PART_COUNT = 256;
+
+static ff::Geometry::Ptr createPart(uint32_t widthSegments, uint32_t heightSegments, float bumps)
+{
+	std::vector<float> positions;
+	std::vector<float> uvs;
+	std::vector<uint32_t> indices;
+
+	//与常见的球体生成方式一致：u=0与u=1的一列顶点位置相同、uv不同，形成一条缝线
+	for (uint32_t y = 0; y <= heightSegments; ++y)
+	{
+		float v = static_cast<float>(y) / heightSegments;
+		for (uint32_t x = 0; x <= widthSegments; ++x)
+		{
+			float u = static_cast<float>(x) / widthSegments;
+			float phi = u * glm::two_pi<float>();
+			float theta = v * glm::pi<float>();
+
+			float radius = 1.0f + 0.05f * std::sin(bumps * phi) * std::sin(bumps * theta);
+			float px = -radius * std::cos(phi) * std::sin(theta);
+			float py = radius * std::cos(theta);
+			float pz = radius * std::sin(phi) * std::sin(theta);
+
+			//缝线两侧的顶点必须使用完全相同的位置
+			if (x == widthSegments)
+			{
+				px = positions[(y * (widthSegments + 1)) * 3];
+				py = positions[(y * (widthSegments + 1)) * 3 + 1];
+				pz = positions[(y * (widthSegments + 1)) * 3 + 2];
+			}
+
+			positions.push_back(px);
+			positions.push_back(py);
+			positions.push_back(pz);
+			uvs.push_back(u);
+			uvs.push_back(1.0f - v);
+		}
+	}
+
+	for (uint32_t y = 0; y < heightSegments; ++y)
+	{
+		for (uint32_t x = 0; x < widthSegments; ++x)
+		{
+			uint32_t a = y * (widthSegments + 1) + x + 1;
+			uint32_t b = y * (widthSegments + 1) + x;
+			uint32_t c = (y + 1) * (widthSegments + 1) + x;
+			uint32_t d = (y + 1) * (widthSegments + 1) + x + 1;
+
+			if (y != 0) { indices.push_back(a); indices.push_back(b); indices.push_back(d); }
+			if (y != heightSegments - 1) { indices.push_back(b); indices.push_back(c); indices.push_back(d); }
+		}
+	}
+
+	auto geometry = ff::Geometry::create();
+	geometry->setAttribute("position", ff::Attributef::create(positions, 3));
+	geometry->setAttribute("uv", ff::Attributef::create(uvs, 2));
+	geometry->setIndex(ff::Attributei::create(indices, 1));
+
+	return geometry;
+}
+
+//三角形的三个顶点都应该位于缝线的同一侧：u=0一列只与u较小的顶点相连，u=1一列只与u较大的顶点相连
+static bool checkSeam(const ff::Geometry::Ptr& geometry, const ff::Attributei::Ptr& index)
+{
+	const auto& uv = geometry->getAttribute("uv")->getData();
+	const auto& indices = index->getData();
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		float minU = 1.0f;
+		float maxU = 0.0f;
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			float u = uv[indices[i + c] * 2];
+			minU = std::min(minU, u);
+			maxU = std::max(maxU, u);
+		}
+
+		if (maxU - minU > 0.5f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	std::vector<ff::Geometry::Ptr> parts;
+	uint64_t inputTriangles = 0;
+	for (uint32_t i = 0; i < PART_COUNT; ++i)
+	{
+		uint32_t segments = 48 + (i % 8) * 16;
+		parts.push_back(createPart(segments, segments / 2, 3.0f + (i % 5)));
+		inputTriangles += parts.back()->getIndex()->getCount() / 3;
+	}
+
+	std::vector<ff::MeshSimplifier::LevelDesc> descs =
+	{
+		{ 0.5f, 0.01f },
+		{ 0.2f, 0.02f },
+		{ 0.05f, 0.05f },
+	};
+
+	uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::vector<std::vector<ff::MeshSimplifier::Level>> results;
+
+	for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		auto jobSystem = threads > 1 ? ff::JobSystem::create(threads) : nullptr;
+
+		ff::Timer timer;
+		timer.reset();
+		results = ff::MeshSimplifier::buildLevels(parts, descs, jobSystem);
+		double seconds = timer.elapsed_micro() / 1000000.0;
+
+		std::cout << "threads: " << threads
+			<< "  time: " << seconds * 1000.0 << " ms"
+			<< "  throughput: " << inputTriangles / seconds / 1000000.0 << " M triangles/s" << std::endl;
+	}
+
+	bool seamsOK = true;
+	for (size_t level = 0; level < descs.size(); ++level)
+	{
+		uint64_t triangles = 0;
+		float maxError = 0.0f;
+		double sumError = 0.0;
+		for (size_t i = 0; i < parts.size(); ++i)
+		{
+			const auto& result = results[i][level];
+			triangles += result.m_triangles;
+			maxError = std::max(maxError, result.m_error);
+			sumError += result.m_error;
+			seamsOK = seamsOK && checkSeam(parts[i], result.m_index);
+		}
+
+		std::cout << "level " << level << " (target " << descs[level].m_ratio * 100.0f << "%, error <= " << descs[level].m_maxError << ")"
+			<< "  triangles: " << triangles << " (" << 100.0 * triangles / inputTriangles << "%)"
+			<< "  error avg: " << sumError / parts.size() << "  max: " << maxError << std::endl;
+	}
+
+	std::cout << "parts: " << parts.size() << "  input triangles: " << inputTriangles << std::endl;
+	std::cout << "seams: " << (seamsOK ? "preserved" : "BROKEN") << std::endl;
+
+	return seamsOK ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+#include "../ff/scene/sceneSnapshot.h"
+#include "../ff/objects/mesh.h"
+#include "../ff/objects/group.h"
+#include "../ff/material/meshPhongMaterial.h"
+#include "../ff/tools/timer.h"
+
+//场景快照测试：
+//生成一份文本格式的源数据(类似obj：若干零件的顶点/uv/三角形，加上引用零件的节点列表)，
+//对比“逐行解析源数据、计算法线与包围体重建场景”与“从二进制快照加载”的耗时，并检查两者得到的场景一致
+
+static const uint32_t PART_COUNT = 64;
+static const uint32_t SEGMENTS = 48;
+static const uint32_t GROUP_COUNT = 200;
+static const uint32_t OBJECTS_PER_GROUP = 100;
+
+static const char* SOURCE_PATH = "snapshotBench.src";
+static const char* SNAPSHOT_PATH = "snapshotBench.ffs";
+
+static void writeSource()
+{
+	std::ofstream stream(SOURCE_PATH);
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (uint32_t part = 0; part < PART_COUNT; ++part)
+	{
+		stream << "part\n";
+
+		float bumps = 2.0f + part % 5;
+		for (uint32_t y = 0; y <= SEGMENTS; ++y)
+		{
+			for (uint32_t x = 0; x <= SEGMENTS; ++x)
+			{
+				float u = static_cast<float>(x) / SEGMENTS;
+				float v = static_cast<float>(y) / SEGMENTS;
+				float phi = u * glm::two_pi<float>();
+				float theta = v * glm::pi<float>();
+				float radius = 1.0f + 0.1f * std::sin(bumps * phi) * std::sin(bumps * theta);
+
+				stream << "v " << -radius * std::cos(phi) * std::sin(theta) << " " << radius * std::cos(theta) << " " << radius * std::sin(phi) * std::sin(theta) << "\n";
+				stream << "vt " << u << " " << 1.0f - v << "\n";
+			}
+		}
+
+		for (uint32_t y = 0; y < SEGMENTS; ++y)
+		{
+			for (uint32_t x = 0; x < SEGMENTS; ++x)
+			{
+				uint32_t a = y * (SEGMENTS + 1) + x;
+				uint32_t b = a + SEGMENTS + 1;
+				stream << "f " << a << " " << b << " " << a + 1 << "\n";
+				stream << "f " << b << " " << b + 1 << " " << a + 1 << "\n";
+			}
+		}
+	}
+
+	//节点：父节点下标(-1为场景)、零件下标(-1为Group)、位置、旋转角度、缩放
+	uint32_t nodeCount = 0;
+	for (uint32_t group = 0; group < GROUP_COUNT; ++group)
+	{
+		uint32_t groupIndex = nodeCount++;
+		stream << "n -1 -1 " << (group % 20) * 40.0f << " 0 " << (group / 20) * 40.0f << " 0 1\n";
+
+		for (uint32_t i = 0; i < OBJECTS_PER_GROUP; ++i)
+		{
+			nodeCount++;
+			stream << "n " << groupIndex << " " << random() % PART_COUNT << " "
+				<< unit(random) * 36.0f << " " << unit(random) * 4.0f << " " << unit(random) * 36.0f << " "
+				<< unit(random) * 360.0f << " " << 0.5f + unit(random) << "\n";
+		}
+	}
+}
+
+static ff::Geometry::Ptr buildPart(const std::vector<float>& positions, const std::vector<float>& uvs, const std::vector<uint32_t>& indices)
+{
+	//按面积加权累积面法线
+	std::vector<float> normals(positions.size(), 0.0f);
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		glm::vec3 p[3];
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			p[c] = glm::make_vec3(&positions[indices[i + c] * 3]);
+		}
+
+		glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				normals[indices[i + c] * 3 + k] += normal[k];
+			}
+		}
+	}
+
+	for (size_t i = 0; i < normals.size(); i += 3)
+	{
+		glm::vec3 normal = glm::make_vec3(&normals[i]);
+		float length = glm::length(normal);
+		normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+		normals[i] = normal.x;
+		normals[i + 1] = normal.y;
+		normals[i + 2] = normal.z;
+	}
+
+	auto geometry = ff::Geometry::create();
+	geometry->setAttribute("position", ff::Attributef::create(positions, 3));
+	geometry->setAttribute("normal", ff::Attributef::create(normals, 3));
+	geometry->setAttribute("uv", ff::Attributef::create(uvs, 2));
+	geometry->setIndex(ff::Attributei::create(indices, 1));
+	geometry->computeBoundingSphere();
+
+	return geometry;
+}
+
+static ff::Scene::Ptr loadSource()
+{
+	std::ifstream stream(SOURCE_PATH);
+	auto scene = ff::Scene::create();
+	auto material = ff::MeshPhongMaterial::create();
+
+	std::vector<ff::Geometry::Ptr> parts;
+	std::vector<ff::Object3D::Ptr> nodes;
+	std::vector<float> positions;
+	std::vector<float> uvs;
+	std::vector<uint32_t> indices;
+
+	auto finishPart = [&]() {
+		if (!positions.empty())
+		{
+			parts.push_back(buildPart(positions, uvs, indices));
+			positions.clear();
+			uvs.clear();
+			indices.clear();
+		}
+	};
+
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		std::istringstream tokens(line);
+		std::string type;
+		tokens >> type;
+
+		if (type == "v")
+		{
+			float x, y, z;
+			tokens >> x >> y >> z;
+			positions.insert(positions.end(), { x, y, z });
+		}
+		else if (type == "vt")
+		{
+			float u, v;
+			tokens >> u >> v;
+			uvs.insert(uvs.end(), { u, v });
+		}
+		else if (type == "f")
+		{
+			uint32_t a, b, c;
+			tokens >> a >> b >> c;
+			indices.insert(indices.end(), { a, b, c });
+		}
+		else if (type == "part")
+		{
+			finishPart();
+		}
+		else if (type == "n")
+		{
+			finishPart();
+
+			int32_t parent, part;
+			float x, y, z, angle, scale;
+			tokens >> parent >> part >> x >> y >> z >> angle >> scale;
+
+			ff::Object3D::Ptr node = part < 0 ? ff::Group::create() : ff::Mesh::create(parts[part], material);
+			node->rotateY(angle);
+			node->setPosition(x, y, z);
+			node->setScale(scale, scale, scale);
+
+			(parent < 0 ? ff::Object3D::Ptr(scene) : nodes[parent])->addChild(node);
+			nodes.push_back(node);
+		}
+	}
+
+	return scene;
+}
+
+//节点数、三角形数与位置的校验和
+static void summarize(const ff::Scene::Ptr& scene, uint32_t& nodes, uint64_t& triangles, double& checksum)
+{
+	nodes = 0;
+	triangles = 0;
+	checksum = 0.0;
+
+	std::vector<ff::Object3D*> stack{ scene.get() };
+	while (!stack.empty())
+	{
+		auto object = stack.back();
+		stack.pop_back();
+		nodes++;
+
+		checksum += glm::dot(object->getPosition(), glm::vec3(1.0f, 2.0f, 3.0f));
+		if (object->m_isMesh)
+		{
+			auto geometry = static_cast<ff::Mesh*>(object)->getGeometry();
+			triangles += geometry->getIndex()->getCount() / 3;
+			checksum += geometry->getBoundingSphere()->m_radius;
+		}
+
+		for (const auto& child : object->getChildren())
+		{
+			stack.push_back(child.get());
+		}
+	}
+}
+
+int main()
+{
+	writeSource();
+
+	ff::Timer timer;
+	timer.reset();
+	auto sourceScene = loadSource();
+	double sourceMs = timer.elapsed_micro() / 1000.0;
+
+	timer.reset();
+	bool saved = ff::SceneSnapshot::save(sourceScene, SNAPSHOT_PATH);
+	double saveMs = timer.elapsed_micro() / 1000.0;
+
+	timer.reset();
+	auto snapshotScene = ff::SceneSnapshot::load(SNAPSHOT_PATH);
+	double loadMs = timer.elapsed_micro() / 1000.0;
+
+	if (!saved || snapshotScene == nullptr)
+	{
+		std::cout << "snapshot failed" << std::endl;
+		return 1;
+	}
+
+	uint32_t sourceNodes, snapshotNodes;
+	uint64_t sourceTriangles, snapshotTriangles;
+	double sourceChecksum, snapshotChecksum;
+	summarize(sourceScene, sourceNodes, sourceTriangles, sourceChecksum);
+	summarize(snapshotScene, snapshotNodes, snapshotTriangles, snapshotChecksum);
+
+	std::ifstream sourceFile(SOURCE_PATH, std::ios::binary | std::ios::ate);
+	std::ifstream snapshotFile(SNAPSHOT_PATH, std::ios::binary | std::ios::ate);
+
+	std::cout << "nodes: " << sourceNodes << "  parts: " << PART_COUNT << "  triangles: " << sourceTriangles << std::endl;
+	std::cout << "source:   " << sourceFile.tellg() / 1024 << " KB  rebuild " << sourceMs << " ms" << std::endl;
+	std::cout << "snapshot: " << snapshotFile.tellg() / 1024 << " KB  save " << saveMs << " ms  load " << loadMs << " ms" << std::endl;
+	std::cout << "speedup: " << sourceMs / loadMs << "x" << std::endl;
+
+	bool same = sourceNodes == snapshotNodes && sourceTriangles == snapshotTriangles && std::abs(sourceChecksum - snapshotChecksum) < 1e-3 * std::abs(sourceChecksum);
+	std::cout << "scenes: " << (same ? "identical" : "DIFFERENT") << std::endl;
+
+	std::remove(SOURCE_PATH);
+	std::remove(SNAPSHOT_PATH);
+
+	return same ? 0 : 1;
+}
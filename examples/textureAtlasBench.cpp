@@ -0,0 +1,148 @@
+#include "../ff/textures/textureAtlas.h"
+#include "../ff/tools/timer.h"
+#include <random>
+
+//贴图打包测试：
+//生成TEXTURE_COUNT张小贴图(类似UI与标牌，每张一个材质)，分别打包成图集与纹理数组，对比
+//  1 打包耗时、页数与填充率
+//  2 按提交顺序绘制时需要切换贴图的次数：不打包 / 打包后随机顺序 / 打包后按页排序
+//并检查经过区域变换采样到的像素与原贴图一致
+
+static const uint32_t TEXTURE_COUNT = 3000;
+static const uint32_t SIZES[] = { 16, 32, 32, 64, 64, 64, 128 };
+
+static ff::Texture::Ptr makeTexture(uint32_t width, uint32_t height, std::mt19937& random)
+{
+	auto texture = ff::Texture::create(width, height, ff::DataType::UnsignedByteType,
+		ff::TextureWrapping::ClampToEdgeWrapping, ff::TextureWrapping::ClampToEdgeWrapping, ff::TextureWrapping::ClampToEdgeWrapping);
+
+	texture->m_source = ff::Source::create();
+	texture->m_source->m_width = width;
+	texture->m_source->m_height = height;
+	texture->m_source->m_data.resize(static_cast<size_t>(width) * height * 4);
+	for (auto& value : texture->m_source->m_data)
+	{
+		value = static_cast<byte>(random());
+	}
+
+	return texture;
+}
+
+//按顺序绘制时绑定的贴图发生变化的次数
+static uint32_t countBinds(const std::vector<ff::Texture::Ptr>& order, const ff::TextureAtlas::Ptr& atlas)
+{
+	uint32_t binds = 0;
+	ff::Texture* bound = nullptr;
+	for (const auto& texture : order)
+	{
+		auto region = atlas != nullptr ? atlas->find(texture) : nullptr;
+		auto page = region != nullptr ? region->m_page.get() : texture.get();
+		if (page != bound)
+		{
+			bound = page;
+			binds++;
+		}
+	}
+
+	return binds;
+}
+
+//用区域变换把uv映射到页中，按最近点取像素，与原贴图比较
+static bool verify(const std::vector<ff::Texture::Ptr>& textures, const ff::TextureAtlas::Ptr& atlas, std::mt19937& random)
+{
+	for (uint32_t i = 0; i < 200; ++i)
+	{
+		const auto& texture = textures[random() % textures.size()];
+		auto region = atlas->find(texture);
+		if (region == nullptr)
+		{
+			return false;
+		}
+
+		uint32_t x = random() % texture->m_width;
+		uint32_t y = random() % texture->m_height;
+		glm::vec2 uv((x + 0.5f) / texture->m_width, (y + 0.5f) / texture->m_height);
+
+		const byte* expected = texture->m_source->m_data.data() + (static_cast<size_t>(y) * texture->m_width + x) * 4;
+		const byte* actual = nullptr;
+
+		if (atlas->getMode() == ff::TextureAtlas::Mode::Atlas)
+		{
+			glm::vec2 pageUV = uv * glm::vec2(region->m_transform.x, region->m_transform.y) + glm::vec2(region->m_transform.z, region->m_transform.w);
+			auto px = static_cast<uint32_t>(pageUV.x * region->m_page->m_width);
+			auto py = static_cast<uint32_t>(pageUV.y * region->m_page->m_height);
+			actual = region->m_page->m_source->m_data.data() + (static_cast<size_t>(py) * region->m_page->m_width + px) * 4;
+		}
+		else
+		{
+			auto array = std::static_pointer_cast<ff::TextureArray>(region->m_page);
+			actual = array->m_sources[region->m_layer]->m_data.data() + (static_cast<size_t>(y) * texture->m_width + x) * 4;
+		}
+
+		if (std::memcmp(expected, actual, 4) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	std::mt19937 random(7);
+
+	std::vector<ff::Texture::Ptr> textures;
+	uint64_t pixels = 0;
+	for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+	{
+		uint32_t width = SIZES[random() % std::size(SIZES)];
+		uint32_t height = SIZES[random() % std::size(SIZES)];
+		textures.push_back(makeTexture(width, height, random));
+		pixels += static_cast<uint64_t>(width) * height;
+	}
+
+	//场景中的提交顺序与贴图无关
+	std::vector<ff::Texture::Ptr> order = textures;
+	std::shuffle(order.begin(), order.end(), random);
+
+	uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto jobSystem = threads > 1 ? ff::JobSystem::create(threads) : nullptr;
+
+	std::cout << "textures: " << TEXTURE_COUNT << "  pixels: " << pixels / 1024 << " K  threads: " << threads << std::endl;
+	std::cout << "unpacked binds: " << countBinds(order, nullptr) << std::endl;
+
+	bool ok = true;
+	for (auto mode : { ff::TextureAtlas::Mode::Atlas, ff::TextureAtlas::Mode::Array })
+	{
+		auto atlas = ff::TextureAtlas::create(mode, 2048);
+		for (const auto& texture : textures)
+		{
+			atlas->add(texture);
+		}
+
+		ff::Timer timer;
+		timer.reset();
+		atlas->build(jobSystem);
+		double buildMs = timer.elapsed_micro() / 1000.0;
+
+		//同一页的物体排在一起
+		std::vector<ff::Texture::Ptr> grouped = order;
+		std::stable_sort(grouped.begin(), grouped.end(), [&](const ff::Texture::Ptr& a, const ff::Texture::Ptr& b) {
+			return atlas->find(a)->m_page->getID() < atlas->find(b)->m_page->getID();
+		});
+
+		bool same = verify(textures, atlas, random);
+		ok = ok && same;
+
+		const auto& stats = atlas->getStats();
+		std::cout << (mode == ff::TextureAtlas::Mode::Atlas ? "atlas" : "array")
+			<< "  build: " << buildMs << " ms  packed: " << stats.m_packed << "  pages: " << stats.m_pages
+			<< "  fill: " << 100.0 * stats.m_usedPixels / std::max<uint64_t>(stats.m_pagePixels, 1) << " %"
+			<< "  binds (submit order): " << countBinds(order, atlas)
+			<< "  binds (grouped by page): " << countBinds(grouped, atlas)
+			<< "  texels: " << (same ? "identical" : "DIFFERENT") << std::endl;
+	}
+
+	return ok ? 0 : 1;
+}
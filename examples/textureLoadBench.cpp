@@ -0,0 +1,112 @@
+#include "../ff/loader/textureLoader.h"
+#include "../ff/loader/cache.h"
+#include "../ff/tools/timer.h"
+
+//异步贴图加载测试：
+//生成IMAGE_COUNT张图片(其中DUPLICATE_COUNT张与其它图片内容相同)，每张图片被REFERENCES个材质引用，
+//对比同步加载全部贴图的耗时，与异步加载时loadAsync返回(即首帧可以开始绘制)的耗时和全部交付的耗时，
+//最后释放所有纹理，检查缓存被清空
+
+static const uint32_t IMAGE_COUNT = 160;
+static const uint32_t DUPLICATE_COUNT = 16;
+static const uint32_t IMAGE_SIZE = 512;
+static const uint32_t REFERENCES = 3;
+
+static std::string imagePath(uint32_t index)
+{
+	return "textureLoadBench_" + std::to_string(index) + ".ppm";
+}
+
+static void writeImages()
+{
+	std::vector<byte> pixels(IMAGE_SIZE * IMAGE_SIZE * 3);
+	for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+	{
+		//最后DUPLICATE_COUNT张与前面的图片内容相同
+		uint32_t pattern = i < IMAGE_COUNT - DUPLICATE_COUNT ? i : i - (IMAGE_COUNT - DUPLICATE_COUNT);
+		for (size_t p = 0; p < pixels.size(); ++p)
+		{
+			pixels[p] = static_cast<byte>((p * (pattern + 1)) >> 4);
+		}
+
+		std::ofstream stream(imagePath(i), std::ios::binary);
+		stream << "P6\n" << IMAGE_SIZE << " " << IMAGE_SIZE << "\n255\n";
+		stream.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+	}
+}
+
+int main()
+{
+	writeImages();
+
+	uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto jobSystem = ff::JobSystem::create(threads);
+	auto cache = ff::Cache::getInstance();
+
+	ff::Timer timer;
+
+	//同步：加载完成之前无法开始绘制
+	{
+		std::vector<ff::Texture::Ptr> textures;
+
+		timer.reset();
+		for (uint32_t r = 0; r < REFERENCES; ++r)
+		{
+			for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+			{
+				textures.push_back(ff::TextureLoader::load(imagePath(i)));
+			}
+		}
+		double syncMs = timer.elapsed_micro() / 1000.0;
+
+		std::cout << "sync   first frame blocked: " << syncMs << " ms  sources: " << cache->getSourceCount() << std::endl;
+	}
+
+	std::cout << "sources after release: " << cache->getSourceCount() << std::endl;
+
+	//异步：loadAsync立即返回占位纹理，之后每帧交付解码完成的纹理
+	{
+		auto loader = ff::TextureLoader::create(jobSystem);
+		std::vector<ff::Texture::Ptr> textures;
+
+		timer.reset();
+		for (uint32_t r = 0; r < REFERENCES; ++r)
+		{
+			for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+			{
+				textures.push_back(loader->loadAsync(imagePath(i)));
+			}
+		}
+		double requestMs = timer.elapsed_micro() / 1000.0;
+
+		uint32_t frames = 0;
+		while (loader->getPendingCount() > 0)
+		{
+			loader->update(16);
+			frames++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		double deliverMs = timer.elapsed_micro() / 1000.0;
+
+		bool complete = std::all_of(textures.begin(), textures.end(), [](const ff::Texture::Ptr& texture) {
+			return texture->m_width == IMAGE_SIZE && texture->m_needUpdate;
+		});
+
+		const auto& stats = loader->getStats();
+		std::cout << "async  first frame blocked: " << requestMs << " ms  all delivered: " << deliverMs << " ms over " << frames << " frames"
+			<< "  threads: " << threads << std::endl;
+		std::cout << "requests: " << stats.m_requests << "  cache hits: " << stats.m_cacheHits << "  decoded: " << stats.m_decoded
+			<< "  shared by content: " << stats.m_shared << "  sources: " << cache->getSourceCount()
+			<< "  textures: " << (complete ? "complete" : "INCOMPLETE") << std::endl;
+	}
+
+	uint32_t remaining = static_cast<uint32_t>(cache->getSourceCount());
+	std::cout << "sources after release: " << remaining << std::endl;
+
+	for (uint32_t i = 0; i < IMAGE_COUNT; ++i)
+	{
+		std::remove(imagePath(i).c_str());
+	}
+
+	return remaining == 0 ? 0 : 1;
+}
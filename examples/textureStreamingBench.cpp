@@ -0,0 +1,106 @@
+#include "../ff/render/driver/driverTextureStreaming.h"
+#include "../ff/tools/timer.h"
+
+//贴图流送测试：
+//OBJECT_COUNT个物体沿一条路排列，每个物体使用一张TEXTURE_SIZE^2的贴图，相机以固定速度从路的一端飞到另一端，
+//每帧用物体的投影尺寸请求贴图，对比
+//  1 所有贴图完整驻留需要的显存
+//  2 开启流送后的驻留字节数、上传数、淘汰数与等待上传数
+//并统计可见物体中驻留级别达到需要级别的比例
+
+static const uint32_t OBJECT_COUNT = 400;
+static const uint32_t TEXTURE_SIZE = 2048;
+static const uint32_t FRAME_COUNT = 600;
+static const float SPACING = 4.0f;			//相邻物体的间距
+static const float RADIUS = 1.0f;			//物体包围球半径
+static const float VIEW_DISTANCE = 120.0f;	//超过这个距离的物体视为被剪裁
+static const float FOCAL_PIXELS = 1000.0f;	//视口高度 / (2 * tan(fov / 2))
+static const uint64_t BUDGET = 128ull * 1024 * 1024;
+
+int main()
+{
+	auto info = ff::DriverInfo::create();
+	auto streaming = ff::DriverTextureStreaming::create(info);
+	streaming->setBudget(BUDGET);
+
+	std::vector<ff::Texture::Ptr> textures;
+	for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+	{
+		textures.push_back(ff::Texture::create(TEXTURE_SIZE, TEXTURE_SIZE));
+	}
+
+	uint64_t fullBytes = ff::MipChain::getChainBytes(TEXTURE_SIZE, TEXTURE_SIZE, 4, 0) * OBJECT_COUNT;
+
+	uint64_t peakResident = 0;
+	uint64_t uploadedBytes = 0;
+	uint32_t uploads = 0;
+	uint32_t evictions = 0;
+	uint32_t maxPending = 0;
+	uint64_t visible = 0;
+	uint64_t satisfied = 0;
+
+	ff::Timer timer;
+	timer.reset();
+
+	float length = OBJECT_COUNT * SPACING;
+	for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		float camera = length * frame / FRAME_COUNT - VIEW_DISTANCE * 0.5f;
+
+		//相机前方的物体可见
+		std::vector<uint32_t> visibleObjects;
+		for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+		{
+			float distance = i * SPACING - camera;
+			if (distance < 1.0f || distance > VIEW_DISTANCE)
+			{
+				continue;
+			}
+
+			float screenSize = 2.0f * RADIUS / distance * FOCAL_PIXELS;
+			streaming->request(textures[i].get(), screenSize);
+			visibleObjects.push_back(i);
+		}
+
+		streaming->update();
+
+		const auto& stats = info->m_textureStreaming;
+		peakResident = std::max(peakResident, stats.m_residentBytes);
+		uploadedBytes += stats.m_uploadedBytes;
+		uploads += stats.m_uploads;
+		evictions += stats.m_evictions;
+		maxPending = std::max(maxPending, stats.m_pending);
+
+		//驻留级别达到需要的级别(按上面同样的公式)的可见物体
+		for (auto i : visibleObjects)
+		{
+			float screenSize = 2.0f * RADIUS / (i * SPACING - camera) * FOCAL_PIXELS;
+			float ratio = TEXTURE_SIZE / std::max(screenSize, 1.0f);
+			uint32_t wanted = ratio > 1.0f ? static_cast<uint32_t>(std::floor(std::log2(ratio))) : 0;
+
+			visible++;
+			satisfied += streaming->getResidentLevel(textures[i]->getID()) <= wanted ? 1 : 0;
+		}
+
+		if (frame % 100 == 0)
+		{
+			std::cout << "frame " << frame << "  visible: " << visibleObjects.size()
+				<< "  resident: " << stats.m_residentBytes / 1024 / 1024 << " MB"
+				<< "  uploads: " << stats.m_uploads << "  evictions: " << stats.m_evictions
+				<< "  pending: " << stats.m_pending << std::endl;
+		}
+	}
+
+	double elapsedMs = timer.elapsed_micro() / 1000.0;
+
+	std::cout << "textures: " << OBJECT_COUNT << " x " << TEXTURE_SIZE << "^2  frames: " << FRAME_COUNT << std::endl;
+	std::cout << "all full resolution: " << fullBytes / 1024 / 1024 << " MB" << std::endl;
+	std::cout << "budget:              " << BUDGET / 1024 / 1024 << " MB" << std::endl;
+	std::cout << "peak resident:       " << peakResident / 1024 / 1024 << " MB" << std::endl;
+	std::cout << "uploads: " << uploads << " (" << uploadedBytes / 1024 / 1024 << " MB)  evictions: " << evictions
+		<< "  max pending: " << maxPending << std::endl;
+	std::cout << "visible textures at wanted level: " << (visible ? 100.0 * satisfied / visible : 0.0) << " %" << std::endl;
+	std::cout << "policy time: " << elapsedMs / FRAME_COUNT << " ms / frame" << std::endl;
+
+	return peakResident <= BUDGET ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+#include "../ff/core/object3D.h"
+#include "../ff/tools/timer.h"
+
+//TRS/本地矩阵延迟同步的对比测试：
+//EagerTransform 是修改前Object3D的写法(每次修改都立即decompose)，
+//在相同的混合读写负载下比较耗时，并比较两者最终得到的本地矩阵
+
+class EagerTransform
+{
+public:
+	void setPosition(const glm::vec3& position)
+	{
+		m_localMatrix[3] = glm::vec4(position, 1.0f);
+		m_position = position;
+	}
+
+	void setQuaternion(const glm::quat& quaternion)
+	{
+		float scaleX = glm::length(glm::vec3(m_localMatrix[0]));
+		float scaleY = glm::length(glm::vec3(m_localMatrix[1]));
+		float scaleZ = glm::length(glm::vec3(m_localMatrix[2]));
+
+		glm::mat4 rotateMatrix = glm::mat4_cast(quaternion);
+
+		m_localMatrix[0] = rotateMatrix[0] * scaleX;
+		m_localMatrix[1] = rotateMatrix[1] * scaleY;
+		m_localMatrix[2] = rotateMatrix[2] * scaleZ;
+
+		decompose();
+	}
+
+	void setScale(float x, float y, float z)
+	{
+		m_localMatrix[0] = glm::vec4(glm::normalize(glm::vec3(m_localMatrix[0])) * x, 0.0f);
+		m_localMatrix[1] = glm::vec4(glm::normalize(glm::vec3(m_localMatrix[1])) * y, 0.0f);
+		m_localMatrix[2] = glm::vec4(glm::normalize(glm::vec3(m_localMatrix[2])) * z, 0.0f);
+
+		decompose();
+	}
+
+	void rotateY(float angle)
+	{
+		glm::mat4 rotateMatrix = glm::rotate(glm::mat4(1.0), glm::radians(angle), glm::vec3(m_localMatrix[1]));
+		m_localMatrix = rotateMatrix * m_localMatrix;
+
+		decompose();
+	}
+
+	void rotateAroundAxis(const glm::vec3& axis, float angle)
+	{
+		m_localMatrix = glm::rotate(m_localMatrix, glm::radians(angle), axis);
+
+		decompose();
+	}
+
+	glm::vec3 getPosition() const { return glm::vec3(m_localMatrix[3]); }
+
+	glm::vec3 getLocalDirection() const { return glm::normalize(-glm::vec3(m_localMatrix[2])); }
+
+	glm::mat4 getLocalMatrix() const { return m_localMatrix; }
+
+private:
+	void decompose()
+	{
+		glm::vec3 skew;
+		glm::vec4 perspective;
+		glm::decompose(m_localMatrix, m_scale, m_quaternion, m_position, skew, perspective);
+	}
+
+	glm::vec3 m_position{ 0.0f };
+	glm::quat m_quaternion{ 1.0f, 0.0f, 0.0f, 0.0f };
+	glm::vec3 m_scale{ 1.0f };
+	glm::mat4 m_localMatrix{ 1.0f };
+};
+
+static const uint32_t NODE_COUNT = 10000;
+static const uint32_t FRAME_COUNT = 50;
+
+//负载1：动画采样，每帧写入TRS，最后读取一次本地矩阵(相当于世界矩阵更新)
+template<typename T, typename SetQuaternion>
+static glm::vec3 animationWorkload(std::vector<T>& nodes, SetQuaternion setQuaternion, uint32_t frame)
+{
+	glm::vec3 sum(0.0f);
+	for (uint32_t i = 0; i < nodes.size(); ++i)
+	{
+		float t = static_cast<float>(frame + i) * 0.01f;
+		nodes[i].setPosition(glm::vec3(t, 0.5f * t, 0.0f));
+		setQuaternion(nodes[i], glm::angleAxis(t, glm::vec3(0.0f, 1.0f, 0.0f)));
+		nodes[i].setScale(1.0f, 1.0f, 1.0f);
+
+		sum += glm::vec3(nodes[i].getLocalMatrix()[3]);
+	}
+
+	return sum;
+}
+
+//负载2：相机/角色控制，连续旋转并读取朝向与位置
+template<typename T>
+static glm::vec3 controlWorkload(std::vector<T>& nodes, uint32_t frame)
+{
+	glm::vec3 sum(0.0f);
+	for (uint32_t i = 0; i < nodes.size(); ++i)
+	{
+		nodes[i].rotateY(0.5f);
+		nodes[i].rotateAroundAxis(glm::vec3(1.0f, 0.0f, 0.0f), 0.25f);
+		sum += nodes[i].getLocalDirection() + nodes[i].getPosition();
+	}
+
+	return sum;
+}
+
+static float maxDifference(const glm::mat4& a, const glm::mat4& b)
+{
+	float diff = 0.0f;
+	for (int c = 0; c < 4; ++c)
+	{
+		for (int r = 0; r < 4; ++r)
+		{
+			diff = std::max(diff, std::abs(a[c][r] - b[c][r]));
+		}
+	}
+
+	return diff;
+}
+
+int main()
+{
+	std::vector<EagerTransform> eagerNodes(NODE_COUNT);
+	std::vector<ff::Object3D> lazyNodes(NODE_COUNT);
+
+	auto eagerSetQuaternion = [](EagerTransform& node, const glm::quat& q) { node.setQuaternion(q); };
+	auto lazySetQuaternion = [](ff::Object3D& node, const glm::quat& q) { node.setQuaternion(q.x, q.y, q.z, q.w); };
+
+	ff::Timer timer;
+	glm::vec3 eagerSum(0.0f), lazySum(0.0f);
+
+	timer.reset();
+	for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		eagerSum += animationWorkload(eagerNodes, eagerSetQuaternion, frame);
+	}
+	auto eagerAnimation = timer.elapsed_micro();
+
+	timer.reset();
+	for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		lazySum += animationWorkload(lazyNodes, lazySetQuaternion, frame);
+	}
+	auto lazyAnimation = timer.elapsed_micro();
+
+	timer.reset();
+	for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		eagerSum += controlWorkload(eagerNodes, frame);
+	}
+	auto eagerControl = timer.elapsed_micro();
+
+	timer.reset();
+	for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		lazySum += controlWorkload(lazyNodes, frame);
+	}
+	auto lazyControl = timer.elapsed_micro();
+
+	float diff = 0.0f;
+	for (uint32_t i = 0; i < NODE_COUNT; ++i)
+	{
+		diff = std::max(diff, maxDifference(eagerNodes[i].getLocalMatrix(), lazyNodes[i].getLocalMatrix()));
+	}
+
+	std::cout << "animation  eager: " << eagerAnimation / 1000.0 << " ms  lazy: " << lazyAnimation / 1000.0 << " ms" << std::endl;
+	std::cout << "control    eager: " << eagerControl / 1000.0 << " ms  lazy: " << lazyControl / 1000.0 << " ms" << std::endl;
+	std::cout << "max local matrix difference: " << diff << std::endl;
+	std::cout << "checksum: " << glm::length(eagerSum - lazySum) << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include "../ff/core/object3D.h"
+#include "../ff/tools/jobSystem.h"
+#include "../ff/tools/timer.h"
+
+//世界矩阵并行更新的扩展性测试：
+//构建人群/车辆式的层级(大量角色，每个角色几十个关节)，每帧修改所有关节的本地矩阵，
+//分别用1~N个线程更新，统计平均耗时，并与另一份相同场景的串行结果逐位比较，确认结果与线程数无关
+
+static const uint32_t CHARACTER_COUNT = 2000;
+static const uint32_t JOINT_DEPTH = 6;
+static const uint32_t JOINT_BRANCH = 3;
+static const uint32_t FRAME_COUNT = 30;
+
+static void buildJoints(const ff::Object3D::Ptr& parent, uint32_t depth, std::vector<ff::Object3D::Ptr>& joints)
+{
+	if (depth == 0)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < JOINT_BRANCH; ++i)
+	{
+		auto joint = ff::Object3D::create();
+		joint->setPosition(0.1f * i, 0.5f, 0.0f);
+		parent->addChild(joint);
+		joints.push_back(joint);
+
+		//只有第一个分支继续向下，形成类似骨骼链的结构
+		if (i == 0)
+		{
+			buildJoints(joint, depth - 1, joints);
+		}
+	}
+}
+
+static ff::Object3D::Ptr buildScene(std::vector<ff::Object3D::Ptr>& joints)
+{
+	auto root = ff::Object3D::create();
+
+	for (uint32_t i = 0; i < CHARACTER_COUNT; ++i)
+	{
+		auto character = ff::Object3D::create();
+		character->setPosition(static_cast<float>(i % 50) * 2.0f, 0.0f, static_cast<float>(i / 50) * 2.0f);
+		root->addChild(character);
+
+		buildJoints(character, JOINT_DEPTH, joints);
+	}
+
+	return root;
+}
+
+static void animate(const std::vector<ff::Object3D::Ptr>& joints, uint32_t frame)
+{
+	for (size_t i = 0; i < joints.size(); ++i)
+	{
+		joints[i]->setRotateAroundAxis(glm::vec3(0.0f, 0.0f, 1.0f), static_cast<float>((frame * 7 + i) % 90));
+	}
+}
+
+static std::vector<glm::mat4> collect(const std::vector<ff::Object3D::Ptr>& joints)
+{
+	std::vector<glm::mat4> matrices;
+	matrices.reserve(joints.size());
+	for (auto& joint : joints)
+	{
+		matrices.push_back(joint->getWorldMatrix());
+	}
+
+	return matrices;
+}
+
+int main()
+{
+	std::vector<ff::Object3D::Ptr> joints;
+	auto root = buildScene(joints);
+
+	//完全相同的第二份场景，用串行的updateWorldMatrix作为基准
+	std::vector<ff::Object3D::Ptr> referenceJoints;
+	auto referenceRoot = buildScene(referenceJoints);
+
+	std::cout << "nodes: " << joints.size() + CHARACTER_COUNT + 1 << std::endl;
+
+	uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	ff::Timer timer;
+	double baseTime = 0.0;
+
+	//1, 2, 4 ... 直到硬件线程数
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	for (auto threads : threadCounts)
+	{
+		auto jobSystem = ff::JobSystem::create(threads);
+
+		bool identical = true;
+		int64_t total = 0;
+		for (uint32_t frame = 1; frame <= FRAME_COUNT; ++frame)
+		{
+			animate(joints, frame);
+
+			timer.reset();
+			root->updateWorldMatrixParallel(jobSystem, true);
+			total += timer.elapsed_micro();
+
+			animate(referenceJoints, frame);
+			referenceRoot->updateWorldMatrix(true, true);
+			identical = identical && collect(joints) == collect(referenceJoints);
+		}
+
+		double average = static_cast<double>(total) / FRAME_COUNT / 1000.0;
+		if (threads == 1)
+		{
+			baseTime = average;
+		}
+
+		std::cout << "threads: " << threads
+			<< "  update: " << average << " ms"
+			<< "  speedup: " << (average > 0.0 ? baseTime / average : 0.0)
+			<< "  identical: " << (identical ? "yes" : "NO") << std::endl;
+	}
+
+	return 0;
+}
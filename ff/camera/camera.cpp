@@ -10,8 +10,14 @@ namespace ff {
 
 	glm::mat4 Camera::updateWorldMatrix(bool updateParent, bool updateChildren) noexcept {
 		Object3D::updateWorldMatrix(updateParent, updateChildren);
-		m_workMatrixInverse = glm::inverse(m_worldMatrix);
 
-		return m_worldMatrix;
+		//worldMatrix没有变化时，逆矩阵也不必重新求
+		uint32_t version = getWorldMatrixVersion();
+		if (m_worldMatrixInverseVersion != version) {
+			m_worldMatrixInverseVersion = version;
+			m_workMatrixInverse = glm::inverse(currentWorldMatrix());
+		}
+
+		return currentWorldMatrix();
 	}
 }
\ No newline at end of file
@@ -51,6 +51,8 @@ namespace ff {
 	protected:
 		glm::mat4 m_workMatrixInverse = glm::mat4(1.0f);
 		glm::mat4 m_projectionMatrix = glm::mat4(1.0f);
+
+		uint32_t m_worldMatrixInverseVersion{ 0 };	//逆矩阵对应的worldMatrix版本
 	};
 
 	
@@ -14,7 +14,11 @@
  * float x = attr->getX(0);
  * ```
  *
+ * 数据既可以由Attribute自己持有(std::vector)，也可以引用外部的只读存储(例如内存映射的网格文件，见 createExternal)，
+ * 两种情况都通过 getData() 返回的只读视图访问，上传GPU时直接从该视图读取，不产生中间拷贝。
+ *
  * @note 本类通过事件系统在析构时广播 "attributeDispose" 消息，配合事件监听机制实现资源生命周期通知。
+ * @note 引用外部存储的Attribute是只读的，setX/setY/setZ不会生效。
  * @note 非线程安全。外部需自行保证并发安全。
  *
  * @tparam T 属性中存储的数据类型（如 float、uint32_t）。
@@ -31,6 +35,30 @@
 
 namespace ff
 {
+	//Attribute数据的只读视图，可以像只读的std::vector一样按下标或者范围for访问
+	template<typename T>
+	class AttributeData
+	{
+	public:
+		AttributeData(const T* data, size_t size) noexcept : m_data(data), m_size(size) {}
+
+		const T* data() const noexcept { return m_data; }
+
+		size_t size() const noexcept { return m_size; }
+
+		bool empty() const noexcept { return m_size == 0; }
+
+		const T* begin() const noexcept { return m_data; }
+
+		const T* end() const noexcept { return m_data + m_size; }
+
+		const T& operator[](size_t index) const noexcept { return m_data[index]; }
+
+	private:
+		const T*	m_data{ nullptr };
+		size_t		m_size{ 0 };
+	};
+
 	//对于每个Mesh，我们将其所有顶点的某个Attribute共同存储成一个数组，比如Position就是一个float类型的数组
 	//每个Attribute有可能数字类型不同，比如Position需要float，index需要uint32_t
 	template<typename T>
@@ -43,8 +71,29 @@ namespace ff
 			return std::make_shared<Attribute<T>>(data, itemSize, bufferAllocType);
 		}
 
+		//接管data，避免大块数据(例如从文件中读出的顶点)再拷贝一次
+		static Ptr create(std::vector<T>&& data, uint32_t itemSize, BufferAllocType bufferAllocType = BufferAllocType::StaticDrawBuffer)
+		{
+			return std::make_shared<Attribute<T>>(std::move(data), itemSize, bufferAllocType);
+		}
+
+		//引用外部的只读存储，不拷贝数据；owner在Attribute的整个生命周期内被持有，保证data一直有效
+		static Ptr createExternal(
+			const T* data,
+			uint32_t size,
+			uint32_t itemSize,
+			const std::shared_ptr<const void>& owner,
+			BufferAllocType bufferAllocType = BufferAllocType::StaticDrawBuffer)
+		{
+			return std::make_shared<Attribute<T>>(data, size, itemSize, owner, bufferAllocType);
+		}
+
 		Attribute(const std::vector<T>& date, uint32_t itemSize, BufferAllocType bufferAllocType = BufferAllocType::StaticDrawBuffer) noexcept;
 
+		Attribute(std::vector<T>&& data, uint32_t itemSize, BufferAllocType bufferAllocType = BufferAllocType::StaticDrawBuffer) noexcept;
+
+		Attribute(const T* data, uint32_t size, uint32_t itemSize, const std::shared_ptr<const void>& owner, BufferAllocType bufferAllocType = BufferAllocType::StaticDrawBuffer) noexcept;
+
 		~Attribute() noexcept;
 
 		void setX(const uint32_t& index, T value) noexcept;
@@ -62,7 +111,13 @@ namespace ff
 
 		auto getID() const noexcept { return m_id; }
 
-		auto getData() const noexcept { return m_data; }
+		//元素个数为getCount() * getItemSize()
+		AttributeData<T> getData() const noexcept
+		{
+			return m_external != nullptr ? AttributeData<T>(m_external, m_externalSize) : AttributeData<T>(m_data.data(), m_data.size());
+		}
+
+		bool isExternal() const noexcept { return m_external != nullptr; }
 
 		auto getCount() const noexcept { return m_count; }
 
@@ -83,6 +138,11 @@ namespace ff
 	private:
 		ID				m_id{ 0 };
 		std::vector<T>	m_data{};	//数据数组
+
+		//外部存储，不为空时m_data不使用
+		const T*					m_external{ nullptr };
+		size_t						m_externalSize{ 0 };
+		std::shared_ptr<const void>	m_externalOwner{ nullptr };
 		uint32_t		m_itemSize{ 0 }; //多少个数据为一个顶点的Attribute
 		uint32_t		m_count{ 0 };  //本attribute的数据，包含了多少个顶点的数据
 
@@ -113,6 +173,38 @@ namespace ff
 		m_dataType = toDataType<T>();
 	}
 
+	template<typename T>
+	Attribute<T>::Attribute(std::vector<T>&& data, uint32_t itemSize, BufferAllocType bufferAllocType) noexcept
+	{
+		m_id = Identity::generateID();
+
+		m_data = std::move(data);
+		m_itemSize = itemSize;
+
+		m_count = static_cast<uint32_t>(m_data.size() / itemSize);
+
+		m_bufferAllocType = bufferAllocType;
+
+		m_dataType = toDataType<T>();
+	}
+
+	template<typename T>
+	Attribute<T>::Attribute(const T* data, uint32_t size, uint32_t itemSize, const std::shared_ptr<const void>& owner, BufferAllocType bufferAllocType) noexcept
+	{
+		m_id = Identity::generateID();
+
+		m_external = data;
+		m_externalSize = size;
+		m_externalOwner = owner;
+		m_itemSize = itemSize;
+
+		m_count = static_cast<uint32_t>(size / itemSize);
+
+		m_bufferAllocType = bufferAllocType;
+
+		m_dataType = toDataType<T>();
+	}
+
 	template<typename T>
 	Attribute<T>::~Attribute() noexcept
 	{
@@ -127,7 +219,8 @@ namespace ff
 	template<typename T>
 	void Attribute<T>::setX(const uint32_t& index, T value) noexcept
 	{
-		assert(index < m_count);
+		assert(index < m_count && m_external == nullptr);
+		if (m_external != nullptr) return;
 
 		//float vector: a b c value e f g h i j
 		//假设index = 1 itemsize=3
@@ -138,42 +231,44 @@ namespace ff
 	template<typename T>
 	void Attribute<T>::setY(const uint32_t& index, T value) noexcept
 	{
-		assert(index < m_count);
+		assert(index < m_count && m_external == nullptr);
+		if (m_external != nullptr) return;
 
-		mData[index * mItemSize + 1] = x;
-		mNeedsUpdate = true;
+		m_data[index * m_itemSize + 1] = value;
+		m_needUpdate = true;
 	}
 
 	template<typename T>
 	void Attribute<T>::setZ(const uint32_t& index, T value) noexcept
 	{
-		assert(index < m_count);
+		assert(index < m_count && m_external == nullptr);
+		if (m_external != nullptr) return;
 
 		//float vector: a b c d e value g h i j
 		//假设index = 1 itemsize=3
-		m_data[index * m_itemSize + 2] = x;
-		mNeedsUpdate = true;
+		m_data[index * m_itemSize + 2] = value;
+		m_needUpdate = true;
 	}
 
 	template<typename T>
 	T Attribute<T>::getX(const uint32_t& index) noexcept 
 	{
 		assert(index < m_count);
-		return m_data[index * m_itemSize];
+		return getData()[index * m_itemSize];
 	}
 
 	template<typename T>
 	T Attribute<T>::getY(const uint32_t& index) noexcept 
 	{
 		assert(index < m_count);
-		return m_data[index * m_itemSize + 1];
+		return getData()[index * m_itemSize + 1];
 	}
 
 	template<typename T>
 	T Attribute<T>::getZ(const uint32_t& index) noexcept 
 	{
 		assert(index < m_count);
-		return m_data[index * m_itemSize + 2];
+		return getData()[index * m_itemSize + 2];
 	}
 
 }
\ No newline at end of file
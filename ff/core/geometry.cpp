@@ -20,6 +20,12 @@ namespace ff
 	void Geometry::setAttribute(const std::string& name, Attributef::Ptr attribute) noexcept
 	{
 		m_attributes[name] = attribute;
+
+		//位置数据变化，之前计算的包围体失效
+		if (name == "position")
+		{
+			invalidateBounds();
+		}
 	}
 
 	Attributef::Ptr Geometry::getAttribute(const std::string& name) noexcept
@@ -44,6 +50,11 @@ namespace ff
 		if (iter != m_attributes.end())
 		{
 			m_attributes.erase(iter);
+
+			if (name == "position")
+			{
+				invalidateBounds();
+			}
 		}
 	}
 
@@ -77,16 +88,21 @@ namespace ff
 			return;
 		}
 
-		if (m_boundingBox == nullptr)
-		{
-			m_boundingBox = Box3::create();
-		}
-
+		//重新计算时需要从空包围盒开始，否则会与上一次的结果合并
+		m_boundingBox = Box3::create();
 		m_boundingBox->setFormAttribute(position);
+
+		m_boundsVersion++;
 	}
 
 	void  Geometry::computeBoundingSphere() noexcept
 	{
+		auto position = getAttribute("position");
+		if (position == nullptr)
+		{
+			return;
+		}
+
 		computeBonudingBox();
 		if (m_boundingSphere == nullptr)
 		{
@@ -96,12 +112,6 @@ namespace ff
 		//包围球跟包围盒共享一个center
 		m_boundingSphere->m_center = m_boundingBox->getCenter();
 
-		auto position = getAttribute("position");
-		if (position == nullptr)
-		{
-			return;
-		}
-
 		//找到距离当前球心最大距离的点
 		float maxRadiusSq = 0;
 		for (uint32_t i = 0; i < position->getCount(); ++i)
@@ -117,6 +127,24 @@ namespace ff
 		
 		//开方求取radius
 		m_boundingSphere->m_radius = std::sqrt(maxRadiusSq);
+
+		m_boundsVersion++;
+	}
+
+	void Geometry::setBoundingVolumes(const Box3::Ptr& box, const Sphere::Ptr& sphere) noexcept
+	{
+		m_boundingBox = box;
+		m_boundingSphere = sphere;
+
+		m_boundsVersion++;
+	}
+
+	void Geometry::invalidateBounds() noexcept
+	{
+		m_boundingBox = nullptr;
+		m_boundingSphere = nullptr;
+
+		m_boundsVersion++;
 	}
 
 }
\ No newline at end of file
@@ -71,9 +71,19 @@ namespace ff
 
 		void computeBoundingSphere() noexcept;
 
-		Sphere::Ptr getBoundingSphere() const noexcept { return m_boundingSphere; }
+		const Sphere::Ptr& getBoundingSphere() const noexcept { return m_boundingSphere; }
 
-		Box3::Ptr getBoundingBox() const noexcept { return m_boundingBox; }
+		const Box3::Ptr& getBoundingBox() const noexcept { return m_boundingBox; }
+
+		//直接使用已知的包围体(例如从文件中读取)，省去逐顶点的计算，调用者保证与position数据一致
+		void setBoundingVolumes(const Box3::Ptr& box, const Sphere::Ptr& sphere) noexcept;
+
+		//包围盒/包围球每重新计算或失效一次加一，用于判断依赖它们的缓存是否过期
+		//直接修改position数据之后，需要重新调用computeBoundingSphere
+		uint32_t getBoundsVersion() const noexcept { return m_boundsVersion; }
+
+	protected:
+		void invalidateBounds() noexcept;
 
 	protected:
 		ID m_id{ 0 }; 
@@ -83,6 +93,8 @@ namespace ff
 		Box3::Ptr	m_boundingBox{ nullptr };	//包围盒
 		Sphere::Ptr m_boundingSphere{ nullptr };  //包围球
 
+		uint32_t	m_boundsVersion{ 0 };
+
 	};
 
 
@@ -1,5 +1,7 @@
 #include "object3D.h"
 #include "../tools/identity.h"
+#include "transformStore.h"
+#include "../tools/jobSystem.h"
 
 namespace ff
 {
@@ -10,7 +12,10 @@ namespace ff
 
 	Object3D::~Object3D() noexcept
 	{
-
+		if (m_transformStore != nullptr)
+		{
+			m_transformStore->onNodeDestroyed(m_transformIndex);
+		}
 	}
 
 	void Object3D::setPosition(float x, float y, float z) noexcept
@@ -18,20 +23,37 @@ namespace ff
 		setPosition(glm::vec3(x, y, z));
 	}
 
+	//平移在两种表示中都是独立的一部分，哪种表示有效就直接写哪种，不需要任何转换
 	void Object3D::setPosition(const glm::vec3& position) noexcept
 	{
-		m_localMatrix[3].x = position.x;  //glm列优先存储
-		m_localMatrix[3].y = position.y;
-		m_localMatrix[3].z = position.z;
+		if (!m_needUpdateMatrix)
+		{
+			m_localMatrix[3].x = position.x;  //glm列优先存储
+			m_localMatrix[3].y = position.y;
+			m_localMatrix[3].z = position.z;
+		}
+
+		if (!m_needDecompose)
+		{
+			m_position = position;
+		}
 
-		m_position = position;
+		setMatrixDirty();
 	}
 
-	//将四元数反映到本地矩阵上，拆解成对应参数
+	//将四元数反映到本地矩阵上
 	void Object3D::setQuaternion(float x, float y, float z, float w) noexcept
 	{
 		glm::quat quaternion(w, x, y, z);
 
+		//TRS有效时只需要替换旋转
+		if (!m_needDecompose)
+		{
+			m_quaternion = quaternion;
+			setTRSChanged();
+			return;
+		}
+
 		//可能已经经过缩放
 		float scaleX = glm::length(glm::vec3(m_localMatrix[0]));
 		float scaleY = glm::length(glm::vec3(m_localMatrix[1]));
@@ -44,11 +66,18 @@ namespace ff
 		m_localMatrix[1] = rotateMatrix[1] * scaleY;
 		m_localMatrix[2] = rotateMatrix[2] * scaleZ;
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::setScale(float x, float y, float z) noexcept
 	{
+		if (!m_needDecompose)
+		{
+			m_scale = glm::vec3(x, y, z);
+			setTRSChanged();
+			return;
+		}
+
 		//1 通过normalize 去掉之前的scale影响，再进行当前的scale
 		auto col0 = glm::normalize(glm::vec3(m_localMatrix[0])) * x;
 		auto col1 = glm::normalize(glm::vec3(m_localMatrix[1])) * y;
@@ -59,50 +88,73 @@ namespace ff
 		m_localMatrix[1] = glm::vec4(col1, 0.0f);
 		m_localMatrix[2] = glm::vec4(col2, 0.0f);
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::rotateX(float angle) noexcept
 	{
-		//1 先获取到当前模型状态下的右侧方向
-		glm::vec3 rorateAxis = glm::vec3(m_localMatrix[0]);
-
-		//2 针对这个右侧方向作为旋转轴来进行旋转
-		glm::mat4 rotateMatrix = glm::rotate(glm::mat4(1.0), glm::radians(angle),rorateAxis);
-		m_localMatrix = rotateMatrix * m_localMatrix;
-
-		decompose();
+		rotateAroundLocalAxis(glm::vec3(1.0f, 0.0f, 0.0f), 0, angle);
 	}
 
 	void Object3D::rotateY(float angle) noexcept
 	{
-		glm::vec3 rorateAxis = glm::vec3(m_localMatrix[1]);
-
-		glm::mat4 rotateMatrix = glm::rotate(glm::mat4(1.0), glm::radians(angle), rorateAxis);
-		m_localMatrix = rotateMatrix * m_localMatrix;
-
-		decompose();
+		rotateAroundLocalAxis(glm::vec3(0.0f, 1.0f, 0.0f), 1, angle);
 	}
 
 	void Object3D::rotateZ(float angle) noexcept
 	{
-		glm::vec3 rorateAxis = glm::vec3(m_localMatrix[2]);
+		rotateAroundLocalAxis(glm::vec3(0.0f, 0.0f, 1.0f), 2, angle);
+	}
+
+	//绕自身的某个坐标轴旋转，旋转作用在父坐标系中，平移也会随之旋转
+	void Object3D::rotateAroundLocalAxis(const glm::vec3& localAxis, int column, float angle) noexcept
+	{
+		//TRS有效：axis = q * localAxis，R * T * Q * S = T(R * p) * (R * Q) * S
+		if (!m_needDecompose)
+		{
+			glm::quat rotate = glm::angleAxis(glm::radians(angle), m_quaternion * localAxis);
+			m_quaternion = glm::normalize(rotate * m_quaternion);
+			m_position = rotate * m_position;
+
+			setTRSChanged();
+			return;
+		}
+
+		//1 先获取到当前模型状态下对应的方向
+		glm::vec3 rorateAxis = glm::vec3(m_localMatrix[column]);
 
+		//2 针对这个方向作为旋转轴来进行旋转
 		glm::mat4 rotateMatrix = glm::rotate(glm::mat4(1.0), glm::radians(angle), rorateAxis);
 		m_localMatrix = rotateMatrix * m_localMatrix;
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::rotateAroundAxis(const glm::vec3& axis, float angle) noexcept
 	{
+		//local * R = T * Q * S * R，只有在等比缩放时才能写成 T * (Q * R) * S，否则会产生切变，只能用矩阵表示
+		if (!m_needDecompose && m_scale.x == m_scale.y && m_scale.y == m_scale.z)
+		{
+			m_quaternion = glm::normalize(m_quaternion * glm::angleAxis(glm::radians(angle), glm::normalize(axis)));
+			setTRSChanged();
+			return;
+		}
+
+		updateMatrix();
 		m_localMatrix = glm::rotate(m_localMatrix, glm::radians(angle), axis);
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::setRotateAroundAxis(const glm::vec3& axis, float angle) noexcept
 	{
+		if (!m_needDecompose)
+		{
+			m_quaternion = glm::angleAxis(glm::radians(angle), glm::normalize(axis));
+			setTRSChanged();
+			return;
+		}
+
 		//1 获取旋转矩阵
 		glm::mat4 rotateMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(angle), axis);
 
@@ -119,22 +171,31 @@ namespace ff
 
 		m_localMatrix *= scaleMatrix;  //RS
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::lookat(const glm::vec3& target, const glm::vec3& up) noexcept
 	{
-		//1 拆解
-		float scaleX = glm::length(glm::vec3(m_localMatrix[0]));
-		float scaleY = glm::length(glm::vec3(m_localMatrix[1]));
-		float scaleZ = glm::length(glm::vec3(m_localMatrix[2]));
-
-		glm::vec3 position = glm::vec3(m_localMatrix[3]);
+		//1 拆解，TRS有效时直接使用
+		glm::vec3 scale;
+		glm::vec3 position;
+		if (!m_needDecompose)
+		{
+			scale = m_scale;
+			position = m_position;
+		}
+		else
+		{
+			scale.x = glm::length(glm::vec3(m_localMatrix[0]));
+			scale.y = glm::length(glm::vec3(m_localMatrix[1]));
+			scale.z = glm::length(glm::vec3(m_localMatrix[2]));
+			position = glm::vec3(m_localMatrix[3]);
+		}
 
 		//2 构建局部坐标系
-		auto nTarget = glm::normalize(target - position) * scaleZ;
-		auto nRight = glm::normalize(glm::cross(up, -nTarget)) * scaleX;
-		auto nUp = glm::normalize(glm::cross(nRight, nTarget)) * scaleY;
+		auto nTarget = glm::normalize(target - position) * scale.z;
+		auto nRight = glm::normalize(glm::cross(up, -nTarget)) * scale.x;
+		auto nUp = glm::normalize(glm::cross(nRight, nTarget)) * scale.y;
 
 		//3 组装本地矩阵
 		m_localMatrix[0] = glm::vec4(nRight, 0.0f);
@@ -142,19 +203,25 @@ namespace ff
 		m_localMatrix[2] = glm::vec4(-nTarget, 0.0f);
 		m_localMatrix[3] = glm::vec4(position, 1.0f);
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::setLocalMatrix(const glm::mat4& localMatrix) noexcept
 	{
 		m_localMatrix = localMatrix;
 
-		decompose();
+		setMatrixChanged();
 	}
 
 	void Object3D::setWorldMatrix(const glm::mat4& worldMatrix) noexcept
 	{
 		m_worldMatrix = worldMatrix;
+
+		//直接给定了worldMatrix，子节点需要跟随更新
+		//挂接到TransformStore的节点，worldMatrix会在下一次TransformStore::update时被覆盖
+		m_worldMatrixVersion++;
+		notifyWorldMatrixChanged();
+		setChildrenDirty();
 	}
 
 	void Object3D::addChild(const Object3D::Ptr& child) noexcept
@@ -173,9 +240,45 @@ namespace ff
 		if (iter != m_children.end()) return;
 
 		m_children.push_back(child);
-		 
+
+		//挂到了新的父节点下，无论版本号如何都需要重新计算一次
+		child->m_needUpdateWorldMatrix = true;
+		setChildrenDirty();
+		setHierarchyChanged();
+	}
+
+	void Object3D::removeChild(const Object3D::Ptr& child) noexcept
+	{
+		auto iter = std::find(m_children.begin(), m_children.end(), child);
+		if (iter == m_children.end()) return;
+
+		m_children.erase(iter);
+		child->m_parent.reset();
+
+		//脱离父节点之后世界矩阵失效，重新挂接时再计算
+		child->m_needUpdateWorldMatrix = true;
+		setHierarchyChanged();
 	}
 
+	void Object3D::removeChildren(const std::unordered_set<const Object3D*>& children) noexcept
+	{
+		//保留的子节点维持原来的顺序，被移除的排到后面
+		auto removed = std::stable_partition(m_children.begin(), m_children.end(), [&children](const Object3D::Ptr& child) {
+			return children.find(child.get()) == children.end();
+		});
+		if (removed == m_children.end()) return;
+
+		for (auto iter = removed; iter != m_children.end(); ++iter)
+		{
+			(*iter)->m_parent.reset();
+			(*iter)->m_needUpdateWorldMatrix = true;
+		}
+
+		m_children.erase(removed, m_children.end());
+		setHierarchyChanged();
+	}
+
+	//TRS为最新的表示时，由TRS重建本地矩阵
 	void Object3D::updateMatrix() noexcept
 	{
 		if (m_needUpdateMatrix)
@@ -186,45 +289,168 @@ namespace ff
 			auto scaleMatrix = glm::scale(glm::mat4(1.0f), m_scale);
 
 			m_localMatrix = translateMatrix * rotateMatrix * scaleMatrix;
+
+			m_localMatrixVersion++;
+			m_needUpdateWorldMatrix = true;
 		}
 	}
 
 	//通过层级matrix相乘，得到最后的转换到世界坐标系的矩阵
+	//只有本地矩阵变化、或者父节点worldMatrix版本变化的节点才会重新计算，没有脏节点的子树整体跳过
 	glm::mat4 Object3D::updateWorldMatrix(bool updateParent, bool updateChildren) noexcept
 	{
+		//挂接到TransformStore的节点由TransformStore::update统一计算
+		if (m_transformStore != nullptr)
+		{
+			return m_transformStore->getWorldMatrix(m_transformIndex);
+		}
+
+		auto& info = getWorldMatrixUpdateInfo();
+
 		//1 检查有没有父节点
-		if (!m_parent.expired() && updateParent)
+		auto parent = m_parent.lock();
+		if (parent && updateParent)
 		{
-			auto parent = m_parent.lock();
 			parent->updateWorldMatrix(true, false);
 		}
 
-		//2 跟新自己的loaclMatrix并初始化worldMatrix，如果没有父节点，那么二者相等
+		//2 跟新自己的loaclMatrix(仅当TRS被修改过)
 		updateMatrix();
-		m_worldMatrix = m_localMatrix;
 
 		//3 如果有父节点，需要做成父节点的woldMatrix， 从而把上方所有的节点的影响带入
-		if (!m_parent.expired())
+		//父节点的worldMatrix一旦重算，版本号就会变化，子节点借此得知自己需要重算
+		uint32_t parentVersion = parent ? parent->getWorldMatrixVersion() : 0;
+		if (m_needUpdateWorldMatrix || parentVersion != m_parentWorldMatrixVersion)
+		{
+			m_worldMatrix = parent ? parent->currentWorldMatrix() * m_localMatrix : m_localMatrix;
+
+			m_parentWorldMatrixVersion = parentVersion;
+			m_needUpdateWorldMatrix = false;
+			m_worldMatrixVersion++;
+			notifyWorldMatrixChanged();
+
+			//自己变了，所有子节点都必须访问
+			m_childrenNeedUpdate = !m_children.empty();
+			info.m_recomputed++;
+		}
+		else
 		{
-			auto parent = m_parent.lock();
-			m_worldMatrix = parent->m_worldMatrix * m_worldMatrix;
+			info.m_skipped++;
 		}
 
-		//4 依次更新子节点的worldMatrix
+		//4 依次更新子节点的worldMatrix，子树中没有脏节点时整体跳过
 		if (updateChildren)
 		{
-			for (auto& child : m_children)
+			updateChildrenWorldMatrix();
+		}
+
+		return m_worldMatrix;
+	}
+
+	glm::mat4 Object3D::updateWorldMatrixParallel(const std::shared_ptr<JobSystem>& jobSystem, bool updateParent) noexcept
+	{
+		if (jobSystem == nullptr || jobSystem->getThreadCount() <= 1 || m_transformStore != nullptr)
+		{
+			return updateWorldMatrix(updateParent, true);
+		}
+
+		auto& info = getWorldMatrixUpdateInfo();
+
+		//1 先更新自己，再按层串行展开，直到得到足够多的子树可以分给各个线程
+		updateWorldMatrix(updateParent, false);
+
+		const size_t targetCount = static_cast<size_t>(jobSystem->getThreadCount()) * 8;
+
+		std::vector<Object3D*> frontier{ this };
+		std::vector<Object3D*> nextFrontier;
+		while (!frontier.empty() && frontier.size() < targetCount)
+		{
+			nextFrontier.clear();
+			for (auto node : frontier)
 			{
-				child->updateWorldMatrix(false, true);
+				//骨骼每次都会重算，其子节点必须访问
+				if (!node->m_childrenNeedUpdate && !node->m_isBone)
+				{
+					if (!node->m_children.empty())
+					{
+						info.m_skippedSubtrees++;
+					}
+					continue;
+				}
+
+				node->m_childrenNeedUpdate = false;
+				for (auto& child : node->m_children)
+				{
+					child->updateWorldMatrix(false, false);
+					nextFrontier.push_back(child.get());
+				}
 			}
+
+			//已经到了叶子层，全部更新完毕
+			if (nextFrontier.empty())
+			{
+				return m_worldMatrix;
+			}
+
+			frontier.swap(nextFrontier);
+		}
+
+		//2 每个子树作为一个任务，统计数据各自记录在工作线程上，完成后按顺序累加回当前线程
+		std::vector<WorldMatrixUpdateInfo> jobInfos(frontier.size());
+
+		JobSystem::WaitGroup group;
+		for (size_t i = 0; i < frontier.size(); ++i)
+		{
+			auto node = frontier[i];
+			auto jobInfo = &jobInfos[i];
+
+			jobSystem->execute([node, jobInfo]() {
+				auto& threadInfo = getWorldMatrixUpdateInfo();
+				auto before = threadInfo;
+
+				node->updateChildrenWorldMatrix();
+
+				jobInfo->m_recomputed = threadInfo.m_recomputed - before.m_recomputed;
+				jobInfo->m_skipped = threadInfo.m_skipped - before.m_skipped;
+				jobInfo->m_skippedSubtrees = threadInfo.m_skippedSubtrees - before.m_skippedSubtrees;
+			}, group);
+		}
+
+		//任务也可能在当前线程上执行，先把当前线程的统计取出，避免重复累加
+		auto mainInfo = info;
+		jobSystem->wait(group);
+		info = mainInfo;
+
+		for (const auto& jobInfo : jobInfos)
+		{
+			info.m_recomputed += jobInfo.m_recomputed;
+			info.m_skipped += jobInfo.m_skipped;
+			info.m_skippedSubtrees += jobInfo.m_skippedSubtrees;
 		}
 
 		return m_worldMatrix;
 	}
 
+	void Object3D::updateChildrenWorldMatrix() noexcept
+	{
+		//骨骼每次都会重算worldMatrix，其子节点必须访问
+		if (m_childrenNeedUpdate || m_isBone)
+		{
+			m_childrenNeedUpdate = false;
+			for (auto& child : m_children)
+			{
+				child->updateWorldMatrix(false, true);
+			}
+		}
+		else if (!m_children.empty())
+		{
+			getWorldMatrixUpdateInfo().m_skippedSubtrees++;
+		}
+	}
+
 	glm::mat4 Object3D::updateModelViewMatrix(const glm::mat4& viewMatrix)noexcept
 	{
-		m_modelViewMatrix = viewMatrix * m_worldMatrix;
+		m_modelViewMatrix = viewMatrix * currentWorldMatrix();
 
 		return m_modelViewMatrix;
 	}
@@ -239,42 +465,71 @@ namespace ff
 
 	glm::vec3 Object3D::getPosition() const noexcept
 	{
-		return glm::vec3(m_localMatrix[3]);
+		return m_needUpdateMatrix ? m_position : glm::vec3(m_localMatrix[3]);
 	}
 
 	glm::vec3 Object3D::getWorldPosition() const noexcept
 	{
-		return glm::vec3(m_worldMatrix[3]);
+		return glm::vec3(currentWorldMatrix()[3]);
 	}
 
+	//方向类的查询在TRS有效时直接由四元数得到，不需要重建矩阵
 	glm::vec3 Object3D::getLocalDirection() const noexcept
 	{
+		if (m_needUpdateMatrix)
+		{
+			return -(m_quaternion * glm::vec3(0.0f, 0.0f, 1.0f));
+		}
+
 		return glm::normalize(-glm::vec3(m_localMatrix[2]));
 	}
 
 	glm::vec3 Object3D::getWorldDirection() const noexcept
 	{
-		return glm::normalize(-glm::vec3(m_worldMatrix[2]));
+		return glm::normalize(-glm::vec3(currentWorldMatrix()[2]));
 	}
 
 	glm::vec3 Object3D::getUp() const noexcept
 	{
+		if (m_needUpdateMatrix)
+		{
+			return m_quaternion * glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+
 		return glm::normalize(glm::vec3(m_localMatrix[1]));
 	}
 
 	glm::vec3 Object3D::getRight() const noexcept
 	{
+		if (m_needUpdateMatrix)
+		{
+			return m_quaternion * glm::vec3(1.0f, 0.0f, 0.0f);
+		}
+
 		return glm::normalize(glm::vec3(m_localMatrix[0]));
 	}
 
+	glm::quat Object3D::getQuaternion() noexcept
+	{
+		updateTRS();
+		return m_quaternion;
+	}
+
+	glm::vec3 Object3D::getScale() noexcept
+	{
+		updateTRS();
+		return m_scale;
+	}
+
 	glm::mat4 Object3D::getLocalMatrix() noexcept
 	{
+		updateMatrix();
 		return m_localMatrix;
 	}
 
 	glm::mat4 Object3D::getWorldMatrix() noexcept
 	{
-		return m_worldMatrix;
+		return currentWorldMatrix();
 	}
 
 	glm::mat4 Object3D::getModelViewMatrix() noexcept
@@ -297,6 +552,100 @@ namespace ff
 		return m_ID;
 	}
 
+	uint32_t Object3D::getWorldMatrixVersion() const noexcept
+	{
+		if (m_transformStore != nullptr)
+		{
+			return m_transformStore->getWorldMatrixVersion(m_transformIndex);
+		}
+
+		return m_worldMatrixVersion;
+	}
+
+	Object3D::WorldMatrixUpdateInfo& Object3D::getWorldMatrixUpdateInfo() noexcept
+	{
+		//每个线程各自统计，避免多线程更新时互相竞争
+		static thread_local WorldMatrixUpdateInfo info;
+		return info;
+	}
+
+	void Object3D::setMatrixDirty() noexcept
+	{
+		m_localMatrixVersion++;
+		m_needUpdateWorldMatrix = true;
+
+		if (m_transformStore != nullptr)
+		{
+			m_transformStore->markLocalDirty(m_transformIndex);
+		}
+
+		auto parent = m_parent.lock();
+		if (parent)
+		{
+			parent->setChildrenDirty();
+		}
+	}
+
+	void Object3D::setChildrenDirty() noexcept
+	{
+		//已经被标记过的节点，其祖先一定也被标记过了，不必再向上走
+		Object3D* node = this;
+		while (node != nullptr && !node->m_childrenNeedUpdate)
+		{
+			node->m_childrenNeedUpdate = true;
+
+			auto parent = node->m_parent.lock();
+			node = parent.get();
+		}
+	}
+
+	void Object3D::setTRSChanged() noexcept
+	{
+		m_needUpdateMatrix = true;
+		m_needDecompose = false;
+
+		setMatrixDirty();
+	}
+
+	void Object3D::setMatrixChanged() noexcept
+	{
+		m_needDecompose = true;
+		m_needUpdateMatrix = false;
+
+		setMatrixDirty();
+	}
+
+	void Object3D::updateTRS() noexcept
+	{
+		if (m_needDecompose)
+		{
+			m_needDecompose = false;
+			decompose();
+		}
+	}
+
+	void Object3D::setHierarchyChanged() noexcept
+	{
+		Object3D* node = this;
+		while (node != nullptr)
+		{
+			node->m_hierarchyVersion++;
+
+			auto parent = node->m_parent.lock();
+			node = parent.get();
+		}
+	}
+
+	const glm::mat4& Object3D::currentWorldMatrix() const noexcept
+	{
+		if (m_transformStore != nullptr)
+		{
+			return m_transformStore->getWorldMatrix(m_transformIndex);
+		}
+
+		return m_worldMatrix;
+	}
+
 	void Object3D::decompose() noexcept
 	{
 		glm::vec3 skew;
@@ -11,11 +11,16 @@
  */
 
 #include "../global/base.h"
+#include <atomic>
+#include <unordered_set>
 #pragma once
 
 
 namespace ff
 {
+	class TransformStore;
+	class JobSystem;
+
 	class ObjectTypeChecker
 	{
 	public:
@@ -28,6 +33,8 @@ namespace ff
 		bool m_isPerpectiveCamera{ false };
 		bool m_isOrthographicCamera{ false };
 		bool m_isGroup{ false };
+		bool m_isLOD{ false };
+		bool m_isHLOD{ false };
 		bool m_isLight{ false };
 		bool m_isAmbientLight{ false };
 		bool m_isDirectionalLight{ false };
@@ -37,6 +44,65 @@ namespace ff
 	class Object3D :public std::enable_shared_from_this<Object3D>, public ObjectTypeChecker
 	{
 	public:
+		friend class TransformStore;
+
+		//一次世界矩阵更新过程中的统计，用来观察静态场景下跳过了多少节点
+		struct WorldMatrixUpdateInfo
+		{
+			uint32_t m_recomputed{ 0 };		//重新计算了worldMatrix的节点数
+			uint32_t m_skipped{ 0 };		//访问到但矩阵没有变化的节点数
+			uint32_t m_skippedSubtrees{ 0 };	//整棵子树都没有变化，直接跳过的子树数
+		};
+
+		//世界矩阵变化的通知标记，由SceneBVH等需要增量更新的结构分配并挂到节点上
+		//节点的worldMatrix每次重新计算都会把自己对应的字节置1，不同节点写不同字节，可以在多线程更新中使用
+		struct WorldChangeFlags
+		{
+			std::vector<uint8_t>	m_flags{};
+			std::atomic<bool>		m_changed{ false };	//是否有任意一个节点发生了变化
+		};
+
+		//显式栈遍历使用的栈，在多次遍历之间复用，容量稳定之后遍历不再分配内存
+		class TraverseStack
+		{
+		public:
+			struct Entry
+			{
+				Object3D*	m_object{ nullptr };
+				uint32_t	m_data{ 0 };	//由访问者向子节点传递的数据，比如groupOrder
+			};
+
+			void push(Object3D* object, uint32_t data) noexcept
+			{
+				if (m_entries.size() == m_entries.capacity())
+				{
+					m_allocations++;
+				}
+				m_entries.push_back({ object, data });
+			}
+
+			bool pop(Entry& entry) noexcept
+			{
+				if (m_entries.empty())
+				{
+					return false;
+				}
+
+				entry = m_entries.back();
+				m_entries.pop_back();
+				return true;
+			}
+
+			void clear() noexcept { m_entries.clear(); }
+
+			//栈扩容(堆分配)的累计次数
+			uint32_t getAllocationCount() const noexcept { return m_allocations; }
+
+		private:
+			std::vector<Entry>	m_entries{};
+			uint32_t			m_allocations{ 0 };
+		};
+
 		using Ptr = std::shared_ptr<Object3D>;
 		static Ptr create()
 		{
@@ -78,10 +144,20 @@ namespace ff
 
 		void addChild(const Object3D::Ptr& child) noexcept;
 
+		//child不是本节点的子节点时什么都不做
+		void removeChild(const Object3D::Ptr& child) noexcept;
+
+		//一次移除多个子节点，子节点列表只重建一次，层级版本只增加一次；不是本节点子节点的忽略
+		//逐个removeChild每次都要查找整个子节点列表，移除大量子节点时为O(n^2)
+		void removeChildren(const std::unordered_set<const Object3D*>& children) noexcept;
+
 		virtual void updateMatrix() noexcept;
 
 		virtual glm::mat4 updateWorldMatrix(bool updateParent = false, bool updateChildren = false) noexcept;
 
+		//与updateWorldMatrix(updateParent, true)结果一致，先串行向下展开若干层，再把展开得到的子树作为任务并行更新
+		glm::mat4 updateWorldMatrixParallel(const std::shared_ptr<JobSystem>& jobSystem, bool updateParent = false) noexcept;
+
 		glm::mat4 updateModelViewMatrix(const glm::mat4& viewMatrix)noexcept;
 
 		glm::mat3 updateNormalMatrix() noexcept;
@@ -98,6 +174,10 @@ namespace ff
 
 		glm::vec3 getRight() const noexcept;
 
+		glm::quat getQuaternion() noexcept;
+
+		glm::vec3 getScale() noexcept;
+
 		glm::mat4 getLocalMatrix() noexcept;
 
 		glm::mat4 getWorldMatrix() noexcept;
@@ -110,8 +190,69 @@ namespace ff
 
 		ID getID() const noexcept;
 
+		//前序遍历本节点为根的子树，m_visible为false的节点连同子树一起跳过
+		//visitor: bool(Object3D* object, uint32_t& data)，返回false时不再访问其子树，
+		//对data的修改只影响其子节点；遍历顺序与递归访问children的顺序一致
+		template<typename Visitor>
+		void traverseVisible(TraverseStack& stack, uint32_t data, Visitor&& visitor) noexcept;
+
+		uint32_t getLocalMatrixVersion() const noexcept { return m_localMatrixVersion; }
+
+		uint32_t getWorldMatrixVersion() const noexcept;
+
+		//节点增删时，自己以及所有祖先的版本号都会加一
+		uint32_t getHierarchyVersion() const noexcept { return m_hierarchyVersion; }
+
+		//是否被挂接到了TransformStore上，挂接后世界矩阵由TransformStore统一计算
+		bool isInTransformStore() const noexcept { return m_transformStore != nullptr; }
+
+		//挂接世界矩阵变化的通知标记，flags为nullptr时取消
+		void setWorldChangeFlags(const std::shared_ptr<WorldChangeFlags>& flags, uint32_t index) noexcept
+		{
+			m_worldChangeFlags = flags;
+			m_worldChangeIndex = index;
+		}
+
+		//当前线程的世界矩阵更新统计，由使用者在每帧开始时清零
+		static WorldMatrixUpdateInfo& getWorldMatrixUpdateInfo() noexcept;
+
 	protected:
 		void decompose() noexcept;
+
+		//本地矩阵为最新的表示时，拆解出TRS
+		void updateTRS() noexcept;
+
+		//写入了TRS，本地矩阵在需要时(updateMatrix)再重建
+		void setTRSChanged() noexcept;
+
+		//写入了本地矩阵，TRS在需要时(updateTRS)再拆解
+		void setMatrixChanged() noexcept;
+
+		void rotateAroundLocalAxis(const glm::vec3& localAxis, int column, float angle) noexcept;
+
+		//本地矩阵发生变化：标记自己需要重算worldMatrix，并通知祖先节点其子树中有脏节点
+		void setMatrixDirty() noexcept;
+
+		//从本节点向上标记，直到遇到已经标记过的祖先
+		void setChildrenDirty() noexcept;
+
+		//子树中存在脏节点时递归更新所有子节点，否则整体跳过
+		void updateChildrenWorldMatrix() noexcept;
+
+		void notifyWorldMatrixChanged() noexcept
+		{
+			if (m_worldChangeFlags != nullptr)
+			{
+				m_worldChangeFlags->m_flags[m_worldChangeIndex] = 1;
+				m_worldChangeFlags->m_changed.store(true, std::memory_order_relaxed);
+			}
+		}
+
+		//层级结构发生变化，自己以及所有祖先的层级版本号加一
+		void setHierarchyChanged() noexcept;
+
+		//当前有效的worldMatrix，挂接到TransformStore时从Store中读取
+		const glm::mat4& currentWorldMatrix() const noexcept;
 	
 	public:
 		bool m_visible{ true };   //是否进行渲染
@@ -120,7 +261,7 @@ namespace ff
 
 		std::string m_name;	//obj的名字
 
-		bool m_needUpdateMatrix{ true };  //是否强制对矩阵进行更新
+		bool m_needUpdateMatrix{ true };  //是否强制对矩阵进行更新(由TRS重建本地矩阵)
 
 	protected:
 		ID m_ID{ 0 };   //全局唯一id
@@ -131,6 +272,10 @@ namespace ff
 
 		glm::vec3 m_scale{ glm::vec3(1.0) };
 
+		//TRS与本地矩阵只保证最后写入的一种是最新的，另一种在读取时才转换
+		//m_needUpdateMatrix为true：矩阵过期；m_needDecompose为true：TRS过期；两者不会同时为true
+		bool m_needDecompose{ false };
+
 		glm::mat4 m_localMatrix = glm::mat4(1.0f);   //对模型坐标进行变换
 
 		glm::mat4 m_worldMatrix = glm::mat4(1.0f);	//将模型顶点从模型坐标系转换到世界坐标系
@@ -144,6 +289,52 @@ namespace ff
 
 		glm::mat3 m_normalMatrix = glm::mat3(1.0f);	//将模型的normal从模型坐标系转换到摄像机坐标系
 
+		//脏标记与版本号
+		bool m_needUpdateWorldMatrix{ true };	//本地矩阵变化或者刚被挂到新的父节点上，需要重算worldMatrix
+		bool m_childrenNeedUpdate{ false };		//子树中存在需要更新的节点，为false时整棵子树可以跳过
+
+		uint32_t m_localMatrixVersion{ 0 };		//本地矩阵每变化一次加一
+		uint32_t m_worldMatrixVersion{ 0 };		//世界矩阵每重新计算一次加一
+		uint32_t m_parentWorldMatrixVersion{ 0 };	//上一次计算时所使用的父节点worldMatrix版本
+		uint32_t m_hierarchyVersion{ 0 };		//子树结构每变化一次加一
+
+		//世界矩阵变化通知，标记数组由使用者共享持有，节点不会访问到已经释放的内存
+		std::shared_ptr<WorldChangeFlags> m_worldChangeFlags{ nullptr };
+		uint32_t m_worldChangeIndex{ 0 };
+
+		//TransformStore句柄
+		TransformStore* m_transformStore{ nullptr };
+		uint32_t m_transformIndex{ 0 };
+
 	};
 
+	template<typename Visitor>
+	void Object3D::traverseVisible(TraverseStack& stack, uint32_t data, Visitor&& visitor) noexcept
+	{
+		stack.clear();
+		stack.push(this, data);
+
+		TraverseStack::Entry entry;
+		while (stack.pop(entry))
+		{
+			auto object = entry.m_object;
+			if (!object->m_visible)
+			{
+				continue;
+			}
+
+			uint32_t childData = entry.m_data;
+			if (!visitor(object, childData))
+			{
+				continue;
+			}
+
+			//逆序压栈，保证出栈顺序与children顺序一致
+			const auto& children = object->m_children;
+			for (auto iter = children.rbegin(); iter != children.rend(); ++iter)
+			{
+				stack.push(iter->get(), childData);
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "transformStore.h"
+
+#if defined(__AVX__)
+#define FF_TRANSFORM_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FF_TRANSFORM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace ff
+{
+	//out = a * b，glm列优先存储：out的第j列 = sum_k a的第k列 * b[j][k]
+	static inline void multiplyMatrix(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) noexcept
+	{
+#if defined(FF_TRANSFORM_AVX)
+		const float* pa = &a[0][0];
+		const float* pb = &b[0][0];
+		float* po = &out[0][0];
+
+		//a的每一列复制到高低两半，一次计算out的两列
+		__m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 0));
+		__m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 4));
+		__m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 8));
+		__m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pa + 12));
+
+		for (int j = 0; j < 4; j += 2)
+		{
+			__m256 bj = _mm256_loadu_ps(pb + j * 4);
+
+			__m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+			r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+
+			_mm256_storeu_ps(po + j * 4, r);
+		}
+#elif defined(FF_TRANSFORM_SSE)
+		const float* pa = &a[0][0];
+		const float* pb = &b[0][0];
+		float* po = &out[0][0];
+
+		__m128 a0 = _mm_loadu_ps(pa + 0);
+		__m128 a1 = _mm_loadu_ps(pa + 4);
+		__m128 a2 = _mm_loadu_ps(pa + 8);
+		__m128 a3 = _mm_loadu_ps(pa + 12);
+
+		for (int j = 0; j < 4; ++j)
+		{
+			__m128 bj = _mm_loadu_ps(pb + j * 4);
+
+			__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+
+			_mm_storeu_ps(po + j * 4, r);
+		}
+#else
+		out = a * b;
+#endif
+	}
+
+	TransformStore::TransformStore() noexcept {}
+
+	TransformStore::~TransformStore() noexcept
+	{
+		detachAll();
+	}
+
+	void TransformStore::build(const Object3D::Ptr& root) noexcept
+	{
+		detachAll();
+
+		m_root = root;
+		if (root == nullptr)
+		{
+			return;
+		}
+
+		m_hierarchyVersion = root->m_hierarchyVersion;
+
+		//深度优先前序展开，子节点逆序压栈，保证展开后的顺序与children顺序一致
+		std::vector<std::pair<Object3D*, int32_t>> stack;
+		stack.push_back({ root.get(), -1 });
+
+		while (!stack.empty())
+		{
+			auto [node, parentIndex] = stack.back();
+			stack.pop_back();
+
+			//骨骼的世界矩阵有自己的规则，整棵骨骼子树交给Bone::updateWorldMatrix
+			if (node->m_isBone)
+			{
+				m_detachedRoots.push_back(node->weak_from_this());
+				continue;
+			}
+
+			//同一个节点只能属于一个Store
+			if (node->m_transformStore != nullptr && node->m_transformStore != this)
+			{
+				node->m_transformStore->onNodeDestroyed(node->m_transformIndex);
+			}
+
+			node->updateMatrix();
+
+			uint32_t index = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.push_back(node);
+			m_parents.push_back(parentIndex);
+			m_subtreeEnds.push_back(index + 1);
+			m_localMatrices.push_back(node->m_localMatrix);
+			m_worldMatrices.push_back(node->m_worldMatrix);
+			m_worldVersions.push_back(node->m_worldMatrixVersion);
+			m_dirtyFlags.push_back(0);
+
+			node->m_transformStore = this;
+			node->m_transformIndex = index;
+
+			const auto& children = node->m_children;
+			for (auto iter = children.rbegin(); iter != children.rend(); ++iter)
+			{
+				stack.push_back({ iter->get(), static_cast<int32_t>(index) });
+			}
+		}
+
+		//前序展开中子树是连续的，从后往前把子节点的区间终点汇总到父节点上
+		for (size_t i = m_nodes.size(); i > 1; --i)
+		{
+			auto parent = m_parents[i - 1];
+			m_subtreeEnds[parent] = std::max(m_subtreeEnds[parent], m_subtreeEnds[i - 1]);
+		}
+
+		//第一次update需要计算整棵树
+		if (!m_nodes.empty())
+		{
+			m_dirtyFlags[0] = 1;
+			m_dirtyIndices.push_back(0);
+		}
+	}
+
+	void TransformStore::clear() noexcept
+	{
+		detachAll();
+	}
+
+	void TransformStore::update() noexcept
+	{
+		auto root = m_root.lock();
+		if (root == nullptr)
+		{
+			if (!m_nodes.empty())
+			{
+				detachAll();
+			}
+			return;
+		}
+
+		//层级结构变化，重新展平
+		if (root->m_hierarchyVersion != m_hierarchyVersion)
+		{
+			build(root);
+		}
+
+		if (!m_nodes.empty())
+		{
+			updateNodes(root);
+		}
+
+		//骨骼子树在其父节点更新之后处理
+		for (auto& weakBone : m_detachedRoots)
+		{
+			auto bone = weakBone.lock();
+			if (bone)
+			{
+				bone->updateWorldMatrix(false, true);
+			}
+		}
+	}
+
+	void TransformStore::updateNodes(const Object3D::Ptr& root) noexcept
+	{
+		//根节点如果还有不属于本Store的父节点，需要带上其worldMatrix
+		auto rootParent = root->m_parent.lock();
+		uint32_t rootParentVersion = rootParent ? rootParent->getWorldMatrixVersion() : 0;
+		if (rootParentVersion != m_rootParentVersion)
+		{
+			m_rootParentVersion = rootParentVersion;
+			m_rootParentMatrix = rootParent ? rootParent->getWorldMatrix() : glm::mat4(1.0f);
+			if (!m_dirtyFlags[0])
+			{
+				m_dirtyFlags[0] = 1;
+				m_dirtyIndices.push_back(0);
+			}
+		}
+
+		auto& info = Object3D::getWorldMatrixUpdateInfo();
+		uint32_t recomputed = 0;
+
+		if (!m_dirtyIndices.empty())
+		{
+			//1 只拷贝脏节点的本地矩阵
+			for (auto index : m_dirtyIndices)
+			{
+				m_dirtyFlags[index] = 0;
+
+				auto node = m_nodes[index];
+				if (node != nullptr)
+				{
+					node->updateMatrix();
+					m_localMatrices[index] = node->m_localMatrix;
+				}
+			}
+
+			//2 每个脏节点对应一段连续的子树区间，排序后合并被包含的区间
+			std::sort(m_dirtyIndices.begin(), m_dirtyIndices.end());
+
+			uint32_t rangeBegin = m_dirtyIndices[0];
+			uint32_t rangeEnd = m_subtreeEnds[rangeBegin];
+			for (size_t i = 1; i < m_dirtyIndices.size(); ++i)
+			{
+				auto index = m_dirtyIndices[i];
+				if (index < rangeEnd)
+				{
+					continue;
+				}
+
+				updateRange(rangeBegin, rangeEnd);
+				recomputed += rangeEnd - rangeBegin;
+
+				rangeBegin = index;
+				rangeEnd = m_subtreeEnds[index];
+			}
+
+			updateRange(rangeBegin, rangeEnd);
+			recomputed += rangeEnd - rangeBegin;
+
+			m_dirtyIndices.clear();
+		}
+
+		info.m_recomputed += recomputed;
+		info.m_skipped += static_cast<uint32_t>(m_nodes.size()) - recomputed;
+	}
+
+	void TransformStore::markLocalDirty(uint32_t index) noexcept
+	{
+		if (!m_dirtyFlags[index])
+		{
+			m_dirtyFlags[index] = 1;
+			m_dirtyIndices.push_back(index);
+		}
+	}
+
+	void TransformStore::onNodeDestroyed(uint32_t index) noexcept
+	{
+		m_nodes[index] = nullptr;
+	}
+
+	void TransformStore::detachAll() noexcept
+	{
+		//把Store中的结果写回节点，释放后节点仍然持有正确的worldMatrix
+		for (size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			auto node = m_nodes[i];
+			if (node == nullptr)
+			{
+				continue;
+			}
+
+			node->m_worldMatrix = m_worldMatrices[i];
+			node->m_worldMatrixVersion = m_worldVersions[i];
+			node->m_needUpdateWorldMatrix = true;
+			node->m_childrenNeedUpdate = !node->m_children.empty();
+			node->m_transformStore = nullptr;
+			node->m_transformIndex = 0;
+		}
+
+		m_root.reset();
+		m_nodes.clear();
+		m_parents.clear();
+		m_subtreeEnds.clear();
+		m_localMatrices.clear();
+		m_worldMatrices.clear();
+		m_worldVersions.clear();
+		m_dirtyFlags.clear();
+		m_dirtyIndices.clear();
+		m_detachedRoots.clear();
+
+		m_rootParentVersion = 0;
+		m_rootParentMatrix = glm::mat4(1.0f);
+	}
+
+	//区间内父节点下标一定小于子节点下标，且区间起点的父节点已经是最新的，顺序计算即可
+	void TransformStore::updateRange(uint32_t begin, uint32_t end) noexcept
+	{
+		const int32_t* parents = m_parents.data();
+		const glm::mat4* locals = m_localMatrices.data();
+		glm::mat4* worlds = m_worldMatrices.data();
+		uint32_t* versions = m_worldVersions.data();
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			int32_t parent = parents[i];
+			const glm::mat4& parentMatrix = parent >= 0 ? worlds[parent] : m_rootParentMatrix;
+
+			multiplyMatrix(parentMatrix, locals[i], worlds[i]);
+			versions[i]++;
+		}
+
+		//矩阵计算完成之后再单独通知，只有发生变化的节点才会被访问
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			auto node = m_nodes[i];
+			if (node != nullptr)
+			{
+				node->notifyWorldMatrixChanged();
+			}
+		}
+	}
+}
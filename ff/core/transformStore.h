@@ -0,0 +1,102 @@
+/**
+ * @class TransformStore
+ * @brief 将一棵Object3D层级中的本地/世界矩阵展平到连续数组中，以线性循环完成世界矩阵的层级更新。
+ *
+ * 简介：
+ * - build(root) 以深度优先前序把整棵树展平：父节点下标一定小于子节点下标，且每棵子树占据一段连续下标。
+ * - 本地矩阵、世界矩阵、父节点下标分别存放在各自的连续数组中(SoA)，更新时不再沿指针访问节点。
+ * - 节点被挂接后成为Store中的一个“句柄”，getWorldMatrix 等接口直接读取Store中的数据。
+ *
+ * 使用示例：
+ * @code
+ * auto store = ff::TransformStore::create();
+ * store->build(scene);
+ * renderer->setTransformStore(store);   // 之后由renderer每帧调用 store->update()
+ * @endcode
+ *
+ * 更新流程：
+ * - 节点的本地矩阵变化时，通过 markLocalDirty 记录下标；update() 时只拷贝这些节点的本地矩阵。
+ * - 每个脏节点的子树对应一段连续区间，合并后对区间做线性的 world[i] = world[parent[i]] * local[i]。
+ * - 矩阵乘法在支持AVX/SSE的平台上使用SIMD实现，否则回退到glm。
+ * - 层级结构发生变化(addChild)时根节点的层级版本号会变化，update() 会自动重新build。
+ *
+ * 限制与注意：
+ * - Bone 子树的世界矩阵规则与普通节点不同，不会被展平，而是在线性更新之后由 Bone::updateWorldMatrix 处理。
+ * - 挂接的节点不再参与 Object3D::updateWorldMatrix 的递归更新，世界矩阵统一由 update() 计算。
+ * - 非线程安全。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "../global/base.h"
+#include "object3D.h"
+
+namespace ff
+{
+	class TransformStore
+	{
+	public:
+		using Ptr = std::shared_ptr<TransformStore>;
+		static Ptr create()
+		{
+			return std::make_shared<TransformStore>();
+		}
+
+		TransformStore() noexcept;
+
+		~TransformStore() noexcept;
+
+		//将root为根的整棵树展平，之前挂接的节点会被释放
+		void build(const Object3D::Ptr& root) noexcept;
+
+		//释放所有挂接的节点，世界矩阵会写回到各个节点中
+		void clear() noexcept;
+
+		//更新所有脏节点所在子树的世界矩阵，层级结构有变化时自动重新build
+		void update() noexcept;
+
+		//由Object3D在本地矩阵变化时调用
+		void markLocalDirty(uint32_t index) noexcept;
+
+		//节点析构时调用，避免Store中残留悬空指针
+		void onNodeDestroyed(uint32_t index) noexcept;
+
+		const glm::mat4& getWorldMatrix(uint32_t index) const noexcept { return m_worldMatrices[index]; }
+
+		const glm::mat4& getLocalMatrix(uint32_t index) const noexcept { return m_localMatrices[index]; }
+
+		uint32_t getWorldMatrixVersion(uint32_t index) const noexcept { return m_worldVersions[index]; }
+
+		uint32_t getCount() const noexcept { return static_cast<uint32_t>(m_nodes.size()); }
+
+	private:
+		void detachAll() noexcept;
+
+		void updateNodes(const Object3D::Ptr& root) noexcept;
+
+		void updateRange(uint32_t begin, uint32_t end) noexcept;
+
+	private:
+		std::weak_ptr<Object3D>		m_root{};
+		uint32_t					m_hierarchyVersion{ 0 };	//build时根节点的层级版本号
+
+		glm::mat4					m_rootParentMatrix = glm::mat4(1.0f);	//根节点的父节点(不属于本Store)的worldMatrix
+		uint32_t					m_rootParentVersion{ 0 };
+
+		std::vector<Object3D*>		m_nodes{};				//下标对应的节点，节点析构后置空
+		std::vector<int32_t>		m_parents{};			//父节点下标，根节点为-1
+		std::vector<uint32_t>		m_subtreeEnds{};		//子树区间 [i, m_subtreeEnds[i])
+		std::vector<glm::mat4>		m_localMatrices{};
+		std::vector<glm::mat4>		m_worldMatrices{};
+		std::vector<uint32_t>		m_worldVersions{};
+
+		std::vector<uint8_t>		m_dirtyFlags{};
+		std::vector<uint32_t>		m_dirtyIndices{};
+
+		//未被展平的Bone子树根节点，在线性更新之后单独更新
+		std::vector<std::weak_ptr<Object3D>>	m_detachedRoots{};
+	};
+}
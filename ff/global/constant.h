@@ -209,7 +209,8 @@ namespace ff
 	enum class TextureType
 	{
 		Texture2D,
-		TextureCubeMap
+		TextureCubeMap,
+		Texture2DArray
 	};
 
 	static GLuint toGL(const TextureType& value) noexcept
@@ -220,6 +221,8 @@ namespace ff
 			return GL_TEXTURE_2D;
 		case TextureType::TextureCubeMap:
 			return GL_TEXTURE_CUBE_MAP;
+		case TextureType::Texture2DArray:
+			return GL_TEXTURE_2D_ARRAY;
 		default:
 			return GL_NONE;
 		}
@@ -0,0 +1,151 @@
+#include "cache.h"
+
+namespace ff
+{
+	Cache* Cache::m_instance = nullptr;
+	Cache* Cache::getInstance()
+	{
+		if (m_instance == nullptr)
+		{
+			m_instance = new Cache();
+		}
+
+		return m_instance;
+	}
+
+	Cache::Cache() noexcept
+	{
+		EventDispatcher::getInstance()->addEventListener("sourceRelease", this, &Cache::onSourceRelease);
+	}
+
+	Cache::~Cache() noexcept
+	{
+		EventDispatcher::getInstance()->removeEventListener("sourceRelease", this, &Cache::onSourceRelease);
+	}
+
+	Source::Ptr Cache::getSource(const std::string& path) noexcept
+	{
+		auto iter = m_paths.find(path);
+		if (iter == m_paths.end())
+		{
+			return nullptr;
+		}
+
+		auto source = findSource(iter->second);
+		source->m_refCount++;
+		return source;
+	}
+
+	Source::Ptr Cache::getSource(HashType hashCode) noexcept
+	{
+		auto iter = m_sources.find(hashCode);
+		if (iter == m_sources.end())
+		{
+			return nullptr;
+		}
+
+		iter->second->m_refCount++;
+		return iter->second;
+	}
+
+	Source::Ptr Cache::cacheSource(const Source::Ptr& source, const std::string& path) noexcept
+	{
+		if (source == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (source->m_hashCode == 0)
+		{
+			source->m_hashCode = hashSource(*source);
+		}
+
+		//哈希相同时再比较内容，碰撞的不同图片各自保存
+		Source::Ptr result{ nullptr };
+		auto range = m_sources.equal_range(source->m_hashCode);
+		for (auto iter = range.first; iter != range.second; ++iter)
+		{
+			const auto& cached = iter->second;
+			if (cached == source || (cached->m_width == source->m_width && cached->m_height == source->m_height && cached->m_data == source->m_data))
+			{
+				result = cached;
+				break;
+			}
+		}
+
+		if (result == nullptr)
+		{
+			result = source;
+			m_sources.emplace(source->m_hashCode, source);
+		}
+
+		result->m_refCount++;
+
+		if (!path.empty())
+		{
+			m_paths[path] = result.get();
+		}
+
+		return result;
+	}
+
+	Source::Ptr Cache::findSource(const Source* source) const noexcept
+	{
+		auto range = m_sources.equal_range(source->m_hashCode);
+		for (auto iter = range.first; iter != range.second; ++iter)
+		{
+			if (iter->second.get() == source)
+			{
+				return iter->second;
+			}
+		}
+
+		return nullptr;
+	}
+
+	HashType Cache::hashSource(const Source& source) noexcept
+	{
+		uint64_t hash = 14695981039346656037ull;
+		auto mix = [&hash](const byte* data, size_t size) {
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash = (hash ^ data[i]) * 1099511628211ull;
+			}
+		};
+
+		mix(reinterpret_cast<const byte*>(&source.m_width), sizeof(source.m_width));
+		mix(reinterpret_cast<const byte*>(&source.m_height), sizeof(source.m_height));
+		mix(source.m_data.data(), source.m_data.size());
+
+		//0表示没有计算过
+		return hash != 0 ? static_cast<HashType>(hash) : 1;
+	}
+
+	void Cache::onSourceRelease(const EventBase::Ptr& e)
+	{
+		auto source = static_cast<Source*>(e->mTarget);
+
+		//不在缓存中的Source，或者只是哈希值恰好相同的另一个Source
+		auto range = m_sources.equal_range(source->m_hashCode);
+		auto iter = std::find_if(range.first, range.second, [source](const auto& entry) { return entry.second.get() == source; });
+		if (iter == range.second)
+		{
+			return;
+		}
+
+		if (source->m_refCount > 0)
+		{
+			source->m_refCount--;
+		}
+
+		if (source->m_refCount == 0)
+		{
+			for (auto path = m_paths.begin(); path != m_paths.end();)
+			{
+				path = path->second == source ? m_paths.erase(path) : std::next(path);
+			}
+
+			m_sources.erase(iter);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+/**
+ * @class Cache
+ * @brief 图片数据(Source)的全局缓存：同一路径、或者内容完全相同的图片在内存中只保存一份，由所有引用它的Texture共享。
+ *
+ * 简介：
+ * - Source以内容哈希(像素数据与宽高，见 hashSource)为键存放，Source::m_hashCode即为该键；
+ *   哈希相同时再比较宽高与像素数据，内容不同的碰撞图片各自保存；
+ *   路径作为别名指向缓存中的Source，所以不同路径下的同一张图片同样只保存一份；
+ * - Source::m_refCount记录有多少个Texture引用它：getSource/cacheSource每返回一次计数加一，
+ *   调用者需要把返回的Source交给恰好一个Texture；Texture析构时派发sourceRelease事件，计数减一，归零时移出缓存；
+ * - Texture::clone得到的纹理共享同一个Source，计数同样加一。
+ *
+ * 使用示例：
+ * @code
+ * auto source = ff::Cache::getInstance()->getSource(path);
+ * if (source == nullptr)
+ * {
+ *     source = ff::Cache::getInstance()->cacheSource(decoded, path);   // 内容相同的Source已存在时返回已有的
+ * }
+ * texture->m_source = source;
+ * @endcode
+ *
+ * 限制与注意：
+ * - 非线程安全，只能在主线程(渲染线程)上使用；工作线程只负责解码与计算hashSource；
+ * - 没有经过缓存的Source(m_hashCode不在缓存中)不受影响。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../global/eventDispatcher.h"
+#include "../textures/source.h"
+
+namespace ff
+{
+	class Cache
+	{
+	public:
+		static Cache* getInstance();
+
+		Cache() noexcept;
+
+		~Cache() noexcept;
+
+		//命中时引用计数加一，没有时返回nullptr
+		Source::Ptr getSource(const std::string& path) noexcept;
+
+		//有哈希碰撞时返回其中任意一个
+		Source::Ptr getSource(HashType hashCode) noexcept;
+
+		//source->m_hashCode为0时先计算内容哈希；内容相同的Source已经存在时返回已有的，否则缓存source并返回
+		//path不为空时记录为别名，返回的Source引用计数加一
+		Source::Ptr cacheSource(const Source::Ptr& source, const std::string& path = "") noexcept;
+
+		//像素数据与宽高的FNV-1a哈希，可以在工作线程上调用
+		static HashType hashSource(const Source& source) noexcept;
+
+		size_t getSourceCount() const noexcept { return m_sources.size(); }
+
+	private:
+		//source不在缓存中时返回nullptr
+		Source::Ptr findSource(const Source* source) const noexcept;
+
+		void onSourceRelease(const EventBase::Ptr& e);
+
+	private:
+		static Cache* m_instance;
+
+		std::unordered_multimap<HashType, Source::Ptr>	m_sources{};	//内容哈希 -> Source
+		std::unordered_map<std::string, Source*>		m_paths{};		//路径 -> 缓存中的Source
+	};
+}
@@ -0,0 +1,348 @@
+#include "mipmapCache.h"
+#include "textureLoader.h"
+#include "../textures/mipChain.h"
+#include <filesystem>
+#include <iomanip>
+
+namespace ff
+{
+	namespace
+	{
+		struct Header
+		{
+			char		m_magic[4]{ 'F', 'F', 'M', 'P' };
+			uint32_t	m_version{ MipmapCache::Version };
+			uint64_t	m_key{ 0 };
+			uint64_t	m_contentHash{ 0 };	//Source::m_hashCode，加载后不必重新计算
+			uint32_t	m_width{ 0 };
+			uint32_t	m_height{ 0 };
+			uint32_t	m_channels{ 0 };
+			uint32_t	m_levels{ 0 };		//包含第0级
+		};
+
+		uint64_t fnv(uint64_t hash, const void* data, size_t size) noexcept
+		{
+			auto bytes = static_cast<const byte*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		void downsample(const byte* src, uint32_t srcWidth, uint32_t srcHeight, byte* dst, uint32_t dstWidth, uint32_t channels, uint32_t beginRow, uint32_t endRow) noexcept
+		{
+			for (uint32_t y = beginRow; y < endRow; ++y)
+			{
+				//源图像某一维为1(或为奇数的最后一行)时，重复使用边上的像素
+				uint32_t y0 = std::min(y * 2, srcHeight - 1);
+				uint32_t y1 = std::min(y * 2 + 1, srcHeight - 1);
+
+				for (uint32_t x = 0; x < dstWidth; ++x)
+				{
+					uint32_t x0 = std::min(x * 2, srcWidth - 1);
+					uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1);
+
+					const byte* p00 = src + (static_cast<size_t>(y0) * srcWidth + x0) * channels;
+					const byte* p01 = src + (static_cast<size_t>(y0) * srcWidth + x1) * channels;
+					const byte* p10 = src + (static_cast<size_t>(y1) * srcWidth + x0) * channels;
+					const byte* p11 = src + (static_cast<size_t>(y1) * srcWidth + x1) * channels;
+
+					byte* out = dst + (static_cast<size_t>(y) * dstWidth + x) * channels;
+					for (uint32_t c = 0; c < channels; ++c)
+					{
+						out[c] = static_cast<byte>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+					}
+				}
+			}
+		}
+	}
+
+	MipmapCache::MipmapCache(const std::string& directory) noexcept
+	{
+		m_directory = directory;
+
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+	}
+
+	MipmapCache::~MipmapCache() noexcept {}
+
+	HashType MipmapCache::hashFile(const std::string& path) noexcept
+	{
+		std::error_code error;
+		auto size = std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return 0;
+		}
+
+		auto time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		if (error)
+		{
+			return 0;
+		}
+
+		uint64_t hash = 14695981039346656037ull;
+		hash = fnv(hash, path.data(), path.size());
+		hash = fnv(hash, &size, sizeof(size));
+		hash = fnv(hash, &time, sizeof(time));
+
+		return static_cast<HashType>(hash);
+	}
+
+	HashType MipmapCache::makeKey(HashType sourceHash, TextureFormat format, DataType dataType) noexcept
+	{
+		uint64_t hash = 14695981039346656037ull;
+		uint32_t version = Version;
+		hash = fnv(hash, &sourceHash, sizeof(sourceHash));
+		hash = fnv(hash, &format, sizeof(format));
+		hash = fnv(hash, &dataType, sizeof(dataType));
+		hash = fnv(hash, &version, sizeof(version));
+
+		return static_cast<HashType>(hash);
+	}
+
+	void MipmapCache::buildMipmaps(Source& source, const JobSystem::Ptr& jobSystem) noexcept
+	{
+		source.m_mipmaps.clear();
+		if (source.m_width == 0 || source.m_height == 0)
+		{
+			return;
+		}
+
+		uint32_t channels = static_cast<uint32_t>(source.m_data.size() / (static_cast<size_t>(source.m_width) * source.m_height));
+
+		uint32_t width = source.m_width;
+		uint32_t height = source.m_height;
+		const byte* src = source.m_data.data();
+
+		while (width > 1 || height > 1)
+		{
+			uint32_t dstWidth = std::max(width / 2, 1u);
+			uint32_t dstHeight = std::max(height / 2, 1u);
+
+			source.m_mipmaps.emplace_back(static_cast<size_t>(dstWidth) * dstHeight * channels);
+			byte* dst = source.m_mipmaps.back().data();
+
+			auto rows = [&](uint32_t begin, uint32_t end) {
+				downsample(src, width, height, dst, dstWidth, channels, begin, end);
+			};
+
+			if (jobSystem != nullptr)
+			{
+				jobSystem->parallelFor(dstHeight, 32, rows);
+			}
+			else
+			{
+				rows(0, dstHeight);
+			}
+
+			src = dst;
+			width = dstWidth;
+			height = dstHeight;
+		}
+	}
+
+	std::string MipmapCache::getPath(HashType key) const noexcept
+	{
+		std::ostringstream name;
+		name << std::hex << std::setw(16) << std::setfill('0') << static_cast<uint64_t>(key) << ".ffmip";
+
+		return m_directory + "/" + name.str();
+	}
+
+	Source::Ptr MipmapCache::load(HashType key) noexcept
+	{
+		std::ifstream stream(getPath(key), std::ios::binary);
+		if (!stream)
+		{
+			return nullptr;
+		}
+
+		Header header;
+		stream.read(reinterpret_cast<char*>(&header), sizeof(Header));
+		if (!stream || std::memcmp(header.m_magic, "FFMP", 4) != 0 || header.m_version != Version || header.m_key != key)
+		{
+			return nullptr;
+		}
+
+		//头部的尺寸不可信，按它分配内存之前先校验：只有RGB/RGBA，必须是完整的mip链，
+		//各级的字节数合计必须与文件剩余的长度相同，损坏的文件不会引起过大的分配
+		if (header.m_width == 0 || header.m_height == 0 || (header.m_channels != 3 && header.m_channels != 4) ||
+			header.m_levels != MipChain::getLevelCount(header.m_width, header.m_height))
+		{
+			return nullptr;
+		}
+
+		uint64_t expectedBytes = 0;
+		{
+			uint64_t width = header.m_width;
+			uint64_t height = header.m_height;
+			for (uint32_t level = 0; level < header.m_levels; ++level)
+			{
+				expectedBytes += width * height * header.m_channels;
+				width = std::max<uint64_t>(width / 2, 1);
+				height = std::max<uint64_t>(height / 2, 1);
+			}
+		}
+
+		auto dataBegin = stream.tellg();
+		stream.seekg(0, std::ios::end);
+		auto fileEnd = stream.tellg();
+		stream.seekg(dataBegin);
+		if (!stream || fileEnd < dataBegin || static_cast<uint64_t>(fileEnd - dataBegin) != expectedBytes)
+		{
+			return nullptr;
+		}
+
+		auto source = Source::create();
+		source->m_width = header.m_width;
+		source->m_height = header.m_height;
+		source->m_hashCode = static_cast<HashType>(header.m_contentHash);
+		source->m_mipmaps.resize(header.m_levels - 1);
+
+		//各级依次排列，顺序读取
+		uint32_t width = header.m_width;
+		uint32_t height = header.m_height;
+		for (uint32_t level = 0; level < header.m_levels; ++level)
+		{
+			auto& data = level == 0 ? source->m_data : source->m_mipmaps[level - 1];
+			data.resize(static_cast<size_t>(width) * height * header.m_channels);
+			stream.read(reinterpret_cast<char*>(data.data()), data.size());
+
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+
+		if (!stream)
+		{
+			return nullptr;
+		}
+
+		return source;
+	}
+
+	bool MipmapCache::save(HashType key, const Source& source) noexcept
+	{
+		if (source.m_width == 0 || source.m_height == 0)
+		{
+			return false;
+		}
+
+		Header header;
+		header.m_key = key;
+		header.m_contentHash = source.m_hashCode;
+		header.m_width = source.m_width;
+		header.m_height = source.m_height;
+		header.m_channels = static_cast<uint32_t>(source.m_data.size() / (static_cast<size_t>(source.m_width) * source.m_height));
+		header.m_levels = static_cast<uint32_t>(source.m_mipmaps.size()) + 1;
+
+		auto path = getPath(key);
+		auto temp = path + "." + std::to_string(m_tempCounter++) + ".tmp";
+		{
+			std::ofstream stream(temp, std::ios::binary);
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			stream.write(reinterpret_cast<const char*>(source.m_data.data()), source.m_data.size());
+			for (const auto& level : source.m_mipmaps)
+			{
+				stream.write(reinterpret_cast<const char*>(level.data()), level.size());
+			}
+
+			if (!stream)
+			{
+				std::cout << "Error: MipmapCache failed to write " << temp << std::endl;
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp, path, error);
+		if (error)
+		{
+			std::filesystem::remove(temp, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	Source::Ptr MipmapCache::loadImage(const std::string& path, const JobSystem::Ptr& jobSystem) noexcept
+	{
+		HashType sourceHash = hashFile(path);
+		if (sourceHash == 0)
+		{
+			return nullptr;
+		}
+
+		HashType key = makeKey(sourceHash, TextureFormat::RGBA, DataType::UnsignedByteType);
+
+		auto source = load(key);
+		if (source != nullptr)
+		{
+			m_hits++;
+			return source;
+		}
+
+		m_misses++;
+
+		source = TextureLoader::decode(path);
+		if (source == nullptr)
+		{
+			return nullptr;
+		}
+
+		buildMipmaps(*source, jobSystem);
+		save(key, *source);
+
+		return source;
+	}
+
+	uint32_t MipmapCache::bake(const std::vector<std::string>& paths, const JobSystem::Ptr& jobSystem) noexcept
+	{
+		std::atomic<uint32_t> baked{ 0 };
+
+		auto bakeRange = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				HashType sourceHash = hashFile(paths[i]);
+				if (sourceHash == 0)
+				{
+					continue;
+				}
+
+				HashType key = makeKey(sourceHash, TextureFormat::RGBA, DataType::UnsignedByteType);
+				if (std::filesystem::exists(getPath(key)))
+				{
+					continue;
+				}
+
+				auto source = TextureLoader::decode(paths[i]);
+				if (source == nullptr)
+				{
+					continue;
+				}
+
+				//各图片之间已经并行，每张图片内部串行
+				buildMipmaps(*source);
+				if (save(key, *source))
+				{
+					baked++;
+				}
+			}
+		};
+
+		auto count = static_cast<uint32_t>(paths.size());
+		if (jobSystem != nullptr)
+		{
+			jobSystem->parallelFor(count, 1, bakeRange);
+		}
+		else
+		{
+			bakeRange(0, count);
+		}
+
+		return baked;
+	}
+}
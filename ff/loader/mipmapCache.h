@@ -0,0 +1,88 @@
+/**
+ * @class MipmapCache
+ * @brief 磁盘上的mipmap缓存：每张贴图一个文件，保存解码后的第0级与预先计算好的全部mip级别，加载时不再解码图片，上传时逐级直接上传。
+ *
+ * 简介：
+ * - 缓存键由来源哈希(图片文件的路径、大小与修改时间，见 hashFile)与决定mip内容的参数(像素格式、数据类型、文件版本)组成，
+ *   图片被修改后键随之变化，旧文件不再被使用；
+ * - 文件由定长文件头与各级像素数据依次排列组成，加载时从头到尾顺序读取；
+ * - mip链用2x2盒式滤波逐级生成，每一级的各行在jobSystem上并行计算；bake()在jobSystem上并行烘焙多张贴图；
+ * - 加载得到的Source在m_mipmaps中带有第1级及之后的数据，DriverTextures检测到后逐级上传，不再调用glGenerateMipmap；
+ * - 写文件时先写入临时文件再改名，多个线程或进程同时烘焙同一张贴图也不会读到不完整的文件。
+ *
+ * 使用示例：
+ * @code
+ * auto mipmaps = ff::MipmapCache::create("cache/mipmaps");
+ * mipmaps->bake(paths, jobSystem);                        // 离线或首次运行
+ *
+ * auto texture = ff::TextureLoader::load("assets/textures/box.png", mipmaps);
+ * loader->setMipmapCache(mipmaps);                        // 异步加载同样使用缓存
+ * @endcode
+ *
+ * 限制与注意：
+ * - 只支持每通道8位的图片(TextureLoader解码得到的RGBA8)；
+ * - 环绕与过滤方式在采样时才起作用，不影响盒式滤波的结果，所以不参与缓存键；
+ * - 缓存目录不会自动清理，修改过的图片的旧缓存文件需要手动删除；
+ * - 文件按本机字节序存放，版本号不一致、或头部与数据长度不符的文件视为未命中。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../textures/source.h"
+#include "../tools/jobSystem.h"
+#include <atomic>
+
+namespace ff
+{
+	class MipmapCache
+	{
+	public:
+		//文件格式或滤波方式发生任何变化时加一
+		static constexpr uint32_t Version = 1;
+
+		using Ptr = std::shared_ptr<MipmapCache>;
+		static Ptr create(const std::string& directory)
+		{
+			return std::make_shared<MipmapCache>(directory);
+		}
+
+		MipmapCache(const std::string& directory) noexcept;
+
+		~MipmapCache() noexcept;
+
+		//图片文件的路径、大小与修改时间的哈希，文件不存在时返回0
+		static HashType hashFile(const std::string& path) noexcept;
+
+		static HashType makeKey(HashType sourceHash, TextureFormat format, DataType dataType) noexcept;
+
+		//在source上生成第1级到1x1的各级mipmap，jobSystem不为空时每一级按行并行
+		static void buildMipmaps(Source& source, const JobSystem::Ptr& jobSystem = nullptr) noexcept;
+
+		//未命中或文件损坏时返回nullptr
+		Source::Ptr load(HashType key) noexcept;
+
+		bool save(HashType key, const Source& source) noexcept;
+
+		//先查缓存，未命中时解码图片、生成mipmap并写入缓存，失败时返回nullptr；可以在工作线程上调用
+		Source::Ptr loadImage(const std::string& path, const JobSystem::Ptr& jobSystem = nullptr) noexcept;
+
+		//烘焙所有还没有缓存的图片，各图片在jobSystem上并行，返回新烘焙的数量
+		uint32_t bake(const std::vector<std::string>& paths, const JobSystem::Ptr& jobSystem) noexcept;
+
+		std::string getPath(HashType key) const noexcept;
+
+		uint32_t getHits() const noexcept { return m_hits; }
+
+		uint32_t getMisses() const noexcept { return m_misses; }
+
+	private:
+		std::string				m_directory{};
+
+		std::atomic<uint32_t>	m_hits{ 0 };
+		std::atomic<uint32_t>	m_misses{ 0 };
+		std::atomic<uint32_t>	m_tempCounter{ 0 };
+	};
+}
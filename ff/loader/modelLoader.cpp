@@ -0,0 +1,535 @@
+#include "modelLoader.h"
+#include "../objects/group.h"
+#include "../objects/mesh.h"
+#include "../objects/skinnedMesh.h"
+#include "../objects/skeleton.h"
+#include "../objects/bone.h"
+#include "../material/meshPhongMaterial.h"
+#include "../textures/texture.h"
+#include "../tools/timer.h"
+#include "cache.h"
+#include "textureLoader.h"
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <array>
+#include <unordered_set>
+
+namespace ff
+{
+	namespace
+	{
+		//一张需要解码的贴图，m_key为去重用的键：外部文件为完整路径，内嵌贴图为其在aiScene中的名字
+		struct Image
+		{
+			std::string			m_key{};
+			const aiTexture*	m_embedded{ nullptr };
+			Source::Ptr			m_source{ nullptr };
+		};
+
+		//aiMatrix4x4按行存放，glm按列存放
+		glm::mat4 toGLM(const aiMatrix4x4& matrix) noexcept
+		{
+			return glm::transpose(glm::make_mat4(&matrix.a1));
+		}
+
+		std::string resolvePath(const std::string& directory, const std::string& path) noexcept
+		{
+			std::string result = path;
+			std::replace(result.begin(), result.end(), '\\', '/');
+
+			bool absolute = !result.empty() && (result[0] == '/' || (result.size() > 1 && result[1] == ':'));
+			if (absolute || directory.empty())
+			{
+				return result;
+			}
+
+			return directory + "/" + result;
+		}
+
+		//在工作线程上执行，失败时m_source保持为空
+		void decodeImage(Image& image) noexcept
+		{
+			if (image.m_embedded == nullptr)
+			{
+				image.m_source = TextureLoader::decode(image.m_key);
+			}
+			else if (image.m_embedded->mHeight == 0)
+			{
+				//mHeight为0时是压缩格式(png/jpg等)的原始文件数据，mWidth为字节数
+				image.m_source = TextureLoader::decode(reinterpret_cast<const byte*>(image.m_embedded->pcData), image.m_embedded->mWidth);
+			}
+			else
+			{
+				//未压缩的内嵌贴图按BGRA存放
+				auto source = Source::create();
+				source->m_width = image.m_embedded->mWidth;
+				source->m_height = image.m_embedded->mHeight;
+				source->m_data.resize(static_cast<size_t>(source->m_width) * source->m_height * 4);
+
+				for (size_t i = 0; i < static_cast<size_t>(source->m_width) * source->m_height; ++i)
+				{
+					const auto& texel = image.m_embedded->pcData[i];
+					source->m_data[i * 4 + 0] = texel.r;
+					source->m_data[i * 4 + 1] = texel.g;
+					source->m_data[i * 4 + 2] = texel.b;
+					source->m_data[i * 4 + 3] = texel.a;
+				}
+
+				source->m_hashCode = Cache::hashSource(*source);
+				image.m_source = source;
+			}
+		}
+
+		//在工作线程上执行，只读取aiMesh，不是三角形的网格返回nullptr
+		Geometry::Ptr convertMesh(const aiMesh* mesh) noexcept
+		{
+			if (!(mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) || mesh->mNumVertices == 0)
+			{
+				return nullptr;
+			}
+
+			uint32_t vertexCount = mesh->mNumVertices;
+
+			std::vector<float> positions(static_cast<size_t>(vertexCount) * 3);
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				positions[i * 3 + 0] = mesh->mVertices[i].x;
+				positions[i * 3 + 1] = mesh->mVertices[i].y;
+				positions[i * 3 + 2] = mesh->mVertices[i].z;
+			}
+
+			std::vector<float> normals;
+			if (mesh->HasNormals())
+			{
+				normals.resize(static_cast<size_t>(vertexCount) * 3);
+				for (uint32_t i = 0; i < vertexCount; ++i)
+				{
+					normals[i * 3 + 0] = mesh->mNormals[i].x;
+					normals[i * 3 + 1] = mesh->mNormals[i].y;
+					normals[i * 3 + 2] = mesh->mNormals[i].z;
+				}
+			}
+
+			std::vector<float> uvs;
+			if (mesh->HasTextureCoords(0))
+			{
+				uvs.resize(static_cast<size_t>(vertexCount) * 2);
+				for (uint32_t i = 0; i < vertexCount; ++i)
+				{
+					uvs[i * 2 + 0] = mesh->mTextureCoords[0][i].x;
+					uvs[i * 2 + 1] = mesh->mTextureCoords[0][i].y;
+				}
+			}
+
+			std::vector<uint32_t> indices;
+			indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
+			for (uint32_t i = 0; i < mesh->mNumFaces; ++i)
+			{
+				const auto& face = mesh->mFaces[i];
+				if (face.mNumIndices == 3)
+				{
+					indices.insert(indices.end(), { face.mIndices[0], face.mIndices[1], face.mIndices[2] });
+				}
+			}
+
+			//每个顶点最多受4根骨骼影响，skinIndex为骨骼在本aiMesh的mBones中的下标
+			std::vector<float> skinIndices;
+			std::vector<float> skinWeights;
+			if (mesh->HasBones())
+			{
+				skinIndices.resize(static_cast<size_t>(vertexCount) * 4, 0.0f);
+				skinWeights.resize(static_cast<size_t>(vertexCount) * 4, 0.0f);
+				std::vector<uint8_t> influences(vertexCount, 0);
+
+				for (uint32_t b = 0; b < mesh->mNumBones; ++b)
+				{
+					const auto bone = mesh->mBones[b];
+					for (uint32_t w = 0; w < bone->mNumWeights; ++w)
+					{
+						const auto& weight = bone->mWeights[w];
+						if (weight.mVertexId >= vertexCount || influences[weight.mVertexId] >= 4)
+						{
+							continue;
+						}
+
+						size_t slot = static_cast<size_t>(weight.mVertexId) * 4 + influences[weight.mVertexId]++;
+						skinIndices[slot] = static_cast<float>(b);
+						skinWeights[slot] = weight.mWeight;
+					}
+				}
+
+				//丢弃了部分影响的顶点，权重重新归一化
+				for (uint32_t i = 0; i < vertexCount; ++i)
+				{
+					float* weights = &skinWeights[static_cast<size_t>(i) * 4];
+					float sum = weights[0] + weights[1] + weights[2] + weights[3];
+					if (sum > 0.0f)
+					{
+						for (uint32_t k = 0; k < 4; ++k)
+						{
+							weights[k] /= sum;
+						}
+					}
+				}
+			}
+
+			auto geometry = Geometry::create();
+			geometry->setAttribute("position", Attributef::create(std::move(positions), 3));
+			if (!normals.empty()) geometry->setAttribute("normal", Attributef::create(std::move(normals), 3));
+			if (!uvs.empty()) geometry->setAttribute("uv", Attributef::create(std::move(uvs), 2));
+			if (!skinIndices.empty())
+			{
+				geometry->setAttribute("skinIndex", Attributef::create(std::move(skinIndices), 4));
+				geometry->setAttribute("skinWeight", Attributef::create(std::move(skinWeights), 4));
+			}
+			geometry->setIndex(Attributei::create(std::move(indices), 1));
+			geometry->computeBoundingSphere();
+
+			return geometry;
+		}
+
+		void runParallel(const JobSystem::Ptr& jobSystem, uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& func) noexcept
+		{
+			if (jobSystem != nullptr)
+			{
+				jobSystem->parallelFor(count, 1, func);
+			}
+			else
+			{
+				func(0, count);
+			}
+		}
+	}
+
+	Object3D::Ptr ModelLoader::load(const std::string& path, const JobSystem::Ptr& jobSystem, Stats* stats) noexcept
+	{
+		Timer timer;
+		timer.reset();
+
+		Assimp::Importer importer;
+		const aiScene* scene = importer.ReadFile(
+			path,
+			aiProcess_Triangulate |
+			aiProcess_JoinIdenticalVertices |
+			aiProcess_GenSmoothNormals |
+			aiProcess_FlipUVs |
+			aiProcess_LimitBoneWeights |
+			aiProcess_SortByPType);
+
+		if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || scene->mRootNode == nullptr)
+		{
+			std::cout << "Error: ModelLoader failed to import " << path << ": " << importer.GetErrorString() << std::endl;
+			return nullptr;
+		}
+
+		double importMs = timer.elapsed_micro() / 1000.0;
+
+		auto separator = path.find_last_of("/\\");
+		std::string directory = separator == std::string::npos ? std::string() : path.substr(0, separator);
+
+		auto model = load(scene, directory, jobSystem, stats);
+		if (stats != nullptr)
+		{
+			stats->m_importMs = importMs;
+			stats->m_totalMs += importMs;
+		}
+
+		return model;
+	}
+
+	Object3D::Ptr ModelLoader::load(const aiScene* scene, const std::string& directory, const JobSystem::Ptr& jobSystem, Stats* stats) noexcept
+	{
+		if (scene == nullptr || scene->mRootNode == nullptr)
+		{
+			return nullptr;
+		}
+
+		Stats localStats;
+		Stats& result = stats != nullptr ? *stats : localStats;
+		result = Stats{};
+
+		Timer timer;
+
+		//1 收集材质引用的贴图，按键去重后并行解码
+		timer.reset();
+
+		static const aiTextureType textureTypes[] = { aiTextureType_DIFFUSE, aiTextureType_NORMALS, aiTextureType_SPECULAR };
+
+		std::vector<Image> images;
+		std::unordered_map<std::string, uint32_t> keyToImage;
+
+		//每个材质每种贴图在images中的下标，-1表示没有
+		std::vector<std::array<int32_t, 3>> materialImages(scene->mNumMaterials);
+
+		for (uint32_t m = 0; m < scene->mNumMaterials; ++m)
+		{
+			const auto material = scene->mMaterials[m];
+			for (uint32_t t = 0; t < 3; ++t)
+			{
+				materialImages[m][t] = -1;
+
+				aiString name;
+				auto type = textureTypes[t];
+
+				//obj等格式把法线贴图记为高度贴图
+				if (type == aiTextureType_NORMALS && material->GetTextureCount(type) == 0)
+				{
+					type = aiTextureType_HEIGHT;
+				}
+
+				if (material->GetTextureCount(type) == 0 || material->GetTexture(type, 0, &name) != AI_SUCCESS)
+				{
+					continue;
+				}
+
+				result.m_textureRefs++;
+
+				const aiTexture* embedded = scene->GetEmbeddedTexture(name.C_Str());
+				std::string key = embedded != nullptr ? std::string(name.C_Str()) : resolvePath(directory, name.C_Str());
+
+				auto iter = keyToImage.find(key);
+				if (iter == keyToImage.end())
+				{
+					iter = keyToImage.emplace(key, static_cast<uint32_t>(images.size())).first;
+					images.push_back({ key, embedded, nullptr });
+				}
+
+				materialImages[m][t] = static_cast<int32_t>(iter->second);
+			}
+		}
+
+		//之前加载过的外部贴图直接从缓存中取得
+		auto cache = Cache::getInstance();
+		std::vector<uint32_t> decodes;
+		for (uint32_t i = 0; i < images.size(); ++i)
+		{
+			images[i].m_source = images[i].m_embedded == nullptr ? cache->getSource(images[i].m_key) : nullptr;
+			if (images[i].m_source == nullptr)
+			{
+				decodes.push_back(i);
+			}
+		}
+
+		runParallel(jobSystem, static_cast<uint32_t>(decodes.size()), [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				decodeImage(images[decodes[i]]);
+			}
+		});
+
+		for (auto i : decodes)
+		{
+			auto& image = images[i];
+			if (image.m_source == nullptr)
+			{
+				std::cout << "Error: ModelLoader failed to load texture " << image.m_key << std::endl;
+				continue;
+			}
+
+			//内嵌贴图的名字("*0"等)只在本模型内有效，只按内容共享
+			image.m_source = cache->cacheSource(image.m_source, image.m_embedded == nullptr ? image.m_key : std::string());
+			result.m_textures++;
+		}
+
+		std::vector<Texture::Ptr> textures(images.size(), nullptr);
+		for (uint32_t i = 0; i < images.size(); ++i)
+		{
+			const auto& source = images[i].m_source;
+			if (source != nullptr)
+			{
+				textures[i] = Texture::create(source->m_width, source->m_height);
+				textures[i]->m_source = source;
+			}
+		}
+
+		result.m_textureMs = timer.elapsed_micro() / 1000.0;
+
+		//2 每个aiMesh并行转换为一个Geometry，Geometry/Attribute析构时会派发事件，所以结果都交回主线程持有
+		timer.reset();
+
+		std::vector<Geometry::Ptr> geometries(scene->mNumMeshes, nullptr);
+		runParallel(jobSystem, scene->mNumMeshes, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				geometries[i] = convertMesh(scene->mMeshes[i]);
+			}
+		});
+
+		for (const auto& geometry : geometries)
+		{
+			if (geometry != nullptr)
+			{
+				result.m_meshes++;
+				result.m_vertices += geometry->getAttribute("position")->getCount();
+				result.m_triangles += geometry->getIndex()->getCount() / 3;
+			}
+		}
+
+		result.m_meshMs = timer.elapsed_micro() / 1000.0;
+
+		//3 材质、节点树与Skeleton
+		timer.reset();
+
+		std::vector<Material::Ptr> materials(scene->mNumMaterials, nullptr);
+		for (uint32_t m = 0; m < scene->mNumMaterials; ++m)
+		{
+			const auto source = scene->mMaterials[m];
+			auto material = MeshPhongMaterial::create();
+
+			float shininess = 0.0f;
+			if (source->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS && shininess > 0.0f)
+			{
+				material->mShininess = shininess;
+			}
+
+			float opacity = 1.0f;
+			if (source->Get(AI_MATKEY_OPACITY, opacity) == AI_SUCCESS && opacity < 1.0f)
+			{
+				material->m_opacity = opacity;
+				material->m_transparent = true;
+			}
+
+			auto textureOf = [&](uint32_t t) {
+				return materialImages[m][t] < 0 ? nullptr : textures[materialImages[m][t]];
+			};
+
+			material->m_diffuseMap = textureOf(0);
+			material->m_normalMap = textureOf(1);
+			material->m_specularMap = textureOf(2);
+
+			materials[m] = material;
+		}
+
+		//模型含有骨骼时，每个aiNode都是一个Bone，骨骼之间的父子关系才能在Bone::updateWorldMatrix中传递
+		bool hasBones = false;
+		for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+		{
+			hasBones = hasBones || (geometries[i] != nullptr && scene->mMeshes[i]->HasBones());
+		}
+
+		std::unordered_map<std::string, Bone::Ptr> nameToBone;
+		std::vector<std::pair<SkinnedMesh::Ptr, uint32_t>> skinnedMeshes;
+
+		Object3D::Ptr root = nullptr;
+		std::vector<std::pair<const aiNode*, Object3D::Ptr>> stack{ { scene->mRootNode, nullptr } };
+		while (!stack.empty())
+		{
+			auto node = stack.back().first;
+			auto parent = stack.back().second;
+			stack.pop_back();
+
+			result.m_nodes++;
+
+			Object3D::Ptr object = nullptr;
+			glm::mat4 matrix = toGLM(node->mTransformation);
+			if (hasBones)
+			{
+				auto bone = Bone::create();
+				bone->mNodeMatrix = matrix;
+				nameToBone[node->mName.C_Str()] = bone;
+				object = bone;
+			}
+			else
+			{
+				glm::vec3 scale, translation, skew;
+				glm::quat rotation;
+				glm::vec4 perspective;
+				glm::decompose(matrix, scale, rotation, translation, skew, perspective);
+
+				object = std::make_shared<Group>();
+				object->setPosition(translation);
+				object->setQuaternion(rotation.x, rotation.y, rotation.z, rotation.w);
+				object->setScale(scale.x, scale.y, scale.z);
+			}
+
+			object->m_name = node->mName.C_Str();
+
+			if (parent != nullptr)
+			{
+				parent->addChild(object);
+			}
+			else
+			{
+				root = object;
+			}
+
+			for (uint32_t i = 0; i < node->mNumMeshes; ++i)
+			{
+				uint32_t index = node->mMeshes[i];
+				const auto& geometry = geometries[index];
+				if (geometry == nullptr)
+				{
+					continue;
+				}
+
+				const auto source = scene->mMeshes[index];
+				auto material = source->mMaterialIndex < materials.size() ? materials[source->mMaterialIndex] : nullptr;
+				if (material == nullptr)
+				{
+					material = MeshPhongMaterial::create();
+				}
+
+				RenderableObject::Ptr mesh = nullptr;
+				if (source->HasBones())
+				{
+					auto skinnedMesh = SkinnedMesh::create(geometry, material);
+					skinnedMeshes.emplace_back(skinnedMesh, index);
+					mesh = skinnedMesh;
+				}
+				else
+				{
+					mesh = Mesh::create(geometry, material);
+				}
+
+				mesh->m_name = source->mName.C_Str();
+				object->addChild(mesh);
+			}
+
+			//逆序入栈，保持子节点的原有顺序
+			for (uint32_t i = node->mNumChildren; i > 0; --i)
+			{
+				stack.emplace_back(node->mChildren[i - 1], object);
+			}
+		}
+
+		//每个带骨骼的aiMesh一个Skeleton，引用同一个aiMesh的SkinnedMesh共享
+		std::unordered_map<uint32_t, Skeleton::Ptr> skeletons;
+		std::unordered_set<std::string> boneNames;
+		for (const auto& item : skinnedMeshes)
+		{
+			auto& skeleton = skeletons[item.second];
+			if (skeleton == nullptr)
+			{
+				const auto source = scene->mMeshes[item.second];
+
+				std::vector<Bone::Ptr> bones;
+				std::vector<glm::mat4> offsetMatrices;
+				for (uint32_t b = 0; b < source->mNumBones; ++b)
+				{
+					const auto bone = source->mBones[b];
+					auto iter = nameToBone.find(bone->mName.C_Str());
+					if (iter == nameToBone.end())
+					{
+						std::cout << "Warning: ModelLoader found no node for bone " << bone->mName.C_Str() << std::endl;
+					}
+
+					//找不到节点的骨骼仍然占一个位置，保持skinIndex与下标一致
+					bones.push_back(iter != nameToBone.end() ? iter->second : Bone::create());
+					offsetMatrices.push_back(toGLM(bone->mOffsetMatrix));
+					boneNames.insert(bone->mName.C_Str());
+				}
+
+				skeleton = Skeleton::create(bones, offsetMatrices);
+			}
+
+			item.first->bind(skeleton);
+		}
+
+		result.m_bones = static_cast<uint32_t>(boneNames.size());
+		result.m_sceneMs = timer.elapsed_micro() / 1000.0;
+		result.m_totalMs = result.m_textureMs + result.m_meshMs + result.m_sceneMs;
+
+		return root;
+	}
+}
@@ -0,0 +1,70 @@
+/**
+ * @class ModelLoader
+ * @brief 基于Assimp的模型加载器：把aiScene转换为由Group/Bone、Mesh/SkinnedMesh与Skeleton组成的Object3D树。
+ *
+ * 简介：
+ * - 每个aiNode对应一个节点：模型含有骨骼时每个aiNode都是一个Bone(其变换存放在mNodeMatrix中)，否则是Group；
+ *   节点引用的每个aiMesh作为其子节点，挂接为Mesh，带骨骼权重的aiMesh挂接为SkinnedMesh并绑定Skeleton；
+ * - aiMesh到Geometry的转换(position/normal/uv/skinIndex/skinWeight、index与包围体)在jobSystem上并行执行，
+ *   每个aiMesh只转换一次，被多个节点引用时共享同一个Geometry，顶点数组以移动的方式交给Attribute，不再拷贝；
+ * - 材质统一转换为MeshPhongMaterial，贴图按路径去重，同一张图片只解码一次，所有引用它的材质共享同一个Texture；
+ *   贴图的解码同样在jobSystem上并行执行，支持外部文件与模型内嵌的贴图；
+ *   解码结果放入 ff::Cache，之后加载的模型引用同一张图片时直接共享；
+ * - 每个阶段(导入、网格转换、贴图解码、材质与节点树的构建)的耗时记录在Stats中。
+ *
+ * 使用示例：
+ * @code
+ * ff::ModelLoader::Stats stats;
+ * auto model = ff::ModelLoader::load("assets/models/robot/robot.fbx", jobSystem, &stats);   // 失败时返回nullptr
+ * scene->addChild(model);
+ *
+ * std::cout << "meshes " << stats.m_meshMs << " ms, textures " << stats.m_textureMs << " ms" << std::endl;
+ * @endcode
+ *
+ * 限制与注意：
+ * - 导入时做三角化、合并重复顶点、生成缺失的法线、翻转uv，并把每个顶点的骨骼影响限制为4个，点与线图元被忽略；
+ * - 只读取第一套uv，以及漫反射、法线与高光贴图，贴图解码为RGBA8；
+ * - 每个带骨骼的aiMesh拥有自己的Skeleton，骨骼按名字与节点对应，找不到对应节点的骨骼会打印警告，并以一个不挂接的Bone占位；
+ * - 动画数据不会被读取；
+ * - 必须在主线程上调用，jobSystem为nullptr时所有工作都在调用线程上串行执行。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../core/object3D.h"
+#include "../tools/jobSystem.h"
+
+struct aiScene;
+
+namespace ff
+{
+	class ModelLoader
+	{
+	public:
+		//各阶段耗时(毫秒)与转换结果的规模
+		struct Stats
+		{
+			double		m_importMs{ 0.0 };		//Assimp读取文件与后处理
+			double		m_meshMs{ 0.0 };		//aiMesh转换为Geometry
+			double		m_textureMs{ 0.0 };		//贴图读取与解码
+			double		m_sceneMs{ 0.0 };		//材质、节点树与Skeleton的构建
+			double		m_totalMs{ 0.0 };
+
+			uint32_t	m_meshes{ 0 };
+			uint32_t	m_vertices{ 0 };
+			uint32_t	m_triangles{ 0 };
+			uint32_t	m_nodes{ 0 };
+			uint32_t	m_bones{ 0 };
+			uint32_t	m_textures{ 0 };		//实际解码的贴图数(不含缓存命中)
+			uint32_t	m_textureRefs{ 0 };		//材质对贴图的引用数，大于m_textures的部分由去重节省
+		};
+
+		static Object3D::Ptr load(const std::string& path, const JobSystem::Ptr& jobSystem = nullptr, Stats* stats = nullptr) noexcept;
+
+		//转换已经导入的aiScene，外部贴图的相对路径以directory为根目录
+		static Object3D::Ptr load(const aiScene* scene, const std::string& directory, const JobSystem::Ptr& jobSystem = nullptr, Stats* stats = nullptr) noexcept;
+	};
+}
@@ -0,0 +1,214 @@
+#include "textureLoader.h"
+#include "cache.h"
+#include <stb_image.h>
+
+namespace ff
+{
+	namespace
+	{
+		Source::Ptr toSource(stbi_uc* pixels, int width, int height) noexcept
+		{
+			if (pixels == nullptr)
+			{
+				return nullptr;
+			}
+
+			auto source = Source::create();
+			source->m_width = static_cast<uint32_t>(width);
+			source->m_height = static_cast<uint32_t>(height);
+			source->m_data.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+			stbi_image_free(pixels);
+
+			source->m_hashCode = Cache::hashSource(*source);
+
+			return source;
+		}
+	}
+
+	TextureLoader::TextureLoader(const JobSystem::Ptr& jobSystem) noexcept
+	{
+		m_jobSystem = jobSystem;
+
+		m_placeholder = Source::create();
+		m_placeholder->m_width = 1;
+		m_placeholder->m_height = 1;
+		m_placeholder->m_data = { 255, 255, 255, 255 };
+	}
+
+	TextureLoader::~TextureLoader() noexcept
+	{
+		//任务中引用了this，必须等它们全部结束
+		if (m_jobSystem != nullptr)
+		{
+			m_jobSystem->wait(m_group);
+		}
+	}
+
+	Source::Ptr TextureLoader::decode(const std::string& path) noexcept
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+		return toSource(pixels, width, height);
+	}
+
+	Source::Ptr TextureLoader::decode(const byte* data, size_t size) noexcept
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha);
+
+		return toSource(pixels, width, height);
+	}
+
+	Texture::Ptr TextureLoader::load(const std::string& path, const MipmapCache::Ptr& mipmapCache) noexcept
+	{
+		auto cache = Cache::getInstance();
+
+		auto source = cache->getSource(path);
+		if (source == nullptr)
+		{
+			auto decoded = mipmapCache != nullptr ? mipmapCache->loadImage(path) : decode(path);
+			if (decoded == nullptr)
+			{
+				std::cout << "Error: TextureLoader failed to load " << path << std::endl;
+				return nullptr;
+			}
+
+			source = cache->cacheSource(decoded, path);
+		}
+
+		auto texture = Texture::create(source->m_width, source->m_height);
+		texture->m_source = source;
+
+		return texture;
+	}
+
+	Texture::Ptr TextureLoader::loadAsync(const std::string& path) noexcept
+	{
+		m_stats.m_requests++;
+
+		//已经在缓存中，直接使用
+		auto source = Cache::getInstance()->getSource(path);
+		if (source != nullptr)
+		{
+			m_stats.m_cacheHits++;
+
+			auto texture = Texture::create(source->m_width, source->m_height);
+			texture->m_source = source;
+			return texture;
+		}
+
+		auto texture = Texture::create(m_placeholder->m_width, m_placeholder->m_height);
+		texture->m_source = m_placeholder;
+
+		//正在解码，等待同一个结果
+		auto iter = m_requests.find(path);
+		if (iter != m_requests.end())
+		{
+			m_stats.m_cacheHits++;
+			iter->second.m_textures.push_back(texture);
+			return texture;
+		}
+
+		m_requests[path].m_textures.push_back(texture);
+
+		//任务只引用路径与解码结果，纹理留在渲染线程上
+		auto job = [this, path, mipmapCache = m_mipmapCache]() {
+			Result result;
+			result.m_path = path;
+			result.m_source = mipmapCache != nullptr ? mipmapCache->loadImage(path) : decode(path);
+
+			//内容哈希在工作线程上算好，交付时不再遍历像素
+			if (result.m_source != nullptr && result.m_source->m_hashCode == 0)
+			{
+				result.m_source->m_hashCode = Cache::hashSource(*result.m_source);
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_finished.push_back(std::move(result));
+		};
+
+		if (m_jobSystem != nullptr)
+		{
+			m_jobSystem->execute(job, m_group);
+		}
+		else
+		{
+			job();
+		}
+
+		return texture;
+	}
+
+	uint32_t TextureLoader::update(uint32_t maxCount) noexcept
+	{
+		//没有工作线程时任务只会在wait中执行
+		if (m_jobSystem != nullptr && m_jobSystem->getThreadCount() <= 1)
+		{
+			m_jobSystem->wait(m_group);
+		}
+
+		std::vector<Result> finished;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			while (!m_finished.empty() && finished.size() < maxCount)
+			{
+				finished.push_back(std::move(m_finished.front()));
+				m_finished.pop_front();
+			}
+		}
+
+		uint32_t delivered = 0;
+		for (const auto& result : finished)
+		{
+			auto iter = m_requests.find(result.m_path);
+			if (iter == m_requests.end())
+			{
+				continue;
+			}
+
+			Request request = std::move(iter->second);
+			m_requests.erase(iter);
+
+			deliver(result.m_path, request, result.m_source);
+			delivered += result.m_source != nullptr ? static_cast<uint32_t>(request.m_textures.size()) : 0;
+		}
+
+		return delivered;
+	}
+
+	void TextureLoader::deliver(const std::string& path, const Request& request, const Source::Ptr& source) noexcept
+	{
+		if (source == nullptr)
+		{
+			m_stats.m_failed++;
+			std::cout << "Error: TextureLoader failed to load " << path << std::endl;
+			return;
+		}
+
+		m_stats.m_decoded++;
+
+		//每个Texture各持有一次引用；内容与缓存中已有的图片相同时，使用已有的Source
+		auto cache = Cache::getInstance();
+		for (const auto& texture : request.m_textures)
+		{
+			auto cached = cache->cacheSource(source, path);
+
+			texture->m_source = cached;
+			texture->m_width = cached->m_width;
+			texture->m_height = cached->m_height;
+			texture->m_needUpdate = true;
+		}
+
+		if (request.m_textures.front()->m_source != source)
+		{
+			m_stats.m_shared++;
+		}
+
+		m_stats.m_delivered += static_cast<uint32_t>(request.m_textures.size());
+	}
+}
@@ -0,0 +1,122 @@
+/**
+ * @class TextureLoader
+ * @brief 图片加载器：用stb_image把图片解码为RGBA8的Source，支持同步加载与在JobSystem上异步解码，解码结果经由 ff::Cache 共享。
+ *
+ * 简介：
+ * - load(path)同步加载，缓存中已有该路径(或内容相同)的图片时不再解码；
+ * - loadAsync(path)立即返回一张Texture，此时它引用一个1x1的白色占位图，可以直接交给材质使用，不阻塞首帧；
+ *   图片在jobSystem的工作线程上读取、解码并计算内容哈希，完成后放入完成队列；
+ * - 渲染线程每帧调用update()，把解码完成的Source放入缓存并交给对应的Texture，同时置m_needUpdate，
+ *   下一次绘制时由DriverTextures按新尺寸重新上传；maxCount限制每帧交付的数量，把上传分摊到多帧；
+ * - 同一路径在解码期间被多次请求时只解码一次，所有请求得到的Texture共享同一个Source；
+ * - 设置了 ff::MipmapCache 时，工作线程直接读取缓存中带完整mip链的图片，未命中时解码并写入缓存。
+ *
+ * 使用示例：
+ * @code
+ * auto loader = ff::TextureLoader::create(jobSystem);
+ * material->m_diffuseMap = loader->loadAsync("assets/textures/box.png");
+ *
+ * while (running)
+ * {
+ *     loader->update(16);   // 每帧最多交付16张
+ *     renderer->render(scene, camera);
+ * }
+ * @endcode
+ *
+ * 限制与注意：
+ * - loadAsync与update只能在渲染线程上调用；
+ * - 解码失败的纹理保持占位图，并在update时打印错误；
+ * - jobSystem为nullptr时loadAsync直接在调用线程上解码，结果仍然在update时交付；
+ *   jobSystem没有工作线程(threadCount <= 1)时，解码在update中执行；
+ * - 在同一个jobSystem上调用parallelFor/wait的线程也可能执行到解码任务；
+ * - 析构时等待所有未完成的解码。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../textures/texture.h"
+#include "../tools/jobSystem.h"
+#include "mipmapCache.h"
+
+namespace ff
+{
+	class TextureLoader
+	{
+	public:
+		struct Stats
+		{
+			uint32_t	m_requests{ 0 };	//loadAsync的调用次数
+			uint32_t	m_cacheHits{ 0 };	//路径已在缓存或正在解码，没有发起新的解码
+			uint32_t	m_decoded{ 0 };		//解码完成的图片数
+			uint32_t	m_shared{ 0 };		//路径不同但内容与缓存中已有图片相同的图片数
+			uint32_t	m_failed{ 0 };
+			uint32_t	m_delivered{ 0 };	//已经交付的Texture数
+		};
+
+		using Ptr = std::shared_ptr<TextureLoader>;
+		static Ptr create(const JobSystem::Ptr& jobSystem)
+		{
+			return std::make_shared<TextureLoader>(jobSystem);
+		}
+
+		TextureLoader(const JobSystem::Ptr& jobSystem) noexcept;
+
+		~TextureLoader() noexcept;
+
+		//同步加载，失败时返回nullptr；mipmapCache不为空时优先从中读取带完整mip链的图片
+		static Texture::Ptr load(const std::string& path, const MipmapCache::Ptr& mipmapCache = nullptr) noexcept;
+
+		//解码图片文件或内存中的图片文件数据为RGBA8，m_hashCode为内容哈希，失败时返回nullptr；可以在工作线程上调用
+		static Source::Ptr decode(const std::string& path) noexcept;
+
+		static Source::Ptr decode(const byte* data, size_t size) noexcept;
+
+		Texture::Ptr loadAsync(const std::string& path) noexcept;
+
+		//交付最多maxCount个解码完成的请求，返回本次交付的Texture数
+		uint32_t update(uint32_t maxCount = UINT32_MAX) noexcept;
+
+		//尚未交付的请求数(包括解码中与已完成等待交付的)
+		uint32_t getPendingCount() const noexcept { return static_cast<uint32_t>(m_requests.size()); }
+
+		const Stats& getStats() const noexcept { return m_stats; }
+
+		//之后的异步请求在工作线程上通过mipmapCache加载
+		void setMipmapCache(const MipmapCache::Ptr& mipmapCache) noexcept { m_mipmapCache = mipmapCache; }
+
+	private:
+		//等待同一次解码的所有纹理，只在渲染线程上访问
+		struct Request
+		{
+			std::vector<Texture::Ptr>	m_textures{};
+		};
+
+		//工作线程的解码结果，不持有任何Texture，工作线程上不会析构纹理
+		struct Result
+		{
+			std::string		m_path{};
+			Source::Ptr		m_source{ nullptr };
+		};
+
+		void deliver(const std::string& path, const Request& request, const Source::Ptr& source) noexcept;
+
+	private:
+		JobSystem::Ptr			m_jobSystem{ nullptr };
+		MipmapCache::Ptr		m_mipmapCache{ nullptr };
+		JobSystem::WaitGroup	m_group{};
+
+		//路径 -> 解码中或等待交付的请求，只在渲染线程上访问
+		std::unordered_map<std::string, Request>	m_requests{};
+
+		//工作线程完成解码后放入，update时取出
+		std::mutex						m_mutex;
+		std::deque<Result>				m_finished{};
+
+		Source::Ptr						m_placeholder{ nullptr };
+
+		Stats							m_stats{};
+	};
+}
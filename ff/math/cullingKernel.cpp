@@ -0,0 +1,388 @@
+#include "cullingKernel.h"
+
+#if defined(__AVX__)
+#define FF_CULLING_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FF_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+namespace ff
+{
+	//把最多8位的结果写入位图的index处，可能跨越两个word
+	static inline void writeMask(uint64_t* bits, uint32_t index, uint32_t mask) noexcept
+	{
+		if (mask == 0)
+		{
+			return;
+		}
+
+		uint32_t word = index >> 6;
+		uint32_t shift = index & 63;
+
+		bits[word] |= static_cast<uint64_t>(mask) << shift;
+		if (shift > 56 && (mask >> (64 - shift)) != 0)
+		{
+			bits[word + 1] |= static_cast<uint64_t>(mask) >> (64 - shift);
+		}
+	}
+
+	static inline uint32_t countBits(uint32_t value) noexcept
+	{
+		value = value - ((value >> 1) & 0x55555555u);
+		value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+		return (((value + (value >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+	}
+
+	//把planeMask展开为需要测试的平面列表
+	static inline uint32_t collectPlanes(uint32_t planeMask, uint32_t* indices) noexcept
+	{
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			if (planeMask & (1u << i))
+			{
+				indices[count++] = i;
+			}
+		}
+
+		return count;
+	}
+
+	//标量的球测试，运算顺序与SIMD版本保持一致
+	static inline bool sphereVisible(
+		const FrustumPlanes& planes, const uint32_t* indices, uint32_t planeCount,
+		float x, float y, float z, float r) noexcept
+	{
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			float distance = plane.x * x + plane.y * y + plane.z * z + plane.w;
+			if (!(distance >= -r))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//标量的AABB测试：取法线方向上最远的顶点，该顶点在平面背面则整个包围盒在视锥体外
+	static inline bool boxVisible(
+		const FrustumPlanes& planes, const uint32_t* indices, uint32_t planeCount,
+		const float* const* farX, const float* const* farY, const float* const* farZ, uint32_t i) noexcept
+	{
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			float distance = plane.x * farX[p][i] + plane.y * farY[p][i] + plane.z * farZ[p][i] + plane.w;
+			if (!(distance >= 0.0f))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	CullingKernel::CullResult CullingKernel::classifyBox(
+		const FrustumPlanes& planes, uint32_t planeMask,
+		const glm::vec3& min, const glm::vec3& max, uint32_t& outMask) noexcept
+	{
+		outMask = 0;
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			if (!(planeMask & (1u << i)))
+			{
+				continue;
+			}
+
+			const auto& plane = planes.m_planes[i];
+
+			//法线方向上最远的点在背面：完全在外面
+			glm::vec3 farPoint(
+				plane.x > 0.0f ? max.x : min.x,
+				plane.y > 0.0f ? max.y : min.y,
+				plane.z > 0.0f ? max.z : min.z);
+			if (glm::dot(glm::vec3(plane), farPoint) + plane.w < 0.0f)
+			{
+				outMask = 0;
+				return CullResult::Outside;
+			}
+
+			//法线方向上最近的点在背面：与平面相交，子节点仍需测试该平面
+			glm::vec3 nearPoint(
+				plane.x > 0.0f ? min.x : max.x,
+				plane.y > 0.0f ? min.y : max.y,
+				plane.z > 0.0f ? min.z : max.z);
+			if (glm::dot(glm::vec3(plane), nearPoint) + plane.w < 0.0f)
+			{
+				outMask |= 1u << i;
+			}
+		}
+
+		return outMask == 0 ? CullResult::Inside : CullResult::Intersect;
+	}
+
+	uint32_t CullingKernel::cullSpheres(
+		const FrustumPlanes& planes, uint32_t planeMask,
+		const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+		uint32_t begin, uint32_t count, uint64_t* visibility) noexcept
+	{
+		uint32_t indices[6];
+		uint32_t planeCount = collectPlanes(planeMask, indices);
+
+		uint32_t visible = 0;
+		uint32_t i = begin;
+		uint32_t end = begin + count;
+
+#if defined(FF_CULLING_AVX)
+		__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			planeX[p] = _mm256_set1_ps(plane.x);
+			planeY[p] = _mm256_set1_ps(plane.y);
+			planeZ[p] = _mm256_set1_ps(plane.z);
+			planeW[p] = _mm256_set1_ps(plane.w);
+		}
+
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 x = _mm256_loadu_ps(centerX + i);
+			__m256 y = _mm256_loadu_ps(centerY + i);
+			__m256 z = _mm256_loadu_ps(centerZ + i);
+			__m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(radius + i), signMask);
+
+			int mask = 0xff;
+			for (uint32_t p = 0; p < planeCount && mask != 0; ++p)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y)), _mm256_mul_ps(planeZ[p], z)), planeW[p]);
+				mask &= _mm256_movemask_ps(_mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+			}
+
+			writeMask(visibility, i, static_cast<uint32_t>(mask));
+			visible += countBits(static_cast<uint32_t>(mask));
+		}
+#elif defined(FF_CULLING_SSE)
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			planeX[p] = _mm_set1_ps(plane.x);
+			planeY[p] = _mm_set1_ps(plane.y);
+			planeZ[p] = _mm_set1_ps(plane.z);
+			planeW[p] = _mm_set1_ps(plane.w);
+		}
+
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(centerX + i);
+			__m128 y = _mm_loadu_ps(centerY + i);
+			__m128 z = _mm_loadu_ps(centerZ + i);
+			__m128 negRadius = _mm_xor_ps(_mm_loadu_ps(radius + i), signMask);
+
+			int mask = 0xf;
+			for (uint32_t p = 0; p < planeCount && mask != 0; ++p)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)), _mm_mul_ps(planeZ[p], z)), planeW[p]);
+				mask &= _mm_movemask_ps(_mm_cmpge_ps(distance, negRadius));
+			}
+
+			writeMask(visibility, i, static_cast<uint32_t>(mask));
+			visible += countBits(static_cast<uint32_t>(mask));
+		}
+#endif
+
+		//剩余不足一组的部分
+		for (; i < end; ++i)
+		{
+			if (sphereVisible(planes, indices, planeCount, centerX[i], centerY[i], centerZ[i], radius[i]))
+			{
+				writeMask(visibility, i, 1);
+				visible++;
+			}
+		}
+
+		return visible;
+	}
+
+	uint32_t CullingKernel::cullSpheresScalar(
+		const FrustumPlanes& planes, uint32_t planeMask,
+		const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+		uint32_t begin, uint32_t count, uint64_t* visibility) noexcept
+	{
+		uint32_t indices[6];
+		uint32_t planeCount = collectPlanes(planeMask, indices);
+
+		uint32_t visible = 0;
+		for (uint32_t i = begin; i < begin + count; ++i)
+		{
+			if (sphereVisible(planes, indices, planeCount, centerX[i], centerY[i], centerZ[i], radius[i]))
+			{
+				writeMask(visibility, i, 1);
+				visible++;
+			}
+		}
+
+		return visible;
+	}
+
+	uint32_t CullingKernel::cullBoxes(
+		const FrustumPlanes& planes, uint32_t planeMask,
+		const float* minX, const float* minY, const float* minZ,
+		const float* maxX, const float* maxY, const float* maxZ,
+		uint32_t begin, uint32_t count, uint64_t* visibility) noexcept
+	{
+		uint32_t indices[6];
+		uint32_t planeCount = collectPlanes(planeMask, indices);
+
+		//每个平面法线方向上最远的顶点只取决于法线的符号，可以提前为每个平面选好数组
+		const float* farX[6];
+		const float* farY[6];
+		const float* farZ[6];
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			farX[p] = plane.x > 0.0f ? maxX : minX;
+			farY[p] = plane.y > 0.0f ? maxY : minY;
+			farZ[p] = plane.z > 0.0f ? maxZ : minZ;
+		}
+
+		uint32_t visible = 0;
+		uint32_t i = begin;
+		uint32_t end = begin + count;
+
+#if defined(FF_CULLING_AVX)
+		__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			planeX[p] = _mm256_set1_ps(plane.x);
+			planeY[p] = _mm256_set1_ps(plane.y);
+			planeZ[p] = _mm256_set1_ps(plane.z);
+			planeW[p] = _mm256_set1_ps(plane.w);
+		}
+
+		const __m256 zero = _mm256_setzero_ps();
+		for (; i + 8 <= end; i += 8)
+		{
+			int mask = 0xff;
+			for (uint32_t p = 0; p < planeCount && mask != 0; ++p)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(planeX[p], _mm256_loadu_ps(farX[p] + i)),
+					_mm256_mul_ps(planeY[p], _mm256_loadu_ps(farY[p] + i))),
+					_mm256_mul_ps(planeZ[p], _mm256_loadu_ps(farZ[p] + i))), planeW[p]);
+				mask &= _mm256_movemask_ps(_mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+			}
+
+			writeMask(visibility, i, static_cast<uint32_t>(mask));
+			visible += countBits(static_cast<uint32_t>(mask));
+		}
+#elif defined(FF_CULLING_SSE)
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			planeX[p] = _mm_set1_ps(plane.x);
+			planeY[p] = _mm_set1_ps(plane.y);
+			planeZ[p] = _mm_set1_ps(plane.z);
+			planeW[p] = _mm_set1_ps(plane.w);
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		for (; i + 4 <= end; i += 4)
+		{
+			int mask = 0xf;
+			for (uint32_t p = 0; p < planeCount && mask != 0; ++p)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(planeX[p], _mm_loadu_ps(farX[p] + i)),
+					_mm_mul_ps(planeY[p], _mm_loadu_ps(farY[p] + i))),
+					_mm_mul_ps(planeZ[p], _mm_loadu_ps(farZ[p] + i))), planeW[p]);
+				mask &= _mm_movemask_ps(_mm_cmpge_ps(distance, zero));
+			}
+
+			writeMask(visibility, i, static_cast<uint32_t>(mask));
+			visible += countBits(static_cast<uint32_t>(mask));
+		}
+#endif
+
+		for (; i < end; ++i)
+		{
+			if (boxVisible(planes, indices, planeCount, farX, farY, farZ, i))
+			{
+				writeMask(visibility, i, 1);
+				visible++;
+			}
+		}
+
+		return visible;
+	}
+
+	uint32_t CullingKernel::cullBoxesScalar(
+		const FrustumPlanes& planes, uint32_t planeMask,
+		const float* minX, const float* minY, const float* minZ,
+		const float* maxX, const float* maxY, const float* maxZ,
+		uint32_t begin, uint32_t count, uint64_t* visibility) noexcept
+	{
+		uint32_t indices[6];
+		uint32_t planeCount = collectPlanes(planeMask, indices);
+
+		const float* farX[6];
+		const float* farY[6];
+		const float* farZ[6];
+		for (uint32_t p = 0; p < planeCount; ++p)
+		{
+			const auto& plane = planes.m_planes[indices[p]];
+			farX[p] = plane.x > 0.0f ? maxX : minX;
+			farY[p] = plane.y > 0.0f ? maxY : minY;
+			farZ[p] = plane.z > 0.0f ? maxZ : minZ;
+		}
+
+		uint32_t visible = 0;
+		for (uint32_t i = begin; i < begin + count; ++i)
+		{
+			if (boxVisible(planes, indices, planeCount, farX, farY, farZ, i))
+			{
+				writeMask(visibility, i, 1);
+				visible++;
+			}
+		}
+
+		return visible;
+	}
+
+	uint32_t CullingKernel::getSimdWidth() noexcept
+	{
+#if defined(FF_CULLING_AVX)
+		return 8;
+#elif defined(FF_CULLING_SSE)
+		return 4;
+#else
+		return 1;
+#endif
+	}
+
+	void CullingKernel::setBits(uint64_t* bits, uint32_t begin, uint32_t count) noexcept
+	{
+		uint32_t end = begin + count;
+		while (begin < end)
+		{
+			uint32_t word = begin >> 6;
+			uint32_t shift = begin & 63;
+			uint32_t length = std::min(64 - shift, end - begin);
+
+			uint64_t mask = length == 64 ? ~0ull : ((1ull << length) - 1);
+			bits[word] |= mask << shift;
+
+			begin += length;
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/**
+ * @class CullingKernel
+ * @brief 批量视锥体剪裁内核：以SoA数组输入包围球/AABB，一次测试4个(SSE)或8个(AVX)，结果写入可见性位图。
+ *
+ * 简介：
+ * - 平面使用值类型的 FrustumPlanes(法线xyz + 常数w)，不经过 Plane::Ptr 的智能指针间接访问。
+ * - planeMask 的第i位表示需要测试第i个平面，层次化剪裁时父节点已经完全位于某个平面正面，子节点可以跳过该平面。
+ * - cullSpheres/cullBoxes 对 [begin, begin + count) 区间内的物体测试，可见的物体在位图对应位置1，
+ *   不可见的位保持不变，调用前需要自行清零；返回值为区间内可见的物体数。
+ * - 带Scalar后缀的版本为逐个物体的标量实现，运算顺序与SIMD版本一致，用于结果比对。
+ *
+ * 使用示例：
+ * @code
+ * std::vector<uint64_t> bits(ff::CullingKernel::getWordCount(count), 0);
+ * ff::CullingKernel::cullSpheres(frustum->getPlaneData(), ff::CullingKernel::AllPlanes,
+ *     centerX.data(), centerY.data(), centerZ.data(), radius.data(), 0, count, bits.data());
+ * if (ff::CullingKernel::testBit(bits.data(), i)) { ... }
+ * @endcode
+ *
+ * 限制与注意：
+ * - 编译时开启AVX(/arch:AVX)使用8路，否则在x64上使用SSE 4路，其余平台退化为标量。
+ * - 输入数组不要求对齐。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "../global/base.h"
+
+namespace ff
+{
+	//值类型的视锥体平面，xyz为单位法线，w为常数项，点在平面正面时 dot(n, p) + w >= 0
+	struct FrustumPlanes
+	{
+		glm::vec4 m_planes[6];
+	};
+
+	class CullingKernel
+	{
+	public:
+		static constexpr uint32_t AllPlanes = 0x3f;
+
+		enum class CullResult
+		{
+			Outside,	//完全在视锥体外
+			Intersect,	//与某些平面相交
+			Inside		//完全在视锥体内
+		};
+
+		//单个AABB的分类，outMask返回仍然相交、子节点还需要继续测试的平面
+		static CullResult classifyBox(
+			const FrustumPlanes& planes, uint32_t planeMask,
+			const glm::vec3& min, const glm::vec3& max, uint32_t& outMask) noexcept;
+
+		static uint32_t cullSpheres(
+			const FrustumPlanes& planes, uint32_t planeMask,
+			const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+			uint32_t begin, uint32_t count, uint64_t* visibility) noexcept;
+
+		static uint32_t cullSpheresScalar(
+			const FrustumPlanes& planes, uint32_t planeMask,
+			const float* centerX, const float* centerY, const float* centerZ, const float* radius,
+			uint32_t begin, uint32_t count, uint64_t* visibility) noexcept;
+
+		static uint32_t cullBoxes(
+			const FrustumPlanes& planes, uint32_t planeMask,
+			const float* minX, const float* minY, const float* minZ,
+			const float* maxX, const float* maxY, const float* maxZ,
+			uint32_t begin, uint32_t count, uint64_t* visibility) noexcept;
+
+		static uint32_t cullBoxesScalar(
+			const FrustumPlanes& planes, uint32_t planeMask,
+			const float* minX, const float* minY, const float* minZ,
+			const float* maxX, const float* maxY, const float* maxZ,
+			uint32_t begin, uint32_t count, uint64_t* visibility) noexcept;
+
+		//当前编译使用的SIMD宽度：8(AVX)、4(SSE)或1(标量)
+		static uint32_t getSimdWidth() noexcept;
+
+		//位图工具
+		static uint32_t getWordCount(uint32_t count) noexcept { return (count + 63) / 64; }
+
+		static bool testBit(const uint64_t* bits, uint32_t index) noexcept
+		{
+			return (bits[index >> 6] >> (index & 63)) & 1;
+		}
+
+		static void setBits(uint64_t* bits, uint32_t begin, uint32_t count) noexcept;
+	};
+}
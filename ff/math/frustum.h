@@ -20,7 +20,8 @@
  * @endcode
  *
  * @note 使用 `glm::value_ptr` 直接访问矩阵数组，需要确保矩阵为列主序（GLM 默认）。
- * @note 本类目前只提供 Sphere 相交测试，如需支持 AABB、OBB 等需扩展。
+ * @note 本类提供 Sphere 与 AABB 相交测试，OBB 等需扩展。
+ * @note 大批量物体的剪裁使用 getPlaneData() 配合 CullingKernel 的SoA批量接口。
  * @author qiang.guo
  * @date 2025-06-17
  */
@@ -30,6 +31,7 @@
 #include "../global/base.h"
 #include "plane.h"
 #include "sphere.h"
+#include "cullingKernel.h"
 #include "../objects/renderableObject.h"
 
 namespace ff {
@@ -44,7 +46,6 @@ namespace ff {
 
 		Frustum() noexcept
 		{
-			m_toolSphere = Sphere::create(glm::vec3(0.0f), 0.0f);
 			for (uint32_t i = 0; i < 6; ++i)
 			{
 				m_planes.push_back(Plane::create(glm::vec3(0.0f), 0.0f));
@@ -60,33 +61,64 @@ namespace ff {
 			m_planes[3]->setComponents(m[3] - m[1], m[7] - m[5], m[11] - m[9], m[15] - m[13]);
 			m_planes[4]->setComponents(m[3] - m[2], m[7] - m[6], m[11] - m[10], m[15] - m[14]);
 			m_planes[5]->setComponents(m[3] + m[2], m[7] + m[6], m[11] + m[10], m[15] + m[14]);
+
+			for (uint32_t i = 0; i < 6; ++i)
+			{
+				m_planeData.m_planes[i] = glm::vec4(m_planes[i]->m_normal, m_planes[i]->m_constant);
+			}
 		}
 
 		bool intersectObject(const RenderableObject::Ptr& object) noexcept
 		{
-			auto geomtry = object->getGeometry();
+			return intersectObject(object.get());
+		}
 
-			if (geomtry->getBoundingSphere() == nullptr)
+		bool intersectObject(RenderableObject* object) noexcept
+		{
+			//物体缓存的世界空间包围球，worldMatrix没有变化时不需要重新变换
+			return intersectSphere(object->getWorldBoundingSphere());
+		}
+
+		//AABB与视锥体相交测试：对每个平面取包围盒在法线方向上最远的顶点，该顶点在平面背面则整个包围盒在视锥体外
+		bool intersectBox(const glm::vec3& min, const glm::vec3& max) noexcept
+		{
+			for (uint32_t i = 0; i < 6; i++)
 			{
-				geomtry->computeBoundingSphere();
-			}
+				const auto& plane = m_planeData.m_planes[i];
 
-			//因为使用的是智能指针，如果直接直接变换会导致geometry里面包含的球不停的累加变换
-			m_toolSphere->copy(geomtry->getBoundingSphere());
-			m_toolSphere->applyMatrix4(object->getWorldMatrix());
+				glm::vec3 point(
+					plane.x > 0.0f ? max.x : min.x,
+					plane.y > 0.0f ? max.y : min.y,
+					plane.z > 0.0f ? max.z : min.z);
 
-			return intersectSphere(m_toolSphere);
+				if (glm::dot(glm::vec3(plane), point) + plane.w < 0.0f)
+				{
+					return false;
+				}
+			}
+			return true;
 		}
 
+		const std::vector<Plane::Ptr>& getPlanes() const noexcept { return m_planes; }
+
+		//值类型的平面数据，与m_planes同步更新
+		const FrustumPlanes& getPlaneData() const noexcept { return m_planeData; }
+
 		bool intersectSphere(const Sphere::Ptr& sphere) noexcept
 		{
-			auto center = sphere->m_center;
-			auto radius = sphere->m_radius;
+			return intersectSphere(*sphere);
+		}
+
+		bool intersectSphere(const Sphere& sphere) noexcept
+		{
+			auto center = sphere.m_center;
+			auto radius = sphere.m_radius;
 
 			for (uint32_t i = 0; i < 6; i++)
 			{
 				//1 计算包围球的球心到当前平面的距离
-				auto distance = m_planes[i]->distanceToPoint(center);
+				const auto& plane = m_planeData.m_planes[i];
+				auto distance = glm::dot(glm::vec3(plane), center) + plane.w;
 
 				//2 如果球心在平面的正面，那distance一定是正数不进if
 				if (distance < -radius)
@@ -100,6 +132,6 @@ namespace ff {
 
 	private:
 		std::vector<Plane::Ptr> m_planes{};
-		Sphere::Ptr m_toolSphere{ nullptr };
+		FrustumPlanes m_planeData{};
 	};
 }
\ No newline at end of file
@@ -49,16 +49,17 @@ namespace ff {
 		~Sphere() noexcept {}
 
 		//应用在跟随物体进行Matrix变换的时候
-		void applyMatrix4(const glm::mat4 matrix) noexcept
+		void applyMatrix4(const glm::mat4& matrix) noexcept
 		{
 			m_center = glm::vec3(matrix * glm::vec4(m_center, 1.0));
 
 			//对于半径，只会收到scale缩放影响，我们只需要烤炉三个scale当中最大的
-			float scaleX = glm::length(glm::vec3(matrix[0]));
-			float scaleY = glm::length(glm::vec3(matrix[1]));
-			float scaleZ = glm::length(glm::vec3(matrix[2]));
+			//先比较长度的平方，只做一次开方
+			float scaleXSq = glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0]));
+			float scaleYSq = glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1]));
+			float scaleZSq = glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]));
 
-			float maxScale = std::max(std::max(scaleX, scaleY), scaleZ);
+			float maxScale = std::sqrt(std::max(std::max(scaleXSq, scaleYSq), scaleZSq));
 
 			m_radius *= maxScale;
 		}
@@ -33,7 +33,14 @@ namespace ff {
 			m_worldMatrix = m_worldMatrix * mNodeMatrix;
 		}
 
+		//骨骼每次都重新计算，版本号同样递增，子节点据此跟随更新
+		m_needUpdateWorldMatrix = false;
+		m_worldMatrixVersion++;
+		notifyWorldMatrixChanged();
+		getWorldMatrixUpdateInfo().m_recomputed++;
+
 		if (updateChildren) {
+			m_childrenNeedUpdate = false;
 			for (auto& child : m_children) {
 				child->updateWorldMatrix(false, true);
 			}
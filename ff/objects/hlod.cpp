@@ -0,0 +1,45 @@
+#include "hlod.h"
+
+namespace ff
+{
+	HLOD::HLOD() noexcept
+	{
+		m_isHLOD = true;
+	}
+
+	HLOD::~HLOD() noexcept {}
+
+	void HLOD::setProxy(const RenderableObject::Ptr& proxy) noexcept
+	{
+		if (m_proxy != nullptr)
+		{
+			removeChild(m_proxy);
+		}
+
+		m_proxy = proxy;
+		m_useProxy = false;
+
+		if (m_proxy != nullptr)
+		{
+			m_proxy->m_visible = false;
+			addChild(m_proxy);
+		}
+	}
+
+	bool HLOD::update(const LOD::View& view) noexcept
+	{
+		if (m_proxy == nullptr)
+		{
+			m_useProxy = false;
+			return m_useProxy;
+		}
+
+		float size = LOD::projectSize(m_proxy->getWorldBoundingSphere(), view);
+
+		//切换到代理需要低于阈值一定比例，切换回子树需要高于阈值一定比例
+		float threshold = m_useProxy ? m_screenSize * (1.0f + m_hysteresis) : m_screenSize * (1.0f - m_hysteresis);
+		m_useProxy = size < threshold;
+
+		return m_useProxy;
+	}
+}
@@ -0,0 +1,77 @@
+/**
+ * @class HLOD
+ * @brief 层次化细节(Hierarchical LOD)节点：一组在空间上聚集的物体，远处时整体替换为一个预先合并、简化的代理Mesh。
+ *
+ * 简介：
+ * - HLOD的子节点为原始的物体(或子树)，另外持有一个代理物体，代理同样作为子节点挂接，但m_visible始终为false，
+ *   只由渲染器在需要时显式地使用，普通的遍历不会访问它；
+ * - 代理的世界包围球投影到屏幕上的直径小于阈值(像素)时使用代理，并跳过整个子树，
+ *   一个簇的所有drawCall合并为一个；与LOD相同，带有相对阈值的滞后；
+ * - 多层HLOD可以嵌套：外层簇的子节点是内层HLOD，外层代理由内层代理合并而成，越远合并的范围越大。
+ *
+ * 代理通常由 ff::HLODBuilder 离线生成，也可以自行制作后通过setProxy设置。
+ *
+ * 使用示例：
+ * @code
+ * auto hlod = ff::HLOD::create();
+ * hlod->addChild(building);
+ * hlod->addChild(tree);
+ * hlod->setProxy(ff::Mesh::create(mergedGeometry, material));
+ * hlod->setScreenSize(64.0f);   // 投影小于64像素时使用代理
+ * @endcode
+ *
+ * 限制与注意：
+ * - 代理与子树共享同一个局部坐标系(即HLOD节点的坐标系)；
+ * - 阴影pass与主相机使用同一个选择结果。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../core/object3D.h"
+#include "renderableObject.h"
+#include "lod.h"
+
+namespace ff
+{
+	class HLOD : public Object3D
+	{
+	public:
+		using Ptr = std::shared_ptr<HLOD>;
+		static Ptr create()
+		{
+			return std::make_shared<HLOD>();
+		}
+
+		HLOD() noexcept;
+
+		~HLOD() noexcept;
+
+		//替换代理，代理作为不可见的子节点挂接
+		void setProxy(const RenderableObject::Ptr& proxy) noexcept;
+
+		const RenderableObject::Ptr& getProxy() const noexcept { return m_proxy; }
+
+		void setScreenSize(float screenSize) noexcept { m_screenSize = screenSize; }
+
+		float getScreenSize() const noexcept { return m_screenSize; }
+
+		void setHysteresis(float hysteresis) noexcept { m_hysteresis = hysteresis; }
+
+		float getHysteresis() const noexcept { return m_hysteresis; }
+
+		//根据代理的投影大小决定是否使用代理，没有代理时总是返回false
+		bool update(const LOD::View& view) noexcept;
+
+		//最近一次update的结果
+		bool isUsingProxy() const noexcept { return m_useProxy; }
+
+	private:
+		RenderableObject::Ptr	m_proxy{ nullptr };
+		float					m_screenSize{ 64.0f };
+		float					m_hysteresis{ 0.1f };
+		bool					m_useProxy{ false };
+	};
+}
@@ -0,0 +1,134 @@
+#include "lod.h"
+
+namespace ff
+{
+	LOD::LOD(Metric metric) noexcept
+	{
+		m_isLOD = true;
+		m_metric = metric;
+	}
+
+	LOD::~LOD() noexcept {}
+
+	void LOD::addLevel(const RenderableObject::Ptr& object, float threshold) noexcept
+	{
+		Level level;
+		level.m_object = object;
+		level.m_threshold = threshold;
+
+		//距离越近越精细，换算为距离的倒数，两种度量统一为“越大越精细”
+		if (m_metric == Metric::Distance)
+		{
+			level.m_detail = threshold > 0.0f ? 1.0f / threshold : std::numeric_limits<float>::max();
+		}
+		else
+		{
+			level.m_detail = threshold;
+		}
+
+		//保持按精度从高到低排列，阈值相同时保持添加顺序
+		auto iter = std::upper_bound(m_levels.begin(), m_levels.end(), level, [](const Level& a, const Level& b) {
+			return a.m_detail > b.m_detail;
+		});
+		m_levels.insert(iter, level);
+
+		addChild(object);
+		m_selected = UINT32_MAX;
+	}
+
+	LOD::View LOD::makeView(const Camera::Ptr& camera, float viewportHeight) noexcept
+	{
+		View view;
+		view.m_cameraPosition = camera->getWorldPosition();
+		view.m_pixelScale = camera->getProjectionMatrix()[1][1] * 0.5f * viewportHeight;
+		view.m_perspective = !camera->m_isOrthographicCamera;
+
+		return view;
+	}
+
+	float LOD::computeDetail(const View& view) noexcept
+	{
+		const auto& sphere = m_levels[0].m_object->getWorldBoundingSphere();
+		if (m_metric == Metric::Distance)
+		{
+			float distance = glm::length(sphere.m_center - view.m_cameraPosition);
+			return distance > 1e-6f ? 1.0f / distance : std::numeric_limits<float>::max();
+		}
+
+		return projectSize(sphere, view);
+	}
+
+	float LOD::projectSize(const Sphere& sphere, const View& view) noexcept
+	{
+		float diameter = 2.0f * sphere.m_radius * view.m_pixelScale;
+		if (!view.m_perspective)
+		{
+			return diameter;
+		}
+
+		//相机位于包围球内，总是使用最高精度
+		float distance = glm::length(sphere.m_center - view.m_cameraPosition);
+		if (distance <= sphere.m_radius)
+		{
+			return std::numeric_limits<float>::max();
+		}
+
+		return diameter / distance;
+	}
+
+	uint32_t LOD::selectLevel(float detail) const noexcept
+	{
+		uint32_t count = static_cast<uint32_t>(m_levels.size());
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (detail >= m_levels[i].m_detail)
+			{
+				return i;
+			}
+		}
+
+		return count;
+	}
+
+	uint32_t LOD::update(const View& view) noexcept
+	{
+		m_switched = false;
+		if (m_levels.empty())
+		{
+			m_current = Culled;
+			return m_current;
+		}
+
+		float detail = computeDetail(view);
+		uint32_t target = selectLevel(detail);
+
+		//m_selected为m_levels.size()时表示剔除，可以与相邻级别一样参与滞后判断
+		if (m_selected <= m_levels.size() && target != m_selected)
+		{
+			//变粗糙：需要低于当前级别下界一定比例
+			if (target > m_selected && detail >= m_levels[m_selected].m_detail * (1.0f - m_hysteresis))
+			{
+				target = m_selected;
+			}
+			//变精细：需要高于上一级别下界一定比例
+			else if (target < m_selected && detail < m_levels[m_selected - 1].m_detail * (1.0f + m_hysteresis))
+			{
+				target = m_selected;
+			}
+		}
+
+		if (target != m_selected)
+		{
+			m_switched = m_selected != UINT32_MAX;
+			m_selected = target;
+
+			for (uint32_t i = 0; i < m_levels.size(); ++i)
+			{
+				m_levels[i].m_object->m_visible = (i == m_selected);
+			}
+		}
+
+		m_current = m_selected < m_levels.size() ? m_selected : Culled;
+		return m_current;
+	}
+}
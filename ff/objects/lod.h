@@ -0,0 +1,119 @@
+/**
+ * @class LOD
+ * @brief 细节层次(Level Of Detail)节点，持有同一物体的若干个精度级别，每帧只让其中一个级别参与渲染。
+ *
+ * 简介：
+ * - 每个级别是一个 RenderableObject，同时作为LOD的子节点挂接，世界矩阵随层级正常更新；
+ * - 选择依据为度量值，支持两种度量：
+ *   - ScreenSize：包围球投影到屏幕上的直径(像素)，级别在投影直径不小于其阈值时可用；
+ *   - Distance：包围球球心到相机的距离，级别在距离小于其阈值时可用；
+ * - 级别按精度从高到低排列，选取第一个可用的级别；没有任何级别可用时整个LOD被剔除(例如投影小于1像素)；
+ * - 带有滞后(hysteresis)：在相邻级别的边界附近，度量值需要越过阈值一定比例才会切换，避免来回跳变。
+ *
+ * 包围球取最高精度级别(第一个级别)的世界包围球。Renderer::projectObject 遍历到LOD节点时调用update，
+ * 被选中的级别m_visible为true，其余级别为false，所以阴影等后续的遍历与主相机使用同一个级别。
+ *
+ * 使用示例：
+ * @code
+ * auto lod = ff::LOD::create();
+ * lod->addLevel(highMesh, 200.0f);  // 投影直径 >= 200px
+ * lod->addLevel(midMesh, 40.0f);    // 投影直径 >= 40px
+ * lod->addLevel(lowMesh, 2.0f);     // 投影直径 >= 2px，更小时整体剔除
+ * scene->addChild(lod);
+ * @endcode
+ *
+ * 限制与注意：
+ * - 级别的m_visible由LOD控制，不要在外部修改；隐藏整个LOD请设置LOD本身的m_visible；
+ * - 同一帧内多个相机渲染时，以最后一次update的相机为准。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../core/object3D.h"
+#include "../camera/camera.h"
+#include "renderableObject.h"
+
+namespace ff
+{
+	class LOD : public Object3D
+	{
+	public:
+		enum class Metric
+		{
+			ScreenSize,
+			Distance
+		};
+
+		//每帧对所有LOD共享的相机参数，由makeView计算一次
+		struct View
+		{
+			glm::vec3	m_cameraPosition{ 0.0f };
+			float		m_pixelScale{ 1.0f };		//单位长度在单位距离处投影的像素数
+			bool		m_perspective{ true };		//正交相机的投影大小与距离无关
+		};
+
+		struct Level
+		{
+			RenderableObject::Ptr	m_object{ nullptr };
+			float					m_threshold{ 0.0f };	//用户设置的阈值
+			float					m_detail{ 0.0f };		//换算为“越大越精细”的度量下界
+		};
+
+		//被剔除时getCurrentLevel返回的值
+		static constexpr uint32_t Culled = UINT32_MAX;
+
+		using Ptr = std::shared_ptr<LOD>;
+		static Ptr create(Metric metric = Metric::ScreenSize)
+		{
+			return std::make_shared<LOD>(metric);
+		}
+
+		LOD(Metric metric) noexcept;
+
+		~LOD() noexcept;
+
+		//按精度从高到低的顺序添加，阈值含义见Metric
+		void addLevel(const RenderableObject::Ptr& object, float threshold) noexcept;
+
+		const std::vector<Level>& getLevels() const noexcept { return m_levels; }
+
+		//相对阈值的滞后比例，默认0.1即需要越过阈值10%才切换
+		void setHysteresis(float hysteresis) noexcept { m_hysteresis = hysteresis; }
+
+		float getHysteresis() const noexcept { return m_hysteresis; }
+
+		Metric getMetric() const noexcept { return m_metric; }
+
+		static View makeView(const Camera::Ptr& camera, float viewportHeight) noexcept;
+
+		//世界空间包围球投影到屏幕上的直径(像素)，相机位于球内时返回float最大值
+		static float projectSize(const Sphere& sphere, const View& view) noexcept;
+
+		//选择级别并设置各级别的可见性，返回选中级别的下标，被剔除时返回Culled
+		uint32_t update(const View& view) noexcept;
+
+		uint32_t getCurrentLevel() const noexcept { return m_current; }
+
+		//上一次update是否切换了级别
+		bool hasSwitched() const noexcept { return m_switched; }
+
+	private:
+		float computeDetail(const View& view) noexcept;
+
+		//不考虑滞后时的级别
+		uint32_t selectLevel(float detail) const noexcept;
+
+	private:
+		Metric				m_metric{ Metric::ScreenSize };
+		std::vector<Level>	m_levels{};
+		float				m_hysteresis{ 0.1f };
+
+		//m_levels.size()表示剔除，首次update之前为UINT32_MAX
+		uint32_t			m_selected{ UINT32_MAX };
+		uint32_t			m_current{ Culled };
+		bool				m_switched{ false };
+	};
+}
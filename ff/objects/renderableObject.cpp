@@ -12,6 +12,80 @@ namespace ff
 
 	RenderableObject::~RenderableObject() noexcept { }
 
+	void RenderableObject::setGeometry(const Geometry::Ptr& geometry) noexcept
+	{
+		m_geometry = geometry;
+
+		//包围盒随geometry变化，与worldMatrix变化一样通知
+		notifyWorldMatrixChanged();
+	}
+
+	const Sphere& RenderableObject::getWorldBoundingSphere() noexcept
+	{
+		updateWorldBounds();
+		return m_worldSphere;
+	}
+
+	const Box3& RenderableObject::getWorldBoundingBox() noexcept
+	{
+		updateWorldBounds();
+		return m_worldBox;
+	}
+
+	void RenderableObject::updateWorldBounds() noexcept
+	{
+		auto geometry = m_geometry.get();
+
+		//第一次使用时计算geometry的包围体，之后由geometry自己维护版本
+		if (geometry != nullptr && geometry->getBoundingSphere() == nullptr && geometry->hasAttribute("position"))
+		{
+			geometry->computeBoundingSphere();
+		}
+
+		auto worldVersion = getWorldMatrixVersion();
+		auto geometryVersion = geometry != nullptr ? geometry->getBoundsVersion() : 0;
+		if (worldVersion == m_boundsWorldVersion && geometry == m_boundsGeometry && geometryVersion == m_boundsGeometryVersion)
+		{
+			return;
+		}
+
+		m_boundsWorldVersion = worldVersion;
+		m_boundsGeometry = geometry;
+		m_boundsGeometryVersion = geometryVersion;
+
+		const auto& worldMatrix = currentWorldMatrix();
+
+		Sphere* sphere = geometry != nullptr ? geometry->getBoundingSphere().get() : nullptr;
+		Box3* box = geometry != nullptr ? geometry->getBoundingBox().get() : nullptr;
+		if (sphere == nullptr || box == nullptr || box->isEmpty())
+		{
+			glm::vec3 position = glm::vec3(worldMatrix[3]);
+			m_worldSphere.m_center = position;
+			m_worldSphere.m_radius = 0.0f;
+			m_worldBox.m_min = position;
+			m_worldBox.m_max = position;
+			return;
+		}
+
+		//1 包围球：球心做完整变换，半径乘以最大的缩放
+		m_worldSphere.m_center = sphere->m_center;
+		m_worldSphere.m_radius = sphere->m_radius;
+		m_worldSphere.applyMatrix4(worldMatrix);
+
+		//2 包围盒：中心做完整变换，半长用矩阵各元素的绝对值变换，得到包住旋转后盒子的AABB
+		glm::vec3 center = (box->m_min + box->m_max) * 0.5f;
+		glm::vec3 halfExtent = (box->m_max - box->m_min) * 0.5f;
+
+		glm::vec3 worldCenter = glm::vec3(worldMatrix * glm::vec4(center, 1.0f));
+		glm::vec3 worldHalfExtent =
+			glm::abs(glm::vec3(worldMatrix[0])) * halfExtent.x +
+			glm::abs(glm::vec3(worldMatrix[1])) * halfExtent.y +
+			glm::abs(glm::vec3(worldMatrix[2])) * halfExtent.z;
+
+		m_worldBox.m_min = worldCenter - worldHalfExtent;
+		m_worldBox.m_max = worldCenter + worldHalfExtent;
+	}
+
 	void RenderableObject::onBeforeRender(Renderer* renderer, Scene* scene, Camera* camera)
 	{
 		if (m_onBeforeRenderCallback)
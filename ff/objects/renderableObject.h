@@ -30,6 +30,8 @@
 #include "../core/object3D.h"
 #include "../core/geometry.h"
 #include "../material/material.h"
+#include "../math/sphere.h"
+#include "../math/box3.h"
 #include "../global/base.h"
 #include "../global/constant.h"
 
@@ -38,10 +40,13 @@ namespace ff
 	class Renderer;
 	class Scene;
 	class Camera;
+	class SceneBVH;
 
 	class RenderableObject : public Object3D
 	{
 	public:
+		friend class SceneBVH;
+
 		using OnBeforRenderCallback = std::function<void(Renderer*, Scene*, Camera*)>;
 
 		using Ptr = std::shared_ptr<RenderableObject>;
@@ -54,9 +59,20 @@ namespace ff
 
 		~RenderableObject() noexcept;
 
-		auto getGeometry() const noexcept { return m_geometry; }
+		//返回引用，不修改引用计数；多个线程同时读取共享的geometry/material时不会争用同一个计数
+		const Geometry::Ptr& getGeometry() const noexcept { return m_geometry; }
 		
-		auto getMaterial() const noexcept { return m_material; }
+		const Material::Ptr& getMaterial() const noexcept { return m_material; }
+
+		//替换geometry，所在的SceneBVH会在下一次refit时重新计算本物体的包围盒
+		void setGeometry(const Geometry::Ptr& geometry) noexcept;
+
+		//世界空间的包围球/包围盒，只有worldMatrix或geometry的包围体版本变化时才重新计算，
+		//主渲染、阴影、拾取等多个pass可以直接复用，不需要各自做一次矩阵变换
+		//geometry没有顶点时退化为物体所在位置的一个点
+		const Sphere& getWorldBoundingSphere() noexcept;
+
+		const Box3& getWorldBoundingBox() noexcept;
 
 		//在本物体渲染前会调用本函数，允许用户指定渲染前做哪些处理
 		void onBeforeRender(Renderer* renderer, Scene* scene, Camera* camera);
@@ -64,10 +80,27 @@ namespace ff
 	public:
 		OnBeforRenderCallback m_onBeforeRenderCallback{ nullptr }; //在本物体可绘制物体进行渲染之前，会回调这个函数进行通知
 
+		bool m_isOccluder{ false };	//开启遮挡剪裁时，是否作为遮挡体光栅化到遮挡深度缓冲中
+
+		Geometry::Ptr m_occluderGeometry{ nullptr };	//作为遮挡体时使用的简化几何体，为空时使用渲染几何体
+
 	protected:
 		Geometry::Ptr m_geometry{ nullptr };
 		Material::Ptr m_material{ nullptr };
 
+		uint32_t m_sceneBVHIndex{ UINT32_MAX };	//在SceneBVH中的下标，由SceneBVH校验是否有效
+
+	private:
+		void updateWorldBounds() noexcept;
+
+	private:
+		//世界空间包围体缓存，以及计算时对应的worldMatrix版本与geometry包围体版本
+		Sphere			m_worldSphere{ glm::vec3(0.0f), 0.0f };
+		Box3			m_worldBox{};
+		const Geometry*	m_boundsGeometry{ nullptr };
+		uint32_t		m_boundsWorldVersion{ UINT32_MAX };
+		uint32_t		m_boundsGeometryVersion{ 0 };
+
 	};
 	
 }
\ No newline at end of file
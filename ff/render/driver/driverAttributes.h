@@ -111,14 +111,15 @@ namespace ff
 		{
 			dattribute = DriverAttribute::create();
 
-			auto date = attribute->getData();
+			//只读视图，外部存储(内存映射文件)的Attribute也直接从映射上传，不经过中间拷贝
+			auto data = attribute->getData();
 
 			glGenBuffers(1, &dattribute->m_handle);
 
 			glBindBuffer(toGL(bufferType), dattribute->m_handle);
 
 			//vbo内存开辟以及数据灌入
-			glBufferData(toGL(bufferType), date.size() * sizeof(T), date.data(), toGL(attribute->getBufferAllocType()));
+			glBufferData(toGL(bufferType), data.size() * sizeof(T), data.data(), toGL(attribute->getBufferAllocType()));
 			glBindBuffer(toGL(bufferType), 0);
 			
 			m_attributes.insert(std::make_pair(attribute->getID(), dattribute));
@@ -135,6 +136,8 @@ namespace ff
 			auto updateRange = attribute->getUpdateRange();
 			auto data = attribute->getData();
 
+			glBindBuffer(toGL(bufferType), dattribute->m_handle);
+
 			//如果用户确实指定的更新的range
 			if (updateRange.m_count > 0)
 			{
@@ -142,7 +145,7 @@ namespace ff
 					toGL(bufferType),
 					updateRange.m_offset * sizeof(T),
 					updateRange.m_count * sizeof(T),
-					data.data() + updateRange.m_offset * sizeof(T));
+					data.data() + updateRange.m_offset);
 			}
 			else
 			{
@@ -53,7 +53,7 @@ namespace ff {
 			mObjects->update(mBoxMesh);
 		}
 
-		renderList->push(mBoxMesh, mBoxMesh->getGeometry(), mBoxMesh->getMaterial(), 0, 0);
+		renderList->push(mBoxMesh.get(), mBoxMesh->getGeometry().get(), mBoxMesh->getMaterial().get(), 0, 0);
 	}
 
 }
\ No newline at end of file
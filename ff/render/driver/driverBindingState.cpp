@@ -37,12 +37,13 @@ namespace ff {
 	}
 
 	// 生成并管理vbo、设置绑定状态、负责vao绑定状态的缓存
-	void DriverBindingStates::setup(
+	bool DriverBindingStates::setup(
 		const Geometry::Ptr& geometry,
 		const Attributei::Ptr& index
 	) 
 	{
 		bool updateBufferLayout = false;
+		bool vaoChanged = false;
 
 		auto state = getBindingState(geometry);
 		
@@ -50,6 +51,7 @@ namespace ff {
 		{
 			m_currentBindingState = state;
 			bindVAO(state->m_vao);
+			vaoChanged = true;
 		}
 
 		updateBufferLayout = needsUpdate(geometry, index);
@@ -80,6 +82,7 @@ namespace ff {
 			}
 		}
 
+		return vaoChanged;
 	}
 
 	DriverBindingState::Ptr DriverBindingStates::createBindingState(GLuint vao) noexcept 
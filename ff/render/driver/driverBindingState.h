@@ -98,7 +98,8 @@ namespace ff
 
 		DriverBindingState::Ptr getBindingState(const Geometry::Ptr& geometry) noexcept;
 
-		void setup(const Geometry::Ptr& geometry, const Attributei::Ptr& index);
+		//切换了VAO时返回true
+		bool setup(const Geometry::Ptr& geometry, const Attributei::Ptr& index);
 
 		DriverBindingState::Ptr createBindingState(GLuint vao) noexcept;
 
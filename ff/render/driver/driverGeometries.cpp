@@ -23,7 +23,7 @@ namespace ff
 	}
 
 	//给了一个机会， 可以在每一次update的之前，对geometry相关数据做一次更新
-	Geometry::Ptr DriverGeometries::get(const Geometry::Ptr geometry) noexcept
+	const Geometry::Ptr& DriverGeometries::get(const Geometry::Ptr& geometry) noexcept
 	{
 		auto iter = m_geometries.find(geometry->getID());
 		if (iter != m_geometries.end())
@@ -52,7 +52,7 @@ namespace ff
 
 	void DriverGeometries::update(const Geometry::Ptr& geometry) noexcept
 	{
-		const auto geometryAttributes = geometry->getAttributes();
+		const auto& geometryAttributes = geometry->getAttributes();
 		
 		for (const auto& iter : geometryAttributes)
 		{
@@ -56,7 +56,8 @@ namespace ff
 
 		~DriverGeometries();
 
-		Geometry::Ptr get(const Geometry::Ptr geometry) noexcept;
+		//返回传入的geometry本身
+		const Geometry::Ptr& get(const Geometry::Ptr& geometry) noexcept;
 
 		void onGeometryDispose(const EventBase::Ptr& e) noexcept;
 
@@ -6,6 +6,16 @@
  * - 几何体和纹理资源的使用数量
  * - 当前帧数与 draw call 次数
  * - 渲染出的三角形总数等
+ * - 场景世界矩阵更新中重算/跳过的节点数
+ * - 场景遍历访问的节点数与遍历栈的内存分配次数
+ * - 主视锥体剪裁访问的BVH节点数与可见物体数
+ * - CPU遮挡剪裁剔除的物体数与耗时
+ * - GPU遮挡查询的发起数、未读取数与节省的drawCall数
+ * - LOD节点的级别切换与剔除数
+ * - 贴图流送的驻留字节数、上传数与淘汰数
+ * - 纹理单元绑定的实际调用数与跳过数
+ * - 绘制时实际发生的program、VAO与uniform切换数(贴图切换见纹理单元绑定的统计)，用于比较不透明物体的排序方式
+ * - 多线程构建渲染列表时并行剪裁与串行提交两个阶段的耗时
  *
  * 本类主要用于调试、性能分析和运行时监控，便于优化渲染流程与资源管理。
  *
@@ -30,6 +40,7 @@ namespace ff
 		{
 			uint32_t m_geometries{ 0 };  //geomery的数量
 			uint32_t m_textures{ 0 };	//贴图数量
+			uint32_t m_bakedMipmaps{ 0 };	//直接上传了预计算mipmap(而非glGenerateMipmap)的贴图数量
 		};
 
 		struct Render
@@ -39,6 +50,97 @@ namespace ff
 			uint32_t	m_triangles{ 0 }; 
 		};
 
+		//每帧场景树世界矩阵更新的统计，静态场景中绝大部分节点应当被跳过
+		struct Transform
+		{
+			uint32_t	m_recomputed{ 0 };		//重新计算了worldMatrix的节点数
+			uint32_t	m_skipped{ 0 };			//访问到但没有变化的节点数
+			uint32_t	m_skippedSubtrees{ 0 };	//没有任何变化而整体跳过的子树数
+		};
+
+		//每帧场景遍历(projectObject与阴影渲染)的统计，栈容量稳定后m_allocations应当为0
+		struct Traverse
+		{
+			uint32_t	m_visited{ 0 };		//访问到的可见节点数
+			uint32_t	m_allocations{ 0 };	//遍历栈扩容的次数
+		};
+
+		//主相机视锥体剪裁的统计，只在开启SceneBVH时有效
+		struct Culling
+		{
+			uint32_t	m_nodesVisited{ 0 };	//访问的BVH节点数
+			uint32_t	m_objectsTested{ 0 };	//逐个测试的物体数
+			uint32_t	m_objectsVisible{ 0 };	//可见物体数
+		};
+
+		//主相机CPU遮挡剪裁的统计，只在开启遮挡剪裁时有效
+		struct Occlusion
+		{
+			uint32_t	m_occluders{ 0 };			//光栅化的遮挡体数
+			uint32_t	m_occluderTriangles{ 0 };	//光栅化的三角形数
+			uint32_t	m_tested{ 0 };				//测试的物体数
+			uint32_t	m_culled{ 0 };				//被遮挡剔除的物体数
+			int64_t		m_microseconds{ 0 };		//光栅化与测试的总耗时
+		};
+
+		//GPU遮挡查询的统计，只在开启遮挡查询时有效
+		struct OcclusionQuery
+		{
+			uint32_t	m_issued{ 0 };		//本帧发起的查询数
+			uint32_t	m_pending{ 0 };		//尚未读取结果的查询数
+			uint32_t	m_drawsSaved{ 0 };	//因被遮挡而跳过的物体数
+		};
+
+		//主相机遍历到的LOD节点的统计
+		struct LevelOfDetail
+		{
+			uint32_t	m_objects{ 0 };		//访问到的LOD节点数
+			uint32_t	m_culled{ 0 };		//投影过小(或过远)被整体剔除的节点数
+			uint32_t	m_switches{ 0 };	//本帧切换了级别的节点数
+			uint32_t	m_hlods{ 0 };		//访问到的HLOD节点数
+			uint32_t	m_proxies{ 0 };		//使用代理代替整个子树的HLOD节点数
+		};
+
+		//贴图流送的统计，只在开启贴图流送时有效；m_memery.m_textures不包含按级别驻留的字节数，以这里为准
+		struct TextureStreaming
+		{
+			uint32_t	m_textures{ 0 };		//参与流送的贴图数
+			uint64_t	m_budgetBytes{ 0 };
+			uint64_t	m_residentBytes{ 0 };	//驻留在显存中的流送贴图字节数
+			uint32_t	m_uploads{ 0 };			//本帧首次上传或提升了级别的贴图数
+			uint64_t	m_uploadedBytes{ 0 };	//本帧上传的字节数
+			uint32_t	m_evictions{ 0 };		//本帧为了腾出预算而降低了级别的贴图数
+			uint32_t	m_pending{ 0 };			//本帧结束时仍低于需要的级别、等待之后的帧上传的贴图数
+		};
+
+		//每帧贴图绑定的统计，m_requests = m_binds + m_skipped
+		struct TextureBinding
+		{
+			uint32_t	m_requests{ 0 };		//采样器请求绑定贴图的次数
+			uint32_t	m_binds{ 0 };			//实际调用glBindTexture的次数
+			uint32_t	m_skipped{ 0 };			//贴图已经在某个纹理单元上而跳过的次数
+			uint32_t	m_activeTextures{ 0 };	//实际调用glActiveTexture的次数
+			uint32_t	m_samplerBinds{ 0 };	//实际调用glBindSampler的次数
+			uint32_t	m_samplers{ 0 };		//按过滤与环绕方式缓存的采样器对象数
+		};
+
+		//每帧绘制时实际发生的状态切换，包括阴影等所有pass；贴图切换即 m_textureBinding.m_binds
+		struct StateChanges
+		{
+			uint32_t	m_programs{ 0 };		//glUseProgram的次数
+			uint32_t	m_vaos{ 0 };			//glBindVertexArray的次数
+			uint32_t	m_uniforms{ 0 };		//上传的uniform数
+		};
+
+		//多线程构建渲染列表的统计，串行构建时全部为0
+		struct RenderListBuild
+		{
+			uint32_t	m_candidates{ 0 };			//遍历收集到、等待剪裁的可渲染物体数
+			uint32_t	m_ranges{ 0 };				//并行剪裁切分的区间数
+			int64_t		m_parallelMicroseconds{ 0 };	//工作线程上剪裁与计算排序键的耗时
+			int64_t		m_commitMicroseconds{ 0 };	//调用线程上合并局部列表与上传geometry的耗时
+		};
+
 		using Ptr = std::shared_ptr<DriverInfo>;
 		static Ptr create()
 		{
@@ -56,6 +158,16 @@ namespace ff
 
 		Memory m_memery{};
 		Render m_render{};
+		Transform m_transform{};
+		Traverse m_traverse{};
+		Culling m_culling{};
+		Occlusion m_occlusion{};
+		OcclusionQuery m_occlusionQuery{};
+		LevelOfDetail m_lod{};
+		TextureStreaming m_textureStreaming{};
+		TextureBinding m_textureBinding{};
+		StateChanges m_stateChanges{};
+		RenderListBuild m_renderList{};
 
 	};
 }
\ No newline at end of file
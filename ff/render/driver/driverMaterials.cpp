@@ -26,6 +26,12 @@ namespace ff {
 		return iter->second;
 	}
 
+	const DriverMaterial* DriverMaterials::find(const Material* material) const noexcept {
+		auto iter = mMaterials.find(material->getID());
+
+		return iter != mMaterials.end() ? iter->second.get() : nullptr;
+	}
+
 	void DriverMaterials::onMaterialDispose(const EventBase::Ptr& event) {
 		auto material = (Material*)event->mTarget;
 
@@ -50,18 +56,18 @@ namespace ff {
 		mMaterials.erase(iter);
 	}
 
-	void DriverMaterials::refreshMaterialUniforms(UniformHandleMap& uniformHandleMap, const Material::Ptr& material) {
+	void DriverMaterials::refreshMaterialUniforms(UniformHandleMap& uniformHandleMap, const Material::Ptr& material, const DriverTextures::Ptr& textures) {
 		uniformHandleMap["opacity"].mValue = material->m_opacity;
 		uniformHandleMap["opacity"].mNeedsUpdate = true;
 
 		if (material->m_isMeshBasicMaterial) {
 			auto basicMaterial = std::static_pointer_cast<MeshBasicMaterial>(material);
-			refreshMaterialBasic(uniformHandleMap, basicMaterial);
+			refreshMaterialBasic(uniformHandleMap, basicMaterial, textures);
 		}
 
 		if (material->m_isMeshPhongMaterial) {
 			auto phongMaterial = std::static_pointer_cast<MeshPhongMaterial>(material);
-			refreshMaterialPhong(uniformHandleMap, phongMaterial);
+			refreshMaterialPhong(uniformHandleMap, phongMaterial, textures);
 		}
 
 		if (material->m_isCubeMaterial) {
@@ -70,35 +76,51 @@ namespace ff {
 		}
 	}
 
-	void DriverMaterials::refreshMaterialPhong(UniformHandleMap& uniformHandleMap, const MeshPhongMaterial::Ptr& material) {
+	void DriverMaterials::refreshMaterialPhong(UniformHandleMap& uniformHandleMap, const MeshPhongMaterial::Ptr& material, const DriverTextures::Ptr& textures) {
 		uniformHandleMap["shininess"].mValue = material->mShininess;
 		uniformHandleMap["shininess"].mNeedsUpdate = true;
 
-		if ((material->m_diffuseMap && material->m_diffuseMap->m_needUpdate) || material->m_needUpdate) {
-			uniformHandleMap["diffuseMap"].mValue = material->m_diffuseMap;
-			uniformHandleMap["diffuseMap"].mNeedsUpdate = true;
-		}
+		refreshDiffuseMap(uniformHandleMap, material, textures);
 
-		if ((material->m_normalMap && material->m_normalMap->m_needUpdate) || material->m_needUpdate) {
+		if (material->m_normalMap || material->m_needUpdate) {
 			uniformHandleMap["normalMap"].mValue = material->m_normalMap;
 			uniformHandleMap["normalMap"].mNeedsUpdate = true;
 		}
 
-		if ((material->m_specularMap && material->m_specularMap->m_needUpdate) || material->m_needUpdate) {
+		if (material->m_specularMap || material->m_needUpdate) {
 			uniformHandleMap["specularMap"].mValue = material->m_specularMap;
 			uniformHandleMap["specularMap"].mNeedsUpdate = true;
 		}
 	}
 
-	void DriverMaterials::refreshMaterialBasic(UniformHandleMap& uniformHandleMap, const MeshBasicMaterial::Ptr& material) {
-		if ((material->m_diffuseMap && material->m_diffuseMap->m_needUpdate) || material->m_needUpdate) {
-			uniformHandleMap["diffuseMap"].mValue = material->m_diffuseMap;
-			uniformHandleMap["diffuseMap"].mNeedsUpdate = true;
+	void DriverMaterials::refreshMaterialBasic(UniformHandleMap& uniformHandleMap, const MeshBasicMaterial::Ptr& material, const DriverTextures::Ptr& textures) {
+		refreshDiffuseMap(uniformHandleMap, material, textures);
+	}
+
+	void DriverMaterials::refreshDiffuseMap(UniformHandleMap& uniformHandleMap, const Material::Ptr& material, const DriverTextures::Ptr& textures) {
+		auto region = material->m_diffuseMap ? textures->getAtlasRegion(material->m_diffuseMap) : nullptr;
+		if (region == nullptr) {
+			//贴图所在的纹理单元每次绘制都可能被换掉，有贴图时每次都要重新绑定
+			if (material->m_diffuseMap || material->m_needUpdate) {
+				uniformHandleMap["diffuseMap"].mValue = material->m_diffuseMap;
+				uniformHandleMap["diffuseMap"].mNeedsUpdate = true;
+			}
+			return;
 		}
+
+		//共享同一页的材质绑定同一张贴图，只有变换与层号不同
+		uniformHandleMap["diffuseMap"].mValue = region->m_page;
+		uniformHandleMap["diffuseMap"].mNeedsUpdate = true;
+
+		uniformHandleMap["diffuseMapTransform"].mValue = region->m_transform;
+		uniformHandleMap["diffuseMapTransform"].mNeedsUpdate = true;
+
+		uniformHandleMap["diffuseMapLayer"].mValue = static_cast<float>(region->m_layer);
+		uniformHandleMap["diffuseMapLayer"].mNeedsUpdate = true;
 	}
 
 	void DriverMaterials::refreshMaterialCube(UniformHandleMap& uniformHandleMap, const CubeMaterial::Ptr& material) {
-		if ((material->m_envMap && material->m_envMap->m_needUpdate) || material->m_needUpdate) {
+		if (material->m_envMap || material->m_needUpdate) {
 			uniformHandleMap["envMap"].mValue = material->m_envMap;
 			uniformHandleMap["envMap"].mNeedsUpdate = true;
 		}
@@ -34,6 +34,9 @@ namespace ff {
 		Texture::Ptr			mNormalMap{ nullptr };
 		Texture::Ptr			mSpecularMap{ nullptr };
 
+		//ǰprogramʱdiffuseMapڵͼҳ仯ʱҪprogram
+		Texture::Ptr			mDiffuseMapPage{ nullptr };
+
 		bool					mNeedsLight{ nullptr };
 		uint32_t				mLightsStateVersion{ 0 };
 
@@ -62,14 +65,20 @@ namespace ff {
 		//ǰ˵material غ˶ӦDriverMaterial
 		DriverMaterial::Ptr get(const Material::Ptr& material) noexcept;
 
+		//ֻҲ޸üûʱnullptrȾбĹ߳̿ͬʱ
+		const DriverMaterial* find(const Material* material) const noexcept;
+
 		void onMaterialDispose(const EventBase::Ptr& event);
 
 		//uniform
-		static void refreshMaterialUniforms(UniformHandleMap& uniformHandleMap, const Material::Ptr& material);
+		static void refreshMaterialUniforms(UniformHandleMap& uniformHandleMap, const Material::Ptr& material, const DriverTextures::Ptr& textures);
+
+		static void refreshMaterialPhong(UniformHandleMap& uniformHandleMap, const MeshPhongMaterial::Ptr& material, const DriverTextures::Ptr& textures);
 
-		static void refreshMaterialPhong(UniformHandleMap& uniformHandleMap, const MeshPhongMaterial::Ptr& material);
+		static void refreshMaterialBasic(UniformHandleMap& uniformHandleMap, const MeshBasicMaterial::Ptr& material, const DriverTextures::Ptr& textures);
 
-		static void refreshMaterialBasic(UniformHandleMap& uniformHandleMap, const MeshBasicMaterial::Ptr& material);
+		//diffuseMapʱڵҳuv任
+		static void refreshDiffuseMap(UniformHandleMap& uniformHandleMap, const Material::Ptr& material, const DriverTextures::Ptr& textures);
 
 		static void refreshMaterialCube(UniformHandleMap& uniformHandleMap, const CubeMaterial::Ptr& material);
 
@@ -52,6 +52,9 @@ namespace ff
 
 		Geometry::Ptr update(const RenderableObject::Ptr& object) noexcept;
 
+		//构建渲染列表时使用：不生成也不拷贝智能指针，返回object的geometry
+		Geometry* update(RenderableObject* object) noexcept;
+
 	private:
 		std::unordered_map<ID, uint32_t> m_updateMap{};
 
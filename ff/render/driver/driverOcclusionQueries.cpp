@@ -0,0 +1,296 @@
+#include "driverOcclusionQueries.h"
+#include "../../geometries/boxGeometry.h"
+#include "../../objects/mesh.h"
+#include "../../material/meshBasicMaterial.h"
+#include "../shaders/shaderLib/occlusionQueryShader.h"
+
+namespace ff
+{
+	DriverOcclusionQueries::DriverOcclusionQueries(
+		const DriverObjects::Ptr& objects,
+		const DriverBindingStates::Ptr& bindingStates,
+		const DriverState::Ptr& state,
+		const DriverInfo::Ptr& info
+	) noexcept
+	{
+		m_objects = objects;
+		m_bindingStates = bindingStates;
+		m_state = state;
+		m_info = info;
+
+		//包围盒只参与深度测试：双面、不写深度、不混合
+		m_boxMaterial = MeshBasicMaterial::create();
+		m_boxMaterial->m_side = Side::DoubleSide;
+		m_boxMaterial->m_depthWrite = false;
+		m_boxMaterial->m_depthFunction = CompareFunction::LessOrEqual;
+		m_boxMaterial->m_blendingType = BlendingType::NoBlending;
+
+		m_box = Mesh::create(BoxGeometry::create(1.0f, 1.0f, 1.0f), m_boxMaterial);
+	}
+
+	DriverOcclusionQueries::~DriverOcclusionQueries() noexcept
+	{
+		for (const auto& iter : m_states)
+		{
+			if (iter.second.m_query)
+			{
+				glDeleteQueries(1, &iter.second.m_query);
+			}
+		}
+
+		if (!m_freeQueries.empty())
+		{
+			glDeleteQueries(static_cast<GLsizei>(m_freeQueries.size()), m_freeQueries.data());
+		}
+
+		if (m_program)
+		{
+			glDeleteProgram(m_program);
+		}
+	}
+
+	void DriverOcclusionQueries::beginFrame() noexcept
+	{
+		m_frame++;
+		m_drawsSaved = 0;
+		m_queryList.clear();
+
+		//1 只读取已经可用的结果，没有完成的查询留到之后的帧，不会等待GPU
+		for (size_t i = 0; i < m_pending.size();)
+		{
+			auto& state = m_states[m_pending[i]];
+
+			GLuint available = 0;
+			glGetQueryObjectuiv(state.m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+			{
+				++i;
+				continue;
+			}
+
+			GLuint anySamplesPassed = 0;
+			glGetQueryObjectuiv(state.m_query, GL_QUERY_RESULT, &anySamplesPassed);
+			state.m_visible = anySamplesPassed != 0;
+
+			releaseQuery(state.m_query);
+			state.m_query = 0;
+
+			m_pending[i] = m_pending.back();
+			m_pending.pop_back();
+		}
+
+		//2 物体没有析构通知，长时间没有通过视锥体剪裁的状态在这里清理
+		if (m_frame % EvictFrames == 0)
+		{
+			for (auto iter = m_states.begin(); iter != m_states.end();)
+			{
+				if (iter->second.m_query == 0 && m_frame - iter->second.m_seenFrame > EvictFrames)
+				{
+					iter = m_states.erase(iter);
+				}
+				else
+				{
+					++iter;
+				}
+			}
+		}
+	}
+
+	bool DriverOcclusionQueries::isCandidate(RenderableObject* object) const noexcept
+	{
+		const auto& material = object->getMaterial();
+		if (material == nullptr || material->m_transparent || !material->m_depthTest)
+		{
+			return false;
+		}
+
+		const auto& geometry = object->getGeometry();
+		if (geometry == nullptr)
+		{
+			return false;
+		}
+
+		auto index = geometry->getIndex();
+		if (index != nullptr)
+		{
+			return index->getCount() >= m_minVertexCount;
+		}
+
+		auto position = geometry->getAttribute("position");
+		return position != nullptr && position->getCount() >= m_minVertexCount;
+	}
+
+	bool DriverOcclusionQueries::isVisible(RenderableObject* object) noexcept
+	{
+		if (!isCandidate(object))
+		{
+			return true;
+		}
+
+		auto& state = m_states[object->getID()];
+		state.m_object = object;
+
+		//上一帧不在视野内的物体，之前的查询结果已经过时，先当作可见
+		if (state.m_seenFrame + 1 < m_frame)
+		{
+			state.m_visible = true;
+		}
+		state.m_seenFrame = m_frame;
+
+		//被遮挡物体的查询迟迟没有返回，保守地当作可见
+		bool visible = state.m_visible;
+		if (!visible && state.m_query != 0 && m_frame - state.m_issuedFrame > MaxLatency)
+		{
+			visible = true;
+		}
+
+		//同一时间每个物体只有一个未完成的查询：被遮挡的物体每帧重新测试，可见的物体按ID错开间隔测试
+		if (state.m_query == 0)
+		{
+			bool retest = !state.m_visible ||
+				m_frame - state.m_testedFrame >= RetestInterval + (object->getID() % RetestInterval);
+			if (retest)
+			{
+				m_queryList.push_back(object->getID());
+			}
+		}
+
+		if (!visible)
+		{
+			m_drawsSaved++;
+		}
+
+		return visible;
+	}
+
+	void DriverOcclusionQueries::issueQueries(const glm::mat4& viewProjection, const glm::vec3& cameraPosition) noexcept
+	{
+		uint32_t issued = 0;
+
+		if (!m_queryList.empty())
+		{
+			if (!m_program)
+			{
+				createProgram();
+			}
+
+			//包围盒的立方体与普通物体一样上传并绑定VAO，保持DriverBindingStates的缓存正确
+			auto geometry = m_objects->update(m_box);
+			m_bindingStates->setup(geometry, geometry->getIndex());
+
+			m_state->setMaterial(m_boxMaterial);
+			m_state->useProgram(m_program);
+			glUniformMatrix4fv(m_viewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+
+			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+			auto indexCount = static_cast<GLsizei>(geometry->getIndex()->getCount());
+			for (auto id : m_queryList)
+			{
+				auto& state = m_states[id];
+				state.m_testedFrame = m_frame;
+
+				//稍微放大包围盒，避免与物体表面深度相等时的精度问题
+				const auto& box = state.m_object->getWorldBoundingBox();
+				glm::vec3 margin = (box.m_max - box.m_min) * 0.01f + glm::vec3(1e-3f);
+				glm::vec3 boxMin = box.m_min - margin;
+				glm::vec3 boxMax = box.m_max + margin;
+
+				//相机在包围盒内时，立方体的正面会被近平面裁掉，直接视为可见
+				if (glm::all(glm::greaterThanEqual(cameraPosition, boxMin)) && glm::all(glm::lessThanEqual(cameraPosition, boxMax)))
+				{
+					state.m_visible = true;
+					continue;
+				}
+
+				state.m_query = acquireQuery();
+				state.m_issuedFrame = m_frame;
+				m_pending.push_back(id);
+
+				glUniform3fv(m_boxMinLocation, 1, glm::value_ptr(boxMin));
+				glUniform3fv(m_boxMaxLocation, 1, glm::value_ptr(boxMax));
+
+				glBeginQuery(GL_ANY_SAMPLES_PASSED, state.m_query);
+				glDrawElements(GL_TRIANGLES, indexCount, toGL(geometry->getIndex()->getDataType()), 0);
+				glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+				issued++;
+			}
+
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			m_queryList.clear();
+		}
+
+		m_info->m_occlusionQuery.m_issued = issued;
+		m_info->m_occlusionQuery.m_pending = static_cast<uint32_t>(m_pending.size());
+		m_info->m_occlusionQuery.m_drawsSaved = m_drawsSaved;
+	}
+
+	GLuint DriverOcclusionQueries::acquireQuery() noexcept
+	{
+		if (m_freeQueries.empty())
+		{
+			GLuint query = 0;
+			glGenQueries(1, &query);
+			return query;
+		}
+
+		auto query = m_freeQueries.back();
+		m_freeQueries.pop_back();
+		return query;
+	}
+
+	void DriverOcclusionQueries::releaseQuery(GLuint query) noexcept
+	{
+		m_freeQueries.push_back(query);
+	}
+
+	void DriverOcclusionQueries::createProgram() noexcept
+	{
+		auto vertex = occlusionQuery::vertex.c_str();
+		auto fragment = occlusionQuery::fragment.c_str();
+
+		char infoLog[512];
+		int  successFlag = 0;
+
+		GLuint vertexID = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertexID, 1, &vertex, NULL);
+		glCompileShader(vertexID);
+
+		glGetShaderiv(vertexID, GL_COMPILE_STATUS, &successFlag);
+		if (!successFlag)
+		{
+			glGetShaderInfoLog(vertexID, 512, NULL, infoLog);
+			std::cout << infoLog << std::endl;
+		}
+
+		GLuint fragID = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragID, 1, &fragment, NULL);
+		glCompileShader(fragID);
+
+		glGetShaderiv(fragID, GL_COMPILE_STATUS, &successFlag);
+		if (!successFlag)
+		{
+			glGetShaderInfoLog(fragID, 512, NULL, infoLog);
+			std::cout << infoLog << std::endl;
+		}
+
+		m_program = glCreateProgram();
+		glAttachShader(m_program, vertexID);
+		glAttachShader(m_program, fragID);
+		glLinkProgram(m_program);
+
+		glGetProgramiv(m_program, GL_LINK_STATUS, &successFlag);
+		if (!successFlag)
+		{
+			glGetProgramInfoLog(m_program, 512, NULL, infoLog);
+			std::cout << infoLog << std::endl;
+		}
+		glDeleteShader(vertexID);
+		glDeleteShader(fragID);
+
+		m_viewProjectionLocation = glGetUniformLocation(m_program, "viewProjectionMatrix");
+		m_boxMinLocation = glGetUniformLocation(m_program, "boxMin");
+		m_boxMaxLocation = glGetUniformLocation(m_program, "boxMax");
+	}
+}
@@ -0,0 +1,119 @@
+/**
+ * @class DriverOcclusionQueries
+ * @brief 基于GPU遮挡查询(GL_ANY_SAMPLES_PASSED)的可见性判定，利用帧间连贯性跳过被遮挡的高开销物体。
+ *
+ * 本类对顶点数超过阈值的不透明物体发起包围盒遮挡查询：
+ * - 不透明物体绘制完毕之后，用世界空间AABB绘制一个不写颜色、不写深度的立方体，统计是否有片元通过深度测试；
+ * - 查询结果在之后的帧里以 GL_QUERY_RESULT_AVAILABLE 非阻塞地读取，通常延迟1~2帧，从不等待GPU；
+ * - 渲染列表构建时直接使用最近一次的查询结果，被判定为遮挡的物体不压入渲染列表，节省其drawCall；
+ * - 保守的重新测试：被遮挡的物体每一帧都重新查询，可见的物体每隔若干帧(按ID错开)重新查询；
+ *   上一帧不在视锥体内的物体、相机位于包围盒内的物体、查询结果迟迟没有返回的被遮挡物体都视为可见。
+ *
+ * 每帧调用顺序：beginFrame -> isVisible(渲染列表构建时) -> issueQueries(不透明物体绘制之后)。
+ *
+ * @note 需要OpenGL 3.3(GL_ANY_SAMPLES_PASSED)，软件光栅化的Mesa llvmpipe同样支持，可以无GPU测试。
+ * @note 查询所使用的立方体几何体通过DriverObjects/DriverBindingStates上传与绑定，状态经DriverState设置，不破坏状态缓存。
+ * @see ff::Renderer::enableOcclusionQueries
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../../global/base.h"
+#include "../../objects/renderableObject.h"
+#include "../../material/material.h"
+#include "driverObjects.h"
+#include "driverBindingState.h"
+#include "driverState.h"
+#include "driverInfo.h"
+
+namespace ff
+{
+	class DriverOcclusionQueries
+	{
+	public:
+		//每个参与查询的物体的状态
+		struct QueryState
+		{
+			GLuint				m_query{ 0 };			//尚未读取结果的查询，0表示没有
+			uint32_t			m_issuedFrame{ 0 };		//m_query发起的帧
+			uint32_t			m_testedFrame{ 0 };		//最近一次发起查询的帧
+			uint32_t			m_seenFrame{ 0 };		//最近一次通过视锥体剪裁的帧
+			bool				m_visible{ true };		//最近一次查询结果
+			RenderableObject*	m_object{ nullptr };	//只在本帧内有效
+		};
+
+		using Ptr = std::shared_ptr<DriverOcclusionQueries>;
+		static Ptr create(
+			const DriverObjects::Ptr& objects,
+			const DriverBindingStates::Ptr& bindingStates,
+			const DriverState::Ptr& state,
+			const DriverInfo::Ptr& info)
+		{
+			return std::make_shared<DriverOcclusionQueries>(objects, bindingStates, state, info);
+		}
+
+		DriverOcclusionQueries(
+			const DriverObjects::Ptr& objects,
+			const DriverBindingStates::Ptr& bindingStates,
+			const DriverState::Ptr& state,
+			const DriverInfo::Ptr& info
+		) noexcept;
+
+		~DriverOcclusionQueries() noexcept;
+
+		//非阻塞地读取已经完成的查询结果，并清理长时间没有出现的物体
+		void beginFrame() noexcept;
+
+		//通过视锥体剪裁的物体是否需要绘制，同时决定本帧是否为其发起查询
+		//不参与查询的物体(顶点数低于阈值或透明)总是返回true
+		bool isVisible(RenderableObject* object) noexcept;
+
+		//在不透明物体绘制之后调用，为本帧需要测试的物体绘制包围盒查询
+		void issueQueries(const glm::mat4& viewProjection, const glm::vec3& cameraPosition) noexcept;
+
+		//顶点数(有index时为index数)不低于该值的物体才发起查询
+		void setMinVertexCount(uint32_t count) noexcept { m_minVertexCount = count; }
+
+		uint32_t getMinVertexCount() const noexcept { return m_minVertexCount; }
+
+	private:
+		bool isCandidate(RenderableObject* object) const noexcept;
+
+		GLuint acquireQuery() noexcept;
+
+		void releaseQuery(GLuint query) noexcept;
+
+		void createProgram() noexcept;
+
+	private:
+		static constexpr uint32_t RetestInterval = 4;		//可见物体重新查询的间隔帧数
+		static constexpr uint32_t MaxLatency = 3;			//被遮挡物体的查询超过该帧数没有结果时视为可见
+		static constexpr uint32_t EvictFrames = 120;		//超过该帧数没有出现的物体状态被清理
+
+		uint32_t	m_frame{ 0 };
+		uint32_t	m_minVertexCount{ 1000 };
+
+		std::unordered_map<ID, QueryState>	m_states{};
+		std::vector<ID>						m_pending{};		//持有未读取查询的物体
+		std::vector<ID>						m_queryList{};		//本帧需要发起查询的物体
+		std::vector<GLuint>					m_freeQueries{};
+
+		//本帧统计
+		uint32_t	m_drawsSaved{ 0 };
+
+		//包围盒的绘制资源
+		RenderableObject::Ptr	m_box{ nullptr };
+		Material::Ptr			m_boxMaterial{ nullptr };
+		GLuint					m_program{ 0 };
+		GLint					m_viewProjectionLocation{ -1 };
+		GLint					m_boxMinLocation{ -1 };
+		GLint					m_boxMaxLocation{ -1 };
+
+		DriverObjects::Ptr			m_objects{ nullptr };
+		DriverBindingStates::Ptr	m_bindingStates{ nullptr };
+		DriverState::Ptr			m_state{ nullptr };
+		DriverInfo::Ptr				m_info{ nullptr };
+	};
+}
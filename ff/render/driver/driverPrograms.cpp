@@ -38,6 +38,8 @@ namespace ff {
 		prefixFragment.append(parameters->mHasDiffuseMap ? "#define HAS_DIFFUSE_MAP\n" : "");
 		prefixFragment.append(parameters->mHasEnvCubeMap ? "#define USE_ENVMAP\n" : "");
 		prefixFragment.append(parameters->mHasSpecularMap ? "#define USE_SPECULARMAP\n" : "");
+		prefixFragment.append(parameters->mDiffuseMapAtlas ? "#define USE_DIFFUSE_ATLAS\n" : "");
+		prefixFragment.append(parameters->mDiffuseMapArray ? "#define USE_DIFFUSE_ARRAY\n" : "");
 
 		prefixFragment.append(parameters->mShadowMapEnabled ? "#define USE_SHADOWMAP\n" : "");
 		prefixFragment.append(parameters->mDepthPacking == DepthMaterial::RGBADepthPacking ? "#define DEPTH_PACKING_RGBA\n" : "");
@@ -167,8 +169,8 @@ namespace ff {
 		return extensionString;
 	}
 
-	void DriverProgram::uploadUniforms(UniformHandleMap& uniformMap, const DriverTextures::Ptr& textures) {
-		mUniforms->upload(uniformMap, textures);
+	uint32_t DriverProgram::uploadUniforms(UniformHandleMap& uniformMap, const DriverTextures::Ptr& textures) {
+		return mUniforms->upload(uniformMap, textures);
 	}
 
 //--------driver programs----------------------------
@@ -207,7 +209,8 @@ namespace ff {
 		const Material::Ptr& material,
 		const Object3D::Ptr& object,
 		const DriverLights::Ptr& lights,
-		const DriverShadowMap::Ptr& shadowMap
+		const DriverShadowMap::Ptr& shadowMap,
+		const DriverTextures::Ptr& textures
 	) noexcept {
 		auto renderObject = std::static_pointer_cast<RenderableObject>(object);
 		auto geometry = renderObject->getGeometry();
@@ -245,6 +248,13 @@ namespace ff {
 
 		if (material->m_diffuseMap != nullptr) {
 			parameters->mHasDiffuseMap = true;
+
+			//被打包的diffuseMap由图集页或纹理数组代替，采样方式不同
+			auto region = textures->getAtlasRegion(material->m_diffuseMap);
+			if (region != nullptr) {
+				parameters->mDiffuseMapArray = region->m_page->m_textureType == TextureType::Texture2DArray;
+				parameters->mDiffuseMapAtlas = !parameters->mDiffuseMapArray;
+			}
 		}
 
 		if (material->m_envMap != nullptr) {
@@ -308,6 +318,8 @@ namespace ff {
 		keyString.append(std::to_string(parameters->mHasDiffuseMap));
 		keyString.append(std::to_string(parameters->mHasEnvCubeMap));
 		keyString.append(std::to_string(parameters->mHasSpecularMap));
+		keyString.append(std::to_string(parameters->mDiffuseMapAtlas));
+		keyString.append(std::to_string(parameters->mDiffuseMapArray));
 		keyString.append(std::to_string(parameters->mDirectionalLightCount));
 		keyString.append(std::to_string(parameters->mNumDirectionalLightShadows));
 		keyString.append(std::to_string(parameters->mSkinning));
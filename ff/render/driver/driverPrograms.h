@@ -29,6 +29,8 @@ namespace ff {
 			bool			mHasDiffuseMap{ false };//本次绘制的模型所使用的材质是否有diffuseMap
 			bool			mHasEnvCubeMap{ false };//本次绘制的模型所使用的材质是否有环境贴图
 			bool			mHasSpecularMap{ false };//本次绘制的模型所使用的材质是否有镜面反射贴图
+			bool			mDiffuseMapAtlas{ false };//diffuseMap被打包进了图集页
+			bool			mDiffuseMapArray{ false };//diffuseMap被打包进了纹理数组
 
 			bool			mShadowMapEnabled{ false };//是否启用阴影
 			uint32_t		mDirectionalLightCount{ 0 };
@@ -58,7 +60,8 @@ namespace ff {
 
 		GLuint		mProgram{ 0 };
 
-		void uploadUniforms(UniformHandleMap& uniformGroup, const DriverTextures::Ptr& textures);
+		//返回上传的uniform数
+		uint32_t uploadUniforms(UniformHandleMap& uniformGroup, const DriverTextures::Ptr& textures);
 
 	private:
 		void replaceAttributeLocations(std::string& shader) noexcept;
@@ -96,7 +99,8 @@ namespace ff {
 			const Material::Ptr& material,
 			const Object3D::Ptr& object, 
 			const DriverLights::Ptr& lights,
-			const DriverShadowMap::Ptr& shadowMap) noexcept;
+			const DriverShadowMap::Ptr& shadowMap,
+			const DriverTextures::Ptr& textures) noexcept;
 
 		HashType getProgramCacheKey(const DriverProgram::Parameters::Ptr& parameters) noexcept;
 
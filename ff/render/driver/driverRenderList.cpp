@@ -2,9 +2,112 @@
 
 namespace ff {
 
-	RenderItem::RenderItem() noexcept {}
+	namespace
+	{
+		uint64_t fieldMask(uint32_t bits) noexcept
+		{
+			return bits >= 64 ? UINT64_MAX : (1ull << bits) - 1;
+		}
+
+		//非负浮点数的位模式与其大小顺序一致，去掉符号位后取高bits位
+		uint64_t quantizeDepth(float depth, uint32_t bits) noexcept
+		{
+			if (!(depth > 0.0f))
+			{
+				return 0;
+			}
+
+			uint32_t value = 0;
+			std::memcpy(&value, &depth, sizeof(value));
+
+			bits = std::min(bits, 31u);
+			return value >> (31 - bits);
+		}
+
+		//距离取以2为底的对数后按1/2^split的步长分桶，[0, 1)为第0个桶
+		uint64_t depthBucket(float depth, uint32_t split) noexcept
+		{
+			if (!(depth >= 1.0f))
+			{
+				return 0;
+			}
+
+			//指数与尾数的高split位
+			uint32_t value = 0;
+			std::memcpy(&value, &depth, sizeof(value));
 
-	RenderItem::~RenderItem() noexcept {}
+			split = std::min(split, 23u);
+			return (value >> (23 - split)) - (127u << split);
+		}
+	}
+
+	uint32_t SortKeyLayout::getTotalBits() const noexcept
+	{
+		uint32_t total = 0;
+		for (const auto& field : m_fields)
+		{
+			total += field.m_bits;
+		}
+
+		return total;
+	}
+
+	SortKeyLayout SortKeyLayout::opaque(OpaqueSortMode mode) noexcept
+	{
+		SortKeyLayout layout;
+		switch (mode)
+		{
+		case OpaqueSortMode::FrontToBack:
+			layout.m_fields = {
+				{ SortKeyField::GroupOrder, 4, true },
+				{ SortKeyField::Depth, 24, false },
+				{ SortKeyField::Program, 10, false },
+				{ SortKeyField::Texture, 10, false },
+				{ SortKeyField::Material, 8, false },
+				{ SortKeyField::VAO, 8, false },
+			};
+			break;
+		case OpaqueSortMode::StateSorted:
+			layout.m_fields = {
+				{ SortKeyField::GroupOrder, 4, true },
+				{ SortKeyField::Program, 10, false },
+				{ SortKeyField::Texture, 12, false },
+				{ SortKeyField::Material, 12, false },
+				{ SortKeyField::VAO, 12, false },
+				{ SortKeyField::Depth, 14, false },
+			};
+			break;
+		default:
+			//每个2的幂区间16个桶(相邻桶的距离相差约4.4%)，256个桶覆盖到2^16的距离，更远的物体放在最后一个桶
+			//桶再粗时桶内的大物体互相遮挡，early-z的收益很快丢失，见examples/opaqueSortBench
+			layout.m_fields = {
+				{ SortKeyField::GroupOrder, 4, true },
+				{ SortKeyField::DepthBucket, 8, false, 4 },
+				{ SortKeyField::Program, 10, false },
+				{ SortKeyField::Texture, 12, false },
+				{ SortKeyField::Material, 12, false },
+				{ SortKeyField::VAO, 12, false },
+				{ SortKeyField::Depth, 6, false },
+			};
+			break;
+		}
+
+		return layout;
+	}
+
+	SortKeyLayout SortKeyLayout::transparent() noexcept
+	{
+		SortKeyLayout layout;
+		layout.m_fields = {
+			{ SortKeyField::GroupOrder, 4, true },
+			{ SortKeyField::Depth, 24, true },
+			{ SortKeyField::Program, 12, false },
+			{ SortKeyField::Material, 12, false },
+			{ SortKeyField::VAO, 12, false },
+		};
+
+		return layout;
+	}
 
 	DriverRenderList::DriverRenderList() {}
 
@@ -13,7 +116,6 @@ namespace ff {
 	//每一帧开始的时候，渲染列表都会被清空
 	void DriverRenderList::init() noexcept 
 	{
-		m_renderItemIndex = 0;
 		m_opaqueue.clear();
 		m_transparents.clear();
 	}
@@ -22,18 +124,17 @@ namespace ff {
 	//为什么需要解包传送,有可能会有替代,举例：本来object拥有一个material，但是scene也拥有一个overrideMaterial
 	//那么就不能使用object原来的material
 	void DriverRenderList::push(
-		const RenderableObject::Ptr& object,
-		const Geometry::Ptr& geometry,
-		const Material::Ptr& material,
+		RenderableObject* object,
+		Geometry* geometry,
+		Material* material,
 		const uint32_t& groupOrder,
-		float z
+		float z,
+		uint32_t programID,
+		uint32_t textureID
 	) noexcept
 	{
-		//每一帧都会重新构建renderList，所以比如有5个物体，如果不做renderItem的缓存，那么
-		//每一帧都要重新new 5个renderItem
-		//所以上一帧假设我们已经生成了10个renderItem，那么会将其缓存在renderItemCache里面，在需要的时候，就
-		//从中取出一个给到renderList使用
-		const auto renderItem = getNextRenderItem(object, geometry, material, groupOrder, z);
+		//RenderItem按值写入数组，容量在之前的帧已经足够时不会分配内存
+		auto renderItem = makeRenderItem(object, geometry, material, groupOrder, z, programID, textureID);
 
 		if (material->m_transparent)
 		{
@@ -45,36 +146,208 @@ namespace ff {
 		}
 	}
 
-	RenderItem::Ptr DriverRenderList::getNextRenderItem(
-		const RenderableObject::Ptr& object,
-		const Geometry::Ptr& geometry,
-		const Material::Ptr& material,
+	void DriverRenderList::initPartials(uint32_t count) noexcept
+	{
+		if (m_partials.size() < count)
+		{
+			m_partials.resize(count);
+		}
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			m_partials[i].m_opaques.clear();
+			m_partials[i].m_transparents.clear();
+		}
+
+		m_partialCount = count;
+	}
+
+	void DriverRenderList::pushPartial(
+		uint32_t partial,
+		RenderableObject* object,
+		Geometry* geometry,
+		Material* material,
 		const uint32_t& groupOrder,
-		float z
-	) noexcept 
+		float z,
+		uint32_t programID,
+		uint32_t textureID
+	) noexcept
 	{
-		RenderItem::Ptr renderItem = nullptr;
-		if (m_renderItemIndex >= m_renderItemCache.size()) //当前renderItem的总数已经大于了缓存数量，那么就重新生成
+		auto renderItem = makeRenderItem(object, geometry, material, groupOrder, z, programID, textureID);
+
+		auto& target = m_partials[partial];
+		if (material->m_transparent)
+		{
+			target.m_transparents.push_back(renderItem);
+		}
+		else
+		{
+			target.m_opaques.push_back(renderItem);
+		}
+	}
+
+	void DriverRenderList::mergePartials(const std::function<bool(const RenderItem&)>& filter) noexcept
+	{
+		auto append = [&filter](std::vector<RenderItem>& items, const std::vector<RenderItem>& partialItems) {
+			if (filter == nullptr)
+			{
+				items.insert(items.end(), partialItems.begin(), partialItems.end());
+				return;
+			}
+
+			for (const auto& item : partialItems)
+			{
+				if (filter(item))
+				{
+					items.push_back(item);
+				}
+			}
+		};
+
+		for (uint32_t i = 0; i < m_partialCount; ++i)
 		{
-			renderItem = RenderItem::create();
-			m_renderItemCache.push_back(renderItem);
+			append(m_opaqueue, m_partials[i].m_opaques);
 		}
-		else  //否则直接从缓存当中抽欺第mRenderItemIndex个item
+
+		for (uint32_t i = 0; i < m_partialCount; ++i)
 		{
-			renderItem = m_renderItemCache[m_renderItemIndex];
+			append(m_transparents, m_partials[i].m_transparents);
 		}
 
-		renderItem->m_id = object->getID();
-		renderItem->m_object = object;
-		renderItem->m_geometry = geometry;
-		renderItem->m_material = material;
-		renderItem->m_z = z;
+		m_partialCount = 0;
+	}
+
+	RenderItem DriverRenderList::makeRenderItem(
+		RenderableObject* object,
+		Geometry* geometry,
+		Material* material,
+		uint32_t groupOrder,
+		float z,
+		uint32_t programID,
+		uint32_t textureID) const noexcept
+	{
+		RenderItem renderItem;
+		renderItem.m_id = object->getID();
+		renderItem.m_object = object;
+		renderItem.m_geometry = geometry;
+		renderItem.m_material = material;
+		renderItem.m_z = z;
+		renderItem.m_groupOrder = groupOrder;
 
-		m_renderItemIndex++;  
+		//相机看向-z，可见物体的z为负
+		const auto& layout = material->m_transparent ? m_transparentLayout : m_opaqueLayout;
+		SortKeyInput input;
+		input.m_groupOrder = groupOrder;
+		input.m_program = programID;
+		input.m_texture = textureID;
+		input.m_material = material->getID();
+		input.m_vao = geometry->getID();
+		input.m_depth = -z;
+		renderItem.m_sortKey = makeSortKey(layout, input);
 
 		return renderItem;
 	}
 
+	uint64_t DriverRenderList::makeSortKey(const SortKeyLayout& layout, const SortKeyInput& input) noexcept
+	{
+		uint64_t key = 0;
+		for (const auto& field : layout.m_fields)
+		{
+			uint64_t mask = fieldMask(field.m_bits);
+			uint64_t value = 0;
+
+			switch (field.m_field)
+			{
+			case SortKeyField::GroupOrder:
+				value = std::min<uint64_t>(input.m_groupOrder, mask);
+				break;
+			case SortKeyField::Program:
+				value = input.m_program & mask;
+				break;
+			case SortKeyField::Texture:
+				value = input.m_texture & mask;
+				break;
+			case SortKeyField::Material:
+				value = input.m_material & mask;
+				break;
+			case SortKeyField::VAO:
+				value = input.m_vao & mask;
+				break;
+			case SortKeyField::Depth:
+				value = quantizeDepth(input.m_depth, field.m_bits);
+				break;
+			case SortKeyField::DepthBucket:
+				value = std::min(depthBucket(input.m_depth, field.m_split), mask);
+				break;
+			default:
+				break;
+			}
+
+			if (field.m_descending)
+			{
+				value = mask - value;
+			}
+
+			key = (field.m_bits >= 64 ? 0 : key << field.m_bits) | value;
+		}
+
+		return key;
+	}
+
+	bool DriverRenderList::setOpaqueLayout(const SortKeyLayout& layout) noexcept
+	{
+		if (layout.getTotalBits() > 64)
+		{
+			std::cout << "Error: DriverRenderList::setOpaqueLayout, sort key has more than 64 bits" << std::endl;
+			return false;
+		}
+
+		m_opaqueLayout = layout;
+		return true;
+	}
+
+	bool DriverRenderList::setTransparentLayout(const SortKeyLayout& layout) noexcept
+	{
+		if (layout.getTotalBits() > 64)
+		{
+			std::cout << "Error: DriverRenderList::setTransparentLayout, sort key has more than 64 bits" << std::endl;
+			return false;
+		}
+
+		m_transparentLayout = layout;
+		return true;
+	}
+
+	void DriverRenderList::sort() noexcept
+	{
+		sortItems(m_opaqueue);
+		sortItems(m_transparents);
+	}
+
+	void DriverRenderList::sortItems(std::vector<RenderItem>& items) noexcept
+	{
+		if (items.size() < 2)
+		{
+			return;
+		}
+
+		//只对键与下标排序，最后按结果一次性重排RenderItem
+		m_sortEntries.clear();
+		for (uint32_t i = 0; i < items.size(); ++i)
+		{
+			m_sortEntries.push_back({ items[i].m_sortKey, i });
+		}
+
+		radixSort(m_sortEntries, m_sortScratch);
+
+		m_sortedItems.resize(items.size());
+		for (size_t i = 0; i < m_sortEntries.size(); ++i)
+		{
+			m_sortedItems[i] = items[m_sortEntries[i].m_index];
+		}
+		items.swap(m_sortedItems);
+	}
+
 	void DriverRenderList::sort(
 		const RenderListSortFunction& opaqueSort,
 		const RenderListSortFunction& transparentSort) noexcept 
@@ -84,27 +357,8 @@ namespace ff {
 		if (!m_transparents.empty()) std::sort(m_transparents.begin(), m_transparents.end(), transparentSort);
 	}
 
-	//如果缓存当中存在10个item，本帧只有5个物体需要渲染，那么就会使用到10个item里面的五个
-	//但是！剩下的没有使用到的五个，item里面，却存有object、materil、geometry的智能指针,则其内存无法被释放
-	//所以finish需要检测剩下的没有使用到的item，然后依次将其智能指针的引用置空
+	//RenderItem不持有对象、几何体与材质的引用，上一帧留下的数据不会阻止它们被释放，这里不需要清理
 	void DriverRenderList::finish() noexcept 
 	{
-		auto listSize = m_renderItemCache.size();
-
-		for (uint32_t i = m_renderItemIndex; i < listSize; ++i)
-		{
-			auto renderItem = m_renderItemCache[i];
-			if (renderItem == nullptr)
-			{
-				break;
-			}
-
-			renderItem->m_id = 0;
-			renderItem->m_object = nullptr;
-			renderItem->m_geometry = nullptr;
-			renderItem->m_groupOrder = 0;
-			renderItem->m_material = nullptr;
-			renderItem->m_z = 0;
-		}
 	}
 }
\ No newline at end of file
@@ -7,11 +7,13 @@
  * - 几何体（Geometry）
  * - 材质（Material）
  * - 所属对象（RenderableObject）
- * - 排序相关属性（m_z、m_groupOrder、m_id）
+ * - 排序相关属性（m_z、m_groupOrder、m_id），以及由它们与program、材质、VAO打包成的64位排序键（m_sortKey）
  *
- * 可配合排序函数（如 `smallerZFirstSort` 和 `biggerZFirstSort`）实现对不透明物体和透明物体的不同渲染顺序。
+ * 绘制顺序由 m_sortKey 决定(布局见 SortKeyLayout)，也可以向 DriverRenderList::sort 传入自定义的比较函数。
  *
  * @note RenderItem 不涉及 OpenGL 渲染指令，仅作为渲染调度的数据结构。
+ * @note RenderItem 是按值存储的POD，对象、几何体与材质都是不持有所有权的裸指针，
+ *       它们由场景持有，在本帧渲染结束之前一定有效；不要跨帧保存 RenderItem。
  * @see DriverRenderList
  * @author qiang.guo
  * @date 2025-06-19
@@ -26,7 +28,9 @@
   * - 存储当前帧的渲染对象（RenderItem）
   * - 区分不透明物体与透明物体（根据 Material 的 transparent 标志）
   * - 提供排序策略支持（如 Z 轴排序、GroupOrder 等）
-  * - 使用缓存机制避免频繁创建 RenderItem
+  * - 压入时按 SortKeyLayout 计算每个 RenderItem 的64位排序键，sort() 对键做基数排序，不调用比较函数
+  * - RenderItem 按值连续存储在每帧复用的数组中，数量不超过之前的帧时压入与排序都不分配内存，也不修改引用计数
+  * - 多线程构建：每个区间压入自己的局部列表(pushPartial)，再由 mergePartials 按区间顺序合并
   *
   * Example usage:
   * @code
@@ -34,12 +38,23 @@
   * renderList->push(meshObj, meshGeo, meshMat, groupOrder, cameraZ);
   * renderList->sort(); // 排序非透明与透明物体
   * renderList->finish();
-  * auto& opaques = renderList->getOpaqueue();
-  * auto& transparents = renderList->getTransparents();
+  * for (const auto& item : renderList->getOpaques()) { ... }
+  * for (const auto& item : renderList->getTransparents()) { ... }
   * @endcode
   *
   * @note 每帧使用流程：init -> push -> sort -> finish。
-  * @note 渲染顺序依赖 m_groupOrder, m_z, m_id 进行优先级判断。
+  * @note 多线程构建时为 init -> initPartials -> 各线程pushPartial -> mergePartials -> sort -> finish，
+  *       一个局部列表同一时间只能由一个线程写入；合并后的顺序与按区间顺序逐个push相同，排序结果也相同。
+  * @note 不透明物体的键由 OpaqueSortMode 决定(默认Hybrid)，groupOrder(大的在前)总是在最高位：
+  *       - FrontToBack：深度(近的在前) > program > 贴图 > 材质 > VAO，early-z剔除最多，状态切换也最多；
+  *       - StateSorted：program > 贴图 > 材质 > VAO > 深度，状态切换最少；
+  *       - Hybrid：深度桶(距离的对数，每个2的幂区间16个桶) > program > 贴图 > 材质 > VAO > 深度，
+  *         桶内按状态合并，桶之间仍由近到远；桶的粗细由 SortKeyLayout::Field::m_split 决定；
+  *       透明物体按 groupOrder > 深度(远的在前) > program > 材质 > VAO，保证混合正确。
+  * @note program、贴图、材质与VAO只取编号的低位，不同对象的低位相同时只会影响合并的效果，不影响正确性；
+  *       program使用材质上一次绘制时的program，第一次绘制时为0；贴图为diffuseMap，被打包时为其所在的页。
+  * @note 各种方式实际产生的状态切换可以通过 DriverInfo::m_stateChanges 与 m_textureBinding.m_binds(贴图切换)比较。
+  * @note 传入比较函数的 sort(opaqueSort, transparentSort) 仍然可用，比较规则由调用者给出。
   *
   * @see RenderItem, RenderableObject, Material
   * @author qiang.guo
@@ -52,72 +67,98 @@
 #include "../../objects/renderableObject.h"
 #include "../../core/geometry.h"
 #include "../../material/material.h"
+#include "../../tools/radixSort.h"
 
 namespace ff 
 {
 
 	//mesh line skinnedMesh 都会被解析为RenderItem
-	class RenderItem 
+	struct RenderItem 
 	{
-	public:
-		using Ptr = std::shared_ptr<RenderItem>;
-		static Ptr create()
-		{
-			return std::make_shared<RenderItem>();
-		}
-		
-		RenderItem() noexcept;
-		~RenderItem() noexcept;
-
-
-	public:
+		uint64_t				m_sortKey{ 0 };  //按SortKeyLayout打包的排序键，小的先绘制
+		RenderableObject*		m_object{ nullptr };
+		Material*				m_material{ nullptr };
+		Geometry*				m_geometry{ nullptr };
 		ID						m_id{ 0 };
 		float					m_z{ 0 };  //用来排序-渲染透明物体的时候，从远到进进行渲染
-		RenderableObject::Ptr	m_object{ nullptr };
-		Material::Ptr			m_material{ nullptr };
-		Geometry::Ptr			m_geometry{ nullptr };
 		uint32_t				m_groupOrder{ 0 }; //影响渲染顺序
 	};
 
-	using RenderListSortFunction = std::function<bool(const RenderItem::Ptr&, const RenderItem::Ptr&)>;
+	//渲染列表中一段连续的RenderItem，只在本帧有效
+	class RenderItemSpan
+	{
+	public:
+		RenderItemSpan() noexcept = default;
+
+		RenderItemSpan(const RenderItem* data, size_t size) noexcept : m_data(data), m_size(size) {}
+
+		const RenderItem* begin() const noexcept { return m_data; }
+
+		const RenderItem* end() const noexcept { return m_data + m_size; }
+
+		const RenderItem& operator[](size_t index) const noexcept { return m_data[index]; }
+
+		size_t size() const noexcept { return m_size; }
 
-	//排序的原因:
-	//1 opaque物体需要排序，
-	//>表示大的在前面
-	static bool smallerZFirstSort(const RenderItem::Ptr& item0, const RenderItem::Ptr& item1)
+		bool empty() const noexcept { return m_size == 0; }
+
+	private:
+		const RenderItem*	m_data{ nullptr };
+		size_t				m_size{ 0 };
+	};
+
+	enum class SortKeyField : uint8_t
 	{
-		//首先保证groupOrder大的物体先绘制
-		if (item0->m_groupOrder != item1->m_groupOrder)
-		{
-			return item0->m_groupOrder > item1->m_groupOrder;
-		}
-		else if (item0->m_z != item1->m_z) //小z 排在前面
-		{
-			return item0->m_z < item1->m_z;
-		}
-		else
-		{
-			return item0->m_id > item1->m_id;
-		}
-	}
+		GroupOrder,
+		Program,
+		Texture,
+		Material,
+		VAO,
+		Depth,			//到相机的距离
+		DepthBucket,	//距离所在的对数桶，见 SortKeyLayout::Field::m_split
+	};
 
-	static bool biggerZFirstSort(const RenderItem::Ptr& item0, const RenderItem::Ptr& item1)
+	//不透明物体的排序方式
+	enum class OpaqueSortMode
 	{
-		//首先保证groupOrder大的物体先绘制
-		if (item0->m_groupOrder != item1->m_groupOrder)
-		{
-			return item0->m_groupOrder > item1->m_groupOrder;
-		}
-		else if (item0->m_z != item1->m_z) //小z 排在前面
-		{
-			return item0->m_z > item1->m_z;
-		}
-		else
+		FrontToBack,
+		StateSorted,
+		Hybrid,
+	};
+
+	//计算排序键用到的各项状态
+	struct SortKeyInput
+	{
+		uint32_t	m_groupOrder{ 0 };
+		uint32_t	m_program{ 0 };
+		uint32_t	m_texture{ 0 };
+		uint32_t	m_material{ 0 };
+		uint32_t	m_vao{ 0 };
+		float		m_depth{ 0.0f };	//到相机的距离
+	};
+
+	//排序键的位域，从最高位开始依次排列
+	struct SortKeyLayout
+	{
+		struct Field
 		{
-			return item0->m_id > item1->m_id;
-		}
-	}
+			SortKeyField	m_field{ SortKeyField::GroupOrder };
+			uint8_t			m_bits{ 0 };
+			bool			m_descending{ false }; //值大的在前
+			uint8_t			m_split{ 0 };	//DepthBucket：每个2的幂区间([1, 2) [2, 4) ...)再等分为2^m_split个桶
+		};
+
+		std::vector<Field> m_fields{};
 
+		uint32_t getTotalBits() const noexcept;
+
+		static SortKeyLayout opaque(OpaqueSortMode mode = OpaqueSortMode::Hybrid) noexcept;
+
+		//深度由远到近优先
+		static SortKeyLayout transparent() noexcept;
+	};
+
+	using RenderListSortFunction = std::function<bool(const RenderItem&, const RenderItem&)>;
 
 	//driverRenderList用来存储基础的渲染单元
 	class DriverRenderList 
@@ -135,41 +176,92 @@ namespace ff
 		void init() noexcept;
 
 		//向渲染队列中加入一个renderItem
+		//z为相机空间的z坐标，programID为材质上一次绘制使用的program，textureID为绘制时绑定的diffuseMap，没有时为0
 		void push(
-			const RenderableObject::Ptr& object,
-			const Geometry::Ptr& geometry,
-			const Material::Ptr& material,
+			RenderableObject* object,
+			Geometry* geometry,
+			Material* material,
 			const uint32_t& groupOrder,
-			float z
+			float z,
+			uint32_t programID = 0,
+			uint32_t textureID = 0
 		) noexcept;
 
+		//准备count个空的局部列表，之前的帧分配的容量保留
+		void initPartials(uint32_t count) noexcept;
+
+		//压入第partial个局部列表，参数与push相同；不同线程写入不同的局部列表时不需要加锁
+		void pushPartial(
+			uint32_t partial,
+			RenderableObject* object,
+			Geometry* geometry,
+			Material* material,
+			const uint32_t& groupOrder,
+			float z,
+			uint32_t programID = 0,
+			uint32_t textureID = 0
+		) noexcept;
+
+		//在调用线程上按区间顺序把局部列表追加到渲染列表，filter不为空时丢弃返回false的项
+		//filter按先不透明、后透明的顺序对每一项调用一次，可以在其中做不能并行的工作
+		void mergePartials(const std::function<bool(const RenderItem&)>& filter = nullptr) noexcept;
+
+		//按排序键排序
+		void sort() noexcept;
+
 		//排序操作,允许给出对于非透明物体以及透明物体的排序规则函数
 		void sort(
-			const RenderListSortFunction& opaqueSort = smallerZFirstSort, //为了earlyz
-			const RenderListSortFunction& transparentSort = biggerZFirstSort) noexcept;//为了颜色混合正确
+			const RenderListSortFunction& opaqueSort,
+			const RenderListSortFunction& transparentSort) noexcept;
+
+		//位数合计超过64时返回false，保持原来的布局
+		bool setOpaqueLayout(const SortKeyLayout& layout) noexcept;
+
+		bool setTransparentLayout(const SortKeyLayout& layout) noexcept;
+
+		static uint64_t makeSortKey(const SortKeyLayout& layout, const SortKeyInput& input) noexcept;
 
 		//在每一次构建完毕渲染列表的时候调用finish
 		void finish() noexcept;
 
-		const auto& getOpaques() const noexcept { return m_opaqueue; }
+		RenderItemSpan getOpaques() const noexcept { return RenderItemSpan(m_opaqueue.data(), m_opaqueue.size()); }
 
-		const auto& getTransparents() const noexcept { return m_transparents; }
+		RenderItemSpan getTransparents() const noexcept { return RenderItemSpan(m_transparents.data(), m_transparents.size()); }
 
 	private:
-		//每一次push一个可渲染物体，都会调用本函数，不管是重新生成renderItem还是
-		//从cache里面获取一个可用的，都会返回一个可用的renderItem
-		RenderItem::Ptr getNextRenderItem(
-			const RenderableObject::Ptr& object,
-			const Geometry::Ptr& geometry,
-			const Material::Ptr& material,
-			const uint32_t& groupOrder,
-			float z
-		) noexcept;
+		RenderItem makeRenderItem(
+			RenderableObject* object,
+			Geometry* geometry,
+			Material* material,
+			uint32_t groupOrder,
+			float z,
+			uint32_t programID,
+			uint32_t textureID) const noexcept;
+
+		void sortItems(std::vector<RenderItem>& items) noexcept;
 
 	private:
-		uint32_t m_renderItemIndex{ 0 }; //用来计算当前渲染队列的item数，每一帧开始的时候在init里面都会被置为0
-		std::vector<RenderItem::Ptr> m_opaqueue{}; //存储非透明物体
-		std::vector<RenderItem::Ptr> m_transparents{};  //存储透明物体
-		std::vector<RenderItem::Ptr> m_renderItemCache{};  //缓存renderItem
+		//每一帧开始的时候在init里面清空，容量保留给之后的帧
+		std::vector<RenderItem> m_opaqueue{}; //存储非透明物体
+		std::vector<RenderItem> m_transparents{};  //存储透明物体
+
+		SortKeyLayout m_opaqueLayout{ SortKeyLayout::opaque() };
+		SortKeyLayout m_transparentLayout{ SortKeyLayout::transparent() };
+
+		//排序用的缓冲区，跨帧复用，数量不增长时排序不分配内存
+		std::vector<SortEntry> m_sortEntries{};
+		std::vector<SortEntry> m_sortScratch{};
+		std::vector<RenderItem> m_sortedItems{};
+
+		//多线程构建时每个区间的局部列表，只增不减，跨帧复用容量
+		//按缓存行对齐，不同线程写入相邻局部列表的size时不会互相使缓存失效
+		struct alignas(64) Partial
+		{
+			std::vector<RenderItem> m_opaques{};
+			std::vector<RenderItem> m_transparents{};
+		};
+
+		std::vector<Partial> m_partials{};
+		uint32_t m_partialCount{ 0 };
 	};
 }
\ No newline at end of file
@@ -92,7 +92,12 @@ namespace ff {
 
 			frustum = shadow->getFrustum();
 
-			renderObject(scene, camera, shadow->mCamera, light, frustum);
+			//用光源的视锥体重新剪裁一次BVH(主相机的结果此时已经使用完毕)
+			if (mRenderer->mSceneBVH != nullptr) {
+				mRenderer->mSceneBVH->cull(frustum);
+			}
+
+			renderObject(scene, shadow->mCamera, frustum);
 		}
 
 		mRenderer->setRenderTarget(currentRenderTarget);
@@ -101,17 +106,23 @@ namespace ff {
 
 	void DriverShadowMap::renderObject(
 		const Object3D::Ptr& object,
-		const Camera::Ptr& camera,
 		const Camera::Ptr& shadowCamera,
-		const Light::Ptr& light,
 		const Frustum::Ptr& frustum) noexcept
 	{
-		if (!object->m_visible) return;
+		auto allocations = mTraverseStack.getAllocationCount();
+		uint32_t visited = 0;
+
+		auto renderCaster = [&](RenderableObject* renderable) {
+			//BVH中的物体直接使用BVH剪裁的结果
+			auto& sceneBVH = mRenderer->mSceneBVH;
+			auto isVisible = [&]() {
+				return (sceneBVH != nullptr && sceneBVH->contains(renderable)) ?
+					sceneBVH->isVisible(renderable) : frustum->intersectObject(renderable);
+			};
 
-		if (object->m_isRenderableObject) {
-			auto renderableObject = std::static_pointer_cast<RenderableObject>(object);
+			if (renderable->m_castShadow && isVisible()) {
+				auto renderableObject = std::static_pointer_cast<RenderableObject>(renderable->shared_from_this());
 
-			if (renderableObject->m_castShadow && frustum->intersectObject(renderableObject)) {
 				renderableObject->updateModelViewMatrix(shadowCamera->getWorldMatrixInverse());
 
 				auto geometry = mObjects->update(renderableObject);
@@ -121,15 +132,28 @@ namespace ff {
 
 				mRenderer->renderBufferDirect(renderableObject, nullptr, shadowCamera, geometry, material);
 			}
-			else {
-				std::cout << std::endl;
+		};
+
+		object->traverseVisible(mTraverseStack, 0, [&](Object3D* current, uint32_t&) {
+			visited++;
+
+			//与主相机使用同一个HLOD选择结果，使用代理时由代理投射阴影
+			if (current->m_isHLOD) {
+				auto hlod = static_cast<HLOD*>(current);
+				if (hlod->isUsingProxy()) {
+					renderCaster(hlod->getProxy().get());
+					return false;
+				}
+			}
+			else if (current->m_isRenderableObject) {
+				renderCaster(static_cast<RenderableObject*>(current));
 			}
 
-		}
+			return true;
+		});
 
-		auto children = object->getChildren();
-		for (const auto& child : children) {
-			renderObject(child, camera, shadowCamera, light, frustum);
-		}
+		auto& traverseInfo = mRenderer->mInfos->m_traverse;
+		traverseInfo.m_visited += visited;
+		traverseInfo.m_allocations += mTraverseStack.getAllocationCount() - allocations;
 	}
 }
\ No newline at end of file
@@ -26,9 +26,7 @@ namespace ff {
 
 		void renderObject(
 			const Object3D::Ptr& object,
-			const Camera::Ptr& camera,
 			const Camera::Ptr& shadowCamera,
-			const Light::Ptr& light,
 			const Frustum::Ptr& frustum) noexcept;
 
 	public:
@@ -40,6 +38,9 @@ namespace ff {
 		std::shared_ptr<DriverObjects>	mObjects{ nullptr };
 		std::shared_ptr<DriverState>	mState{ nullptr };
 
+		//renderObjectõıջ
+		Object3D::TraverseStack	mTraverseStack{};
+
 		DepthMaterial::Ptr	mDefaultDepthMaterial = DepthMaterial::create(DepthMaterial::RGBADepthPacking);
 	};
 }
\ No newline at end of file
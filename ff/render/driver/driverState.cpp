@@ -231,4 +231,84 @@ namespace ff {
 	glm::vec4 DriverState::getClearColor() const noexcept {
 		return mCurrentColor.mClearColor;
 	}
+
+	DriverState::TextureBinding DriverState::bindTexture(GLenum target, GLuint texture, GLuint sampler) noexcept {
+		TextureBinding binding;
+		GLint unit = acquireTextureUnit(target, texture, binding);
+
+		auto& textureUnit = mTextureUnits[unit];
+		if (textureUnit.mSampler != sampler) {
+			glBindSampler(unit, sampler);
+			textureUnit.mSampler = sampler;
+			binding.mSamplerBound = true;
+		}
+
+		return binding;
+	}
+
+	DriverState::TextureBinding DriverState::bindTextureForUpload(GLenum target, GLuint texture) noexcept {
+		TextureBinding binding;
+		GLint unit = acquireTextureUnit(target, texture, binding);
+
+		//glTexImage等上传接口作用在激活的单元上
+		if (mActiveTextureUnit != unit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			mActiveTextureUnit = unit;
+			binding.mActivated = true;
+		}
+
+		return binding;
+	}
+
+	GLint DriverState::acquireTextureUnit(GLenum target, GLuint texture, TextureBinding& binding) noexcept {
+		//1 贴图已经在某个单元上
+		GLint unit = -1;
+		for (GLint i = 0; i < static_cast<GLint>(TEXTURE_UNIT_COUNT); ++i) {
+			if (mTextureUnits[i].mTexture == texture && mTextureUnits[i].mTarget == target) {
+				unit = i;
+				break;
+			}
+		}
+
+		//2 换出最久没有使用的单元，本次绘制已经占用的单元不能换出
+		if (unit < 0) {
+			uint64_t oldest = UINT64_MAX;
+			for (GLint i = 0; i < static_cast<GLint>(TEXTURE_UNIT_COUNT); ++i) {
+				if (mTextureUnits[i].mLastUsed != mDrawIndex && mTextureUnits[i].mLastUsed < oldest) {
+					oldest = mTextureUnits[i].mLastUsed;
+					unit = i;
+				}
+			}
+
+			if (unit < 0) {
+				std::cout << "Error: DriverState::bindTexture, more than " << TEXTURE_UNIT_COUNT << " textures in one draw" << std::endl;
+				unit = 0;
+			}
+
+			if (mActiveTextureUnit != unit) {
+				glActiveTexture(GL_TEXTURE0 + unit);
+				mActiveTextureUnit = unit;
+				binding.mActivated = true;
+			}
+
+			glBindTexture(target, texture);
+			mTextureUnits[unit].mTarget = target;
+			mTextureUnits[unit].mTexture = texture;
+			binding.mBound = true;
+		}
+
+		mTextureUnits[unit].mLastUsed = mDrawIndex;
+		binding.mUnit = unit;
+
+		return unit;
+	}
+
+	void DriverState::forgetTexture(GLuint texture) noexcept {
+		for (auto& unit : mTextureUnits) {
+			if (unit.mTexture == texture) {
+				unit.mTarget = GL_NONE;
+				unit.mTexture = 0;
+			}
+		}
+	}
 }
\ No newline at end of file
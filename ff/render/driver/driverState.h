@@ -13,15 +13,19 @@
  * - 清屏颜色设置与查询：setClearColor() / getClearColor()
  * - 颜色混合配置：setBlending()
  * - 深度测试与写入配置：setDepth()
+ * - 纹理单元分配与绑定缓存：bindTexture()、bindTextureForUpload()
  *
  * 状态分组说明：
  * - RasterState：面剔除与正面朝向配置（mSide、mFrontFace）
  * - BlendingState：混合类型、透明标志、RGB/Alpha 源因子、目标因子与方程
  * - DepthState：深度测试开关、写入掩码、比较函数与深度清空值
  * - ColorState：清屏颜色（mClearColor）
+ * - TextureUnit：每个纹理单元上绑定的贴图与采样器对象，以及最后一次使用它的绘制序号
  *
  * 设计要点：
  * - 内部缓存当前状态（程序、视口、FBO 与各类管线状态），避免重复调用底层 GL 接口。
+ * - 纹理单元不与着色器中的采样器固定对应：贴图已经在某个单元上时直接复用，
+ *   否则换出最久没有使用的单元(同一次绘制已经占用的单元不会被换出)，采样器uniform改为指向该单元。
  * - 通过枚举（BlendingType、BlendingFactor、BlendingEquation、CompareFunction 等）
  *   屏蔽底层常量，提升可移植性与可读性。
  *
@@ -86,6 +90,24 @@ namespace ff {
 			double			mDepthClearColor{ -1.0f };
 		};
 
+		//OpenGL 3.3 保证片元着色器至少可以使用16个纹理单元
+		static constexpr uint32_t TEXTURE_UNIT_COUNT = 16;
+
+		struct TextureUnit {
+			GLenum		mTarget{ GL_NONE };
+			GLuint		mTexture{ 0 };
+			GLuint		mSampler{ 0 };
+			uint64_t	mLastUsed{ 0 };	//最后一次使用本单元的绘制序号
+		};
+
+		//bindTexture的结果，mUnit为贴图所在的单元，其余表示实际调用了哪些GL接口
+		struct TextureBinding {
+			GLint		mUnit{ 0 };
+			bool		mBound{ false };
+			bool		mActivated{ false };
+			bool		mSamplerBound{ false };
+		};
+
 		using Ptr = std::shared_ptr<DriverState>;
 		static Ptr create() { return std::make_shared<DriverState>(); }
 
@@ -123,7 +145,23 @@ namespace ff {
 
 		glm::vec4 getClearColor() const noexcept;
 
+		//每次绘制开始时调用，之前的绘制占用的纹理单元可以被换出
+		void beginDraw() noexcept { ++mDrawIndex; }
+
+		//把texture绑定到某个纹理单元并使用sampler采样，已经绑定时不调用GL
+		TextureBinding bindTexture(GLenum target, GLuint texture, GLuint sampler) noexcept;
+
+		//上传贴图之前调用：贴图按同样的LRU规则占用一个单元并激活该单元，上传之后保持绑定，
+		//不会换出本次绘制已经占用的单元；不改变该单元的sampler
+		TextureBinding bindTextureForUpload(GLenum target, GLuint texture) noexcept;
+
+		//glDeleteTextures会把贴图从所有单元上解绑，删除前调用
+		void forgetTexture(GLuint texture) noexcept;
+
 	private:
+		//贴图已经在某个单元上时返回该单元，否则换出最久没有使用的单元并绑定
+		GLint acquireTextureUnit(GLenum target, GLuint texture, TextureBinding& binding) noexcept;
+
 		void setBlendingInternal(
 			bool				transparent,
 			BlendingFactor		blendSrc,
@@ -143,5 +181,9 @@ namespace ff {
 		GLuint	mCurrentProgram{ 0 };
 		glm::vec4 mCurrentViewport{};
 		GLuint	mCurrentFrameBuffer{ 0 };
+
+		TextureUnit	mTextureUnits[TEXTURE_UNIT_COUNT]{};
+		GLint		mActiveTextureUnit{ 0 };
+		uint64_t	mDrawIndex{ 1 };
 	};
 }
\ No newline at end of file
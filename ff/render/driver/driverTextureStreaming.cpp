@@ -0,0 +1,243 @@
+#include "driverTextureStreaming.h"
+
+namespace ff
+{
+	DriverTextureStreaming::DriverTextureStreaming(const DriverInfo::Ptr& info) noexcept
+	{
+		m_info = info;
+	}
+
+	DriverTextureStreaming::~DriverTextureStreaming() noexcept {}
+
+	uint64_t DriverTextureStreaming::bytesOf(const Entry& entry, uint32_t level) const noexcept
+	{
+		if (level >= entry.m_levels)
+		{
+			return 0;
+		}
+
+		return MipChain::getChainBytes(entry.m_width, entry.m_height, entry.m_bytesPerPixel, level);
+	}
+
+	void DriverTextureStreaming::request(Texture* texture, float screenSize) noexcept
+	{
+		auto iter = m_entries.find(texture->getID());
+		if (iter == m_entries.end())
+		{
+			Entry entry;
+			entry.m_texture = texture;
+			entry.m_width = texture->m_width;
+			entry.m_height = texture->m_height;
+			entry.m_bytesPerPixel = texture->m_format == TextureFormat::RGB ? 3 : 4;
+			entry.m_levels = MipChain::getLevelCount(entry.m_width, entry.m_height);
+			entry.m_resident = entry.m_levels;
+
+			//最大边不超过tailSize的第一级
+			uint32_t size = std::max(entry.m_width, entry.m_height);
+			while (entry.m_tail + 1 < entry.m_levels && (size >> entry.m_tail) > m_tailSize)
+			{
+				++entry.m_tail;
+			}
+
+			iter = m_entries.emplace(texture->getID(), entry).first;
+		}
+
+		auto& entry = iter->second;
+		if (entry.m_lastUsedFrame != m_frame)
+		{
+			entry.m_lastUsedFrame = m_frame;
+			entry.m_screenSize = 0.0f;
+		}
+		entry.m_screenSize = std::max(entry.m_screenSize, screenSize);
+
+		//贴图大致铺满物体一次，每缩小一半降一级
+		float ratio = static_cast<float>(std::max(entry.m_width, entry.m_height)) / std::max(entry.m_screenSize, 1.0f);
+		uint32_t wanted = ratio > 1.0f ? static_cast<uint32_t>(std::floor(std::log2(ratio))) : 0;
+		entry.m_wanted = std::min(wanted, entry.m_tail);
+	}
+
+	void DriverTextureStreaming::remove(ID id) noexcept
+	{
+		auto iter = m_entries.find(id);
+		if (iter == m_entries.end())
+		{
+			return;
+		}
+
+		m_residentBytes -= bytesOf(iter->second, iter->second.m_resident);
+		m_entries.erase(iter);
+	}
+
+	uint32_t DriverTextureStreaming::getResidentLevel(ID id) const noexcept
+	{
+		auto iter = m_entries.find(id);
+		if (iter == m_entries.end())
+		{
+			return UINT32_MAX;
+		}
+
+		return iter->second.m_resident;
+	}
+
+	void DriverTextureStreaming::setResident(Entry& entry, uint32_t level) noexcept
+	{
+		m_residentBytes -= bytesOf(entry, entry.m_resident);
+		m_residentBytes += bytesOf(entry, level);
+		entry.m_resident = level;
+
+		m_changes.push_back({ entry.m_texture, level });
+	}
+
+	bool DriverTextureStreaming::makeRoom(uint64_t need, const Entry* keep) noexcept
+	{
+		if (m_residentBytes + need <= m_budget)
+		{
+			return true;
+		}
+
+		//本帧没有用到的贴图可以降到尾部，用到的贴图只能降到需要的级别
+		auto floorOf = [this](const Entry& entry) {
+			return entry.m_lastUsedFrame == m_frame ? entry.m_wanted : entry.m_tail;
+		};
+
+		m_candidates.clear();
+		for (auto& iter : m_entries)
+		{
+			auto& entry = iter.second;
+			if (&entry != keep && entry.m_resident < floorOf(entry))
+			{
+				m_candidates.push_back(&entry);
+			}
+		}
+
+		//越久没有用到越先淘汰，同一帧用到的先淘汰能腾出更多空间的
+		std::sort(m_candidates.begin(), m_candidates.end(), [&](const Entry* a, const Entry* b) {
+			if (a->m_lastUsedFrame != b->m_lastUsedFrame)
+			{
+				return a->m_lastUsedFrame < b->m_lastUsedFrame;
+			}
+
+			return bytesOf(*a, a->m_resident) - bytesOf(*a, floorOf(*a)) > bytesOf(*b, b->m_resident) - bytesOf(*b, floorOf(*b));
+		});
+
+		//先确认全部淘汰是否放得下，放不下时不做无用的淘汰
+		uint64_t freeable = 0;
+		for (auto entry : m_candidates)
+		{
+			freeable += bytesOf(*entry, entry->m_resident) - bytesOf(*entry, floorOf(*entry));
+		}
+
+		if (m_residentBytes - std::min(freeable, m_residentBytes) + need > m_budget)
+		{
+			return false;
+		}
+
+		for (auto entry : m_candidates)
+		{
+			if (m_residentBytes + need <= m_budget)
+			{
+				break;
+			}
+
+			setResident(*entry, floorOf(*entry));
+			m_info->m_textureStreaming.m_evictions++;
+		}
+
+		return true;
+	}
+
+	const std::vector<DriverTextureStreaming::Change>& DriverTextureStreaming::update() noexcept
+	{
+		m_changes.clear();
+
+		auto& stats = m_info->m_textureStreaming;
+		stats.m_uploads = 0;
+		stats.m_uploadedBytes = 0;
+		stats.m_evictions = 0;
+		stats.m_pending = 0;
+
+		//1 新贴图立即驻留尾部
+		for (auto& iter : m_entries)
+		{
+			auto& entry = iter.second;
+			if (entry.m_resident < entry.m_levels)
+			{
+				continue;
+			}
+
+			makeRoom(bytesOf(entry, entry.m_tail), &entry);
+			setResident(entry, entry.m_tail);
+
+			entry.m_firstFrame = m_frame;
+
+			stats.m_uploads++;
+			stats.m_uploadedBytes += bytesOf(entry, entry.m_tail);
+		}
+
+		//2 本帧用到且驻留不够清晰的贴图，差距大的优先，同样差距时投影大的优先；刚上传尾部的贴图从下一帧开始提升
+		m_upgrades.clear();
+		for (auto& iter : m_entries)
+		{
+			auto& entry = iter.second;
+			if (entry.m_lastUsedFrame != m_frame || entry.m_wanted >= entry.m_resident)
+			{
+				continue;
+			}
+
+			stats.m_pending++;
+			if (entry.m_firstFrame != m_frame)
+			{
+				m_upgrades.push_back(&entry);
+			}
+		}
+
+		std::sort(m_upgrades.begin(), m_upgrades.end(), [](const Entry* a, const Entry* b) {
+			uint32_t deficitA = a->m_resident - a->m_wanted;
+			uint32_t deficitB = b->m_resident - b->m_wanted;
+			if (deficitA != deficitB)
+			{
+				return deficitA > deficitB;
+			}
+
+			return a->m_screenSize > b->m_screenSize;
+		});
+
+		uint32_t uploads = 0;
+		for (auto entry : m_upgrades)
+		{
+			if (uploads >= m_maxUploads)
+			{
+				break;
+			}
+
+			//放不下需要的级别时退而求其次
+			uint32_t target = entry->m_wanted;
+			while (target < entry->m_resident && !makeRoom(bytesOf(*entry, target) - bytesOf(*entry, entry->m_resident), entry))
+			{
+				++target;
+			}
+
+			if (target < entry->m_resident)
+			{
+				stats.m_uploads++;
+				stats.m_uploadedBytes += bytesOf(*entry, target);
+
+				setResident(*entry, target);
+				++uploads;
+
+				if (target == entry->m_wanted)
+				{
+					stats.m_pending--;
+				}
+			}
+		}
+
+		stats.m_textures = static_cast<uint32_t>(m_entries.size());
+		stats.m_budgetBytes = m_budget;
+		stats.m_residentBytes = m_residentBytes;
+
+		++m_frame;
+
+		return m_changes;
+	}
+}
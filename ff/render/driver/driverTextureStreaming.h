@@ -0,0 +1,114 @@
+/**
+ * @class DriverTextureStreaming
+ * @brief 贴图mip级别流送的驻留策略：按使用贴图的物体的投影尺寸决定每张贴图需要的mip级别，在显存预算内以LRU淘汰。
+ *
+ * 简介：
+ * - 每张参与流送的贴图在显存中只保留[驻留级别, 最后一级]这一段mip链，驻留级别越小越清晰；
+ * - 贴图第一次被用到时只驻留尾部(最大边不超过tailSize的级别)，之后按投影尺寸逐帧提升：
+ *   需要的级别 = log2(贴图最大边 / 物体投影尺寸)，同一帧内多个物体使用同一张贴图时取最清晰的需求；
+ * - 每帧最多提升maxUploads张贴图，需求与当前驻留差距越大越优先；
+ * - 驻留总字节数超过预算时，先把最久没有用到的贴图降回尾部，再把本帧用到但驻留得比需求更清晰的贴图降到需求级别；
+ *   仍然放不下时改用更低一级的目标；
+ * - update()返回本帧需要重新上传的贴图及其新的驻留级别，由DriverTextures完成实际上传。
+ *
+ * 每帧调用顺序：request(渲染列表构建时，每个可见物体的每张贴图) -> update。
+ *
+ * @note 本类只负责决策，不调用OpenGL，可以脱离窗口单独测试。
+ * @note 尾部始终驻留，即使超出预算，保证每张贴图都有内容可以采样。
+ * @see ff::DriverTextures::enableStreaming, ff::MipmapCache
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../../global/base.h"
+#include "../../textures/texture.h"
+#include "../../textures/mipChain.h"
+#include "driverInfo.h"
+
+namespace ff
+{
+	class DriverTextureStreaming
+	{
+	public:
+		//m_level为贴图新的驻留级别
+		struct Change
+		{
+			Texture*	m_texture{ nullptr };
+			uint32_t	m_level{ 0 };
+		};
+
+		using Ptr = std::shared_ptr<DriverTextureStreaming>;
+		static Ptr create(const DriverInfo::Ptr& info)
+		{
+			return std::make_shared<DriverTextureStreaming>(info);
+		}
+
+		DriverTextureStreaming(const DriverInfo::Ptr& info) noexcept;
+
+		~DriverTextureStreaming() noexcept;
+
+		void setBudget(uint64_t bytes) noexcept { m_budget = bytes; }
+
+		uint64_t getBudget() const noexcept { return m_budget; }
+
+		void setTailSize(uint32_t size) noexcept { m_tailSize = std::max(size, 1u); }
+
+		void setMaxUploads(uint32_t count) noexcept { m_maxUploads = count; }
+
+		//本帧有一个投影尺寸为screenSize像素的物体使用了texture
+		void request(Texture* texture, float screenSize) noexcept;
+
+		const std::vector<Change>& update() noexcept;
+
+		bool contains(ID id) const noexcept { return m_entries.find(id) != m_entries.end(); }
+
+		//贴图析构或内容改变时调用，之后再次被请求时从尾部重新开始
+		void remove(ID id) noexcept;
+
+		//驻留的最高一级，0表示全部级别都已驻留；已登记但还没有驻留时返回级别数，没有登记时返回UINT32_MAX
+		uint32_t getResidentLevel(ID id) const noexcept;
+
+		uint64_t getResidentBytes() const noexcept { return m_residentBytes; }
+
+	private:
+		struct Entry
+		{
+			Texture*	m_texture{ nullptr };
+			uint32_t	m_width{ 0 };
+			uint32_t	m_height{ 0 };
+			uint32_t	m_bytesPerPixel{ 4 };
+			uint32_t	m_levels{ 0 };
+			uint32_t	m_tail{ 0 };			//尾部级别
+			uint32_t	m_resident{ 0 };		//等于m_levels表示还没有驻留
+			uint32_t	m_wanted{ 0 };			//本帧需要的级别
+			uint32_t	m_lastUsedFrame{ 0 };
+			uint32_t	m_firstFrame{ 0 };		//上传尾部的帧
+			float		m_screenSize{ 0.0f };
+		};
+
+		uint64_t bytesOf(const Entry& entry, uint32_t level) const noexcept;
+
+		void setResident(Entry& entry, uint32_t level) noexcept;
+
+		//按LRU降低其它贴图的驻留级别，直到能再放下need字节；放不下时返回false
+		bool makeRoom(uint64_t need, const Entry* keep) noexcept;
+
+	private:
+		DriverInfo::Ptr					m_info{ nullptr };
+
+		uint64_t						m_budget{ 256ull * 1024 * 1024 };
+		uint32_t						m_tailSize{ 64 };
+		uint32_t						m_maxUploads{ 8 };
+
+		uint32_t						m_frame{ 1 };
+		uint64_t						m_residentBytes{ 0 };
+
+		std::unordered_map<ID, Entry>	m_entries{};
+		std::vector<Change>				m_changes{};
+
+		std::vector<Entry*>				m_candidates{};
+		std::vector<Entry*>				m_upgrades{};
+	};
+}
@@ -1,5 +1,6 @@
 #include "driverTextures.h"
 #include "../MultipleRenderTarget.h"
+#include "../../textures/textureArray.h"
 
 namespace ff 
 {
@@ -14,15 +15,16 @@ namespace ff
 	{ 
 		if (m_handle)
 		{
-			glDeleteFramebuffers(GL_TEXTURE_2D, &m_handle);
+			glDeleteTextures(1, &m_handle);
 			m_handle = 0;
 		}
 	}
 
-	DriverTextures::DriverTextures(const DriverInfo::Ptr& info, const DriverRenderTargets::Ptr& renderTargets) noexcept 
+	DriverTextures::DriverTextures(const DriverInfo::Ptr& info, const DriverRenderTargets::Ptr& renderTargets, const DriverState::Ptr& state) noexcept 
 	{
 		m_info = info;
 		m_renderTargets = renderTargets;
+		m_state = state;
 
 		EventDispatcher::getInstance()->addEventListener("textureDispose", this, &DriverTextures::onTextureDestroy);
 	}
@@ -30,11 +32,20 @@ namespace ff
 	DriverTextures::~DriverTextures() noexcept 
 	{
 		EventDispatcher::getInstance()->removeEventListener("textureDispose", this, &DriverTextures::onTextureDestroy);
+
+		for (const auto& iter : m_samplers)
+		{
+			glDeleteSamplers(1, &iter.second);
+		}
 	}
 
 	void DriverTextures::update(const Texture::Ptr& texture) noexcept 
 	{
-		auto dTexture = get(texture);
+		//按级别驻留的贴图由updateStreaming上传
+		if (m_streaming != nullptr && m_streaming->contains(texture->getID()))
+		{
+			return;
+		}
 
 		//mNeedsUpdate在texture初次创建的时候，会是true
 		//在使用者更改了texture相关的东西之后，可以手动将其置为true，就会触发更改
@@ -56,7 +67,8 @@ namespace ff
 			glGenTextures(1, &dTexture->m_handle);
 		}
 
-		glBindTexture(toGL(texture->m_textureType), dTexture->m_handle);
+		//在自己的纹理单元上上传，不会解绑本次绘制已经绑定好的其它贴图
+		bindForUpload(toGL(texture->m_textureType), dTexture->m_handle);
 
 		//设置纹理参数
 		glTexParameteri(toGL(texture->m_textureType), GL_TEXTURE_MIN_FILTER, toGL(texture->m_minFilter));
@@ -73,14 +85,48 @@ namespace ff
 			//1 开辟内存空间
 			//2 传输图片数据
 			glTexImage2D(GL_TEXTURE_2D, 0, toGL(texture->m_internalFormat), texture->m_width, texture->m_height, 0, toGL(texture->m_format), toGL(texture->m_dataType), data);
-			glGenerateMipmap(GL_TEXTURE_2D);
+
+			//有预先计算好的mipmap时逐级直接上传，否则由驱动生成；渲染目标与深度贴图没有source
+			if (data != nullptr && !texture->m_source->m_mipmaps.empty())
+			{
+				const auto& mipmaps = texture->m_source->m_mipmaps;
+				uint32_t width = texture->m_width;
+				uint32_t height = texture->m_height;
+				for (uint32_t level = 1; level <= mipmaps.size(); ++level)
+				{
+					width = std::max(width / 2, 1u);
+					height = std::max(height / 2, 1u);
+					glTexImage2D(GL_TEXTURE_2D, level, toGL(texture->m_internalFormat), width, height, 0, toGL(texture->m_format), toGL(texture->m_dataType), mipmaps[level - 1].data());
+				}
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipmaps.size()));
+				m_info->m_memery.m_bakedMipmaps++;
+			}
+			else
+			{
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+				glGenerateMipmap(GL_TEXTURE_2D);
+			}
+			dTexture->m_mipmapped = data != nullptr;
+		}
+		else if (texture->m_textureType == TextureType::Texture2DArray)
+		{
+			//先为所有层开辟空间，再逐层上传
+			auto textureArray = static_cast<TextureArray*>(texture.get());
+			auto layers = static_cast<GLsizei>(textureArray->m_sources.size());
+
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, toGL(texture->m_internalFormat), texture->m_width, texture->m_height, layers, 0, toGL(texture->m_format), toGL(texture->m_dataType), nullptr);
+			for (GLsizei layer = 0; layer < layers; ++layer)
+			{
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, texture->m_width, texture->m_height, 1, toGL(texture->m_format), toGL(texture->m_dataType), textureArray->m_sources[layer]->m_data.data());
+			}
+			glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+			dTexture->m_mipmapped = true;
 		}
 		else  //TextureCubeMap
 		{
 
 		}
 
-		glBindTexture(toGL(texture->m_textureType), 0);
 		m_info->m_memery.m_textures++;
 
 		return dTexture;
@@ -161,21 +207,94 @@ namespace ff
 
 	DriverTexture::Ptr DriverTextures::get(const Texture::Ptr& texture) noexcept 
 	{
-		auto iter = m_textures.find(texture->getID());
-		if (iter != m_textures.end())
+		return get(texture->getID());
+	}
+
+	DriverTexture::Ptr DriverTextures::get(ID id) noexcept
+	{
+		auto iter = m_textures.find(id);
+		if (iter == m_textures.end())
 		{
-			iter = m_textures.insert(std::make_pair(texture->getID(), DriverTexture::create())).first;
+			iter = m_textures.insert(std::make_pair(id, DriverTexture::create())).first;
 		}
 
 		return iter->second;
 	}
 
-	void DriverTextures::bindTexture(const Texture::Ptr& texture, GLenum textureUnit) 
+	GLint DriverTextures::bindTexture(const Texture::Ptr& texture) noexcept
 	{
-		//GL_TEXTURE0  GL_TEXTURE1 GL_TEXTURE2....
-		//GL_TEXTURE1 = GL_TEXTURE0+1
-		//GL_TEXTURE2 = GL_TEXTURE0+2
-		
+		auto& stats = m_info->m_textureBinding;
+		stats.m_requests++;
+
+		update(texture);
+		auto dTexture = get(texture);
+
+		auto binding = m_state->bindTexture(toGL(texture->m_textureType), dTexture->m_handle, getSampler(texture, dTexture->m_mipmapped));
+		if (binding.mBound)
+		{
+			stats.m_binds++;
+		}
+		else
+		{
+			stats.m_skipped++;
+		}
+		stats.m_activeTextures += binding.mActivated ? 1 : 0;
+		stats.m_samplerBinds += binding.mSamplerBound ? 1 : 0;
+
+		return binding.mUnit;
+	}
+
+	void DriverTextures::bindForUpload(GLenum target, GLuint handle) noexcept
+	{
+		auto& stats = m_info->m_textureBinding;
+		stats.m_requests++;
+
+		auto binding = m_state->bindTextureForUpload(target, handle);
+		if (binding.mBound)
+		{
+			stats.m_binds++;
+		}
+		else
+		{
+			stats.m_skipped++;
+		}
+		stats.m_activeTextures += binding.mActivated ? 1 : 0;
+	}
+
+	GLuint DriverTextures::getSampler(const Texture::Ptr& texture, bool mipmapped) noexcept
+	{
+		uint32_t key = static_cast<uint32_t>(texture->m_minFilter)
+			| static_cast<uint32_t>(texture->m_magFilter) << 2
+			| (mipmapped ? 1u : 0u) << 4
+			| static_cast<uint32_t>(texture->m_wrapS) << 8
+			| static_cast<uint32_t>(texture->m_wrapT) << 12
+			| static_cast<uint32_t>(texture->m_wrapR) << 16;
+
+		auto iter = m_samplers.find(key);
+		if (iter != m_samplers.end())
+		{
+			return iter->second;
+		}
+
+		//贴图自身的过滤参数只有线性与最近点，有mipmap时在级别之间使用同样的方式
+		GLint minFilter = toGL(texture->m_minFilter);
+		if (mipmapped)
+		{
+			minFilter = texture->m_minFilter == TextureFilter::LinearFilter ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+		}
+
+		GLuint sampler = 0;
+		glGenSamplers(1, &sampler);
+		glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, minFilter);
+		glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, toGL(texture->m_magFilter));
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, toGL(texture->m_wrapS));
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, toGL(texture->m_wrapT));
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, toGL(texture->m_wrapR));
+
+		m_samplers.insert(std::make_pair(key, sampler));
+		m_info->m_textureBinding.m_samplers = static_cast<uint32_t>(m_samplers.size());
+
+		return sampler;
 	}
 
 	void DriverTextures::setupRenderTarget(const RenderTarget::Ptr& renderTarget) noexcept 
@@ -185,6 +304,140 @@ namespace ff
 
 	void DriverTextures::onTextureDestroy(const EventBase::Ptr& e) noexcept 
 	{
-		
+		auto texture = static_cast<Texture*>(e->mTarget);
+
+		//DriverTexture析构时释放GL贴图
+		auto iter = m_textures.find(texture->getID());
+		if (iter != m_textures.end())
+		{
+			m_state->forgetTexture(iter->second->m_handle);
+			m_textures.erase(iter);
+		}
+
+		if (m_streaming != nullptr)
+		{
+			m_streaming->remove(texture->getID());
+		}
+	}
+
+	const TextureAtlas::Region* DriverTextures::getAtlasRegion(const Texture::Ptr& texture) const noexcept
+	{
+		if (m_atlas == nullptr)
+		{
+			return nullptr;
+		}
+
+		return m_atlas->find(texture);
+	}
+
+	void DriverTextures::enableStreaming(bool enable, uint64_t budgetBytes) noexcept
+	{
+		if (!enable)
+		{
+			//已经按级别驻留的贴图下次使用时重新完整上传
+			if (m_streaming != nullptr)
+			{
+				for (const auto& iter : m_textures)
+				{
+					if (m_streaming->contains(iter.first))
+					{
+						m_state->forgetTexture(iter.second->m_handle);
+						iter.second->dispose();
+					}
+				}
+			}
+
+			m_streaming = nullptr;
+			m_info->m_textureStreaming = DriverInfo::TextureStreaming();
+			return;
+		}
+
+		if (m_streaming == nullptr)
+		{
+			m_streaming = DriverTextureStreaming::create(m_info);
+		}
+		m_streaming->setBudget(budgetBytes);
+	}
+
+	bool DriverTextures::canStream(const Texture::Ptr& texture) const noexcept
+	{
+		if (texture->getUsage() != TextureUsage::SamplerTexture || texture->m_textureType != TextureType::Texture2D || texture->m_source == nullptr)
+		{
+			return false;
+		}
+
+		//被打包进图集页的贴图绘制时只绑定所在的页，自己不会被上传
+		if (getAtlasRegion(texture) != nullptr)
+		{
+			return false;
+		}
+
+		//只有带完整mip链的贴图才能按级别上传
+		const auto& source = texture->m_source;
+		return !source->m_data.empty() && source->m_mipmaps.size() + 1 == MipChain::getLevelCount(texture->m_width, texture->m_height);
+	}
+
+	void DriverTextures::requestStreaming(const Material::Ptr& material, float screenSize) noexcept
+	{
+		for (const auto& texture : { material->m_diffuseMap, material->m_normalMap, material->m_specularMap })
+		{
+			if (texture == nullptr)
+			{
+				continue;
+			}
+
+			//内容被替换(例如异步加载完成)的贴图从尾部重新开始
+			if (texture->m_needUpdate)
+			{
+				m_streaming->remove(texture->getID());
+			}
+
+			if (canStream(texture))
+			{
+				m_streaming->request(texture.get(), screenSize);
+			}
+		}
+	}
+
+	void DriverTextures::updateStreaming() noexcept
+	{
+		for (const auto& change : m_streaming->update())
+		{
+			uploadResident(change.m_texture, change.m_level);
+		}
+	}
+
+	void DriverTextures::uploadResident(Texture* texture, uint32_t level) noexcept
+	{
+		auto dTexture = get(texture->getID());
+		texture->m_needUpdate = false;
+
+		const auto& source = texture->m_source;
+		uint32_t levels = static_cast<uint32_t>(source->m_mipmaps.size()) + 1;
+
+		//没有稀疏贴图，只能重新指定整张贴图：旧的存储整体释放，新的第0级是原来的第level级
+		if (!dTexture->m_handle)
+		{
+			glGenTextures(1, &dTexture->m_handle);
+		}
+
+		bindForUpload(GL_TEXTURE_2D, dTexture->m_handle);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, toGL(texture->m_minFilter));
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, toGL(texture->m_magFilter));
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, toGL(texture->m_wrapS));
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, toGL(texture->m_wrapT));
+
+		for (uint32_t i = level; i < levels; ++i)
+		{
+			GLsizei width = std::max(texture->m_width >> i, 1u);
+			GLsizei height = std::max(texture->m_height >> i, 1u);
+			const byte* data = i == 0 ? source->m_data.data() : source->m_mipmaps[i - 1].data();
+
+			glTexImage2D(GL_TEXTURE_2D, i - level, toGL(texture->m_internalFormat), width, height, 0, toGL(texture->m_format), toGL(texture->m_dataType), data);
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels - 1 - level));
+		dTexture->m_mipmapped = true;
 	}
 }
\ No newline at end of file
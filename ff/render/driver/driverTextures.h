@@ -4,8 +4,12 @@
 #include "../../textures/cubeTexture.h"
 #include "../../global/eventDispatcher.h"
 #include "driverInfo.h"
+#include "driverState.h"
 #include "../renderTarget.h"
 #include "driverRenderTargets.h"
+#include "driverTextureStreaming.h"
+#include "../../textures/textureAtlas.h"
+#include "../../material/material.h"
 
 namespace ff 
 {
@@ -27,6 +31,9 @@ namespace ff
 		//ͨglGenTexturesõtextureı
 		GLuint	m_handle{ 0 };
 
+		//mipmapʱʹmipmap
+		bool	m_mipmapped{ false };
+
 	};
 	
 	/*
@@ -38,13 +45,13 @@ namespace ff
 	{
 	public:
 		using Ptr = std::shared_ptr<DriverTextures>;
-		static Ptr create(const DriverInfo::Ptr& texture, const DriverRenderTargets::Ptr& renderTargets)
+		static Ptr create(const DriverInfo::Ptr& texture, const DriverRenderTargets::Ptr& renderTargets, const DriverState::Ptr& state)
 		{
-			return std::make_shared<DriverTextures>(texture, renderTargets);
+			return std::make_shared<DriverTextures>(texture, renderTargets, state);
 		}
 
 		 
-		DriverTextures(const DriverInfo::Ptr& texture, const DriverRenderTargets::Ptr& renderTargets) noexcept;
+		DriverTextures(const DriverInfo::Ptr& texture, const DriverRenderTargets::Ptr& renderTargets, const DriverState::Ptr& state) noexcept;
 
 		~DriverTextures() noexcept;
 
@@ -52,20 +59,50 @@ namespace ff
 		DriverTexture::Ptr get(const Texture::Ptr& texture) noexcept;
 
 		//:
-		// textureӦDriver TextureеmHandle󶨵textureUnitslot
-		//GL_TEXTURE0 GL_TEXTURE1....
-		void bindTexture(const Texture::Ptr& texture, GLenum textureUnit);
+		// ҪʱϴtextureDriverState󶨵ĳԪ(Ѿʱ)
+		// 뻷ƷʽɻĲṩصԪı(0ʾGL_TEXTURE0)
+		GLint bindTexture(const Texture::Ptr& texture) noexcept;
 
 		void setupRenderTarget(const RenderTarget::Ptr& renderTarget) noexcept;
 
 		void onTextureDestroy(const EventBase::Ptr& e) noexcept;
 
+		//mip( ff::MipmapCache)ĲͼפֽbudgetBytes
+		void enableStreaming(bool enable, uint64_t budgetBytes) noexcept;
+
+		DriverTextureStreaming::Ptr getStreaming() const noexcept { return m_streaming; }
+
+		//ȾбʱÿɼͶӰߴ()ϵͼ
+		void requestStreaming(const Material::Ptr& material, float screenSize) noexcept;
+
+		//Ⱦбɺãϴļͷṷ̋ļ
+		void updateStreaming() noexcept;
+
+		//ú󣬱ͼڻʱڵͼҳ()
+		void setTextureAtlas(const TextureAtlas::Ptr& atlas) noexcept { m_atlas = atlas; }
+
+		//textureûбʱnullptr
+		const TextureAtlas::Region* getAtlasRegion(const Texture::Ptr& texture) const noexcept;
+
 	private:
 		//Ҫô½һtexture  Ҫôԭtextureݻ
 		void update(const Texture::Ptr& texture) noexcept;
 
+		DriverTexture::Ptr get(ID id) noexcept;
+
 		DriverTexture::Ptr setupDriverTexture(const Texture::Ptr& texture) noexcept;
 
+		//ϴǰͼ󶨵ԼԪϴ󱣳ְ󶨣ͼͳ
+		void bindForUpload(GLenum target, GLuint handle) noexcept;
+
+		//뻷Ʒʽȡòûʱ
+		GLuint getSampler(const Texture::Ptr& texture, bool mipmapped) noexcept;
+
+		bool canStream(const Texture::Ptr& texture) const noexcept;
+
+		//ָͼֻlevelһ
+		void uploadResident(Texture* texture, uint32_t level) noexcept;
+
 		void setupFBOColorAttachment(const GLuint& fbo, const GLenum& attachment, const Texture::Ptr& texture) noexcept;
 
 		void setupFBODepthStencilAttachment(const RenderTarget::Ptr& renderTatget) noexcept;
@@ -78,7 +115,11 @@ namespace ff
 	private:
 		DriverInfo::Ptr							m_info{ nullptr };
 		DriverRenderTargets::Ptr				m_renderTargets{ nullptr };
+		DriverState::Ptr						m_state{ nullptr };
+		std::unordered_map<uint32_t, GLuint>	m_samplers{};
 		std::unordered_map<ID, DriverTexture::Ptr>	m_textures{};
+		DriverTextureStreaming::Ptr				m_streaming{ nullptr };
+		TextureAtlas::Ptr						m_atlas{ nullptr };
 		
 	};
 }
\ No newline at end of file
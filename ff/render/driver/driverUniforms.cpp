@@ -89,9 +89,10 @@ namespace ff
 			UPLOAD(glm::mat4, value)
 				break;
 		case GL_SAMPLER_2D:
-			uploadTexture(driverUniforms, textures, value);
+		case GL_SAMPLER_2D_ARRAY:
 		case GL_SAMPLER_CUBE:
 			uploadTexture(driverUniforms, textures, value);
+			break;
 		default:
 			break;
 		}
@@ -103,7 +104,31 @@ namespace ff
 		const std::any& value
 	)
 	{
+		//环境贴图以CubeTexture::Ptr的形式保存
+		Texture::Ptr texture = nullptr;
+		if (auto ptr = std::any_cast<Texture::Ptr>(&value))
+		{
+			texture = *ptr;
+		}
+		else if (auto cubePtr = std::any_cast<CubeTexture::Ptr>(&value))
+		{
+			texture = *cubePtr;
+		}
+
+		if (texture == nullptr)
+		{
+			return;
+		}
+
+		//贴图所在的单元由DriverState按LRU分配，每次绘制都可能不同
+		GLint unit = textures->bindTexture(texture);
 
+		//本program的采样器已经指向这个单元时不再设置
+		if (driverUniforms->getTextureSlot(m_location) != unit)
+		{
+			upload<int>(unit);
+			driverUniforms->setTextureSlot(m_location, unit);
+		}
 	}
 
 	PureArrayUniform::PureArrayUniform(const std::string& id, const GLint& location, const GLenum& type, GLint size) noexcept
@@ -188,44 +213,28 @@ namespace ff
 		//PureArrayUniform 对应的外部数据，一定都被装载了vector里面
 		auto textureArray = std::any_cast<std::vector<Texture::Ptr>>(value);
 
-		//假设本数组长度为n，那么就需要为n个textures分配textureUnits
-		std::vector<GLint> textureSlots = driverUniforms->getTextureArraySlot(m_location);
-
-		//如果数组长度为0，说明原先并没有分配过
-		if (textureSlots.size() == 0) {
-			//由于是PureArrayUniform，所以一定是如下形式：
-			// uniform sampler2D texs[10];
-			// mSize就是10
-			//
-			textureSlots = driverUniforms->allocateTextureUnits(m_size);
-			driverUniforms->setTextureArraySlot(m_location, textureSlots);
-		}
-
-		//将获得的n个textureUnits，分别与texture数组当中的每一个texture进行绑定
+		//将texture数组当中的每一个texture绑定到某个textureUnit上
 		// 举例：
 		// textureArray[0]-GL_TEXTURE4
 		// textureArray[1]-GL_TEXTURE5
 		// textureArray[2]-GL_TEXTURE6
-
-		for (uint32_t i = 0; i < textureArray.size(); ++i) {
-			textures->bindTexture(textureArray[i], textureSlots[i]);
-		}
-
-
-		//绑定shader当中的sampler2D数组，与textureUnits之间的关系
-
 		std::vector<GLint> textureIndices;
-		for (int i = 0; i < textureSlots.size(); ++i) {
-			textureIndices.push_back(textureSlots[i] - GL_TEXTURE0);
+		for (uint32_t i = 0; i < textureArray.size() && i < static_cast<uint32_t>(m_size); ++i) {
+			textureIndices.push_back(textures->bindTexture(textureArray[i]));
 		}
 
+		//绑定shader当中的sampler2D数组，与textureUnits之间的关系，没有变化时不再设置
 		//比如：
 		// uniform sampler2D texs[3];
 		// texs[0]-4
 		// texs[1]-5
 		// texs[2]-6
 		//
-		gl::uniform1iv(m_location, textureArray.size(), textureIndices.data());
+		if (textureIndices != driverUniforms->getTextureArraySlot(m_location))
+		{
+			gl::uniform1iv(m_location, static_cast<GLsizei>(textureIndices.size()), textureIndices.data());
+			driverUniforms->setTextureArraySlot(m_location, textureIndices);
+		}
 	}
 
 
@@ -369,8 +378,9 @@ namespace ff
 	{
 	}
 
-	void DriverUniforms::upload(UniformHandleMap& unifromHandleMap, const DriverTextures::Ptr& textures)
+	uint32_t DriverUniforms::upload(UniformHandleMap& unifromHandleMap, const DriverTextures::Ptr& textures)
 	{
+		uint32_t uploaded = 0;
 		for (auto& iter : m_uniformMap)
 		{
 			auto name = iter.first;
@@ -383,9 +393,12 @@ namespace ff
 				uniformHandle.mNeedsUpdate = false;
 
 				uniform->setValue(uniformHandle.mValue, textures, shared_from_this());
+				uploaded++;
 			}
 
 		}
+
+		return uploaded;
 	}
 
 	void DriverUniforms::addUniform(UniformContainer* container, const UniformBase::Ptr& uniformObject)
@@ -395,7 +408,7 @@ namespace ff
 
 	void DriverUniforms::setTextureSlot(const GLint& location, GLuint slot) noexcept
 	{
-		m_textureSlots.insert(std::make_pair(location, slot));
+		m_textureSlots[location] = slot;
 	}
 
 	GLint DriverUniforms::getTextureSlot(const GLint& location) noexcept
@@ -411,7 +424,7 @@ namespace ff
 
 	void DriverUniforms::setTextureArraySlot(const GLint& location, std::vector<GLint> slots) noexcept
 	{
-		m_textureArraySlots.insert(std::make_pair(location, slots));
+		m_textureArraySlots[location] = std::move(slots);
 	}
 
 	std::vector<GLint> DriverUniforms::getTextureArraySlot(const GLint& location) noexcept
@@ -426,23 +439,4 @@ namespace ff
 		return slots;
 	}
 
-	std::vector<GLint> DriverUniforms::allocateTextureUnits(const int& n)
-	{
-		std::vector<GLint> units;
-		for (int i = 0; i < n; ++i) {
-			//GL_TEXTURE1 = GL_TEXTURE0 + 1
-			//GL_TEXTURE2 = GL_TEXTURE0 + 2
-			//...........
-			GLenum slot = GL_TEXTURE0 + m_currentTextureSlots;
-			if (slot >= MAX_TEXTURE) {
-				throw std::runtime_error("DriverTextures->allocateTextureUnit: too much textures");
-			}
-
-			units.push_back(slot);
-			m_currentTextureSlots++;
-		}
-
-		return units;
-	}
-
 }
\ No newline at end of file
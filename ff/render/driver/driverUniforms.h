@@ -221,11 +221,12 @@ namespace ff {
 		DriverUniforms(const GLint& program) noexcept;
 
 		~DriverUniforms();
-		void upload(UniformHandleMap& unifromHandleMap, const DriverTextures::Ptr& textures);
+		//返回上传的uniform数
+		uint32_t upload(UniformHandleMap& unifromHandleMap, const DriverTextures::Ptr& textures);
 
 		void addUniform(UniformContainer* container, const UniformBase::Ptr& uniformObject);
 		
-		//texture slots
+		//texture slots，记录本program中采样器uniform当前指向的纹理单元
 		void setTextureSlot(const GLint& location, GLuint slot) noexcept;
 
 		GLint getTextureSlot(const GLint& location) noexcept;
@@ -236,25 +237,19 @@ namespace ff {
 
 		std::vector<GLint> getTextureArraySlot(const GLint& location) noexcept;
 
-		//返回n个可以使用的textureUnits
-		std::vector<GLint> allocateTextureUnits(const int& n);
-
 	private:
 		//key:某一个uniform sampler2D tex;变量的location
-		//value：GL_TEXTUREXXXX
+		//value：纹理单元的编号(0表示GL_TEXTURE0)
 		std::unordered_map<GLint, GLuint> m_textureSlots{};
 
 		//uniform sampler2D texs[10];
 		//name: texs[0] 
 		//size:10
-		//需要给texs分配十个slot（units）
+		//texs中的每一个texture都绑定在某个slot（unit）上
 		//每个purearrayuniform只有一个location
 		//key：PureArrayUniform这种类型的texture数组的location 
-		//value：数组，为这个texture数组当中的所有textures按序分配的textureUnits
+		//value：数组，这个texture数组当中的所有textures按序所在的textureUnits
 		std::unordered_map<GLint, std::vector<GLint>> m_textureArraySlots{};
-
-		//用于记录当前已经分配到了哪一个TextureUnit
-		GLint m_currentTextureSlots{ 0 };
 	};
 
 
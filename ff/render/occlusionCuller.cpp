@@ -0,0 +1,526 @@
+#include "occlusionCuller.h"
+
+#if defined(__AVX__)
+#define FF_OCCLUSION_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FF_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace ff
+{
+	//有jobSystem时按grainSize切分并行执行，否则在调用线程上一次执行完
+	static void forRange(
+		const JobSystem::Ptr& jobSystem, uint32_t count, uint32_t grainSize,
+		const std::function<void(uint32_t begin, uint32_t end)>& func) noexcept
+	{
+		if (jobSystem != nullptr && jobSystem->getThreadCount() > 1 && count > grainSize)
+		{
+			jobSystem->parallelFor(count, grainSize, func);
+		}
+		else if (count > 0)
+		{
+			func(0, count);
+		}
+	}
+
+	//一行8个像素中深度 >= z 的像素掩码，第i位对应第i个像素
+	static inline uint32_t farPixelMask(const float* depth, float z) noexcept
+	{
+#if defined(FF_OCCLUSION_AVX)
+		return static_cast<uint32_t>(_mm256_movemask_ps(
+			_mm256_cmp_ps(_mm256_loadu_ps(depth), _mm256_set1_ps(z), _CMP_GE_OQ)));
+#elif defined(FF_OCCLUSION_SSE)
+		__m128 value = _mm_set1_ps(z);
+		uint32_t low = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depth), value)));
+		uint32_t high = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depth + 4), value)));
+		return low | (high << 4);
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			if (depth[i] >= z)
+			{
+				mask |= 1u << i;
+			}
+		}
+		return mask;
+#endif
+	}
+
+	static inline float maxOf8(const float* depth) noexcept
+	{
+#if defined(FF_OCCLUSION_AVX)
+		__m256 value = _mm256_loadu_ps(depth);
+		__m128 result = _mm_max_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+		result = _mm_max_ps(result, _mm_movehl_ps(result, result));
+		result = _mm_max_ss(result, _mm_shuffle_ps(result, result, 1));
+		return _mm_cvtss_f32(result);
+#elif defined(FF_OCCLUSION_SSE)
+		__m128 result = _mm_max_ps(_mm_loadu_ps(depth), _mm_loadu_ps(depth + 4));
+		result = _mm_max_ps(result, _mm_movehl_ps(result, result));
+		result = _mm_max_ss(result, _mm_shuffle_ps(result, result, 1));
+		return _mm_cvtss_f32(result);
+#else
+		float result = depth[0];
+		for (uint32_t i = 1; i < 8; ++i)
+		{
+			result = std::max(result, depth[i]);
+		}
+		return result;
+#endif
+	}
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height) noexcept
+	{
+		setResolution(width, height);
+	}
+
+	OcclusionCuller::~OcclusionCuller() noexcept {}
+
+	void OcclusionCuller::setResolution(uint32_t width, uint32_t height) noexcept
+	{
+		m_tilesX = std::max((width + TileSize - 1) / TileSize, 1u);
+		m_tilesY = std::max((height + TileSize - 1) / TileSize, 1u);
+		m_width = m_tilesX * TileSize;
+		m_height = m_tilesY * TileSize;
+
+		m_depth.assign(m_width * m_height, 1.0f);
+		m_tileMaxDepth.assign(m_tilesX * m_tilesY, 1.0f);
+	}
+
+	void OcclusionCuller::begin(const glm::mat4& viewProjection) noexcept
+	{
+		m_viewProjection = viewProjection;
+		m_occluders.clear();
+		m_occludees.clear();
+		m_occluded.clear();
+		m_cullInfo = CullInfo();
+	}
+
+	void OcclusionCuller::addOccluder(RenderableObject* object) noexcept
+	{
+		m_occluders.push_back(object);
+	}
+
+	uint32_t OcclusionCuller::addOccludee(const Box3& worldBox) noexcept
+	{
+		m_occludees.push_back(worldBox);
+		return static_cast<uint32_t>(m_occludees.size() - 1);
+	}
+
+	void OcclusionCuller::cull(const JobSystem::Ptr& jobSystem) noexcept
+	{
+		rasterize(jobSystem);
+
+		uint32_t count = static_cast<uint32_t>(m_occludees.size());
+		m_occluded.assign(count, 0);
+
+		//没有遮挡体时深度缓冲为空，所有物体都可见
+		if (m_cullInfo.m_occluderTriangles > 0)
+		{
+			forRange(jobSystem, count, 64, [this](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const auto& box = m_occludees[i];
+					m_occluded[i] = testBox(box.m_min, box.m_max) ? 0 : 1;
+				}
+			});
+		}
+
+		uint32_t culled = 0;
+		for (auto occluded : m_occluded)
+		{
+			culled += occluded;
+		}
+
+		m_cullInfo.m_occludeesTested = count;
+		m_cullInfo.m_occludeesCulled = culled;
+	}
+
+	void OcclusionCuller::rasterize(const JobSystem::Ptr& jobSystem) noexcept
+	{
+		//1 每个遮挡体独立建立三角形，写入各自的数组
+		uint32_t occluderCount = static_cast<uint32_t>(m_occluders.size());
+		if (m_occluderTriangles.size() < occluderCount)
+		{
+			m_occluderTriangles.resize(occluderCount);
+		}
+
+		forRange(jobSystem, occluderCount, 4, [this](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				m_occluderTriangles[i].clear();
+				setupOccluder(m_occluders[i], m_occluderTriangles[i]);
+			}
+		});
+
+		uint32_t triangleCount = 0;
+		for (uint32_t i = 0; i < occluderCount; ++i)
+		{
+			triangleCount += static_cast<uint32_t>(m_occluderTriangles[i].size());
+		}
+
+		m_cullInfo.m_occluders = occluderCount;
+		m_cullInfo.m_occluderTriangles = triangleCount;
+
+		//2 按tile行切分条带光栅化，每个条带只写自己的像素与块深度
+		forRange(jobSystem, m_tilesY, 1, [this](uint32_t begin, uint32_t end) {
+			rasterizeTileRows(begin, end);
+		});
+	}
+
+	void OcclusionCuller::setupOccluder(RenderableObject* object, std::vector<Triangle>& triangles) noexcept
+	{
+		auto geometry = object->m_occluderGeometry != nullptr ? object->m_occluderGeometry : object->getGeometry();
+		if (geometry == nullptr)
+		{
+			return;
+		}
+
+		auto position = geometry->getAttribute("position");
+		if (position == nullptr || position->getItemSize() < 3)
+		{
+			return;
+		}
+
+		glm::mat4 matrix = m_viewProjection * object->getWorldMatrix();
+
+		const auto& positions = position->getData();
+		uint32_t itemSize = position->getItemSize();
+		uint32_t vertexCount = position->getCount();
+
+		auto transform = [&](uint32_t vertex) {
+			const float* p = positions.data() + vertex * itemSize;
+			return matrix * glm::vec4(p[0], p[1], p[2], 1.0f);
+		};
+
+		auto index = geometry->getIndex();
+		if (index != nullptr)
+		{
+			const auto& indices = index->getData();
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount)
+				{
+					continue;
+				}
+
+				setupTriangle(transform(indices[i]), transform(indices[i + 1]), transform(indices[i + 2]), triangles);
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i + 2 < vertexCount; i += 3)
+			{
+				setupTriangle(transform(i), transform(i + 1), transform(i + 2), triangles);
+			}
+		}
+	}
+
+	void OcclusionCuller::setupTriangle(
+		const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2,
+		std::vector<Triangle>& triangles) const noexcept
+	{
+		//1 三个顶点都在同一个裁剪平面外侧时整个三角形不可见
+		if ((v0.x > v0.w && v1.x > v1.w && v2.x > v2.w) ||
+			(v0.x < -v0.w && v1.x < -v1.w && v2.x < -v2.w) ||
+			(v0.y > v0.w && v1.y > v1.w && v2.y > v2.w) ||
+			(v0.y < -v0.w && v1.y < -v1.w && v2.y < -v2.w) ||
+			(v0.z > v0.w && v1.z > v1.w && v2.z > v2.w))
+		{
+			return;
+		}
+
+		//2 对近平面 z + w >= 0 做裁剪，得到最多4个顶点的凸多边形
+		glm::vec4 input[3] = { v0, v1, v2 };
+		glm::vec4 polygon[4];
+		uint32_t vertexCount = 0;
+
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const auto& current = input[i];
+			const auto& next = input[(i + 1) % 3];
+			float currentDistance = current.z + current.w;
+			float nextDistance = next.z + next.w;
+
+			if (currentDistance >= 0.0f)
+			{
+				polygon[vertexCount++] = current;
+			}
+
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+			{
+				float t = currentDistance / (currentDistance - nextDistance);
+				polygon[vertexCount++] = current + (next - current) * t;
+			}
+		}
+
+		if (vertexCount < 3)
+		{
+			return;
+		}
+
+		//3 透视除法，变换到像素坐标，深度映射到[0, 1]
+		glm::vec3 screen[4];
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			float w = std::max(polygon[i].w, 1e-6f);
+			float invW = 1.0f / w;
+			screen[i].x = (polygon[i].x * invW * 0.5f + 0.5f) * static_cast<float>(m_width);
+			screen[i].y = (polygon[i].y * invW * 0.5f + 0.5f) * static_cast<float>(m_height);
+			screen[i].z = polygon[i].z * invW * 0.5f + 0.5f;
+		}
+
+		//4 以扇形拆分为三角形，建立边函数与深度平面
+		for (uint32_t i = 1; i + 1 < vertexCount; ++i)
+		{
+			const auto& p0 = screen[0];
+			const auto& p1 = screen[i];
+			const auto& p2 = screen[i + 1];
+
+			float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+			if (std::abs(area) < 1e-8f)
+			{
+				continue;
+			}
+
+			Triangle triangle;
+			triangle.m_minX = std::max(static_cast<int32_t>(std::floor(std::min({ p0.x, p1.x, p2.x }))), 0);
+			triangle.m_maxX = std::min(static_cast<int32_t>(std::ceil(std::max({ p0.x, p1.x, p2.x }))), static_cast<int32_t>(m_width) - 1);
+			triangle.m_minY = std::max(static_cast<int32_t>(std::floor(std::min({ p0.y, p1.y, p2.y }))), 0);
+			triangle.m_maxY = std::min(static_cast<int32_t>(std::ceil(std::max({ p0.y, p1.y, p2.y }))), static_cast<int32_t>(m_height) - 1);
+			if (triangle.m_minX > triangle.m_maxX || triangle.m_minY > triangle.m_maxY)
+			{
+				continue;
+			}
+
+			//逆时针时三角形内部三条边函数都为正，顺时针则整体取反
+			float sign = area > 0.0f ? 1.0f : -1.0f;
+			const glm::vec3* points[3] = { &p0, &p1, &p2 };
+			for (uint32_t e = 0; e < 3; ++e)
+			{
+				const auto& a = *points[e];
+				const auto& b = *points[(e + 1) % 3];
+				triangle.m_edgeA[e] = (a.y - b.y) * sign;
+				triangle.m_edgeB[e] = (b.x - a.x) * sign;
+				triangle.m_edgeC[e] = (a.x * b.y - a.y * b.x) * sign;
+			}
+
+			float dx1 = p1.x - p0.x, dy1 = p1.y - p0.y, dz1 = p1.z - p0.z;
+			float dx2 = p2.x - p0.x, dy2 = p2.y - p0.y, dz2 = p2.z - p0.z;
+			triangle.m_zA = (dz1 * dy2 - dy1 * dz2) / area;
+			triangle.m_zB = (dx1 * dz2 - dz1 * dx2) / area;
+			triangle.m_zC = p0.z - triangle.m_zA * p0.x - triangle.m_zB * p0.y;
+
+			triangles.push_back(triangle);
+		}
+	}
+
+	void OcclusionCuller::rasterizeTileRows(uint32_t tileRowBegin, uint32_t tileRowEnd) noexcept
+	{
+		int32_t rowBegin = static_cast<int32_t>(tileRowBegin * TileSize);
+		int32_t rowEnd = static_cast<int32_t>(tileRowEnd * TileSize);
+
+		std::fill(m_depth.begin() + rowBegin * m_width, m_depth.begin() + rowEnd * m_width, 1.0f);
+
+		uint32_t occluderCount = static_cast<uint32_t>(m_occluders.size());
+		for (uint32_t i = 0; i < occluderCount; ++i)
+		{
+			for (const auto& triangle : m_occluderTriangles[i])
+			{
+				if (triangle.m_maxY < rowBegin || triangle.m_minY >= rowEnd)
+				{
+					continue;
+				}
+
+				rasterizeTriangle(triangle, rowBegin, rowEnd);
+			}
+		}
+
+		//更新条带内的块深度
+		for (uint32_t tileY = tileRowBegin; tileY < tileRowEnd; ++tileY)
+		{
+			for (uint32_t tileX = 0; tileX < m_tilesX; ++tileX)
+			{
+				const float* tile = m_depth.data() + tileY * TileSize * m_width + tileX * TileSize;
+
+				float maxDepth = 0.0f;
+				for (uint32_t y = 0; y < TileSize; ++y)
+				{
+					maxDepth = std::max(maxDepth, maxOf8(tile + y * m_width));
+				}
+
+				m_tileMaxDepth[tileY * m_tilesX + tileX] = maxDepth;
+			}
+		}
+	}
+
+	void OcclusionCuller::rasterizeTriangle(const Triangle& triangle, int32_t rowBegin, int32_t rowEnd) noexcept
+	{
+		int32_t minY = std::max(triangle.m_minY, rowBegin);
+		int32_t maxY = std::min(triangle.m_maxY, rowEnd - 1);
+
+#if defined(FF_OCCLUSION_AVX)
+		constexpr int32_t Lanes = 8;
+#elif defined(FF_OCCLUSION_SSE)
+		constexpr int32_t Lanes = 4;
+#else
+		constexpr int32_t Lanes = 1;
+#endif
+
+		//宽度是TileSize的倍数，按SIMD宽度对齐后每次处理的像素都不会越过行尾
+		int32_t minX = triangle.m_minX & ~(Lanes - 1);
+		int32_t maxX = triangle.m_maxX;
+
+#if defined(FF_OCCLUSION_AVX)
+		const __m256 laneOffset = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 edgeA[3];
+		for (uint32_t e = 0; e < 3; ++e)
+		{
+			edgeA[e] = _mm256_set1_ps(triangle.m_edgeA[e]);
+		}
+		const __m256 zA = _mm256_set1_ps(triangle.m_zA);
+#elif defined(FF_OCCLUSION_SSE)
+		const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+		__m128 edgeA[3];
+		for (uint32_t e = 0; e < 3; ++e)
+		{
+			edgeA[e] = _mm_set1_ps(triangle.m_edgeA[e]);
+		}
+		const __m128 zA = _mm_set1_ps(triangle.m_zA);
+#endif
+
+		for (int32_t y = minY; y <= maxY; ++y)
+		{
+			float centerY = static_cast<float>(y) + 0.5f;
+			float* row = m_depth.data() + y * m_width;
+
+			//每行的常数部分
+			float rowEdge[3];
+			for (uint32_t e = 0; e < 3; ++e)
+			{
+				rowEdge[e] = triangle.m_edgeB[e] * centerY + triangle.m_edgeC[e];
+			}
+			float rowZ = triangle.m_zB * centerY + triangle.m_zC;
+
+			for (int32_t x = minX; x <= maxX; x += Lanes)
+			{
+#if defined(FF_OCCLUSION_AVX)
+				__m256 centerX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffset);
+
+				__m256 inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[0], centerX), _mm256_set1_ps(rowEdge[0])), zero, _CMP_GE_OQ);
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[1], centerX), _mm256_set1_ps(rowEdge[1])), zero, _CMP_GE_OQ));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[2], centerX), _mm256_set1_ps(rowEdge[2])), zero, _CMP_GE_OQ));
+				if (_mm256_movemask_ps(inside) == 0)
+				{
+					continue;
+				}
+
+				__m256 depth = _mm256_add_ps(_mm256_mul_ps(zA, centerX), _mm256_set1_ps(rowZ));
+				__m256 old = _mm256_loadu_ps(row + x);
+				_mm256_storeu_ps(row + x, _mm256_blendv_ps(old, _mm256_min_ps(old, depth), inside));
+#elif defined(FF_OCCLUSION_SSE)
+				__m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+
+				__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], centerX), _mm_set1_ps(rowEdge[0])), zero);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], centerX), _mm_set1_ps(rowEdge[1])), zero));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], centerX), _mm_set1_ps(rowEdge[2])), zero));
+				if (_mm_movemask_ps(inside) == 0)
+				{
+					continue;
+				}
+
+				__m128 depth = _mm_add_ps(_mm_mul_ps(zA, centerX), _mm_set1_ps(rowZ));
+				__m128 old = _mm_loadu_ps(row + x);
+				__m128 nearer = _mm_min_ps(old, depth);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+#else
+				float centerX = static_cast<float>(x) + 0.5f;
+				if (triangle.m_edgeA[0] * centerX + rowEdge[0] >= 0.0f &&
+					triangle.m_edgeA[1] * centerX + rowEdge[1] >= 0.0f &&
+					triangle.m_edgeA[2] * centerX + rowEdge[2] >= 0.0f)
+				{
+					row[x] = std::min(row[x], triangle.m_zA * centerX + rowZ);
+				}
+#endif
+			}
+		}
+	}
+
+	bool OcclusionCuller::testBox(const glm::vec3& min, const glm::vec3& max) const noexcept
+	{
+		//1 投影8个顶点，求屏幕矩形与最近深度，任何一个顶点在近平面之前都视为可见
+		glm::vec2 screenMin(std::numeric_limits<float>::max());
+		glm::vec2 screenMax(-std::numeric_limits<float>::max());
+		float nearestDepth = std::numeric_limits<float>::max();
+
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			glm::vec4 corner(
+				(i & 1) ? max.x : min.x,
+				(i & 2) ? max.y : min.y,
+				(i & 4) ? max.z : min.z,
+				1.0f);
+
+			glm::vec4 clip = m_viewProjection * corner;
+			if (clip.w <= 1e-6f || clip.z + clip.w < 0.0f)
+			{
+				return true;
+			}
+
+			float invW = 1.0f / clip.w;
+			glm::vec2 screen(
+				(clip.x * invW * 0.5f + 0.5f) * static_cast<float>(m_width),
+				(clip.y * invW * 0.5f + 0.5f) * static_cast<float>(m_height));
+
+			screenMin = glm::min(screenMin, screen);
+			screenMax = glm::max(screenMax, screen);
+			nearestDepth = std::min(nearestDepth, clip.z * invW * 0.5f + 0.5f);
+		}
+
+		//完全在屏幕外的物体交给视锥体剪裁处理，这里不算作被遮挡
+		if (screenMax.x < 0.0f || screenMax.y < 0.0f ||
+			screenMin.x >= static_cast<float>(m_width) || screenMin.y >= static_cast<float>(m_height))
+		{
+			return true;
+		}
+
+		int32_t minX = std::max(static_cast<int32_t>(std::floor(screenMin.x)), 0);
+		int32_t minY = std::max(static_cast<int32_t>(std::floor(screenMin.y)), 0);
+		int32_t maxX = std::min(static_cast<int32_t>(std::floor(screenMax.x)), static_cast<int32_t>(m_width) - 1);
+		int32_t maxY = std::min(static_cast<int32_t>(std::floor(screenMax.y)), static_cast<int32_t>(m_height) - 1);
+
+		//2 块深度比物体更近的tile整块跳过，否则比较矩形内的像素
+		for (int32_t tileY = minY / TileSize; tileY <= maxY / static_cast<int32_t>(TileSize); ++tileY)
+		{
+			for (int32_t tileX = minX / TileSize; tileX <= maxX / static_cast<int32_t>(TileSize); ++tileX)
+			{
+				if (m_tileMaxDepth[tileY * m_tilesX + tileX] < nearestDepth)
+				{
+					continue;
+				}
+
+				int32_t tileLeft = tileX * TileSize;
+				int32_t columnBegin = std::max(minX - tileLeft, 0);
+				int32_t columnEnd = std::min(maxX - tileLeft, static_cast<int32_t>(TileSize) - 1);
+				uint32_t columnMask = ((2u << columnEnd) - 1) & ~((1u << columnBegin) - 1);
+
+				int32_t rowBegin = std::max(minY, tileY * static_cast<int32_t>(TileSize));
+				int32_t rowEnd = std::min(maxY, (tileY + 1) * static_cast<int32_t>(TileSize) - 1);
+				for (int32_t y = rowBegin; y <= rowEnd; ++y)
+				{
+					if (farPixelMask(m_depth.data() + y * m_width + tileLeft, nearestDepth) & columnMask)
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+}
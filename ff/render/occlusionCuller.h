@@ -0,0 +1,143 @@
+/**
+ * @class OcclusionCuller
+ * @brief CPU软件遮挡剪裁：把标记为遮挡体的物体光栅化到一张低分辨率深度缓冲中，再用被遮挡体的包围盒与之比较，剔除完全被挡住的物体。
+ *
+ * 简介：
+ * - 深度缓冲按8x8像素分块(tile)，每块额外保存一个块内最远深度，被遮挡体测试时先用块深度整块判定，块深度不够时再逐像素比较。
+ * - 遮挡体三角形先在裁剪空间对近平面做裁剪，再变换到屏幕空间；光栅化按tile行切分为若干条带，
+ *   每个条带是一个任务，条带之间没有写冲突，可以在 JobSystem 的工作线程上并行执行。
+ * - 光栅化内层循环一次处理8个(AVX)或4个(SSE)像素：用边函数判断覆盖，用屏幕空间线性的z/w平面求深度，取最近的深度写入。
+ * - 被遮挡体用世界空间AABB测试：8个顶点投影后得到屏幕矩形与最近深度，矩形内所有像素的遮挡深度都比它近时判定为被遮挡。
+ *   包围盒跨越近平面时一律视为可见。
+ *
+ * 使用示例：
+ * @code
+ * auto culler = ff::OcclusionCuller::create();
+ * culler->begin(projectionMatrix * viewMatrix);
+ * culler->addOccluder(wall.get());
+ * auto index = culler->addOccludee(mesh->getWorldBoundingBox());
+ * culler->cull(jobSystem);     // jobSystem可以为nullptr，此时在调用线程上串行执行
+ * if (!culler->isOccluded(index)) { ... }
+ * @endcode
+ *
+ * 限制与注意：
+ * - 覆盖以像素中心采样，遮挡体的轮廓边缘可能多挡住不足一个像素的范围，遮挡体应当选取墙体、地形、大型建筑等实心物体。
+ * - 遮挡体可以通过 RenderableObject::m_occluderGeometry 指定简化的几何体，为空时使用渲染几何体；只支持三角形绘制模式。
+ * - 不考虑蒙皮变形，透明物体不会作为遮挡体。
+ * - begin/addOccluder/addOccludee 非线程安全，cull内部自行分配任务。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "../global/base.h"
+#include "../objects/renderableObject.h"
+#include "../math/box3.h"
+#include "../tools/jobSystem.h"
+
+namespace ff
+{
+	class OcclusionCuller
+	{
+	public:
+		//一帧遮挡剪裁的统计
+		struct CullInfo
+		{
+			uint32_t m_occluders{ 0 };			//光栅化的遮挡体数
+			uint32_t m_occluderTriangles{ 0 };	//裁剪之后送入光栅化的三角形数
+			uint32_t m_occludeesTested{ 0 };	//测试的被遮挡体数
+			uint32_t m_occludeesCulled{ 0 };	//被剔除的被遮挡体数
+		};
+
+		static constexpr uint32_t TileSize = 8;
+
+		using Ptr = std::shared_ptr<OcclusionCuller>;
+		static Ptr create(uint32_t width = 256, uint32_t height = 128)
+		{
+			return std::make_shared<OcclusionCuller>(width, height);
+		}
+
+		OcclusionCuller(uint32_t width, uint32_t height) noexcept;
+
+		~OcclusionCuller() noexcept;
+
+		//分辨率向上取整到TileSize的倍数
+		void setResolution(uint32_t width, uint32_t height) noexcept;
+
+		//开始新的一帧：记录视图投影矩阵，清空遮挡体与被遮挡体列表
+		void begin(const glm::mat4& viewProjection) noexcept;
+
+		void addOccluder(RenderableObject* object) noexcept;
+
+		//返回被遮挡体的下标，cull之后通过isOccluded查询
+		uint32_t addOccludee(const Box3& worldBox) noexcept;
+
+		//光栅化所有遮挡体，然后测试所有被遮挡体
+		void cull(const JobSystem::Ptr& jobSystem) noexcept;
+
+		bool isOccluded(uint32_t index) const noexcept { return m_occluded[index] != 0; }
+
+		//单独测试一个包围盒，需要在cull(或rasterize)之后调用
+		bool testBox(const glm::vec3& min, const glm::vec3& max) const noexcept;
+
+		//只光栅化遮挡体，不测试被遮挡体
+		void rasterize(const JobSystem::Ptr& jobSystem) noexcept;
+
+		const CullInfo& getCullInfo() const noexcept { return m_cullInfo; }
+
+		uint32_t getWidth() const noexcept { return m_width; }
+
+		uint32_t getHeight() const noexcept { return m_height; }
+
+		//行优先、自下而上的深度缓冲，取值[0, 1]，1表示没有遮挡
+		const std::vector<float>& getDepthBuffer() const noexcept { return m_depth; }
+
+	private:
+		//屏幕空间的三角形：三条边函数 a * x + b * y + c >= 0 时像素中心被覆盖，深度为 zA * x + zB * y + zC
+		struct Triangle
+		{
+			float		m_edgeA[3];
+			float		m_edgeB[3];
+			float		m_edgeC[3];
+			float		m_zA{ 0.0f };
+			float		m_zB{ 0.0f };
+			float		m_zC{ 0.0f };
+			int32_t		m_minX{ 0 };
+			int32_t		m_maxX{ 0 };
+			int32_t		m_minY{ 0 };
+			int32_t		m_maxY{ 0 };
+		};
+
+		//遮挡体的三角形变换、近平面裁剪与三角形建立，结果追加到triangles
+		void setupOccluder(RenderableObject* object, std::vector<Triangle>& triangles) noexcept;
+
+		void setupTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2, std::vector<Triangle>& triangles) const noexcept;
+
+		//光栅化[tileRowBegin, tileRowEnd)范围内的tile行，并更新其块深度
+		void rasterizeTileRows(uint32_t tileRowBegin, uint32_t tileRowEnd) noexcept;
+
+		void rasterizeTriangle(const Triangle& triangle, int32_t rowBegin, int32_t rowEnd) noexcept;
+
+	private:
+		uint32_t					m_width{ 0 };
+		uint32_t					m_height{ 0 };
+		uint32_t					m_tilesX{ 0 };
+		uint32_t					m_tilesY{ 0 };
+
+		glm::mat4					m_viewProjection = glm::mat4(1.0f);
+
+		std::vector<float>			m_depth{};		//逐像素深度
+		std::vector<float>			m_tileMaxDepth{};	//每个tile内最远的深度
+
+		std::vector<RenderableObject*>	m_occluders{};
+		std::vector<Box3>			m_occludees{};
+		std::vector<uint8_t>		m_occluded{};
+
+		//按遮挡体分别建立三角形，避免多线程写同一个数组，在多帧之间复用
+		std::vector<std::vector<Triangle>>	m_occluderTriangles{};
+
+		CullInfo					m_cullInfo{};
+	};
+}
@@ -6,6 +6,9 @@
 
 namespace ff {
 
+	//多线程构建渲染列表时每个任务处理的物体数，也是一个局部列表对应的区间长度
+	static const uint32_t RENDER_LIST_GRAIN_SIZE = 1024;
+
 	static void onFrameSizeCallback(DriverWindow* dwindow, int width, int height) {
 		if (dwindow->mRenderer != nullptr) {
 			dwindow->mRenderer->setSize(width, height);
@@ -33,10 +36,14 @@ namespace ff {
 		mBackground = DriverBackground::create(this, mObjects);
 		mRenderState = DriverRenderState::create();
 		mRenderTargets = DriverRenderTargets::create();
-		mTextures = DriverTextures::create(mInfos, mRenderTargets);
+		mTextures = DriverTextures::create(mInfos, mRenderTargets, mState);
 		mShadowMap = DriverShadowMap::create(this, mObjects, mState);
 
 		mFrustum = Frustum::create();
+
+		if (descriptor.mThreadCount > 1) {
+			mJobSystem = JobSystem::create(descriptor.mThreadCount);
+		}
 	}
 
 	Renderer::~Renderer() noexcept {}
@@ -49,26 +56,86 @@ namespace ff {
 
 		if (scene == nullptr) { scene = mDummyScene; }
 
-		//1 更新场景数据
-		scene->updateWorldMatrix(true, true);
+		//1 更新场景数据,只有发生了变化的子树才会重新计算
+		auto& updateInfo = Object3D::getWorldMatrixUpdateInfo();
+		updateInfo = Object3D::WorldMatrixUpdateInfo();
+
+		if (mTransformStore != nullptr) {
+			mTransformStore->update();
+		}
+		else if (mJobSystem != nullptr) {
+			scene->updateWorldMatrixParallel(mJobSystem, true);
+		}
+		else {
+			scene->updateWorldMatrix(true, true);
+		}
 		camera->updateWorldMatrix(true, true);
 
+		mInfos->m_transform.m_recomputed = updateInfo.m_recomputed;
+		mInfos->m_transform.m_skipped = updateInfo.m_skipped;
+		mInfos->m_transform.m_skippedSubtrees = updateInfo.m_skippedSubtrees;
+
+		//遍历统计在本帧所有遍历(包括阴影)之前清零
+		auto traverseAllocations = mTraverseStack.getAllocationCount();
+		mInfos->m_traverse = DriverInfo::Traverse();
+		mInfos->m_lod = DriverInfo::LevelOfDetail();
+		mInfos->m_textureBinding = DriverInfo::TextureBinding();
+		mInfos->m_stateChanges = DriverInfo::StateChanges();
+		mInfos->m_renderList = DriverInfo::RenderListBuild();
+
 		auto projectionMatrix = camera->getProjectionMatrix();
 		auto cameraInverseMatrix = camera->getWorldMatrixInverse();
 
 		mCurrentViewMatrix = projectionMatrix * cameraInverseMatrix;
 		mFrustum->setFromProjectionMatrix(mCurrentViewMatrix);
+		mLODView = LOD::makeView(camera, mViewport.w);
+
+		//BVH跟随世界矩阵增量refit，之后整棵分支地剪裁
+		if (mSceneBVH != nullptr) {
+			mSceneBVH->update(scene);
+			mSceneBVH->cull(mFrustum);
+
+			const auto& cullInfo = mSceneBVH->getCullInfo();
+			mInfos->m_culling.m_nodesVisited = cullInfo.m_nodesVisited;
+			mInfos->m_culling.m_objectsTested = cullInfo.m_objectsTested;
+			mInfos->m_culling.m_objectsVisible = cullInfo.m_objectsVisible;
+		}
 
 		//2 提取渲染数据，构成渲染列表与状态
 		mRenderState->init();
 		mRenderList->init();
 
+		if (mOcclusionCuller != nullptr) {
+			mOcclusionCuller->begin(mCurrentViewMatrix);
+		}
+
+		//非阻塞地取回之前帧的查询结果，供压入渲染列表时使用
+		if (mOcclusionQueries != nullptr) {
+			mOcclusionQueries->beginFrame();
+		}
+
 		//scene当中的数据都是层级架构的树状数据，从这个结构，解析为一个线性列表
 		projectObject(scene, 0, mSortObject);
+		mInfos->m_traverse.m_allocations += mTraverseStack.getAllocationCount() - traverseAllocations;
+
+		//多线程构建时，遍历只收集了可渲染物体，在这里并行剪裁并合并
+		if (!mProjectItems.empty()) {
+			projectRenderables(mSortObject);
+		}
+
+		//遮挡剪裁位于视锥体剪裁与压入渲染列表之间
+		if (mOcclusionCuller != nullptr) {
+			cullOccludedItems();
+		}
 
 		//调用完毕projectObject之后，所有可渲染物体&在视景体范围内的，都已经被压入到了RenderList当中
 		mRenderList->finish();
 
+		//按本帧可见物体的投影尺寸提升或淘汰流送贴图的级别
+		if (mTextures->getStreaming() != nullptr) {
+			mTextures->updateStreaming();
+		}
+
 		//经过上述projectObject的流程，任何一个我们使用到的Attribute都已经成功的被解析成为了一个VBO
 		//在上述流程中，每个Mesh的IndexAttribute并没有被解析为EBO
 
@@ -100,62 +167,274 @@ namespace ff {
 		mWindow->swap();
 	}
 
+	//以显式栈遍历场景，不再递归，也不再拷贝children数组
+	//只有真正压入渲染列表/光源列表的物体才会生成智能指针
 	void Renderer::projectObject(const Object3D::Ptr& object, uint32_t groupOrder, bool sortObjects) noexcept {
-		//当前需要被解析的物体，如果是不可见物体，那么连同其子节点一起都变为不可见状态
-		if (!object->m_visible) return;
+		uint32_t visited = 0;
 
-		glm::vec4 toolVec(1.0f);
+		//当前需要被解析的物体，如果是不可见物体，那么连同其子节点一起都变为不可见状态(由traverseVisible跳过)
+		object->traverseVisible(mTraverseStack, groupOrder, [&](Object3D* current, uint32_t& currentGroupOrder) {
+			visited++;
 
-		//对object进行了类型判断，并且分别做不同的处理 
-		if (object->m_isGroup) {
-			auto group = std::static_pointer_cast<Group>(object);
-			groupOrder = group->m_groupOrder;
-		}
-		else if (object->m_isLight) {
-			auto light = std::static_pointer_cast<Light>(object);
-			mRenderState->pushLight(light);
-			if (light->mCastShadow) {
-				mRenderState->pushShadow(light);
+			//对object进行了类型判断，并且分别做不同的处理 
+			if (current->m_isGroup) {
+				currentGroupOrder = static_cast<Group*>(current)->m_groupOrder;
+			}
+			//LOD只保留选中级别可见，投影过小时连同所有级别一起跳过
+			else if (current->m_isLOD) {
+				auto lod = static_cast<LOD*>(current);
+				auto level = lod->update(mLODView);
+
+				mInfos->m_lod.m_objects++;
+				mInfos->m_lod.m_switches += lod->hasSwitched() ? 1 : 0;
+				if (level == LOD::Culled) {
+					mInfos->m_lod.m_culled++;
+					return false;
+				}
 			}
+			//HLOD距离足够远时用合并后的代理代替整个子树，代理本身不可见，不会被遍历到
+			else if (current->m_isHLOD) {
+				auto hlod = static_cast<HLOD*>(current);
+
+				mInfos->m_lod.m_hlods++;
+				if (hlod->update(mLODView)) {
+					mInfos->m_lod.m_proxies++;
+					projectRenderable(hlod->getProxy().get(), currentGroupOrder, sortObjects);
+					return false;
+				}
+			}
+			else if (current->m_isLight) {
+				auto light = std::static_pointer_cast<Light>(current->shared_from_this());
+				mRenderState->pushLight(light);
+				if (light->mCastShadow) {
+					mRenderState->pushShadow(light);
+				}
+			}
+			//如果是可渲染物体
+			else if (current->m_isRenderableObject) {
+				//骨骼
+				if (current->m_isSkinnedMesh) {
+					static_cast<SkinnedMesh*>(current)->mSkeleton->update();
+				}
+
+				projectRenderable(static_cast<RenderableObject*>(current), currentGroupOrder, sortObjects);
+			}
+
+			return true;
+		});
+
+		mInfos->m_traverse.m_visited += visited;
+	}
+
+	void Renderer::projectRenderable(RenderableObject* renderable, uint32_t groupOrder, bool sortObjects) noexcept {
+		//多线程构建渲染列表时先收集起来，剪裁与排序键在projectRenderables中并行计算
+		if (mParallelRenderList && mJobSystem != nullptr) {
+			//geometry的包围体在第一次使用时计算，它可能被多个物体共享，不能放到工作线程中
+			const auto& geometry = renderable->getGeometry();
+			if (geometry != nullptr && geometry->getBoundingSphere() == nullptr) {
+				renderable->getWorldBoundingSphere();
+			}
+
+			mProjectItems.push_back({ renderable, groupOrder });
+			return;
 		}
-		//如果是可渲染物体
-		else if (object->m_isRenderableObject) {
-			//骨骼
-			if (object->m_isSkinnedMesh) {
-				auto skinnedMesh = std::dynamic_pointer_cast<SkinnedMesh>(object);
-				skinnedMesh->mSkeleton->update();
+
+		float z = 0.0f;
+		if (!cullRenderable(renderable, sortObjects, z)) {
+			return;
+		}
+
+		if (mOcclusionCuller != nullptr) {
+			//先暂存，遮挡体全部光栅化之后再决定是否压入渲染列表
+			addOcclusionItem(renderable, groupOrder, z);
+		}
+		else {
+			pushRenderItem(renderable, groupOrder, z);
+		}
+	}
+
+	void Renderer::projectRenderables(bool sortObjects) noexcept {
+		const auto count = static_cast<uint32_t>(mProjectItems.size());
+		const auto rangeCount = (count + RENDER_LIST_GRAIN_SIZE - 1) / RENDER_LIST_GRAIN_SIZE;
+		const bool occlusion = mOcclusionCuller != nullptr;
+
+		if (occlusion) {
+			if (mVisibleRanges.size() < rangeCount) {
+				mVisibleRanges.resize(rangeCount);
 			}
 
-			//如果需要在渲染列表当中对物体进行排序，则需要计算其z坐标值(深度值）
-			if (mSortObject) {
-				toolVec = glm::vec4(object->getWorldPosition(), 1.0);
-				toolVec = mCurrentViewMatrix * toolVec;
+			for (uint32_t i = 0; i < rangeCount; ++i) {
+				mVisibleRanges[i].clear();
 			}
+		}
+		else {
+			mRenderList->initPartials(rangeCount);
+		}
 
-			auto renderableObject = std::static_pointer_cast<RenderableObject>(object);
+		Timer timer;
+		timer.reset();
 
-			//首先对object进行一次视景体剪裁测试
-			if (mFrustum->intersectObject(renderableObject)) {
+		//1 工作线程：剪裁、计算z与排序键，每个区间只写入自己的局部列表，不接触GL
+		mJobSystem->parallelFor(count, RENDER_LIST_GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+			const uint32_t range = begin / RENDER_LIST_GRAIN_SIZE;
 
-				//1 对object geometry attribute进行解析与更新
-				auto geometry = mObjects->update(renderableObject);
+			for (uint32_t i = begin; i < end; ++i) {
+				const auto& item = mProjectItems[i];
 
-				//2 拿出material
-				auto material = renderableObject->getMaterial();
+				float z = 0.0f;
+				if (!cullRenderable(item.m_object, sortObjects, z)) {
+					continue;
+				}
 
-				mRenderList->push(
-					renderableObject,
-					geometry,
-					material,
-					groupOrder,
-					toolVec.z);
+				if (occlusion) {
+					mVisibleRanges[range].push_back({ item.m_object, item.m_groupOrder, z });
+					continue;
+				}
+
+				const auto& material = item.m_object->getMaterial();
+
+				uint32_t programID = 0;
+				uint32_t textureID = 0;
+				getSortStateIDs(material.get(), programID, textureID);
+
+				mRenderList->pushPartial(
+					range,
+					item.m_object,
+					item.m_object->getGeometry().get(),
+					material.get(),
+					item.m_groupOrder,
+					z,
+					programID,
+					textureID);
 			}
+		});
+
+		auto parallelTime = timer.elapsed_micro();
+		timer.reset();
+
+		//2 调用线程：按区间顺序合并，geometry上传、遮挡查询与流送请求都在这里进行，渲染列表的顺序与串行构建相同
+		if (occlusion) {
+			for (uint32_t i = 0; i < rangeCount; ++i) {
+				for (const auto& item : mVisibleRanges[i]) {
+					addOcclusionItem(item.m_object, item.m_groupOrder, item.m_z);
+				}
+			}
+		}
+		else {
+			mRenderList->mergePartials([this](const RenderItem& item) {
+				return commitRenderItem(item.m_object);
+			});
+		}
+
+		mInfos->m_renderList.m_candidates = count;
+		mInfos->m_renderList.m_ranges = rangeCount;
+		mInfos->m_renderList.m_parallelMicroseconds = parallelTime;
+		mInfos->m_renderList.m_commitMicroseconds = timer.elapsed_micro();
+
+		mProjectItems.clear();
+	}
+
+	bool Renderer::cullRenderable(RenderableObject* renderable, bool sortObjects, float& z) noexcept {
+		//首先对object进行一次视景体剪裁测试，BVH中的物体直接使用BVH剪裁的结果
+		bool visible = (mSceneBVH != nullptr && mSceneBVH->contains(renderable)) ?
+			mSceneBVH->isVisible(renderable) : mFrustum->intersectObject(renderable);
+
+		//如果需要在渲染列表当中对物体进行排序，则需要计算其z坐标值(深度值）
+		if (visible && sortObjects) {
+			z = (mCurrentViewMatrix * glm::vec4(renderable->getWorldPosition(), 1.0f)).z;
+		}
+
+		return visible;
+	}
+
+	void Renderer::addOcclusionItem(RenderableObject* renderable, uint32_t groupOrder, float z) noexcept {
+		OcclusionItem item{ renderable, groupOrder, z };
+
+		const auto& material = renderable->getMaterial();
+		if (renderable->m_isOccluder && !material->m_transparent && material->m_drawMode == DrawMode::Triangles) {
+			mOcclusionCuller->addOccluder(renderable);
+		}
+		else {
+			item.m_occludee = mOcclusionCuller->addOccludee(renderable->getWorldBoundingBox());
 		}
 
-		auto children = object->getChildren();
-		for (auto& child : children) {
-			projectObject(child, groupOrder, sortObjects);
+		mOcclusionItems.push_back(item);
+	}
+
+	void Renderer::pushRenderItem(RenderableObject* object, uint32_t groupOrder, float z) noexcept {
+		if (!commitRenderItem(object)) {
+			return;
 		}
+
+		const auto& material = object->getMaterial();
+
+		uint32_t programID = 0;
+		uint32_t textureID = 0;
+		getSortStateIDs(material.get(), programID, textureID);
+
+		mRenderList->push(
+			object,
+			object->getGeometry().get(),
+			material.get(),
+			groupOrder,
+			z,
+			programID,
+			textureID);
+	}
+
+	bool Renderer::commitRenderItem(RenderableObject* object) noexcept {
+		//GPU遮挡查询判定为被遮挡的物体，连同其geometry的更新一起跳过
+		if (mOcclusionQueries != nullptr && !mOcclusionQueries->isVisible(object)) {
+			return false;
+		}
+
+		//对object geometry attribute进行解析与更新，不生成智能指针
+		mObjects->update(object);
+
+		if (mTextures->getStreaming() != nullptr) {
+			mTextures->requestStreaming(object->getMaterial(), LOD::projectSize(object->getWorldBoundingSphere(), mLODView));
+		}
+
+		return true;
+	}
+
+	void Renderer::getSortStateIDs(const Material* material, uint32_t& programID, uint32_t& textureID) const noexcept {
+		//排序键按材质上一次使用的program与绘制时绑定的diffuseMap(被打包时为其所在的页)分组
+		auto driverMaterial = mMaterials->find(material);
+		programID = (driverMaterial != nullptr && driverMaterial->mCurrentProgram != nullptr) ?
+			driverMaterial->mCurrentProgram->getID() : 0;
+
+		textureID = 0;
+		if (material->m_diffuseMap != nullptr) {
+			auto region = mTextures->getAtlasRegion(material->m_diffuseMap);
+			textureID = region != nullptr ? region->m_page->getID() : material->m_diffuseMap->getID();
+		}
+	}
+
+	void Renderer::cullOccludedItems() noexcept {
+		Timer timer;
+		timer.reset();
+
+		mOcclusionCuller->cull(mJobSystem);
+
+		auto elapsed = timer.elapsed_micro();
+
+		//按暂存的顺序压入，与不开启遮挡剪裁时的渲染列表顺序一致
+		for (const auto& item : mOcclusionItems) {
+			if (item.m_occludee != UINT32_MAX && mOcclusionCuller->isOccluded(item.m_occludee)) {
+				continue;
+			}
+
+			pushRenderItem(item.m_object, item.m_groupOrder, item.m_z);
+		}
+		mOcclusionItems.clear();
+
+		const auto& cullInfo = mOcclusionCuller->getCullInfo();
+		mInfos->m_occlusion.m_occluders = cullInfo.m_occluders;
+		mInfos->m_occlusion.m_occluderTriangles = cullInfo.m_occluderTriangles;
+		mInfos->m_occlusion.m_tested = cullInfo.m_occludeesTested;
+		mInfos->m_occlusion.m_culled = cullInfo.m_occludeesCulled;
+		mInfos->m_occlusion.m_microseconds = elapsed;
 	}
 
 	void Renderer::renderScene(
@@ -173,12 +452,17 @@ namespace ff {
 
 		if (!opaqueObjects.empty()) renderObjects(opaqueObjects, scene, camera);
 
+		//不透明物体的深度已经写入，在此之上绘制包围盒查询
+		if (mOcclusionQueries != nullptr) {
+			mOcclusionQueries->issueQueries(mCurrentViewMatrix, camera->getWorldPosition());
+		}
+
 		if (!transparentObjects.empty()) renderObjects(transparentObjects, scene, camera);
 
 	}
 
 	void Renderer::renderObjects(
-		const std::vector<RenderItem::Ptr>& renderItems,
+		const RenderItemSpan& renderItems,
 		const Scene::Ptr& scene,
 		const Camera::Ptr& camera
 	) noexcept {
@@ -186,9 +470,10 @@ namespace ff {
 		const auto overrideMaterial = scene->m_isScene ? scene->m_overrideMaterial : nullptr;
 
 		for (const auto& renderItem : renderItems) {
-			const auto object = renderItem->m_object;
-			const auto geometry = renderItem->m_geometry;
-			const auto material = overrideMaterial == nullptr ? renderItem->m_material : overrideMaterial;
+			//渲染列表只保存裸指针，绘制时再取得智能指针
+			const auto object = std::static_pointer_cast<RenderableObject>(renderItem.m_object->shared_from_this());
+			const auto geometry = renderItem.m_geometry->shared_from_this();
+			const auto material = overrideMaterial == nullptr ? object->getMaterial() : overrideMaterial;
 
 			renderObject(object, scene, camera, geometry, material);
 		}
@@ -224,6 +509,9 @@ namespace ff {
 		auto index = geometry->getIndex();
 		auto position = geometry->getAttribute("position");
 
+		//上一次绘制占用的纹理单元从这里起可以被换出
+		mState->beginDraw();
+
 		auto program = setProgram(camera, _scene, geometry, material, object);
 
 		mState->setMaterial(material);
@@ -231,7 +519,9 @@ namespace ff {
 		//1 生成并管理VAO
 		//2 设置绑定状态
 		//3 负责了VAO绑定状态的缓存
-		mBindingStates->setup(geometry, index);
+		if (mBindingStates->setup(geometry, index)) {
+			mInfos->m_stateChanges.m_vaos++;
+		}
 
 		//draw
 		if (index) {
@@ -290,6 +580,16 @@ namespace ff {
 				}
 			}
 
+			//diffuseMap被打包与否，或者所在页的类型(图集/纹理数组)变化，采样代码不同
+			auto diffuseRegion = mTextures->getAtlasRegion(material->m_diffuseMap);
+			auto diffuseMapPage = diffuseRegion != nullptr ? diffuseRegion->m_page : nullptr;
+			if (diffuseMapPage != dMaterial->mDiffuseMapPage) {
+				if (diffuseMapPage == nullptr || dMaterial->mDiffuseMapPage == nullptr ||
+					diffuseMapPage->m_textureType != dMaterial->mDiffuseMapPage->m_textureType) {
+					needsProgramChange = true;
+				}
+			}
+
 			if (material->m_envMap != dMaterial->mEnvMap) {
 				if (material->m_envMap == nullptr || dMaterial->mEnvMap == nullptr) {
 					needsProgramChange = true;
@@ -341,6 +641,7 @@ namespace ff {
 		//useProgram当中，如果更换了绑定的Program，就得更新Uniform
 		if (mState->useProgram(dprogram->mProgram)) {
 			refreshProgram = true;
+			mInfos->m_stateChanges.m_programs++;
 		}
 
 		//----------------------------------以上就是做完了Program的绑定工作-----------------------------------
@@ -351,7 +652,7 @@ namespace ff {
 		auto uniforms = dMaterial->mUniforms;
 
 		//DriverMaterial根据我们绘制需要的material，对uniforms进行了更新处理
-		DriverMaterials::refreshMaterialUniforms(uniforms, material);
+		DriverMaterials::refreshMaterialUniforms(uniforms, material, mTextures);
 
 		bool needsLights = materialNeedsLights(material);
 
@@ -388,7 +689,7 @@ namespace ff {
 
 		DebugLog::getInstance()->beginUpLoad(material->getType());
 
-		dprogram->uploadUniforms(uniforms, mTextures);
+		mInfos->m_stateChanges.m_uniforms += dprogram->uploadUniforms(uniforms, mTextures);
 
 		DebugLog::getInstance()->end();
 
@@ -409,7 +710,7 @@ namespace ff {
 		auto& programs = dMaterial->mPrograms;
 
 		//mPrograms是DriverPrograms，通过下方的接口，生成本个RenderItem的Parameters
-		auto parameters = mPrograms->getParameters(material, object, lights, mShadowMap);
+		auto parameters = mPrograms->getParameters(material, object, lights, mShadowMap, mTextures);
 
 		//通过Parameters计算一个哈希值
 		auto cacheKey = mPrograms->getProgramCacheKey(parameters);
@@ -455,6 +756,9 @@ namespace ff {
 		dMaterial->mEnvMap = material->m_envMap;
 		dMaterial->mNormalMap = material->m_normalMap;
 		dMaterial->mSpecularMap = material->m_specularMap;
+
+		auto diffuseRegion = mTextures->getAtlasRegion(material->m_diffuseMap);
+		dMaterial->mDiffuseMapPage = diffuseRegion != nullptr ? diffuseRegion->m_page : nullptr;
 	}
 
 	bool Renderer::materialNeedsLights(const Material::Ptr& material) noexcept {
@@ -533,6 +837,58 @@ namespace ff {
 		mShadowMap->mEnabled = enable;
 	}
 
+	void Renderer::setTransformStore(const TransformStore::Ptr& store) noexcept {
+		mTransformStore = store;
+	}
+
+	void Renderer::enableSceneBVH(bool enable) noexcept {
+		if (!enable) {
+			mSceneBVH = nullptr;
+		}
+		else if (mSceneBVH == nullptr) {
+			mSceneBVH = SceneBVH::create();
+		}
+	}
+
+	void Renderer::enableOcclusionCulling(bool enable) noexcept {
+		if (!enable) {
+			mOcclusionCuller = nullptr;
+			mInfos->m_occlusion = DriverInfo::Occlusion();
+		}
+		else if (mOcclusionCuller == nullptr) {
+			mOcclusionCuller = OcclusionCuller::create();
+		}
+	}
+
+	void Renderer::enableOcclusionQueries(bool enable, uint32_t minVertexCount) noexcept {
+		if (!enable) {
+			mOcclusionQueries = nullptr;
+			mInfos->m_occlusionQuery = DriverInfo::OcclusionQuery();
+			return;
+		}
+
+		if (mOcclusionQueries == nullptr) {
+			mOcclusionQueries = DriverOcclusionQueries::create(mObjects, mBindingStates, mState, mInfos);
+		}
+		mOcclusionQueries->setMinVertexCount(minVertexCount);
+	}
+
+	void Renderer::enableTextureStreaming(bool enable, uint64_t budgetBytes) noexcept {
+		mTextures->enableStreaming(enable, budgetBytes);
+	}
+
+	void Renderer::setTextureAtlas(const TextureAtlas::Ptr& atlas) noexcept {
+		mTextures->setTextureAtlas(atlas);
+	}
+
+	void Renderer::setOpaqueSortMode(OpaqueSortMode mode) noexcept {
+		mRenderList->setOpaqueLayout(SortKeyLayout::opaque(mode));
+	}
+
+	void Renderer::enableParallelRenderList(bool enable) noexcept {
+		mParallelRenderList = enable;
+	}
+
 	//为何不直接使用driverWindow的set函数进行回调设置呢？
 	//窗体大小的变化会影响咱们renderer的状态,比如视口viewport需要跟随设置变化
 	void Renderer::setFrameSizeCallBack(const OnSizeCallback& callback) noexcept {
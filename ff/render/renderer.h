@@ -2,9 +2,14 @@
 #include "../global/base.h"
 #include "../camera/camera.h"
 #include "../core/object3D.h"
+#include "../core/transformStore.h"
 #include "../objects/mesh.h"
+#include "../objects/lod.h"
+#include "../objects/hlod.h"
 #include "../scene/scene.h"
+#include "../scene/sceneBVH.h"
 #include "renderTarget.h"
+#include "occlusionCuller.h"
 #include "driver/driverAttributes.h"
 #include "driver/driverBindingState.h"
 #include "driver/driverPrograms.h"
@@ -19,7 +24,9 @@
 #include "driver/driverRenderState.h"
 #include "driver/driverRenderTargets.h"
 #include "driver/driverShadowMap.h"
+#include "driver/driverOcclusionQueries.h"
 #include "../math/frustum.h"
+#include "../tools/jobSystem.h"
 
 namespace ff {
 
@@ -30,6 +37,9 @@ namespace ff {
 		struct Descriptor {
 			uint32_t mWidth{ 800 };
 			uint32_t mHeight{ 600 };
+
+			//µȲʹõ߳(Ⱦ߳)1ʾȫȾ߳ϴִ
+			uint32_t mThreadCount{ 1 };
 		};
 
 		using OnSizeCallback = std::function<void(int width, int height)>;
@@ -67,6 +77,33 @@ namespace ff {
 
 		void enableShadow(bool enable) noexcept;
 
+		//úÿ֡store->update()󣬴scene->updateWorldMatrixĵݹ
+		void setTransformStore(const TransformStore::Ptr& store) noexcept;
+
+		//ʹóBVHλ׶(Ӱ)İΧ
+		void enableSceneBVH(bool enable) noexcept;
+
+		//׶֮m_isOccluderǵڵCPUڵã޳ȫס
+		void enableOcclusionCulling(bool enable) noexcept;
+
+		//ԶminVertexCountĲ͸巢GPUΧڵѯӳ1~2֡ʹýڵ
+		void enableOcclusionQueries(bool enable, uint32_t minVertexCount = 1000) noexcept;
+
+		//mipͼפͷֱʵβٰʹͶӰߴ֡פֽbudgetBytes(LRṶ)
+		void enableTextureStreaming(bool enable, uint64_t budgetBytes = 256ull * 1024 * 1024) noexcept;
+
+		//úʹñͼĲʰڵͼҳ()ͬһҳ֮䲻лͼnullptrȡ
+		void setTextureAtlas(const TextureAtlas::Ptr& atlas) noexcept;
+
+		//͸ʽĬHybridmSortObjectʱЧʽ״̬л DriverInfo::m_stateChanges
+		void setOpaqueSortMode(OpaqueSortMode mode) noexcept;
+
+		//(ҪDescriptor::mThreadCount > 1)׶㰴ڹ߳ϽУgeometryϴڵ߳ϣĬϿ
+		void enableParallelRenderList(bool enable) noexcept;
+
+		//֡Ļͳ(״̬лͼ󶨡޳)
+		const DriverInfo::Ptr& getInfo() const noexcept { return mInfos; }
+
 		void clear(bool color = true, bool depth = true, bool stencil = true) noexcept;
 
 	public:
@@ -80,6 +117,30 @@ namespace ff {
 		// 3 sortObjects ǷȾбУitem
 		void projectObject(const Object3D::Ptr& object, uint32_t groupOrder, bool sortObjects) noexcept;
 
+		//ԿȾȼãͨѹȾб(ݴȴڵ޳)̹߳ʱֻռ
+		void projectRenderable(RenderableObject* renderable, uint32_t groupOrder, bool sortObjects) noexcept;
+
+		//̹߳mJobSystemϲмprojectObjectռ壬дֲбڵ߳Ϻϲ
+		void projectRenderables(bool sortObjects) noexcept;
+
+		//׶ãɼҪʱռzֻݣڹ߳ϵ
+		bool cullRenderable(RenderableObject* renderable, bool sortObjects, float& z) noexcept;
+
+		//OcclusionCullerΪڵ򱻲壬ݴ
+		void addOcclusionItem(RenderableObject* renderable, uint32_t groupOrder, float z) noexcept;
+
+		//ͨõĿȾ壬geometryѹȾб
+		void pushRenderItem(RenderableObject* object, uint32_t groupOrder, float z) noexcept;
+
+		//ѹȾб֮ǰֻڵ߳ϽеĹڵѯgeometryϴͼ󣻱ڵʱfalse
+		bool commitRenderItem(RenderableObject* object) noexcept;
+
+		//ʹõprogramͼţֻڹ߳ϵ
+		void getSortStateIDs(const Material* material, uint32_t& programID, uint32_t& textureID) const noexcept;
+
+		//դڵ岢projectObjectݴ壬˳ûбڵѹȾб
+		void cullOccludedItems() noexcept;
+
 		//һ㼶ڳ𣬽һЩ״̬ĴãҸ
 		//ʵ/͸жȾ-renderObjects
 		void renderScene(const DriverRenderList::Ptr& currentRenderList, const Scene::Ptr& scene, const Camera::Ptr& camera) noexcept;
@@ -87,7 +148,7 @@ namespace ff {
 		//ڶ㼶ڶм𣬽һЩ״̬Ĵ
 		//εÿȾԪ뵽renderObject
 		void renderObjects(
-			const std::vector<RenderItem::Ptr>& renderItems, 
+			const RenderItemSpan& renderItems, 
 			const Scene::Ptr& scene, 
 			const Camera::Ptr& camera) noexcept;
 
@@ -137,6 +198,9 @@ namespace ff {
 
 		glm::mat4	mCurrentViewMatrix = glm::mat4(1.0f);
 
+		//֡ѡLODʹõĲ
+		LOD::View	mLODView{};
+
 		glm::vec4	mViewport{};
 
 		RenderTarget::Ptr	mCurrentRenderTarget{ nullptr };
@@ -159,6 +223,42 @@ namespace ff {
 
 		Frustum::Ptr			mFrustum{ nullptr };
 
+		//projectObjectõıջ
+		Object3D::TraverseStack	mTraverseStack{};
+
+		TransformStore::Ptr		mTransformStore{ nullptr };
+
+		JobSystem::Ptr			mJobSystem{ nullptr };
+
+		SceneBVH::Ptr			mSceneBVH{ nullptr };
+
+		//ڵÿʱprojectObjectȰͨ׶õݴ
+		struct OcclusionItem
+		{
+			RenderableObject*	m_object{ nullptr };
+			uint32_t			m_groupOrder{ 0 };
+			float				m_z{ 0.0f };
+			uint32_t			m_occludee{ UINT32_MAX };	//OcclusionCullerе±꣬ڵ屾ΪUINT32_MAX
+		};
+
+		OcclusionCuller::Ptr		mOcclusionCuller{ nullptr };
+		std::vector<OcclusionItem>	mOcclusionItems{};
+
+		//̹߳ȾбʱprojectObjectֻռȾ壬projectRenderablesвн
+		struct ProjectItem
+		{
+			RenderableObject*	m_object{ nullptr };
+			uint32_t			m_groupOrder{ 0 };
+		};
+
+		bool							mParallelRenderList{ true };
+		std::vector<ProjectItem>		mProjectItems{};
+
+		//ڵÿʱÿͨ׶õ壬˳򽻸OcclusionCuller
+		std::vector<std::vector<OcclusionItem>>	mVisibleRanges{};
+
+		DriverOcclusionQueries::Ptr	mOcclusionQueries{ nullptr };
+
 		//dummy objects
 		Scene::Ptr				mDummyScene = Scene::create();
 	};
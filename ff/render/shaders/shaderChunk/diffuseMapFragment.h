@@ -4,7 +4,13 @@
 namespace ff {
 	static const std::string diffuseMapFragment =
 		"#ifdef HAS_DIFFUSE_MAP\n"\
-		"	diffuseColor.rgb = texture(diffuseMap, fragUV).rgb;\n"\
+		"	#if defined(USE_DIFFUSE_ARRAY)\n"\
+		"		diffuseColor.rgb = texture(diffuseMap, vec3(fragUV, diffuseMapLayer)).rgb;\n"\
+		"	#elif defined(USE_DIFFUSE_ATLAS)\n"\
+		"		diffuseColor.rgb = texture(diffuseMap, clamp(fragUV, 0.0, 1.0) * diffuseMapTransform.xy + diffuseMapTransform.zw).rgb;\n"\
+		"	#else\n"\
+		"		diffuseColor.rgb = texture(diffuseMap, fragUV).rgb;\n"\
+		"	#endif\n"\
 		"#endif\n"\
 		"\n";
 }
\ No newline at end of file
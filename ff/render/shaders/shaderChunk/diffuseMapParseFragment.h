@@ -5,7 +5,15 @@ namespace ff {
 
 	static const std::string diffuseMapParseFragment =
 		"#ifdef HAS_DIFFUSE_MAP\n"\
-		"	uniform sampler2D diffuseMap;\n"\
+		"	#if defined(USE_DIFFUSE_ARRAY)\n"\
+		"		uniform sampler2DArray diffuseMap;\n"\
+		"		uniform float diffuseMapLayer;\n"\
+		"	#else\n"\
+		"		uniform sampler2D diffuseMap;\n"\
+		"	#endif\n"\
+		"	#ifdef USE_DIFFUSE_ATLAS\n"\
+		"		uniform vec4 diffuseMapTransform;\n"\
+		"	#endif\n"\
 		"#endif\n"\
 		"\n";
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once 
+#include "../../../global/base.h"
+
+namespace ff 
+{
+	//遮挡查询使用的包围盒shader，由DriverOcclusionQueries直接编译，不经过DriverPrograms
+	//position为中心在原点的单位立方体，按boxMin/boxMax拉伸到世界空间AABB，只写深度测试结果不写颜色
+	namespace occlusionQuery
+	{
+		static const std::string vertex =
+			"#version 330 core\n"\
+			"layout(location = 0) in vec3 position;\n"\
+			"uniform mat4 viewProjectionMatrix;\n"\
+			"uniform vec3 boxMin;\n"\
+			"uniform vec3 boxMax;\n"\
+
+			"void main() {\n"\
+			"	vec3 worldPosition = mix(boxMin, boxMax, position + vec3(0.5));\n"\
+			"	gl_Position = viewProjectionMatrix * vec4(worldPosition, 1.0);\n"\
+			"}\n";
+
+		static const std::string fragment =
+			"#version 330 core\n"\
+			"out vec4 fragmentColor;\n"\
+
+			"void main() {\n"\
+			"	fragmentColor = vec4(1.0);\n"\
+			"}\n";
+	}
+}
@@ -95,6 +95,8 @@ namespace ff {
 		{
 			"common", {
 				{"diffuseMap", UniformHandle()},
+				{"diffuseMapTransform", UniformHandle()},
+				{"diffuseMapLayer", UniformHandle()},
 				{"opacity", UniformHandle()}
 			}
 		},
@@ -0,0 +1,373 @@
+#include "sceneBVH.h"
+
+namespace ff
+{
+	SceneBVH::SceneBVH() noexcept {}
+
+	SceneBVH::~SceneBVH() noexcept {}
+
+	void SceneBVH::build(const Object3D::Ptr& root) noexcept
+	{
+		m_objects.clear();
+		m_minX.clear();
+		m_minY.clear();
+		m_minZ.clear();
+		m_maxX.clear();
+		m_maxY.clear();
+		m_maxZ.clear();
+		m_objectLeaves.clear();
+		m_geometries.clear();
+		m_geometryGroups.clear();
+		m_geometryGroupIndices.clear();
+		m_visibility.clear();
+		m_nodes.clear();
+		m_dirtyNodes.clear();
+		m_buildObjects.clear();
+
+		m_root = root;
+		if (root == nullptr)
+		{
+			return;
+		}
+
+		m_hierarchyVersion = root->getHierarchyVersion();
+
+		//1 收集所有可渲染物体，不可见的物体也需要收集，其可见性可能每帧变化
+		std::vector<Object3D*> pending{ root.get() };
+		while (!pending.empty())
+		{
+			auto object = pending.back();
+			pending.pop_back();
+
+			if (object->m_isRenderableObject)
+			{
+				m_buildObjects.push_back(static_cast<RenderableObject*>(object));
+			}
+
+			for (const auto& child : object->getChildren())
+			{
+				pending.push_back(child.get());
+			}
+		}
+
+		uint32_t count = static_cast<uint32_t>(m_buildObjects.size());
+		m_buildMins.resize(count);
+		m_buildMaxs.resize(count);
+		m_buildIndices.resize(count);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const auto& box = m_buildObjects[i]->getWorldBoundingBox();
+			m_buildMins[i] = box.m_min;
+			m_buildMaxs[i] = box.m_max;
+			m_buildIndices[i] = i;
+		}
+
+		m_objects.resize(count);
+		m_minX.resize(count);
+		m_minY.resize(count);
+		m_minZ.resize(count);
+		m_maxX.resize(count);
+		m_maxY.resize(count);
+		m_maxZ.resize(count);
+		m_objectLeaves.resize(count);
+		m_geometries.resize(count, nullptr);
+		m_visibility.resize(CullingKernel::getWordCount(count), 0);
+
+		//2 自顶向下构建，叶子节点确定后物体按叶子顺序写入
+		if (count > 0)
+		{
+			m_nodes.reserve(count * 2 / MaxLeafObjects + 1);
+			buildNode(0, count, 0);
+		}
+
+		m_dirtyNodes.resize(m_nodes.size(), 0);
+		m_buildObjects.clear();
+
+		//3 旧的标记数组仍然被不在本次收集范围内的物体持有，这里总是重新分配
+		m_changeFlags = std::make_shared<Object3D::WorldChangeFlags>();
+		m_changeFlags->m_flags.resize(count, 0);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			m_objects[i]->m_sceneBVHIndex = i;
+			m_objects[i]->setWorldChangeFlags(m_changeFlags, i);
+		}
+	}
+
+	void SceneBVH::update(const Object3D::Ptr& root) noexcept
+	{
+		if (m_root.lock() != root || root == nullptr || root->getHierarchyVersion() != m_hierarchyVersion)
+		{
+			build(root);
+			return;
+		}
+
+		refit();
+	}
+
+	void SceneBVH::refit() noexcept
+	{
+		bool changed = m_changeFlags != nullptr && m_changeFlags->m_changed.exchange(false);
+
+		//1 包围体版本变化过的geometry，把使用它的物体也标记为变化；geometry的数量远少于物体，不需要逐个访问物体
+		m_changedGroups.clear();
+		for (uint32_t i = 0; i < m_geometryGroups.size(); ++i)
+		{
+			auto& group = m_geometryGroups[i];
+			auto geometry = group.m_geometry.lock();
+			if (geometry == nullptr || geometry->getBoundsVersion() == group.m_version)
+			{
+				continue;
+			}
+
+			for (auto object : group.m_objects)
+			{
+				m_changeFlags->m_flags[object] = 1;
+			}
+
+			m_changedGroups.push_back(i);
+			changed = true;
+		}
+
+		//没有任何物体的worldMatrix或包围体发生变化
+		if (!changed)
+		{
+			return;
+		}
+
+		//2 找出变化过的物体，标记其所在叶子以及所有祖先
+		auto& flags = m_changeFlags->m_flags;
+		for (uint32_t i = 0; i < m_objects.size(); ++i)
+		{
+			if (!flags[i])
+			{
+				continue;
+			}
+
+			flags[i] = 0;
+			computeObjectBounds(i);
+
+			uint32_t node = m_objectLeaves[i];
+			while (!m_dirtyNodes[node])
+			{
+				m_dirtyNodes[node] = 1;
+				if (node == 0)
+				{
+					break;
+				}
+				node = m_nodes[node].m_parent;
+			}
+		}
+
+		//3 计算物体包围盒时可能重新计算了geometry的包围体，版本在这之后读取
+		for (auto index : m_changedGroups)
+		{
+			auto& group = m_geometryGroups[index];
+			if (auto geometry = group.m_geometry.lock())
+			{
+				group.m_version = geometry->getBoundsVersion();
+			}
+		}
+
+		//4 子节点下标一定大于父节点，逆序遍历即可保证先更新子节点
+		for (uint32_t i = static_cast<uint32_t>(m_nodes.size()); i > 0; --i)
+		{
+			if (m_dirtyNodes[i - 1])
+			{
+				m_dirtyNodes[i - 1] = 0;
+				computeNodeBounds(i - 1);
+			}
+		}
+	}
+
+	void SceneBVH::cull(const Frustum::Ptr& frustum) noexcept
+	{
+		m_cullInfo = CullInfo();
+		std::fill(m_visibility.begin(), m_visibility.end(), 0);
+
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		const auto& planes = frustum->getPlaneData();
+
+		m_stack.clear();
+		m_stack.push_back({ 0, CullingKernel::AllPlanes });
+
+		while (!m_stack.empty())
+		{
+			auto entry = m_stack.back();
+			m_stack.pop_back();
+
+			const auto& node = m_nodes[entry.m_node];
+			m_cullInfo.m_nodesVisited++;
+
+			//planeMask只保留与本节点相交的平面，子节点不再测试已经完全通过的平面
+			uint32_t planeMask = 0;
+			auto result = CullingKernel::classifyBox(planes, entry.m_planeMask, node.m_min, node.m_max, planeMask);
+			if (result == CullingKernel::CullResult::Outside)
+			{
+				continue;
+			}
+
+			//整个分支都在视锥体内，子树中的物体全部可见
+			if (result == CullingKernel::CullResult::Inside)
+			{
+				CullingKernel::setBits(m_visibility.data(), node.m_begin, node.m_count);
+				m_cullInfo.m_objectsVisible += node.m_count;
+				continue;
+			}
+
+			if (node.m_right != 0)
+			{
+				m_stack.push_back({ node.m_right, planeMask });
+				m_stack.push_back({ entry.m_node + 1, planeMask });
+				continue;
+			}
+
+			//与视锥体相交的叶子，物体下标连续，批量测试
+			m_cullInfo.m_objectsTested += node.m_count;
+			m_cullInfo.m_objectsVisible += CullingKernel::cullBoxes(
+				planes, planeMask,
+				m_minX.data(), m_minY.data(), m_minZ.data(),
+				m_maxX.data(), m_maxY.data(), m_maxZ.data(),
+				node.m_begin, node.m_count, m_visibility.data());
+		}
+	}
+
+	uint32_t SceneBVH::buildNode(uint32_t begin, uint32_t end, uint32_t parent) noexcept
+	{
+		uint32_t index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back(Node());
+
+		m_nodes[index].m_begin = begin;
+		m_nodes[index].m_count = end - begin;
+		m_nodes[index].m_parent = parent;
+
+		if (end - begin <= MaxLeafObjects)
+		{
+			//本区间的排列已经确定，按叶子顺序写入物体与包围盒
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				auto object = m_buildIndices[i];
+				m_objects[i] = m_buildObjects[object];
+				m_minX[i] = m_buildMins[object].x;
+				m_minY[i] = m_buildMins[object].y;
+				m_minZ[i] = m_buildMins[object].z;
+				m_maxX[i] = m_buildMaxs[object].x;
+				m_maxY[i] = m_buildMaxs[object].y;
+				m_maxZ[i] = m_buildMaxs[object].z;
+				m_objectLeaves[i] = index;
+				recordGeometry(i);
+			}
+			computeNodeBounds(index);
+			return index;
+		}
+
+		//1 统计包围盒中心的范围，沿最长轴划分
+		glm::vec3 centerMin(std::numeric_limits<float>::max());
+		glm::vec3 centerMax(-std::numeric_limits<float>::max());
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			auto object = m_buildIndices[i];
+			glm::vec3 center = (m_buildMins[object] + m_buildMaxs[object]) * 0.5f;
+			centerMin = glm::min(centerMin, center);
+			centerMax = glm::max(centerMax, center);
+		}
+
+		glm::vec3 extent = centerMax - centerMin;
+		int axis = 0;
+		if (extent.y > extent.x) { axis = 1; }
+		if (extent.z > extent[axis]) { axis = 2; }
+
+		//2 按中位数划分，左右两边物体数相等，保证树的深度为log(n)
+		uint32_t middle = begin + (end - begin) / 2;
+		std::nth_element(
+			m_buildIndices.begin() + begin,
+			m_buildIndices.begin() + middle,
+			m_buildIndices.begin() + end,
+			[this, axis](uint32_t a, uint32_t b) {
+				return m_buildMins[a][axis] + m_buildMaxs[a][axis] < m_buildMins[b][axis] + m_buildMaxs[b][axis];
+			});
+
+		//3 左子节点紧跟在本节点之后
+		buildNode(begin, middle, index);
+		uint32_t right = buildNode(middle, end, index);
+
+		m_nodes[index].m_right = right;
+		computeNodeBounds(index);
+
+		return index;
+	}
+
+	void SceneBVH::computeNodeBounds(uint32_t index) noexcept
+	{
+		auto& node = m_nodes[index];
+
+		if (node.m_right != 0)
+		{
+			const auto& left = m_nodes[index + 1];
+			const auto& right = m_nodes[node.m_right];
+			node.m_min = glm::min(left.m_min, right.m_min);
+			node.m_max = glm::max(left.m_max, right.m_max);
+			return;
+		}
+
+		node.m_min = glm::vec3(std::numeric_limits<float>::max());
+		node.m_max = glm::vec3(-std::numeric_limits<float>::max());
+		for (uint32_t i = node.m_begin; i < node.m_begin + node.m_count; ++i)
+		{
+			node.m_min = glm::min(node.m_min, glm::vec3(m_minX[i], m_minY[i], m_minZ[i]));
+			node.m_max = glm::max(node.m_max, glm::vec3(m_maxX[i], m_maxY[i], m_maxZ[i]));
+		}
+	}
+
+	void SceneBVH::computeObjectBounds(uint32_t index) noexcept
+	{
+		//直接使用物体缓存的世界空间包围盒
+		const auto& box = m_objects[index]->getWorldBoundingBox();
+		m_minX[index] = box.m_min.x;
+		m_minY[index] = box.m_min.y;
+		m_minZ[index] = box.m_min.z;
+		m_maxX[index] = box.m_max.x;
+		m_maxY[index] = box.m_max.y;
+		m_maxZ[index] = box.m_max.z;
+
+		recordGeometry(index);
+	}
+
+	void SceneBVH::recordGeometry(uint32_t index) noexcept
+	{
+		const auto& geometry = m_objects[index]->m_geometry;
+		if (geometry.get() == m_geometries[index])
+		{
+			return;
+		}
+
+		//物体换了geometry，加入新geometry的分组；旧分组中的记录保留，只会多做一次重新计算
+		m_geometries[index] = geometry.get();
+		if (geometry == nullptr)
+		{
+			return;
+		}
+
+		auto result = m_geometryGroupIndices.emplace(geometry.get(), static_cast<uint32_t>(m_geometryGroups.size()));
+		if (result.second)
+		{
+			m_geometryGroups.emplace_back();
+		}
+
+		//同一地址上之前的geometry已经析构，分组重新开始
+		auto& group = m_geometryGroups[result.first->second];
+		if (result.second || group.m_geometry.lock() != geometry)
+		{
+			group.m_geometry = geometry;
+			group.m_objects.clear();
+		}
+
+		group.m_version = geometry->getBoundsVersion();
+		group.m_objects.push_back(index);
+	}
+}
@@ -0,0 +1,173 @@
+/**
+ * @class SceneBVH
+ * @brief 场景级的包围体层次结构(BVH)，以世界空间AABB组织场景中所有可渲染物体，用于层次化的视锥体剪裁。
+ *
+ * 简介：
+ * - build(root) 收集root下所有RenderableObject，按包围盒中心沿最长轴做中位数划分，构建二叉树。
+ * - update(root) 每帧调用：层级结构变化(节点增删)时重新build，否则只对worldMatrix变化过、
+ *   或者geometry被替换/包围体版本变化的物体做增量refit。
+ * - 物体的worldMatrix变化通过 Object3D::WorldChangeFlags 通知，refit只扫描一个字节数组，不需要逐个访问物体；
+ *   物体按geometry分组，refit比较每个geometry的包围体版本(Geometry::getBoundsVersion)，变化时整组重新计算；
+ *   RenderableObject::setGeometry 替换geometry时同样通过 WorldChangeFlags 通知。
+ * - cull(frustum) 自顶向下剪裁，整棵在视锥体外的分支直接跳过，整棵在视锥体内的分支不再逐个测试；
+ *   节点已经完全位于某个平面正面时，子树不再测试该平面(平面掩码)，叶子中的物体用 CullingKernel 批量测试。
+ * - build之后物体按树的叶子顺序重新编号，每个叶子对应一段连续下标，包围盒以SoA方式存储。
+ * - 剪裁结果按物体保存在可见性位图中，渲染遍历场景时通过 isVisible 查询，替代逐个物体的包围球测试。
+ *
+ * 使用示例：
+ * @code
+ * auto bvh = ff::SceneBVH::create();
+ * bvh->update(scene);          // 世界矩阵更新之后
+ * bvh->cull(frustum);
+ * if (bvh->contains(mesh.get()) && bvh->isVisible(mesh.get())) { ... }
+ * @endcode
+ *
+ * 限制与注意：
+ * - 物体包围盒取自geometry的BoundingBox，与原先的包围球测试一样不考虑蒙皮变形。
+ * - refit不会改变树的拓扑，物体大范围移动后树的质量会下降，可以主动调用build重建。
+ * - 一个物体同一时间只记录在一个SceneBVH中。
+ * - 非线程安全。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "../global/base.h"
+#include "../objects/renderableObject.h"
+#include "../math/frustum.h"
+#include "../math/cullingKernel.h"
+
+namespace ff
+{
+	class SceneBVH
+	{
+	public:
+		//一次剪裁的统计
+		struct CullInfo
+		{
+			uint32_t m_nodesVisited{ 0 };	//访问的BVH节点数
+			uint32_t m_objectsTested{ 0 };	//逐个做了包围盒测试的物体数
+			uint32_t m_objectsVisible{ 0 };	//可见物体数
+		};
+
+		using Ptr = std::shared_ptr<SceneBVH>;
+		static Ptr create()
+		{
+			return std::make_shared<SceneBVH>();
+		}
+
+		SceneBVH() noexcept;
+
+		~SceneBVH() noexcept;
+
+		//收集root下所有的可渲染物体并重新构建
+		void build(const Object3D::Ptr& root) noexcept;
+
+		//root或其层级结构变化时重新构建，否则增量refit
+		void update(const Object3D::Ptr& root) noexcept;
+
+		//只更新worldMatrix变化过、或者geometry的包围体变化过的物体包围盒，并向上更新祖先节点
+		//层级结构变化(物体可能已被析构)时需要先build，一般通过update调用
+		void refit() noexcept;
+
+		void cull(const Frustum::Ptr& frustum) noexcept;
+
+		bool contains(const RenderableObject* object) const noexcept
+		{
+			auto index = object->m_sceneBVHIndex;
+			return index < m_objects.size() && m_objects[index] == object;
+		}
+
+		//调用前需要确认contains
+		bool isVisible(const RenderableObject* object) const noexcept
+		{
+			return CullingKernel::testBit(m_visibility.data(), object->m_sceneBVHIndex);
+		}
+
+		const CullInfo& getCullInfo() const noexcept { return m_cullInfo; }
+
+		uint32_t getObjectCount() const noexcept { return static_cast<uint32_t>(m_objects.size()); }
+
+		uint32_t getNodeCount() const noexcept { return static_cast<uint32_t>(m_nodes.size()); }
+
+	private:
+		//前序存储：左子节点紧跟在父节点之后，m_right为右子节点下标，叶子节点m_right为0
+		//每个节点的子树对应物体下标中一段连续区间
+		struct Node
+		{
+			glm::vec3	m_min{ 0.0f };
+			uint32_t	m_right{ 0 };
+			glm::vec3	m_max{ 0.0f };
+			uint32_t	m_begin{ 0 };
+			uint32_t	m_count{ 0 };
+			uint32_t	m_parent{ 0 };
+		};
+
+		uint32_t buildNode(uint32_t begin, uint32_t end, uint32_t parent) noexcept;
+
+		void computeNodeBounds(uint32_t index) noexcept;
+
+		//取物体缓存的世界空间AABB，写入SoA数组
+		void computeObjectBounds(uint32_t index) noexcept;
+
+		//物体的geometry与上一次记录的不同时，加入新geometry的分组
+		void recordGeometry(uint32_t index) noexcept;
+
+		//遍历栈中的节点，以及该节点还需要测试的平面
+		struct StackEntry
+		{
+			uint32_t	m_node{ 0 };
+			uint32_t	m_planeMask{ 0 };
+		};
+
+	private:
+		static constexpr uint32_t MaxLeafObjects = 4;
+
+		std::weak_ptr<Object3D>			m_root{};
+		uint32_t						m_hierarchyVersion{ 0 };
+
+		//按物体存储，下标即叶子顺序
+		std::vector<RenderableObject*>	m_objects{};
+		std::vector<float>				m_minX{};
+		std::vector<float>				m_minY{};
+		std::vector<float>				m_minZ{};
+		std::vector<float>				m_maxX{};
+		std::vector<float>				m_maxY{};
+		std::vector<float>				m_maxZ{};
+		std::vector<uint32_t>			m_objectLeaves{};
+		std::vector<const Geometry*>	m_geometries{};	//计算包围盒时物体的geometry
+		std::vector<uint64_t>			m_visibility{};	//可见性位图
+
+		//物体worldMatrix变化的通知标记，每次build重新分配
+		std::shared_ptr<Object3D::WorldChangeFlags>	m_changeFlags{ nullptr };
+
+		//使用同一个geometry的物体，以及上一次refit时该geometry的包围体版本
+		struct GeometryGroup
+		{
+			std::weak_ptr<Geometry>	m_geometry{};
+			uint32_t				m_version{ 0 };
+			std::vector<uint32_t>	m_objects{};
+		};
+
+		std::vector<GeometryGroup>						m_geometryGroups{};
+		std::unordered_map<const Geometry*, uint32_t>	m_geometryGroupIndices{};
+		std::vector<uint32_t>							m_changedGroups{};
+
+		//树结构
+		std::vector<Node>				m_nodes{};
+		std::vector<uint8_t>			m_dirtyNodes{};
+
+		//build过程中使用：按收集顺序的物体与包围盒，以及划分时的排列
+		std::vector<RenderableObject*>	m_buildObjects{};
+		std::vector<glm::vec3>			m_buildMins{};
+		std::vector<glm::vec3>			m_buildMaxs{};
+		std::vector<uint32_t>			m_buildIndices{};
+
+		//遍历栈，在多帧之间复用
+		std::vector<StackEntry>			m_stack{};
+
+		CullInfo						m_cullInfo{};
+	};
+}
@@ -0,0 +1,1121 @@
+#include "sceneSnapshot.h"
+#include "../objects/mesh.h"
+#include "../objects/group.h"
+#include "../objects/lod.h"
+#include "../objects/hlod.h"
+#include "../lights/directionalLight.h"
+#include "../material/meshBasicMaterial.h"
+#include "../material/meshPhongMaterial.h"
+#include "../material/depthMaterial.h"
+#include "../material/cubeMaterial.h"
+#include "../textures/cubeTexture.h"
+#include "../tools/mappedFile.h"
+#include <cstring>
+
+namespace ff
+{
+	namespace
+	{
+		static constexpr uint32_t Invalid = UINT32_MAX;
+		static constexpr char Magic[4] = { 'F', 'F', 'S', 'S' };
+
+		enum Section : uint32_t
+		{
+			BlobSection,
+			StringSection,
+			SourceSection,
+			TextureSection,
+			MaterialSection,
+			AttributeSection,
+			GeometryAttributeSection,
+			GeometrySection,
+			NodeSection,
+			SectionCount
+		};
+
+		struct SectionRecord
+		{
+			uint64_t	m_offset{ 0 };
+			uint64_t	m_size{ 0 };	//字节数
+			uint32_t	m_count{ 0 };	//记录数
+			uint32_t	m_pad{ 0 };
+		};
+
+		struct Header
+		{
+			char			m_magic[4]{};
+			uint32_t		m_version{ 0 };
+			SectionRecord	m_sections[SectionCount]{};
+		};
+
+		struct SourceRecord
+		{
+			uint32_t	m_width{ 0 };
+			uint32_t	m_height{ 0 };
+			uint64_t	m_hashCode{ 0 };
+			uint64_t	m_dataOffset{ 0 };
+			uint64_t	m_dataSize{ 0 };
+		};
+
+		struct TextureRecord
+		{
+			uint32_t	m_textureType{ 0 };
+			uint32_t	m_width{ 0 };
+			uint32_t	m_height{ 0 };
+			uint32_t	m_minFilter{ 0 };
+			uint32_t	m_magFilter{ 0 };
+			uint32_t	m_wrapS{ 0 };
+			uint32_t	m_wrapT{ 0 };
+			uint32_t	m_wrapR{ 0 };
+			uint32_t	m_format{ 0 };
+			uint32_t	m_internalFormat{ 0 };
+			uint32_t	m_dataType{ 0 };
+			uint32_t	m_sources[CubeTexture::CUBE_TEXTURE_COUNT]{ Invalid, Invalid, Invalid, Invalid, Invalid, Invalid };	//2D纹理只使用第一个
+		};
+
+		enum class MaterialKind : uint32_t
+		{
+			Material,
+			MeshBasic,
+			MeshPhong,
+			Depth,
+			Cube
+		};
+
+		struct MaterialRecord
+		{
+			MaterialKind	m_kind{ MaterialKind::Material };
+			uint32_t		m_frontFace{ 0 };
+			uint32_t		m_side{ 0 };
+			uint32_t		m_drawMode{ 0 };
+			uint32_t		m_transparent{ 0 };
+			float			m_opacity{ 1.0f };
+			uint32_t		m_blendingType{ 0 };
+			uint32_t		m_blendSrc{ 0 };
+			uint32_t		m_blendDst{ 0 };
+			uint32_t		m_blendEquation{ 0 };
+			uint32_t		m_blendSrcAlpha{ 0 };
+			uint32_t		m_blendDstAlpha{ 0 };
+			uint32_t		m_blendEquationAlpha{ 0 };
+			uint32_t		m_depthTest{ 0 };
+			uint32_t		m_depthWrite{ 0 };
+			uint32_t		m_depthFunction{ 0 };
+			double			m_depthClearColor{ 1.0 };
+			float			m_shininess{ 0.0f };	//MeshPhongMaterial
+			uint32_t		m_packing{ 0 };			//DepthMaterial
+			uint32_t		m_diffuseMap{ Invalid };
+			uint32_t		m_envMap{ Invalid };
+			uint32_t		m_normalMap{ Invalid };
+			uint32_t		m_specularMap{ Invalid };
+		};
+
+		struct AttributeRecord
+		{
+			uint64_t	m_dataOffset{ 0 };
+			uint32_t	m_size{ 0 };		//元素个数
+			uint32_t	m_itemSize{ 0 };
+			uint32_t	m_dataType{ 0 };	//FloatType或者UnsignedIntType
+			uint32_t	m_bufferAllocType{ 0 };
+		};
+
+		struct GeometryAttributeRecord
+		{
+			uint32_t	m_nameOffset{ 0 };
+			uint32_t	m_nameLength{ 0 };
+			uint32_t	m_attribute{ Invalid };
+		};
+
+		struct GeometryRecord
+		{
+			uint32_t	m_firstAttribute{ 0 };
+			uint32_t	m_attributeCount{ 0 };
+			uint32_t	m_index{ Invalid };
+			uint32_t	m_hasBounds{ 0 };
+			float		m_boxMin[3]{};
+			float		m_boxMax[3]{};
+			float		m_sphereCenter[3]{};
+			float		m_sphereRadius{ 0.0f };
+		};
+
+		enum class NodeKind : uint32_t
+		{
+			Object3D,
+			Scene,
+			Group,
+			Mesh,
+			LOD,
+			HLOD,
+			Light,
+			DirectionalLight
+		};
+
+		enum NodeFlag : uint32_t
+		{
+			Visible = 1 << 0,
+			CastShadow = 1 << 1,
+			Occluder = 1 << 2,
+			LODLevel = 1 << 3,			//父节点LOD的一个级别，m_params[0]为阈值
+			HLODProxy = 1 << 4,			//父节点HLOD的代理
+			LightCastShadow = 1 << 5
+		};
+
+		//m_params按类型解释：
+		//Group：[0]为groupOrder；LOD：[0]为metric，[1]为hysteresis；HLOD：[0]为screenSize，[1]为hysteresis；
+		//Light：[0~2]为颜色，[3]为强度；LOD级别：[0]为阈值
+		struct NodeRecord
+		{
+			NodeKind	m_kind{ NodeKind::Object3D };
+			uint32_t	m_parent{ Invalid };
+			uint32_t	m_nameOffset{ 0 };
+			uint32_t	m_nameLength{ 0 };
+			uint32_t	m_flags{ 0 };
+			uint32_t	m_geometry{ Invalid };
+			uint32_t	m_material{ Invalid };	//Scene为overrideMaterial
+			uint32_t	m_texture{ Invalid };	//Scene为background
+			float		m_position[3]{};
+			float		m_quaternion[4]{};		//x y z w
+			float		m_scale[3]{};
+			float		m_params[4]{};
+		};
+
+		static_assert(std::is_trivially_copyable<NodeRecord>::value, "snapshot records must be trivially copyable");
+		static_assert(std::is_trivially_copyable<MaterialRecord>::value, "snapshot records must be trivially copyable");
+		static_assert(std::is_trivially_copyable<GeometryRecord>::value, "snapshot records must be trivially copyable");
+
+		class Writer
+		{
+		public:
+			void writeNodes(const Scene::Ptr& scene) noexcept
+			{
+				struct Entry
+				{
+					Object3D*	m_object;
+					Object3D*	m_parentObject;
+					uint32_t	m_parent;
+				};
+
+				std::vector<Entry> stack{ { scene.get(), nullptr, Invalid } };
+				bool warned = false;
+
+				while (!stack.empty())
+				{
+					auto entry = stack.back();
+					stack.pop_back();
+
+					auto object = entry.m_object;
+					auto index = static_cast<uint32_t>(m_nodes.size());
+					m_nodes.push_back(makeNode(object, entry.m_parentObject, entry.m_parent, warned));
+
+					//逆序压栈，保证子节点按children顺序写入
+					const auto& children = object->getChildren();
+					for (auto iter = children.rbegin(); iter != children.rend(); ++iter)
+					{
+						stack.push_back({ iter->get(), object, index });
+					}
+				}
+			}
+
+			bool writeFile(const std::string& path) noexcept
+			{
+				Header header;
+				std::memcpy(header.m_magic, Magic, sizeof(Magic));
+				header.m_version = SceneSnapshot::Version;
+
+				uint64_t offset = align(sizeof(Header));
+				auto layout = [&](Section section, uint64_t size, uint32_t count) {
+					header.m_sections[section] = { offset, size, count, 0 };
+					offset = align(offset + size);
+				};
+
+				layout(BlobSection, m_blob.size(), 0);
+				layout(StringSection, m_strings.size(), 0);
+				layout(SourceSection, bytesOf(m_sources), static_cast<uint32_t>(m_sources.size()));
+				layout(TextureSection, bytesOf(m_textures), static_cast<uint32_t>(m_textures.size()));
+				layout(MaterialSection, bytesOf(m_materials), static_cast<uint32_t>(m_materials.size()));
+				layout(AttributeSection, bytesOf(m_attributes), static_cast<uint32_t>(m_attributes.size()));
+				layout(GeometryAttributeSection, bytesOf(m_geometryAttributes), static_cast<uint32_t>(m_geometryAttributes.size()));
+				layout(GeometrySection, bytesOf(m_geometries), static_cast<uint32_t>(m_geometries.size()));
+				layout(NodeSection, bytesOf(m_nodes), static_cast<uint32_t>(m_nodes.size()));
+
+				//整个文件先拼接在内存中，一次写出
+				std::vector<byte> file(offset, 0);
+				std::memcpy(file.data(), &header, sizeof(Header));
+
+				auto copy = [&](Section section, const void* data) {
+					const auto& record = header.m_sections[section];
+					if (record.m_size > 0)
+					{
+						std::memcpy(file.data() + record.m_offset, data, record.m_size);
+					}
+				};
+
+				copy(BlobSection, m_blob.data());
+				copy(StringSection, m_strings.data());
+				copy(SourceSection, m_sources.data());
+				copy(TextureSection, m_textures.data());
+				copy(MaterialSection, m_materials.data());
+				copy(AttributeSection, m_attributes.data());
+				copy(GeometryAttributeSection, m_geometryAttributes.data());
+				copy(GeometrySection, m_geometries.data());
+				copy(NodeSection, m_nodes.data());
+
+				std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+				if (!stream.is_open())
+				{
+					std::cout << "Error: SceneSnapshot can not open " << path << " for writing" << std::endl;
+					return false;
+				}
+
+				stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+				return stream.good();
+			}
+
+		private:
+			static uint64_t align(uint64_t offset) noexcept
+			{
+				return (offset + 7) & ~uint64_t(7);
+			}
+
+			template<typename T>
+			static uint64_t bytesOf(const std::vector<T>& records) noexcept
+			{
+				return records.size() * sizeof(T);
+			}
+
+			uint64_t appendBlob(const void* data, uint64_t size) noexcept
+			{
+				uint64_t offset = align(m_blob.size());
+				m_blob.resize(offset + size);
+				if (size > 0)
+				{
+					std::memcpy(m_blob.data() + offset, data, size);
+				}
+
+				return offset;
+			}
+
+			void appendString(const std::string& text, uint32_t& offset, uint32_t& length) noexcept
+			{
+				offset = static_cast<uint32_t>(m_strings.size());
+				length = static_cast<uint32_t>(text.size());
+				m_strings.insert(m_strings.end(), text.begin(), text.end());
+			}
+
+			template<typename T>
+			uint32_t writeAttribute(const std::shared_ptr<Attribute<T>>& attribute) noexcept
+			{
+				if (attribute == nullptr)
+				{
+					return Invalid;
+				}
+
+				auto iter = m_attributeIndices.find(attribute.get());
+				if (iter != m_attributeIndices.end())
+				{
+					return iter->second;
+				}
+
+				const auto& data = attribute->getData();
+
+				AttributeRecord record;
+				record.m_dataOffset = appendBlob(data.data(), data.size() * sizeof(T));
+				record.m_size = static_cast<uint32_t>(data.size());
+				record.m_itemSize = attribute->getItemSize();
+				record.m_dataType = static_cast<uint32_t>(attribute->getDataType());
+				record.m_bufferAllocType = static_cast<uint32_t>(attribute->getBufferAllocType());
+
+				auto index = static_cast<uint32_t>(m_attributes.size());
+				m_attributes.push_back(record);
+				m_attributeIndices[attribute.get()] = index;
+
+				return index;
+			}
+
+			uint32_t writeGeometry(const Geometry::Ptr& geometry) noexcept
+			{
+				if (geometry == nullptr)
+				{
+					return Invalid;
+				}
+
+				auto iter = m_geometryIndices.find(geometry.get());
+				if (iter != m_geometryIndices.end())
+				{
+					return iter->second;
+				}
+
+				GeometryRecord record;
+				record.m_firstAttribute = static_cast<uint32_t>(m_geometryAttributes.size());
+
+				//unordered_map的遍历顺序不固定，按名称排序保证同一个场景写出的文件完全一致
+				std::vector<std::pair<std::string, Attributef::Ptr>> attributes(geometry->getAttributes().begin(), geometry->getAttributes().end());
+				std::sort(attributes.begin(), attributes.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+				for (const auto& attribute : attributes)
+				{
+					GeometryAttributeRecord attributeRecord;
+					appendString(attribute.first, attributeRecord.m_nameOffset, attributeRecord.m_nameLength);
+					attributeRecord.m_attribute = writeAttribute(attribute.second);
+					m_geometryAttributes.push_back(attributeRecord);
+				}
+
+				record.m_attributeCount = static_cast<uint32_t>(attributes.size());
+				record.m_index = writeAttribute(geometry->getIndex());
+
+				//包围体随文件保存，加载时不再逐顶点计算
+				if (geometry->getBoundingSphere() == nullptr && geometry->hasAttribute("position"))
+				{
+					geometry->computeBoundingSphere();
+				}
+
+				auto box = geometry->getBoundingBox();
+				auto sphere = geometry->getBoundingSphere();
+				if (box != nullptr && sphere != nullptr)
+				{
+					record.m_hasBounds = 1;
+					std::memcpy(record.m_boxMin, glm::value_ptr(box->m_min), sizeof(record.m_boxMin));
+					std::memcpy(record.m_boxMax, glm::value_ptr(box->m_max), sizeof(record.m_boxMax));
+					std::memcpy(record.m_sphereCenter, glm::value_ptr(sphere->m_center), sizeof(record.m_sphereCenter));
+					record.m_sphereRadius = sphere->m_radius;
+				}
+
+				auto index = static_cast<uint32_t>(m_geometries.size());
+				m_geometries.push_back(record);
+				m_geometryIndices[geometry.get()] = index;
+
+				return index;
+			}
+
+			uint32_t writeSource(const Source::Ptr& source) noexcept
+			{
+				if (source == nullptr)
+				{
+					return Invalid;
+				}
+
+				auto iter = m_sourceIndices.find(source.get());
+				if (iter != m_sourceIndices.end())
+				{
+					return iter->second;
+				}
+
+				SourceRecord record;
+				record.m_width = source->m_width;
+				record.m_height = source->m_height;
+				record.m_hashCode = source->m_hashCode;
+				record.m_dataOffset = appendBlob(source->m_data.data(), source->m_data.size());
+				record.m_dataSize = source->m_data.size();
+
+				auto index = static_cast<uint32_t>(m_sources.size());
+				m_sources.push_back(record);
+				m_sourceIndices[source.get()] = index;
+
+				return index;
+			}
+
+			uint32_t writeTexture(const Texture::Ptr& texture) noexcept
+			{
+				if (texture == nullptr || texture->getUsage() != TextureUsage::SamplerTexture)
+				{
+					return Invalid;
+				}
+
+				auto iter = m_textureIndices.find(texture.get());
+				if (iter != m_textureIndices.end())
+				{
+					return iter->second;
+				}
+
+				TextureRecord record;
+				record.m_textureType = static_cast<uint32_t>(texture->m_textureType);
+				record.m_width = texture->m_width;
+				record.m_height = texture->m_height;
+				record.m_minFilter = static_cast<uint32_t>(texture->m_minFilter);
+				record.m_magFilter = static_cast<uint32_t>(texture->m_magFilter);
+				record.m_wrapS = static_cast<uint32_t>(texture->m_wrapS);
+				record.m_wrapT = static_cast<uint32_t>(texture->m_wrapT);
+				record.m_wrapR = static_cast<uint32_t>(texture->m_wrapR);
+				record.m_format = static_cast<uint32_t>(texture->m_format);
+				record.m_internalFormat = static_cast<uint32_t>(texture->m_internalFormat);
+				record.m_dataType = static_cast<uint32_t>(texture->m_dataType);
+
+				if (texture->m_textureType == TextureType::TextureCubeMap)
+				{
+					auto cubeTexture = std::static_pointer_cast<CubeTexture>(texture);
+					for (uint32_t i = 0; i < CubeTexture::CUBE_TEXTURE_COUNT; ++i)
+					{
+						record.m_sources[i] = writeSource(cubeTexture->m_sources[i]);
+					}
+				}
+				else
+				{
+					record.m_sources[0] = writeSource(texture->m_source);
+				}
+
+				auto index = static_cast<uint32_t>(m_textures.size());
+				m_textures.push_back(record);
+				m_textureIndices[texture.get()] = index;
+
+				return index;
+			}
+
+			uint32_t writeMaterial(const Material::Ptr& material) noexcept
+			{
+				if (material == nullptr)
+				{
+					return Invalid;
+				}
+
+				auto iter = m_materialIndices.find(material.get());
+				if (iter != m_materialIndices.end())
+				{
+					return iter->second;
+				}
+
+				MaterialRecord record;
+				if (material->m_isMeshPhongMaterial)
+				{
+					record.m_kind = MaterialKind::MeshPhong;
+					record.m_shininess = std::static_pointer_cast<MeshPhongMaterial>(material)->mShininess;
+				}
+				else if (material->m_isMeshBasicMaterial)
+				{
+					record.m_kind = MaterialKind::MeshBasic;
+				}
+				else if (material->m_isDepthMaterial)
+				{
+					record.m_kind = MaterialKind::Depth;
+					record.m_packing = std::static_pointer_cast<DepthMaterial>(material)->m_packing;
+				}
+				else if (material->m_isCubeMaterial)
+				{
+					record.m_kind = MaterialKind::Cube;
+				}
+
+				record.m_frontFace = static_cast<uint32_t>(material->m_frontFace);
+				record.m_side = static_cast<uint32_t>(material->m_side);
+				record.m_drawMode = static_cast<uint32_t>(material->m_drawMode);
+				record.m_transparent = material->m_transparent ? 1 : 0;
+				record.m_opacity = material->m_opacity;
+				record.m_blendingType = static_cast<uint32_t>(material->m_blendingType);
+				record.m_blendSrc = static_cast<uint32_t>(material->m_blendSrc);
+				record.m_blendDst = static_cast<uint32_t>(material->m_blendDst);
+				record.m_blendEquation = static_cast<uint32_t>(material->m_blendEuqation);
+				record.m_blendSrcAlpha = static_cast<uint32_t>(material->m_blendSrcAlpha);
+				record.m_blendDstAlpha = static_cast<uint32_t>(material->m_blendDstAlpha);
+				record.m_blendEquationAlpha = static_cast<uint32_t>(material->m_blendEquationAlpha);
+				record.m_depthTest = material->m_depthTest ? 1 : 0;
+				record.m_depthWrite = material->m_depthWrite ? 1 : 0;
+				record.m_depthFunction = static_cast<uint32_t>(material->m_depthFunction);
+				record.m_depthClearColor = material->m_depthClearColor;
+				record.m_diffuseMap = writeTexture(material->m_diffuseMap);
+				record.m_envMap = writeTexture(material->m_envMap);
+				record.m_normalMap = writeTexture(material->m_normalMap);
+				record.m_specularMap = writeTexture(material->m_specularMap);
+
+				auto index = static_cast<uint32_t>(m_materials.size());
+				m_materials.push_back(record);
+				m_materialIndices[material.get()] = index;
+
+				return index;
+			}
+
+			NodeRecord makeNode(Object3D* object, Object3D* parentObject, uint32_t parent, bool& warned) noexcept
+			{
+				NodeRecord record;
+				record.m_parent = parent;
+				appendString(object->m_name, record.m_nameOffset, record.m_nameLength);
+
+				record.m_flags |= object->m_visible ? Visible : 0;
+				record.m_flags |= object->m_castShadow ? CastShadow : 0;
+
+				auto position = object->getPosition();
+				auto quaternion = object->getQuaternion();
+				auto scale = object->getScale();
+				std::memcpy(record.m_position, glm::value_ptr(position), sizeof(record.m_position));
+				record.m_quaternion[0] = quaternion.x;
+				record.m_quaternion[1] = quaternion.y;
+				record.m_quaternion[2] = quaternion.z;
+				record.m_quaternion[3] = quaternion.w;
+				std::memcpy(record.m_scale, glm::value_ptr(scale), sizeof(record.m_scale));
+
+				if (parentObject != nullptr && parentObject->m_isLOD)
+				{
+					for (const auto& level : static_cast<LOD*>(parentObject)->getLevels())
+					{
+						if (level.m_object.get() == object)
+						{
+							record.m_flags |= LODLevel;
+							record.m_params[0] = level.m_threshold;
+						}
+					}
+				}
+				else if (parentObject != nullptr && parentObject->m_isHLOD && static_cast<HLOD*>(parentObject)->getProxy().get() == object)
+				{
+					record.m_flags |= HLODProxy;
+				}
+
+				if (object->m_isScene)
+				{
+					auto scene = static_cast<Scene*>(object);
+					record.m_kind = NodeKind::Scene;
+					record.m_material = writeMaterial(scene->m_overrideMaterial);
+					record.m_texture = writeTexture(scene->m_background);
+				}
+				else if (object->m_isMesh && !object->m_isSkinnedMesh)
+				{
+					auto mesh = static_cast<Mesh*>(object);
+					record.m_kind = NodeKind::Mesh;
+					record.m_flags |= mesh->m_isOccluder ? Occluder : 0;
+					record.m_geometry = writeGeometry(mesh->getGeometry());
+					record.m_material = writeMaterial(mesh->getMaterial());
+				}
+				else if (object->m_isGroup)
+				{
+					record.m_kind = NodeKind::Group;
+					record.m_params[0] = static_cast<float>(static_cast<Group*>(object)->m_groupOrder);
+				}
+				else if (object->m_isLOD)
+				{
+					auto lod = static_cast<LOD*>(object);
+					record.m_kind = NodeKind::LOD;
+					record.m_params[0] = static_cast<float>(lod->getMetric());
+					record.m_params[1] = lod->getHysteresis();
+				}
+				else if (object->m_isHLOD)
+				{
+					auto hlod = static_cast<HLOD*>(object);
+					record.m_kind = NodeKind::HLOD;
+					record.m_params[0] = hlod->getScreenSize();
+					record.m_params[1] = hlod->getHysteresis();
+				}
+				else if (object->m_isLight)
+				{
+					auto light = static_cast<Light*>(object);
+					record.m_kind = object->m_isDirectionalLight ? NodeKind::DirectionalLight : NodeKind::Light;
+					record.m_flags |= light->mCastShadow ? LightCastShadow : 0;
+					std::memcpy(record.m_params, glm::value_ptr(light->mColor), sizeof(float) * 3);
+					record.m_params[3] = light->mIntensity;
+				}
+				else if ((object->m_isRenderableObject || object->m_isCamera || object->m_isBone) && !warned)
+				{
+					warned = true;
+					std::cout << "Warning: SceneSnapshot saves unsupported objects as plain Object3D" << std::endl;
+				}
+
+				return record;
+			}
+
+		private:
+			std::vector<byte>						m_blob{};
+			std::vector<char>						m_strings{};
+			std::vector<SourceRecord>				m_sources{};
+			std::vector<TextureRecord>				m_textures{};
+			std::vector<MaterialRecord>				m_materials{};
+			std::vector<AttributeRecord>			m_attributes{};
+			std::vector<GeometryAttributeRecord>	m_geometryAttributes{};
+			std::vector<GeometryRecord>				m_geometries{};
+			std::vector<NodeRecord>					m_nodes{};
+
+			std::unordered_map<const void*, uint32_t>	m_attributeIndices{};
+			std::unordered_map<const void*, uint32_t>	m_geometryIndices{};
+			std::unordered_map<const void*, uint32_t>	m_sourceIndices{};
+			std::unordered_map<const void*, uint32_t>	m_textureIndices{};
+			std::unordered_map<const void*, uint32_t>	m_materialIndices{};
+		};
+
+		class Reader
+		{
+		public:
+			bool open(const std::string& path, SceneSnapshot::LoadMode mode) noexcept
+			{
+				if (mode == SceneSnapshot::LoadMode::Map)
+				{
+					m_mapping = MappedFile::open(path);
+					if (m_mapping == nullptr)
+					{
+						return false;
+					}
+
+					m_data = m_mapping->getData();
+					m_size = m_mapping->getSize();
+				}
+				else
+				{
+					std::ifstream stream(path, std::ios::binary | std::ios::ate);
+					if (!stream.is_open())
+					{
+						std::cout << "Error: SceneSnapshot can not open " << path << std::endl;
+						return false;
+					}
+
+					//整个文件一次读入
+					auto size = static_cast<uint64_t>(stream.tellg());
+					m_buffer.resize(size);
+					stream.seekg(0);
+					stream.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(size));
+					if (!stream.good())
+					{
+						std::cout << "Error: SceneSnapshot failed to read " << path << std::endl;
+						return false;
+					}
+
+					m_data = m_buffer.data();
+					m_size = size;
+				}
+
+				auto size = m_size;
+				if (size < sizeof(Header))
+				{
+					std::cout << "Error: SceneSnapshot " << path << " is truncated" << std::endl;
+					return false;
+				}
+
+				std::memcpy(&m_header, m_data, sizeof(Header));
+				if (std::memcmp(m_header.m_magic, Magic, sizeof(Magic)) != 0 || m_header.m_version != SceneSnapshot::Version)
+				{
+					std::cout << "Error: " << path << " is not a scene snapshot of version " << SceneSnapshot::Version << std::endl;
+					return false;
+				}
+
+				for (const auto& section : m_header.m_sections)
+				{
+					if (section.m_offset > size || section.m_size > size - section.m_offset)
+					{
+						std::cout << "Error: SceneSnapshot " << path << " is truncated" << std::endl;
+						return false;
+					}
+				}
+
+				return readTable(SourceSection, m_sources) &&
+					readTable(TextureSection, m_textures) &&
+					readTable(MaterialSection, m_materials) &&
+					readTable(AttributeSection, m_attributes) &&
+					readTable(GeometryAttributeSection, m_geometryAttributes) &&
+					readTable(GeometrySection, m_geometries) &&
+					readTable(NodeSection, m_nodes);
+			}
+
+			Scene::Ptr build() noexcept
+			{
+				//先按表建立共享的资源，节点之间只通过下标引用
+				m_sourceObjects.resize(m_sources.size());
+				for (size_t i = 0; i < m_sources.size(); ++i)
+				{
+					const auto& record = m_sources[i];
+					if (!inBlob(record.m_dataOffset, record.m_dataSize)) return nullptr;
+
+					auto source = Source::create();
+					source->m_width = record.m_width;
+					source->m_height = record.m_height;
+					source->m_hashCode = static_cast<HashType>(record.m_hashCode);
+					source->m_data.assign(blob() + record.m_dataOffset, blob() + record.m_dataOffset + record.m_dataSize);
+					m_sourceObjects[i] = source;
+				}
+
+				m_textureObjects.resize(m_textures.size());
+				for (size_t i = 0; i < m_textures.size(); ++i)
+				{
+					m_textureObjects[i] = buildTexture(m_textures[i]);
+				}
+
+				m_materialObjects.resize(m_materials.size());
+				for (size_t i = 0; i < m_materials.size(); ++i)
+				{
+					m_materialObjects[i] = buildMaterial(m_materials[i]);
+				}
+
+				m_floatAttributes.resize(m_attributes.size());
+				m_uintAttributes.resize(m_attributes.size());
+				m_geometryObjects.resize(m_geometries.size());
+				for (size_t i = 0; i < m_geometries.size(); ++i)
+				{
+					m_geometryObjects[i] = buildGeometry(m_geometries[i]);
+					if (m_geometryObjects[i] == nullptr) return nullptr;
+				}
+
+				return buildNodes();
+			}
+
+		private:
+			template<typename T>
+			bool readTable(Section section, std::vector<T>& records) noexcept
+			{
+				const auto& record = m_header.m_sections[section];
+				if (record.m_size != static_cast<uint64_t>(record.m_count) * sizeof(T))
+				{
+					std::cout << "Error: SceneSnapshot section " << section << " has a wrong size" << std::endl;
+					return false;
+				}
+
+				records.resize(record.m_count);
+				if (record.m_size > 0)
+				{
+					std::memcpy(records.data(), m_data + record.m_offset, record.m_size);
+				}
+
+				return true;
+			}
+
+			const byte* blob() const noexcept
+			{
+				return m_data + m_header.m_sections[BlobSection].m_offset;
+			}
+
+			bool inBlob(uint64_t offset, uint64_t size) const noexcept
+			{
+				uint64_t blobSize = m_header.m_sections[BlobSection].m_size;
+				return offset <= blobSize && size <= blobSize - offset;
+			}
+
+			std::string readString(uint32_t offset, uint32_t length) const noexcept
+			{
+				const auto& section = m_header.m_sections[StringSection];
+				if (static_cast<uint64_t>(offset) + length > section.m_size)
+				{
+					return std::string();
+				}
+
+				return std::string(reinterpret_cast<const char*>(m_data + section.m_offset + offset), length);
+			}
+
+			template<typename T>
+			std::shared_ptr<T> lookupPtr(const std::vector<std::shared_ptr<T>>& objects, uint32_t index) const noexcept
+			{
+				return index < objects.size() ? objects[index] : nullptr;
+			}
+
+			//映射模式下Attribute直接引用映射的内存，否则整块拷贝出数据，同一条记录只建立一次
+			template<typename T>
+			std::shared_ptr<Attribute<T>> buildAttribute(uint32_t index, std::vector<std::shared_ptr<Attribute<T>>>& cache) noexcept
+			{
+				if (index >= m_attributes.size())
+				{
+					return nullptr;
+				}
+
+				if (cache[index] != nullptr)
+				{
+					return cache[index];
+				}
+
+				const auto& record = m_attributes[index];
+				if (record.m_itemSize == 0 ||
+					record.m_dataType != static_cast<uint32_t>(toDataType<T>()) ||
+					!inBlob(record.m_dataOffset, static_cast<uint64_t>(record.m_size) * sizeof(T)))
+				{
+					return nullptr;
+				}
+
+				auto bufferAllocType = static_cast<BufferAllocType>(record.m_bufferAllocType);
+				if (m_mapping != nullptr)
+				{
+					//blob按8字节对齐，映射的起始地址按页对齐，指针满足T的对齐要求
+					auto data = reinterpret_cast<const T*>(blob() + record.m_dataOffset);
+					cache[index] = Attribute<T>::createExternal(data, record.m_size, record.m_itemSize, m_mapping, bufferAllocType);
+					return cache[index];
+				}
+
+				std::vector<T> data(record.m_size);
+				if (record.m_size > 0)
+				{
+					std::memcpy(data.data(), blob() + record.m_dataOffset, record.m_size * sizeof(T));
+				}
+
+				cache[index] = Attribute<T>::create(std::move(data), record.m_itemSize, bufferAllocType);
+				return cache[index];
+			}
+
+			Geometry::Ptr buildGeometry(const GeometryRecord& record) noexcept
+			{
+				if (static_cast<uint64_t>(record.m_firstAttribute) + record.m_attributeCount > m_geometryAttributes.size())
+				{
+					std::cout << "Error: SceneSnapshot geometry references missing attributes" << std::endl;
+					return nullptr;
+				}
+
+				auto geometry = Geometry::create();
+				for (uint32_t i = 0; i < record.m_attributeCount; ++i)
+				{
+					const auto& attributeRecord = m_geometryAttributes[record.m_firstAttribute + i];
+					auto attribute = buildAttribute(attributeRecord.m_attribute, m_floatAttributes);
+					if (attribute == nullptr)
+					{
+						std::cout << "Error: SceneSnapshot attribute " << attributeRecord.m_attribute << " is invalid" << std::endl;
+						return nullptr;
+					}
+
+					geometry->setAttribute(readString(attributeRecord.m_nameOffset, attributeRecord.m_nameLength), attribute);
+				}
+
+				if (record.m_index != Invalid)
+				{
+					auto index = buildAttribute(record.m_index, m_uintAttributes);
+					if (index == nullptr)
+					{
+						std::cout << "Error: SceneSnapshot index attribute " << record.m_index << " is invalid" << std::endl;
+						return nullptr;
+					}
+
+					geometry->setIndex(index);
+				}
+
+				if (record.m_hasBounds)
+				{
+					auto box = Box3::create();
+					box->m_min = glm::make_vec3(record.m_boxMin);
+					box->m_max = glm::make_vec3(record.m_boxMax);
+					auto sphere = Sphere::create(glm::make_vec3(record.m_sphereCenter), record.m_sphereRadius);
+					geometry->setBoundingVolumes(box, sphere);
+				}
+
+				return geometry;
+			}
+
+			Texture::Ptr buildTexture(const TextureRecord& record) noexcept
+			{
+				Texture::Ptr texture{ nullptr };
+				if (record.m_textureType == static_cast<uint32_t>(TextureType::TextureCubeMap))
+				{
+					auto cubeTexture = CubeTexture::create(record.m_width, record.m_height);
+					for (uint32_t i = 0; i < CubeTexture::CUBE_TEXTURE_COUNT; ++i)
+					{
+						cubeTexture->m_sources[i] = lookupPtr(m_sourceObjects, record.m_sources[i]);
+					}
+					texture = cubeTexture;
+				}
+				else
+				{
+					texture = Texture::create(record.m_width, record.m_height);
+					texture->m_source = lookupPtr(m_sourceObjects, record.m_sources[0]);
+				}
+
+				texture->m_minFilter = static_cast<TextureFilter>(record.m_minFilter);
+				texture->m_magFilter = static_cast<TextureFilter>(record.m_magFilter);
+				texture->m_wrapS = static_cast<TextureWrapping>(record.m_wrapS);
+				texture->m_wrapT = static_cast<TextureWrapping>(record.m_wrapT);
+				texture->m_wrapR = static_cast<TextureWrapping>(record.m_wrapR);
+				texture->m_format = static_cast<TextureFormat>(record.m_format);
+				texture->m_internalFormat = static_cast<TextureFormat>(record.m_internalFormat);
+				texture->m_dataType = static_cast<DataType>(record.m_dataType);
+
+				return texture;
+			}
+
+			Material::Ptr buildMaterial(const MaterialRecord& record) noexcept
+			{
+				Material::Ptr material{ nullptr };
+				switch (record.m_kind)
+				{
+				case MaterialKind::MeshBasic:
+					material = MeshBasicMaterial::create();
+					break;
+				case MaterialKind::MeshPhong:
+				{
+					auto phong = MeshPhongMaterial::create();
+					phong->mShininess = record.m_shininess;
+					material = phong;
+					break;
+				}
+				case MaterialKind::Depth:
+					material = DepthMaterial::create(record.m_packing);
+					break;
+				case MaterialKind::Cube:
+					material = CubeMaterial::create();
+					break;
+				default:
+					material = Material::create();
+					break;
+				}
+
+				material->m_frontFace = static_cast<FrontFace>(record.m_frontFace);
+				material->m_side = static_cast<Side>(record.m_side);
+				material->m_drawMode = static_cast<DrawMode>(record.m_drawMode);
+				material->m_transparent = record.m_transparent != 0;
+				material->m_opacity = record.m_opacity;
+				material->m_blendingType = static_cast<BlendingType>(record.m_blendingType);
+				material->m_blendSrc = static_cast<BlendingFactor>(record.m_blendSrc);
+				material->m_blendDst = static_cast<BlendingFactor>(record.m_blendDst);
+				material->m_blendEuqation = static_cast<BlendingEquation>(record.m_blendEquation);
+				material->m_blendSrcAlpha = static_cast<BlendingFactor>(record.m_blendSrcAlpha);
+				material->m_blendDstAlpha = static_cast<BlendingFactor>(record.m_blendDstAlpha);
+				material->m_blendEquationAlpha = static_cast<BlendingEquation>(record.m_blendEquationAlpha);
+				material->m_depthTest = record.m_depthTest != 0;
+				material->m_depthWrite = record.m_depthWrite != 0;
+				material->m_depthFunction = static_cast<CompareFunction>(record.m_depthFunction);
+				material->m_depthClearColor = record.m_depthClearColor;
+				material->m_diffuseMap = lookupPtr(m_textureObjects, record.m_diffuseMap);
+				material->m_normalMap = lookupPtr(m_textureObjects, record.m_normalMap);
+				material->m_specularMap = lookupPtr(m_textureObjects, record.m_specularMap);
+
+				auto envMap = lookupPtr(m_textureObjects, record.m_envMap);
+				if (envMap != nullptr && envMap->m_textureType == TextureType::TextureCubeMap)
+				{
+					material->m_envMap = std::static_pointer_cast<CubeTexture>(envMap);
+				}
+
+				return material;
+			}
+
+			Scene::Ptr buildNodes() noexcept
+			{
+				if (m_nodes.empty() || m_nodes[0].m_kind != NodeKind::Scene)
+				{
+					std::cout << "Error: SceneSnapshot has no scene root" << std::endl;
+					return nullptr;
+				}
+
+				std::vector<Object3D::Ptr> objects(m_nodes.size());
+				for (size_t i = 0; i < m_nodes.size(); ++i)
+				{
+					const auto& record = m_nodes[i];
+					if (i > 0 && record.m_parent >= i)
+					{
+						std::cout << "Error: SceneSnapshot node " << i << " has an invalid parent" << std::endl;
+						return nullptr;
+					}
+
+					auto object = buildNode(record);
+					object->m_name = readString(record.m_nameOffset, record.m_nameLength);
+					object->m_visible = (record.m_flags & Visible) != 0;
+					object->m_castShadow = (record.m_flags & CastShadow) != 0;
+					object->setPosition(glm::make_vec3(record.m_position));
+					object->setQuaternion(record.m_quaternion[0], record.m_quaternion[1], record.m_quaternion[2], record.m_quaternion[3]);
+					object->setScale(record.m_scale[0], record.m_scale[1], record.m_scale[2]);
+
+					if (i > 0)
+					{
+						attach(objects[record.m_parent], object, record);
+					}
+
+					objects[i] = object;
+				}
+
+				return std::static_pointer_cast<Scene>(objects[0]);
+			}
+
+			Object3D::Ptr buildNode(const NodeRecord& record) noexcept
+			{
+				switch (record.m_kind)
+				{
+				case NodeKind::Scene:
+				{
+					auto scene = Scene::create();
+					scene->m_overrideMaterial = lookupPtr(m_materialObjects, record.m_material);
+
+					auto background = lookupPtr(m_textureObjects, record.m_texture);
+					if (background != nullptr && background->m_textureType == TextureType::TextureCubeMap)
+					{
+						scene->m_background = std::static_pointer_cast<CubeTexture>(background);
+					}
+					return scene;
+				}
+				case NodeKind::Group:
+				{
+					auto group = std::make_shared<Group>();
+					group->m_groupOrder = static_cast<uint32_t>(record.m_params[0]);
+					return group;
+				}
+				case NodeKind::Mesh:
+				{
+					auto geometry = lookupPtr(m_geometryObjects, record.m_geometry);
+					auto material = lookupPtr(m_materialObjects, record.m_material);
+					auto mesh = Mesh::create(
+						geometry != nullptr ? geometry : Geometry::create(),
+						material != nullptr ? material : MeshBasicMaterial::create());
+					mesh->m_isOccluder = (record.m_flags & Occluder) != 0;
+					return mesh;
+				}
+				case NodeKind::LOD:
+				{
+					auto lod = LOD::create(static_cast<LOD::Metric>(static_cast<uint32_t>(record.m_params[0])));
+					lod->setHysteresis(record.m_params[1]);
+					return lod;
+				}
+				case NodeKind::HLOD:
+				{
+					auto hlod = HLOD::create();
+					hlod->setScreenSize(record.m_params[0]);
+					hlod->setHysteresis(record.m_params[1]);
+					return hlod;
+				}
+				case NodeKind::Light:
+				case NodeKind::DirectionalLight:
+				{
+					Light::Ptr light = record.m_kind == NodeKind::DirectionalLight ? DirectionalLight::create() : Light::create();
+					light->mColor = glm::make_vec3(record.m_params);
+					light->mIntensity = record.m_params[3];
+					light->mCastShadow = (record.m_flags & LightCastShadow) != 0;
+					return light;
+				}
+				default:
+					return std::make_shared<Object3D>();
+				}
+			}
+
+			//LOD的级别与HLOD的代理需要通过各自的接口挂接
+			void attach(const Object3D::Ptr& parent, const Object3D::Ptr& object, const NodeRecord& record) noexcept
+			{
+				if ((record.m_flags & LODLevel) && parent->m_isLOD && object->m_isRenderableObject)
+				{
+					std::static_pointer_cast<LOD>(parent)->addLevel(std::static_pointer_cast<RenderableObject>(object), record.m_params[0]);
+				}
+				else if ((record.m_flags & HLODProxy) && parent->m_isHLOD && object->m_isRenderableObject)
+				{
+					std::static_pointer_cast<HLOD>(parent)->setProxy(std::static_pointer_cast<RenderableObject>(object));
+				}
+				else
+				{
+					parent->addChild(object);
+				}
+			}
+
+		private:
+			//文件内容，读入m_buffer或者映射到m_mapping
+			const byte*								m_data{ nullptr };
+			uint64_t								m_size{ 0 };
+			std::vector<byte>						m_buffer{};
+			MappedFile::Ptr							m_mapping{ nullptr };
+			Header									m_header{};
+
+			std::vector<SourceRecord>				m_sources{};
+			std::vector<TextureRecord>				m_textures{};
+			std::vector<MaterialRecord>				m_materials{};
+			std::vector<AttributeRecord>			m_attributes{};
+			std::vector<GeometryAttributeRecord>	m_geometryAttributes{};
+			std::vector<GeometryRecord>				m_geometries{};
+			std::vector<NodeRecord>					m_nodes{};
+
+			std::vector<Source::Ptr>				m_sourceObjects{};
+			std::vector<Texture::Ptr>				m_textureObjects{};
+			std::vector<Material::Ptr>				m_materialObjects{};
+			std::vector<Attributef::Ptr>			m_floatAttributes{};
+			std::vector<Attributei::Ptr>			m_uintAttributes{};
+			std::vector<Geometry::Ptr>				m_geometryObjects{};
+		};
+	}
+
+	bool SceneSnapshot::save(const Scene::Ptr& scene, const std::string& path) noexcept
+	{
+		if (scene == nullptr)
+		{
+			return false;
+		}
+
+		Writer writer;
+		writer.writeNodes(scene);
+
+		return writer.writeFile(path);
+	}
+
+	Scene::Ptr SceneSnapshot::load(const std::string& path, LoadMode mode) noexcept
+	{
+		Reader reader;
+		if (!reader.open(path, mode))
+		{
+			return nullptr;
+		}
+
+		return reader.build();
+	}
+}
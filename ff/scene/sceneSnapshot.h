@@ -0,0 +1,62 @@
+/**
+ * @class SceneSnapshot
+ * @brief 场景的二进制快照：把Object3D层级、Geometry、Material、Texture整体写入一个带版本号的文件，加载时批量读取直接重建Scene。
+ *
+ * 简介：
+ * - 文件由文件头与若干个段(section)组成，每个段是一个定长记录的数组，或一块原始字节数据：
+ *   - Blob：所有Attribute数据与图片数据，按8字节对齐，原样存放；
+ *   - Strings：节点名与Attribute名；
+ *   - Sources/Textures/Materials/Attributes/GeometryAttributes/Geometries/Nodes：定长记录，相互之间以下标引用；
+ * - 共享的对象(同一个Geometry/Material/Texture/Source被多处引用)只写一份，加载后仍然是共享的；
+ * - Geometry同时保存包围盒与包围球，加载后不再逐顶点计算；
+ * - 节点按先序排列，父节点总是在子节点之前，加载时顺序创建即可挂接；
+ * - 加载时整个文件一次读入内存，记录直接拷贝，Attribute数据整块拷贝进Attribute，没有逐元素的解析；
+ * - LoadMode::Map 以只读方式映射文件，Attribute直接引用映射中的数据(见 Attribute::createExternal)，
+ *   顶点数据不占用进程私有内存，上传GPU时直接从映射读取，适合数GB的网格数据。
+ *
+ * 支持的节点：Scene、Object3D、Group、Mesh、LOD(含级别阈值)、HLOD(含代理)、Light/DirectionalLight；
+ * 支持的材质：Material、MeshBasicMaterial、MeshPhongMaterial、DepthMaterial、CubeMaterial；
+ * 支持的纹理：Texture、CubeTexture(图片数据随文件保存)。
+ *
+ * 使用示例：
+ * @code
+ * ff::SceneSnapshot::save(scene, "campus.ffs");
+ *
+ * auto scene = ff::SceneSnapshot::load("campus.ffs");   // 失败时返回nullptr
+ * auto mapped = ff::SceneSnapshot::load("campus.ffs", ff::SceneSnapshot::LoadMode::Map);
+ * @endcode
+ *
+ * 限制与注意：
+ * - 不支持的节点(SkinnedMesh、Bone、Camera等)按普通Object3D保存，只保留变换与子节点，保存时打印警告；
+ * - 光源只保存颜色、强度与是否产生阴影，阴影参数使用默认值；
+ * - 文件按本机字节序存放，版本号不一致的文件拒绝加载；
+ * - 渲染目标等运行时创建的纹理(usage不是SamplerTexture)不会被保存；
+ * - 映射模式下加载出的Attribute是只读的，文件在场景释放之前不能被修改或删除(Windows上删除会失败)。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "scene.h"
+
+namespace ff
+{
+	class SceneSnapshot
+	{
+	public:
+		//文件格式发生任何变化时加一
+		static constexpr uint32_t Version = 1;
+
+		enum class LoadMode
+		{
+			Copy,	//文件整体读入内存，Attribute持有各自的数据
+			Map		//文件以只读方式映射，Attribute直接引用映射的内存，不拷贝顶点数据
+		};
+
+		static bool save(const Scene::Ptr& scene, const std::string& path) noexcept;
+
+		static Scene::Ptr load(const std::string& path, LoadMode mode = LoadMode::Copy) noexcept;
+	};
+}
@@ -0,0 +1,30 @@
+#include "mipChain.h"
+
+namespace ff
+{
+	uint32_t MipChain::getLevelCount(uint32_t width, uint32_t height) noexcept
+	{
+		uint32_t size = std::max(std::max(width, height), 1u);
+		uint32_t levels = 1;
+		while (size > 1)
+		{
+			size >>= 1;
+			++levels;
+		}
+
+		return levels;
+	}
+
+	uint64_t MipChain::getChainBytes(uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t level) noexcept
+	{
+		uint32_t levels = getLevelCount(width, height);
+
+		uint64_t bytes = 0;
+		for (uint32_t i = level; i < levels; ++i)
+		{
+			bytes += static_cast<uint64_t>(std::max(width >> i, 1u)) * std::max(height >> i, 1u) * bytesPerPixel;
+		}
+
+		return bytes;
+	}
+}
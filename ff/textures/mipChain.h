@@ -0,0 +1,27 @@
+/**
+ * @class MipChain
+ * @brief 完整mip链的级别数与字节数计算，加载器(ff::MipmapCache)与驱动层(ff::DriverTextureStreaming)共用。
+ *
+ * 简介：
+ * - 每一级的宽高为上一级的一半(向下取整)，不小于1，最后一级为1x1；
+ * - 只做整数运算，不依赖OpenGL，可以在工作线程上调用。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+
+namespace ff
+{
+	class MipChain
+	{
+	public:
+		//包含第0级
+		static uint32_t getLevelCount(uint32_t width, uint32_t height) noexcept;
+
+		//从level到最后一级的字节数
+		static uint64_t getChainBytes(uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t level) noexcept;
+	};
+}
@@ -45,6 +45,9 @@ namespace ff {
 		uint32_t			m_height{ 0 };
 
 		std::vector<byte>	m_data{};	//读入的图片数据
+
+		//预先计算好的第1级及之后各级mipmap(见 MipmapCache)，为空时由驱动生成
+		std::vector<std::vector<byte>>	m_mipmaps{};
 		bool				m_needUpdate{ true };
 
 		HashType			m_hashCode{ 0 }; //存在多个texture引用了同一个source,增加缓存，每一个source都有自己的hashcode
@@ -40,7 +40,7 @@ namespace ff {
 		if (m_source)
 		{
 			EventBase::Ptr e = EventBase::create("sourceRelease");
-			e->mTarget = this;
+			e->mTarget = m_source.get();
 			EventDispatcher::getInstance()->dispatchEvent(e);
 		}
 	}
@@ -49,6 +49,11 @@ namespace ff {
 	{
 		auto texture = Texture::create(m_width, m_height, m_dataType, m_wrapS, m_wrapT, m_wrapR, m_magFilter, m_minFilter, m_format);
 		texture->m_source = m_source;
+		if (m_source)
+		{
+			//与本纹理共享Source，析构时同样会释放一次引用
+			m_source->m_refCount++;
+		}
 		texture->m_usage = m_usage;
 		texture->m_textureType = m_textureType;
 		texture->m_internalFormat = m_internalFormat;
@@ -0,0 +1,33 @@
+#include "textureArray.h"
+#include "../global/eventDispatcher.h"
+
+namespace ff {
+
+	TextureArray::TextureArray(
+		const uint32_t& width,
+		const uint32_t& height,
+		const DataType& dataType,
+		const TextureWrapping& wrapS,
+		const TextureWrapping& wrapT,
+		const TextureWrapping& wrapR,
+		const TextureFilter& magFilter,
+		const TextureFilter& minFilter,
+		const TextureFormat& format
+	) noexcept: Texture(width, height, dataType, wrapS, wrapT, wrapR, magFilter, minFilter, format)
+	{
+		m_textureType = TextureType::Texture2DArray;
+	}
+
+	TextureArray::~TextureArray() noexcept 
+	{
+		for (const auto& source : m_sources) 
+		{
+			if (source) 
+			{
+				EventBase::Ptr e = EventBase::create("sourceRelease");
+				e->mTarget = source.get();
+				EventDispatcher::getInstance()->dispatchEvent(e);
+			}
+		}
+	}
+}
@@ -0,0 +1,76 @@
+/**
+ * @class TextureArray
+ * @brief TextureArray 表示二维纹理数组(GL_TEXTURE_2D_ARRAY)，所有层共享同一个尺寸与像素格式。
+ *
+ * TextureArray 继承自 Texture，内部按层维护 `Source::Ptr`，第i个Source对应第i层，
+ * 着色器中以 sampler2DArray 采样，texture(map, vec3(uv, layer))。
+ * 与图集相比，每一层都可以独立地重复(Repeat)环绕与生成mipmap，不会互相渗色。
+ *
+ * Example usage:
+ * ```cpp
+ * auto array = ff::TextureArray::create(64, 64);
+ * array->m_sources.push_back(source0);
+ * array->m_sources.push_back(source1);
+ * ```
+ * @note 每一层Source的尺寸必须等于m_width x m_height，上传时层数为m_sources.size()。
+ * @note 层数不应超过 GL_MAX_ARRAY_TEXTURE_LAYERS(OpenGL 3.3 至少为256)。
+ *
+ * @see ff::Texture, ff::TextureAtlas, ff::TextureType::Texture2DArray
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+
+#pragma once 
+#include "../global/base.h"
+#include "../global/constant.h"
+#include "texture.h"
+
+namespace ff 
+{
+
+	class TextureArray :public Texture 
+	{
+	public:
+		using Ptr = std::shared_ptr<TextureArray>;
+		static Ptr create(
+			const uint32_t& width,
+			const uint32_t& height,
+			const DataType& dataType = DataType::UnsignedByteType,
+			const TextureWrapping& wrapS = TextureWrapping::RepeatWrapping,
+			const TextureWrapping& wrapT = TextureWrapping::RepeatWrapping,
+			const TextureWrapping& wrapR = TextureWrapping::RepeatWrapping,
+			const TextureFilter& magFilter = TextureFilter::LinearFilter,
+			const TextureFilter& minFilter = TextureFilter::LinearFilter,
+			const TextureFormat& format = TextureFormat::RGBA
+		)
+		{
+			return std::make_shared<TextureArray>(
+				width,
+				height,
+				dataType,
+				wrapS,
+				wrapT,
+				wrapR,
+				magFilter,
+				minFilter,
+				format);
+		}
+
+		TextureArray(
+			const uint32_t& width,
+			const uint32_t& height,
+			const DataType& dataType = DataType::UnsignedByteType,
+			const TextureWrapping& wrapS = TextureWrapping::RepeatWrapping,
+			const TextureWrapping& wrapT = TextureWrapping::RepeatWrapping,
+			const TextureWrapping& wrapR = TextureWrapping::RepeatWrapping,
+			const TextureFilter& magFilter = TextureFilter::LinearFilter,
+			const TextureFilter& minFilter = TextureFilter::LinearFilter,
+			const TextureFormat& format = TextureFormat::RGBA
+		) noexcept;
+
+		~TextureArray() noexcept;
+
+		std::vector<Source::Ptr> m_sources{};
+	};
+}
@@ -0,0 +1,378 @@
+#include "textureAtlas.h"
+
+namespace ff
+{
+	namespace
+	{
+		uint32_t channelCount(TextureFormat format) noexcept
+		{
+			switch (format)
+			{
+			case TextureFormat::RGB:
+				return 3;
+			case TextureFormat::RGBA:
+				return 4;
+			default:
+				return 0;
+			}
+		}
+
+		uint32_t nextPowerOfTwo(uint32_t value) noexcept
+		{
+			uint32_t result = 1;
+			while (result < value)
+			{
+				result <<= 1;
+			}
+
+			return result;
+		}
+
+		//贴图在图集页中的位置(包含padding)
+		struct Placement
+		{
+			Texture::Ptr	m_texture{ nullptr };
+			uint32_t		m_page{ 0 };
+			uint32_t		m_x{ 0 };
+			uint32_t		m_y{ 0 };
+		};
+
+		//把贴图拷贝到页中，并向四周复制padding像素的边缘
+		void blit(const Texture& texture, uint32_t x, uint32_t y, uint32_t padding, Source& page, uint32_t pageWidth, uint32_t channels) noexcept
+		{
+			const byte* src = texture.m_source->m_data.data();
+			int width = static_cast<int>(texture.m_width);
+			int height = static_cast<int>(texture.m_height);
+			int pad = static_cast<int>(padding);
+
+			for (int row = -pad; row < height + pad; ++row)
+			{
+				int srcRow = std::clamp(row, 0, height - 1);
+				byte* dst = page.m_data.data() + (static_cast<size_t>(y + pad + row) * pageWidth + x) * channels;
+
+				const byte* srcLine = src + static_cast<size_t>(srcRow) * width * channels;
+				for (int col = -pad; col < 0; ++col, dst += channels)
+				{
+					std::memcpy(dst, srcLine, channels);
+				}
+
+				std::memcpy(dst, srcLine, static_cast<size_t>(width) * channels);
+				dst += static_cast<size_t>(width) * channels;
+
+				for (int col = 0; col < pad; ++col, dst += channels)
+				{
+					std::memcpy(dst, srcLine + static_cast<size_t>(width - 1) * channels, channels);
+				}
+			}
+		}
+	}
+
+	TextureAtlas::TextureAtlas(Mode mode, uint32_t pageSize) noexcept
+	{
+		m_mode = mode;
+		m_pageSize = pageSize;
+	}
+
+	TextureAtlas::~TextureAtlas() noexcept {}
+
+	bool TextureAtlas::isCompatible(const Texture::Ptr& texture) const noexcept
+	{
+		if (texture == nullptr || texture->getUsage() != TextureUsage::SamplerTexture || texture->m_textureType != TextureType::Texture2D)
+		{
+			return false;
+		}
+
+		if (texture->m_dataType != DataType::UnsignedByteType || channelCount(texture->m_format) == 0)
+		{
+			return false;
+		}
+
+		const auto& source = texture->m_source;
+		if (source == nullptr || texture->m_width == 0 || texture->m_height == 0 ||
+			source->m_data.size() != static_cast<size_t>(texture->m_width) * texture->m_height * channelCount(texture->m_format))
+		{
+			return false;
+		}
+
+		if (std::max(texture->m_width, texture->m_height) > m_maxTextureSize)
+		{
+			return false;
+		}
+
+		if (m_mode == Mode::Atlas)
+		{
+			//图集中无法重复，只接受本来就限制在边缘的贴图
+			if (texture->m_wrapS != TextureWrapping::ClampToEdgeWrapping || texture->m_wrapT != TextureWrapping::ClampToEdgeWrapping)
+			{
+				return false;
+			}
+
+			if (texture->m_width + 2 * m_padding > m_pageSize || texture->m_height + 2 * m_padding > m_pageSize)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	HashType TextureAtlas::groupKey(const Texture::Ptr& texture) const noexcept
+	{
+		std::hash<std::string> hasher;
+
+		std::string keyString;
+		keyString.append(std::to_string(static_cast<uint32_t>(texture->m_format)));
+		keyString.append(std::to_string(static_cast<uint32_t>(texture->m_internalFormat)));
+		keyString.append(std::to_string(static_cast<uint32_t>(texture->m_dataType)));
+		keyString.append(std::to_string(static_cast<uint32_t>(texture->m_minFilter)));
+		keyString.append(std::to_string(static_cast<uint32_t>(texture->m_magFilter)));
+
+		//纹理数组的各层尺寸与环绕方式必须一致
+		if (m_mode == Mode::Array)
+		{
+			keyString.append("_" + std::to_string(texture->m_width) + "x" + std::to_string(texture->m_height));
+			keyString.append(std::to_string(static_cast<uint32_t>(texture->m_wrapS)));
+			keyString.append(std::to_string(static_cast<uint32_t>(texture->m_wrapT)));
+		}
+
+		return hasher(keyString);
+	}
+
+	bool TextureAtlas::add(const Texture::Ptr& texture) noexcept
+	{
+		if (!isCompatible(texture))
+		{
+			m_stats.m_rejected++;
+			return false;
+		}
+
+		for (const auto& added : m_textures)
+		{
+			if (added == texture)
+			{
+				return true;
+			}
+		}
+
+		m_textures.push_back(texture);
+		m_stats.m_added++;
+
+		return true;
+	}
+
+	void TextureAtlas::clear() noexcept
+	{
+		m_textures.clear();
+		m_regions.clear();
+		m_pages.clear();
+		m_stats = Stats();
+	}
+
+	const TextureAtlas::Region* TextureAtlas::find(ID id) const noexcept
+	{
+		auto iter = m_regions.find(id);
+		if (iter == m_regions.end())
+		{
+			return nullptr;
+		}
+
+		return &iter->second;
+	}
+
+	Texture::Ptr TextureAtlas::createPage(const Texture::Ptr& sample, uint32_t width, uint32_t height) const noexcept
+	{
+		Texture::Ptr page = nullptr;
+		if (m_mode == Mode::Array)
+		{
+			page = TextureArray::create(width, height, sample->m_dataType, sample->m_wrapS, sample->m_wrapT, sample->m_wrapR,
+				sample->m_magFilter, sample->m_minFilter, sample->m_format);
+		}
+		else
+		{
+			page = Texture::create(width, height, sample->m_dataType, TextureWrapping::ClampToEdgeWrapping, TextureWrapping::ClampToEdgeWrapping,
+				TextureWrapping::ClampToEdgeWrapping, sample->m_magFilter, sample->m_minFilter, sample->m_format);
+		}
+		page->m_internalFormat = sample->m_internalFormat;
+
+		return page;
+	}
+
+	void TextureAtlas::build(const JobSystem::Ptr& jobSystem) noexcept
+	{
+		m_regions.clear();
+		m_pages.clear();
+		m_stats.m_packed = 0;
+		m_stats.m_pages = 0;
+		m_stats.m_usedPixels = 0;
+		m_stats.m_pagePixels = 0;
+
+		//按加入顺序分组，保证结果可重复
+		std::vector<HashType> keys;
+		std::unordered_map<HashType, std::vector<Texture::Ptr>> groups;
+		for (const auto& texture : m_textures)
+		{
+			auto key = groupKey(texture);
+			auto& group = groups[key];
+			if (group.empty())
+			{
+				keys.push_back(key);
+			}
+			group.push_back(texture);
+		}
+
+		for (auto key : keys)
+		{
+			if (m_mode == Mode::Atlas)
+			{
+				buildAtlas(groups[key], jobSystem);
+			}
+			else
+			{
+				buildArray(groups[key]);
+			}
+		}
+
+		m_stats.m_pages = static_cast<uint32_t>(m_pages.size());
+	}
+
+	void TextureAtlas::buildAtlas(std::vector<Texture::Ptr>& group, const JobSystem::Ptr& jobSystem) noexcept
+	{
+		//高的先放，同一行内高度接近，浪费最少
+		std::stable_sort(group.begin(), group.end(), [](const Texture::Ptr& a, const Texture::Ptr& b) {
+			if (a->m_height != b->m_height)
+			{
+				return a->m_height > b->m_height;
+			}
+
+			return a->m_width > b->m_width;
+		});
+
+		uint32_t firstPage = static_cast<uint32_t>(m_pages.size());
+		std::vector<Placement> placements;
+		std::vector<uint32_t> pageHeights;
+
+		uint32_t x = 0, y = 0, shelfHeight = 0;
+		pageHeights.push_back(0);
+
+		for (const auto& texture : group)
+		{
+			uint32_t width = texture->m_width + 2 * m_padding;
+			uint32_t height = texture->m_height + 2 * m_padding;
+
+			//换行
+			if (x + width > m_pageSize)
+			{
+				y += shelfHeight;
+				x = 0;
+				shelfHeight = 0;
+			}
+
+			//换页
+			if (y + height > m_pageSize)
+			{
+				pageHeights.push_back(0);
+				x = 0;
+				y = 0;
+				shelfHeight = 0;
+			}
+
+			Placement placement;
+			placement.m_texture = texture;
+			placement.m_page = static_cast<uint32_t>(pageHeights.size() - 1);
+			placement.m_x = x;
+			placement.m_y = y;
+			placements.push_back(placement);
+
+			x += width;
+			shelfHeight = std::max(shelfHeight, height);
+			pageHeights.back() = std::max(pageHeights.back(), y + height);
+		}
+
+		//每页的高度取能容纳所有行的最小2的幂
+		auto channels = channelCount(group.front()->m_format);
+		for (auto height : pageHeights)
+		{
+			auto page = createPage(group.front(), m_pageSize, std::min(nextPowerOfTwo(height), m_pageSize));
+			page->m_source = Source::create();
+			page->m_source->m_width = page->m_width;
+			page->m_source->m_height = page->m_height;
+			page->m_source->m_data.resize(static_cast<size_t>(page->m_width) * page->m_height * channels, 0);
+
+			m_stats.m_pagePixels += static_cast<uint64_t>(page->m_width) * page->m_height;
+			m_pages.push_back(page);
+		}
+
+		for (const auto& placement : placements)
+		{
+			const auto& texture = placement.m_texture;
+			const auto& page = m_pages[firstPage + placement.m_page];
+
+			Region region;
+			region.m_page = page;
+			region.m_transform = glm::vec4(
+				static_cast<float>(texture->m_width) / page->m_width,
+				static_cast<float>(texture->m_height) / page->m_height,
+				static_cast<float>(placement.m_x + m_padding) / page->m_width,
+				static_cast<float>(placement.m_y + m_padding) / page->m_height);
+
+			m_regions[texture->getID()] = region;
+			m_stats.m_usedPixels += static_cast<uint64_t>(texture->m_width) * texture->m_height;
+			m_stats.m_packed++;
+		}
+
+		//各贴图写入的区域互不重叠，可以直接并行
+		auto copy = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				const auto& placement = placements[i];
+				const auto& page = m_pages[firstPage + placement.m_page];
+				blit(*placement.m_texture, placement.m_x, placement.m_y, m_padding, *page->m_source, page->m_width, channels);
+			}
+		};
+
+		auto count = static_cast<uint32_t>(placements.size());
+		if (jobSystem != nullptr)
+		{
+			jobSystem->parallelFor(count, 16, copy);
+		}
+		else
+		{
+			copy(0, count);
+		}
+	}
+
+	void TextureAtlas::buildArray(std::vector<Texture::Ptr>& group) noexcept
+	{
+		//只有一张时放进数组没有意义
+		if (group.size() < 2)
+		{
+			return;
+		}
+
+		for (size_t begin = 0; begin < group.size(); begin += m_maxLayers)
+		{
+			size_t end = std::min(begin + m_maxLayers, group.size());
+
+			auto page = std::static_pointer_cast<TextureArray>(createPage(group.front(), group.front()->m_width, group.front()->m_height));
+			for (size_t i = begin; i < end; ++i)
+			{
+				const auto& texture = group[i];
+
+				//与原贴图共享Source，数组析构时同样会释放一次引用
+				texture->m_source->m_refCount++;
+				page->m_sources.push_back(texture->m_source);
+
+				Region region;
+				region.m_page = page;
+				region.m_layer = static_cast<uint32_t>(i - begin);
+				m_regions[texture->getID()] = region;
+
+				m_stats.m_usedPixels += static_cast<uint64_t>(texture->m_width) * texture->m_height;
+				m_stats.m_packed++;
+			}
+
+			m_stats.m_pagePixels += static_cast<uint64_t>(page->m_width) * page->m_height * page->m_sources.size();
+			m_pages.push_back(page);
+		}
+	}
+}
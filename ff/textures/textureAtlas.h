@@ -0,0 +1,134 @@
+/**
+ * @class TextureAtlas
+ * @brief 小贴图打包器：把大量兼容的小贴图放进共享的图集页或纹理数组的层中，使用这些贴图的物体绑定同一张贴图，减少绑定次数并便于合批。
+ *
+ * 简介：
+ * - Mode::Atlas：按高度从大到小排序后逐行(shelf)放入pageSize x pageSize的图集页，每张贴图四周留出padding像素的边缘复制，
+ *   避免线性过滤与低级别mipmap采样到相邻贴图；着色器中先把uv限制在[0, 1]，再按区域变换到图集中；
+ * - Mode::Array：尺寸与环绕方式相同的贴图放进同一个 ff::TextureArray 的不同层，各层直接共享原贴图的Source，
+ *   可以重复(Repeat)环绕，着色器中以vec3(uv, layer)采样；
+ * - 像素格式、数据类型、过滤方式不同的贴图不会放进同一页；
+ * - build()之后，DriverTextures通过find()查到贴图所在的页与变换，DriverMaterials把diffuseMap换成页，
+ *   并上传diffuseMapTransform(xy为缩放，zw为偏移)与diffuseMapLayer，DriverPrograms按打包方式开启对应的宏。
+ *
+ * 使用示例：
+ * @code
+ * auto atlas = ff::TextureAtlas::create(ff::TextureAtlas::Mode::Atlas);
+ * for (const auto& material : signMaterials)
+ * {
+ *     atlas->add(material->m_diffuseMap);
+ * }
+ * atlas->build(jobSystem);
+ * renderer->setTextureAtlas(atlas);
+ * @endcode
+ *
+ * 限制与注意：
+ * - 只打包带有像素数据、每通道8位的RGB/RGBA采样贴图；不兼容或过大的贴图add返回false，照常单独绑定；
+ * - Atlas模式只接受ClampToEdge环绕的贴图，需要重复的贴图请使用Array模式；
+ * - 图集页的mipmap由驱动对整页生成，padding为p时前log2(p)级不会渗色，更低的级别可能混入相邻贴图的颜色；
+ * - Array模式下只有一张的尺寸不会被打包；
+ * - 打包后原贴图的内容或尺寸发生变化时需要clear()后重新add与build；
+ * - 只对diffuseMap生效，法线与高光贴图保持单独绑定。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "texture.h"
+#include "textureArray.h"
+#include "../tools/jobSystem.h"
+
+namespace ff
+{
+	class TextureAtlas
+	{
+	public:
+		enum class Mode
+		{
+			Atlas,
+			Array
+		};
+
+		//贴图在打包结果中的位置
+		struct Region
+		{
+			Texture::Ptr	m_page{ nullptr };
+			glm::vec4		m_transform{ 1.0f, 1.0f, 0.0f, 0.0f };	//uv * xy + zw
+			uint32_t		m_layer{ 0 };
+		};
+
+		struct Stats
+		{
+			uint32_t	m_added{ 0 };		//add成功的贴图数
+			uint32_t	m_rejected{ 0 };	//不兼容而没有加入的贴图数
+			uint32_t	m_packed{ 0 };		//build后放入页中的贴图数
+			uint32_t	m_pages{ 0 };
+			uint64_t	m_usedPixels{ 0 };	//各页中被贴图(不含padding)占用的像素数
+			uint64_t	m_pagePixels{ 0 };	//各页的总像素数
+		};
+
+		using Ptr = std::shared_ptr<TextureAtlas>;
+		static Ptr create(Mode mode, uint32_t pageSize = 2048)
+		{
+			return std::make_shared<TextureAtlas>(mode, pageSize);
+		}
+
+		TextureAtlas(Mode mode, uint32_t pageSize) noexcept;
+
+		~TextureAtlas() noexcept;
+
+		void setPadding(uint32_t padding) noexcept { m_padding = padding; }
+
+		//最大边超过size的贴图不打包
+		void setMaxTextureSize(uint32_t size) noexcept { m_maxTextureSize = size; }
+
+		//Array模式下每个纹理数组的最大层数
+		void setMaxLayers(uint32_t layers) noexcept { m_maxLayers = std::max(layers, 1u); }
+
+		//不兼容的贴图返回false
+		bool add(const Texture::Ptr& texture) noexcept;
+
+		//排布所有加入的贴图并生成页，jobSystem不为空时并行拷贝像素
+		void build(const JobSystem::Ptr& jobSystem = nullptr) noexcept;
+
+		void clear() noexcept;
+
+		//没有被打包的贴图返回nullptr
+		const Region* find(ID id) const noexcept;
+
+		const Region* find(const Texture::Ptr& texture) const noexcept { return texture == nullptr ? nullptr : find(texture->getID()); }
+
+		const std::vector<Texture::Ptr>& getPages() const noexcept { return m_pages; }
+
+		Mode getMode() const noexcept { return m_mode; }
+
+		const Stats& getStats() const noexcept { return m_stats; }
+
+	private:
+		bool isCompatible(const Texture::Ptr& texture) const noexcept;
+
+		//可以放进同一页的贴图的键
+		HashType groupKey(const Texture::Ptr& texture) const noexcept;
+
+		void buildAtlas(std::vector<Texture::Ptr>& group, const JobSystem::Ptr& jobSystem) noexcept;
+
+		void buildArray(std::vector<Texture::Ptr>& group) noexcept;
+
+		Texture::Ptr createPage(const Texture::Ptr& sample, uint32_t width, uint32_t height) const noexcept;
+
+	private:
+		Mode							m_mode{ Mode::Atlas };
+		uint32_t						m_pageSize{ 2048 };
+		uint32_t						m_padding{ 4 };
+		uint32_t						m_maxTextureSize{ 256 };
+		uint32_t						m_maxLayers{ 256 };
+
+		std::vector<Texture::Ptr>		m_textures{};
+		std::unordered_map<ID, Region>	m_regions{};
+		std::vector<Texture::Ptr>		m_pages{};
+
+		Stats							m_stats{};
+	};
+}
@@ -0,0 +1,317 @@
+#include "hlodBuilder.h"
+#include "meshSimplifier.h"
+#include "../objects/mesh.h"
+#include "../objects/lod.h"
+
+namespace ff
+{
+	namespace
+	{
+		//参与合并的一个Mesh，matrix为其到HLOD坐标系的变换
+		struct Source
+		{
+			Geometry::Ptr	m_geometry{ nullptr };
+			glm::mat4		m_matrix{ 1.0f };
+		};
+
+		struct Cluster
+		{
+			std::vector<Object3D::Ptr>	m_objects{};
+			std::vector<Source>			m_sources{};
+			Material::Ptr				m_material{ nullptr };
+
+			//合并与简化的中间结果也保存在这里，统一在主线程上释放(Geometry/Attribute析构时会派发事件)
+			Geometry::Ptr				m_merged{ nullptr };
+			MeshSimplifier::Level		m_level{};
+			Geometry::Ptr				m_proxy{ nullptr };
+		};
+
+		void addRenderable(RenderableObject* renderable, const glm::mat4& toCluster, Cluster& cluster) noexcept
+		{
+			const auto& geometry = renderable->getGeometry();
+			const auto& material = renderable->getMaterial();
+			if (!renderable->m_isMesh || renderable->m_isSkinnedMesh || material->m_drawMode != DrawMode::Triangles ||
+				geometry == nullptr || !geometry->hasAttribute("position"))
+			{
+				return;
+			}
+
+			cluster.m_sources.push_back({ geometry, toCluster * renderable->getWorldMatrix() });
+			if (cluster.m_material == nullptr)
+			{
+				cluster.m_material = material;
+			}
+		}
+
+		void collectSources(Object3D* object, const glm::mat4& toCluster, Cluster& cluster) noexcept
+		{
+			if (!object->m_visible)
+			{
+				return;
+			}
+
+			//已经生成过代理的HLOD直接使用代理，形成多层的HLOD
+			if (object->m_isHLOD)
+			{
+				const auto& proxy = static_cast<HLOD*>(object)->getProxy();
+				if (proxy != nullptr)
+				{
+					addRenderable(proxy.get(), toCluster, cluster);
+					return;
+				}
+			}
+			//LOD只取最高精度级别，其余级别的可见性由LOD控制，不能按m_visible判断
+			else if (object->m_isLOD)
+			{
+				const auto& levels = static_cast<LOD*>(object)->getLevels();
+				if (!levels.empty())
+				{
+					addRenderable(levels[0].m_object.get(), toCluster, cluster);
+				}
+				return;
+			}
+			else if (object->m_isRenderableObject)
+			{
+				addRenderable(static_cast<RenderableObject*>(object), toCluster, cluster);
+			}
+
+			for (const auto& child : object->getChildren())
+			{
+				collectSources(child.get(), toCluster, cluster);
+			}
+		}
+
+		//用于分组的位置：可渲染物体与HLOD取包围球球心(HLOD本身位于单位变换处)，其余取世界坐标
+		glm::vec3 clusterPosition(Object3D* object) noexcept
+		{
+			if (object->m_isHLOD && static_cast<HLOD*>(object)->getProxy() != nullptr)
+			{
+				return static_cast<HLOD*>(object)->getProxy()->getWorldBoundingSphere().m_center;
+			}
+
+			if (object->m_isRenderableObject)
+			{
+				return static_cast<RenderableObject*>(object)->getWorldBoundingSphere().m_center;
+			}
+
+			return object->getWorldPosition();
+		}
+
+		void mergeCluster(Cluster& cluster, const HLODBuilder::Desc& desc) noexcept
+		{
+			//只保留所有Mesh都具有的属性
+			bool hasNormal = true;
+			bool hasUV = true;
+			for (const auto& source : cluster.m_sources)
+			{
+				hasNormal = hasNormal && source.m_geometry->hasAttribute("normal");
+				hasUV = hasUV && source.m_geometry->hasAttribute("uv");
+			}
+
+			std::vector<float> positions;
+			std::vector<float> normals;
+			std::vector<float> uvs;
+			std::vector<uint32_t> indices;
+
+			for (const auto& source : cluster.m_sources)
+			{
+				auto base = static_cast<uint32_t>(positions.size() / 3);
+				glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(source.m_matrix)));
+
+				const auto& position = source.m_geometry->getAttribute("position")->getData();
+				uint32_t count = static_cast<uint32_t>(position.size() / 3);
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					glm::vec3 point = source.m_matrix * glm::vec4(position[i * 3], position[i * 3 + 1], position[i * 3 + 2], 1.0f);
+					positions.insert(positions.end(), { point.x, point.y, point.z });
+				}
+
+				if (hasNormal)
+				{
+					const auto& normal = source.m_geometry->getAttribute("normal")->getData();
+					for (uint32_t i = 0; i < count; ++i)
+					{
+						glm::vec3 n = glm::normalize(normalMatrix * glm::vec3(normal[i * 3], normal[i * 3 + 1], normal[i * 3 + 2]));
+						normals.insert(normals.end(), { n.x, n.y, n.z });
+					}
+				}
+
+				if (hasUV)
+				{
+					const auto& uv = source.m_geometry->getAttribute("uv")->getData();
+					uvs.insert(uvs.end(), uv.begin(), uv.begin() + count * 2);
+				}
+
+				//没有index的Mesh按顺序每三个顶点一个三角形
+				auto index = source.m_geometry->getIndex();
+				if (index != nullptr)
+				{
+					for (auto i : index->getData())
+					{
+						indices.push_back(base + i);
+					}
+				}
+				else
+				{
+					for (uint32_t i = 0; i + 2 < count; i += 3)
+					{
+						indices.insert(indices.end(), { base + i, base + i + 1, base + i + 2 });
+					}
+				}
+			}
+
+			if (indices.empty())
+			{
+				return;
+			}
+
+			cluster.m_merged = Geometry::create();
+			cluster.m_merged->setAttribute("position", Attributef::create(positions, 3));
+			if (hasNormal) cluster.m_merged->setAttribute("normal", Attributef::create(normals, 3));
+			if (hasUV) cluster.m_merged->setAttribute("uv", Attributef::create(uvs, 2));
+			cluster.m_merged->setIndex(Attributei::create(indices, 1));
+
+			auto levels = MeshSimplifier(cluster.m_merged).buildLevels({ { desc.m_ratio, desc.m_maxError } });
+			if (levels.empty() || levels[0].m_triangles == 0)
+			{
+				return;
+			}
+			cluster.m_level = levels[0];
+
+			//去掉简化之后不再被引用的顶点，代理只保留自己用到的数据
+			std::vector<uint32_t> remap(positions.size() / 3, UINT32_MAX);
+			std::vector<float> compactPositions;
+			std::vector<float> compactNormals;
+			std::vector<float> compactUVs;
+			std::vector<uint32_t> compactIndices;
+			compactIndices.reserve(cluster.m_level.m_index->getData().size());
+
+			for (auto i : cluster.m_level.m_index->getData())
+			{
+				if (remap[i] == UINT32_MAX)
+				{
+					remap[i] = static_cast<uint32_t>(compactPositions.size() / 3);
+					compactPositions.insert(compactPositions.end(), positions.begin() + i * 3, positions.begin() + i * 3 + 3);
+					if (hasNormal) compactNormals.insert(compactNormals.end(), normals.begin() + i * 3, normals.begin() + i * 3 + 3);
+					if (hasUV) compactUVs.insert(compactUVs.end(), uvs.begin() + i * 2, uvs.begin() + i * 2 + 2);
+				}
+
+				compactIndices.push_back(remap[i]);
+			}
+
+			cluster.m_proxy = Geometry::create();
+			cluster.m_proxy->setAttribute("position", Attributef::create(compactPositions, 3));
+			if (hasNormal) cluster.m_proxy->setAttribute("normal", Attributef::create(compactNormals, 3));
+			if (hasUV) cluster.m_proxy->setAttribute("uv", Attributef::create(compactUVs, 2));
+			cluster.m_proxy->setIndex(Attributei::create(compactIndices, 1));
+		}
+	}
+
+	std::vector<HLOD::Ptr> HLODBuilder::build(const Object3D::Ptr& root, const Desc& desc, const JobSystem::Ptr& jobSystem) noexcept
+	{
+		std::vector<HLOD::Ptr> hlods;
+		if (root == nullptr || desc.m_cellSize <= 0.0f)
+		{
+			return hlods;
+		}
+
+		root->updateWorldMatrix(true, true);
+
+		//1 按网格单元分组，std::map保证结果与子节点顺序无关、可重复
+		std::map<std::tuple<int32_t, int32_t, int32_t>, uint32_t> cellToCluster;
+		std::vector<Cluster> clusters;
+
+		for (const auto& child : root->getChildren())
+		{
+			if (child->m_isLight || child->m_isCamera)
+			{
+				continue;
+			}
+
+			glm::vec3 cell = glm::floor(clusterPosition(child.get()) / desc.m_cellSize);
+			auto key = std::make_tuple(static_cast<int32_t>(cell.x), static_cast<int32_t>(cell.y), static_cast<int32_t>(cell.z));
+
+			auto iter = cellToCluster.find(key);
+			if (iter == cellToCluster.end())
+			{
+				iter = cellToCluster.emplace(key, static_cast<uint32_t>(clusters.size())).first;
+				clusters.emplace_back();
+			}
+
+			clusters[iter->second].m_objects.push_back(child);
+		}
+
+		clusters.erase(std::remove_if(clusters.begin(), clusters.end(), [&](const Cluster& cluster) {
+			return cluster.m_objects.size() < std::max(desc.m_minObjects, 1u);
+		}), clusters.end());
+
+		//2 收集参与合并的Mesh，HLOD以单位变换挂到root下，所以HLOD坐标系就是root的本地坐标系
+		glm::mat4 toCluster = glm::inverse(root->getWorldMatrix());
+		for (auto& cluster : clusters)
+		{
+			for (const auto& object : cluster.m_objects)
+			{
+				collectSources(object.get(), toCluster, cluster);
+			}
+		}
+
+		//3 合并与简化，只读取Geometry，不修改场景
+		auto mergeRange = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				mergeCluster(clusters[i], desc);
+			}
+		};
+
+		auto count = static_cast<uint32_t>(clusters.size());
+		if (jobSystem != nullptr)
+		{
+			jobSystem->parallelFor(count, 1, mergeRange);
+		}
+		else
+		{
+			mergeRange(0, count);
+		}
+
+		//4 调整层级结构，没有得到代理(例如组内没有三角形Mesh)的组保持原样
+		//成组的物体一次性从root下移除，root的子节点列表只重建一次
+		std::unordered_set<const Object3D*> clustered;
+		for (const auto& cluster : clusters)
+		{
+			if (cluster.m_proxy == nullptr)
+			{
+				continue;
+			}
+
+			for (const auto& object : cluster.m_objects)
+			{
+				clustered.insert(object.get());
+			}
+		}
+		root->removeChildren(clustered);
+
+		for (auto& cluster : clusters)
+		{
+			if (cluster.m_proxy == nullptr)
+			{
+				continue;
+			}
+
+			auto hlod = HLOD::create();
+			hlod->setScreenSize(desc.m_screenSize);
+			root->addChild(hlod);
+
+			for (const auto& object : cluster.m_objects)
+			{
+				hlod->addChild(object);
+			}
+
+			auto material = desc.m_material != nullptr ? desc.m_material : cluster.m_material;
+			hlod->setProxy(Mesh::create(cluster.m_proxy, material));
+
+			hlods.push_back(hlod);
+		}
+
+		return hlods;
+	}
+}
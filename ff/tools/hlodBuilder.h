@@ -0,0 +1,59 @@
+/**
+ * @class HLODBuilder
+ * @brief 离线生成HLOD：把一个节点下在空间上聚集的子节点分组，每组挂到一个HLOD下，并合并、简化出单一材质的代理Mesh。
+ *
+ * 简介：
+ * - 按子节点的世界位置落在哪个边长为m_cellSize的网格单元进行分组，同一单元内不少于m_minObjects个子节点时生成一个HLOD；
+ * - 组内子树中所有三角形Mesh变换到HLOD坐标系下合并为一个Geometry，只保留组内所有Mesh共有的position/normal/uv，
+ *   之后用 ff::MeshSimplifier 简化并去掉不再使用的顶点；
+ * - 子树中的LOD只取最高精度级别，已有代理的HLOD直接使用其代理，
+ *   所以对同一个节点用更大的m_cellSize再调用一次即可得到多层的HLOD；
+ * - 各组的合并与简化在jobSystem上并行执行，jobSystem为nullptr时串行。
+ *
+ * 使用示例：
+ * @code
+ * ff::HLODBuilder::Desc desc;
+ * desc.m_cellSize = 50.0f;
+ * desc.m_material = ff::MeshBasicMaterial::create();
+ * auto hlods = ff::HLODBuilder::build(campus, desc, jobSystem);
+ *
+ * desc.m_cellSize = 200.0f;   // 第二层，合并第一层的代理
+ * desc.m_screenSize = 32.0f;
+ * ff::HLODBuilder::build(campus, desc, jobSystem);
+ * @endcode
+ *
+ * 限制与注意：
+ * - 会修改root的层级结构：被分组的子节点从root移动到新建的HLOD下，HLOD本身以单位变换挂到root下，子节点的世界变换不变；
+ * - SkinnedMesh、非三角形绘制的物体以及不可见的子树不参与合并，但仍然会随组一起被代理替换；
+ * - 代理使用m_material(为空时使用组内第一个Mesh的材质)，各物体原有的材质差异会丢失。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../core/object3D.h"
+#include "../material/material.h"
+#include "../objects/hlod.h"
+#include "jobSystem.h"
+
+namespace ff
+{
+	class HLODBuilder
+	{
+	public:
+		struct Desc
+		{
+			float			m_cellSize{ 50.0f };		//分组网格单元的边长(世界单位)
+			float			m_ratio{ 0.1f };			//代理的三角形数占合并后三角形数的比例
+			float			m_maxError{ 0.02f };		//简化允许的误差，以组的包围盒最长边为单位
+			float			m_screenSize{ 64.0f };		//投影直径小于该像素数时使用代理
+			uint32_t		m_minObjects{ 2 };			//少于该数量的组不生成HLOD
+			Material::Ptr	m_material{ nullptr };
+		};
+
+		//返回本次新建的HLOD节点
+		static std::vector<HLOD::Ptr> build(const Object3D::Ptr& root, const Desc& desc, const JobSystem::Ptr& jobSystem) noexcept;
+	};
+}
@@ -3,5 +3,5 @@
 
 namespace ff
 {
-	ID Identity::m_currentID = 0;
+	std::atomic<ID> Identity::m_currentID{ 0 };
 }
\ No newline at end of file
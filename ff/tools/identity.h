@@ -13,15 +13,17 @@
 
 #pragma once
 #include "../global/base.h"
+#include <atomic>
 
 namespace ff
 {
 	class Identity
 	{
 	public:
-		static ID generateID() { return ++m_currentID; }
+		static ID generateID() { return m_currentID.fetch_add(1, std::memory_order_relaxed) + 1; }
 
 	private:
-		static ID m_currentID;
+		//工作线程中也会创建Geometry/Attribute(例如并行的网格简化)，必须是原子操作
+		static std::atomic<ID> m_currentID;
 	};
 }
\ No newline at end of file
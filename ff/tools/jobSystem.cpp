@@ -0,0 +1,163 @@
+#include "jobSystem.h"
+
+namespace ff
+{
+	//当前线程所属的JobSystem以及队列下标，外部线程为nullptr
+	static thread_local JobSystem* s_currentJobSystem = nullptr;
+	static thread_local uint32_t s_currentQueueIndex = 0;
+
+	JobSystem::JobSystem(uint32_t threadCount) noexcept
+	{
+		m_threadCount = std::max(threadCount, 1u);
+
+		//工作线程各一个队列，外部线程共用最后一个队列
+		for (uint32_t i = 0; i < m_threadCount; ++i)
+		{
+			m_workers.push_back(std::make_unique<Worker>());
+		}
+
+		for (uint32_t i = 0; i + 1 < m_threadCount; ++i)
+		{
+			m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem() noexcept
+	{
+		m_running = false;
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_sleepCondition.notify_all();
+
+		for (auto& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	void JobSystem::execute(const Job& job, WaitGroup& group) noexcept
+	{
+		group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+		//工作线程提交到自己的队列，外部线程提交到公共队列
+		uint32_t index = s_currentJobSystem == this ? s_currentQueueIndex : m_threadCount - 1;
+		{
+			auto& worker = *m_workers[index];
+			std::lock_guard<std::mutex> lock(worker.m_mutex);
+			worker.m_tasks.push_back({ job, &group });
+		}
+		m_queuedTasks.fetch_add(1, std::memory_order_release);
+
+		//先获取一次锁，保证睡眠中的线程不会错过这次唤醒
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_sleepCondition.notify_one();
+	}
+
+	void JobSystem::wait(WaitGroup& group) noexcept
+	{
+		uint32_t index = s_currentJobSystem == this ? s_currentQueueIndex : m_threadCount - 1;
+
+		Task task;
+		while (group.m_pending.load(std::memory_order_acquire) > 0)
+		{
+			if (popTask(index, task))
+			{
+				runTask(task);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t begin, uint32_t end)>& func) noexcept
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		grainSize = std::max(grainSize, 1u);
+
+		WaitGroup group;
+		for (uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			uint32_t end = std::min(begin + grainSize, count);
+			execute([&func, begin, end]() { func(begin, end); }, group);
+		}
+
+		wait(group);
+	}
+
+	void JobSystem::workerLoop(uint32_t index) noexcept
+	{
+		s_currentJobSystem = this;
+		s_currentQueueIndex = index;
+
+		Task task;
+		while (m_running)
+		{
+			if (popTask(index, task))
+			{
+				runTask(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [this]() {
+				return !m_running || m_queuedTasks.load(std::memory_order_acquire) > 0;
+			});
+		}
+	}
+
+	bool JobSystem::popTask(uint32_t index, Task& task) noexcept
+	{
+		if (m_queuedTasks.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		//1 自己的队列从队尾取，刚提交的任务数据还在缓存中
+		{
+			auto& worker = *m_workers[index];
+			std::lock_guard<std::mutex> lock(worker.m_mutex);
+			if (!worker.m_tasks.empty())
+			{
+				task = std::move(worker.m_tasks.back());
+				worker.m_tasks.pop_back();
+				m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		//2 从其它队列的队首窃取
+		for (uint32_t i = 1; i < m_threadCount; ++i)
+		{
+			auto& victim = *m_workers[(index + i) % m_threadCount];
+			std::lock_guard<std::mutex> lock(victim.m_mutex);
+			if (!victim.m_tasks.empty())
+			{
+				task = std::move(victim.m_tasks.front());
+				victim.m_tasks.pop_front();
+				m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void JobSystem::runTask(Task& task) noexcept
+	{
+		task.m_job();
+
+		auto group = task.m_group;
+		task = Task();
+
+		group->m_pending.fetch_sub(1, std::memory_order_release);
+	}
+}
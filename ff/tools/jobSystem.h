@@ -0,0 +1,107 @@
+/**
+ * @class JobSystem
+ * @brief 基于工作窃取(work-stealing)的任务系统，用于把可以并行的计算拆分到多个核心上执行。
+ *
+ * 简介：
+ * - 构造时创建 threadCount - 1 个工作线程，调用线程在 wait() 时同样参与执行任务，总并行度为 threadCount。
+ * - 每个工作线程拥有自己的任务队列：本线程从队尾取任务(LIFO，缓存友好)，其它线程从队首窃取(FIFO)。
+ * - 任务通过 WaitGroup 分组，wait(group) 在等待期间会持续执行/窃取任务，不会空等。
+ *
+ * 使用示例：
+ * @code
+ * auto jobs = ff::JobSystem::create(8);
+ * ff::JobSystem::WaitGroup group;
+ * for (auto& item : items) {
+ *     jobs->execute([&item]() { item.process(); }, group);
+ * }
+ * jobs->wait(group);
+ *
+ * jobs->parallelFor(count, 256, [&](uint32_t begin, uint32_t end) { ... });
+ * @endcode
+ *
+ * 限制与注意：
+ * - 任务之间的数据依赖需要由使用者通过 WaitGroup 自行保证。
+ * - 任务内部可以继续提交任务并等待，但不要在任务中阻塞在锁或者IO上。
+ * - threadCount <= 1 时不创建工作线程，所有任务在 wait() 时由调用线程执行。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "../global/base.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace ff
+{
+	class JobSystem
+	{
+	public:
+		using Job = std::function<void()>;
+
+		//一组任务的完成计数，所有任务执行完毕后 m_pending 归零
+		struct WaitGroup
+		{
+			std::atomic<uint32_t> m_pending{ 0 };
+		};
+
+		using Ptr = std::shared_ptr<JobSystem>;
+		static Ptr create(uint32_t threadCount)
+		{
+			return std::make_shared<JobSystem>(threadCount);
+		}
+
+		JobSystem(uint32_t threadCount) noexcept;
+
+		~JobSystem() noexcept;
+
+		//提交一个任务，任务完成时group计数减一
+		void execute(const Job& job, WaitGroup& group) noexcept;
+
+		//等待group中的任务全部完成，等待期间调用线程也会执行任务
+		void wait(WaitGroup& group) noexcept;
+
+		//把[0, count)按grainSize切分成区间并行执行，返回时全部完成
+		void parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t begin, uint32_t end)>& func) noexcept;
+
+		//包含调用线程在内的并行度
+		uint32_t getThreadCount() const noexcept { return m_threadCount; }
+
+	private:
+		struct Task
+		{
+			Job			m_job{ nullptr };
+			WaitGroup*	m_group{ nullptr };
+		};
+
+		struct Worker
+		{
+			std::mutex			m_mutex;
+			std::deque<Task>	m_tasks;
+		};
+
+		void workerLoop(uint32_t index) noexcept;
+
+		//先取自己的队列，再依次从其它队列窃取
+		bool popTask(uint32_t index, Task& task) noexcept;
+
+		void runTask(Task& task) noexcept;
+
+	private:
+		uint32_t						m_threadCount{ 1 };
+
+		//每个线程一个队列，最后一个队列属于外部提交/等待的线程
+		std::vector<std::unique_ptr<Worker>>	m_workers{};
+		std::vector<std::thread>		m_threads{};
+
+		std::atomic<uint32_t>			m_queuedTasks{ 0 };
+		std::atomic<bool>				m_running{ true };
+
+		std::mutex						m_sleepMutex;
+		std::condition_variable			m_sleepCondition;
+	};
+}
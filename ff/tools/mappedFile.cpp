@@ -0,0 +1,92 @@
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ff
+{
+	MappedFile::MappedFile() noexcept {}
+
+	MappedFile::~MappedFile() noexcept
+	{
+#ifdef _WIN32
+		if (m_data != nullptr) UnmapViewOfFile(m_data);
+		if (m_mapping != nullptr) CloseHandle(m_mapping);
+		if (m_file != nullptr && m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+		if (m_data != nullptr) munmap(const_cast<byte*>(m_data), m_size);
+#endif
+	}
+
+	MappedFile::Ptr MappedFile::open(const std::string& path) noexcept
+	{
+		auto file = std::make_shared<MappedFile>();
+
+#ifdef _WIN32
+		file->m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file->m_file == INVALID_HANDLE_VALUE)
+		{
+			std::cout << "Error: MappedFile can not open " << path << std::endl;
+			return nullptr;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file->m_file, &size) || size.QuadPart == 0)
+		{
+			std::cout << "Error: MappedFile " << path << " is empty" << std::endl;
+			return nullptr;
+		}
+		file->m_size = static_cast<uint64_t>(size.QuadPart);
+
+		file->m_mapping = CreateFileMappingA(file->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (file->m_mapping == nullptr)
+		{
+			std::cout << "Error: MappedFile failed to map " << path << std::endl;
+			return nullptr;
+		}
+
+		file->m_data = static_cast<const byte*>(MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		int descriptor = ::open(path.c_str(), O_RDONLY);
+		if (descriptor < 0)
+		{
+			std::cout << "Error: MappedFile can not open " << path << std::endl;
+			return nullptr;
+		}
+
+		struct stat info;
+		if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+		{
+			std::cout << "Error: MappedFile " << path << " is empty" << std::endl;
+			::close(descriptor);
+			return nullptr;
+		}
+		file->m_size = static_cast<uint64_t>(info.st_size);
+
+		//映射建立之后即可关闭文件描述符
+		void* data = mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		::close(descriptor);
+		file->m_data = data != MAP_FAILED ? static_cast<const byte*>(data) : nullptr;
+#endif
+
+		if (file->m_data == nullptr)
+		{
+			std::cout << "Error: MappedFile failed to map " << path << std::endl;
+			return nullptr;
+		}
+
+		return file;
+	}
+}
@@ -0,0 +1,61 @@
+/**
+ * @class MappedFile
+ * @brief 只读的内存映射文件，用于让大块数据(例如网格快照中的顶点数据)不经拷贝直接被引用。
+ *
+ * 简介：
+ * - 打开时只建立映射，页面在第一次访问时才由系统读入，且属于可回收的文件页，不计入进程私有内存；
+ * - 以shared_ptr持有，引用映射内存的对象(例如 Attribute::createExternal 创建的Attribute)同时持有MappedFile，
+ *   最后一个引用释放时解除映射。
+ *
+ * 使用示例：
+ * @code
+ * auto file = ff::MappedFile::open("mesh.ffs");
+ * if (file != nullptr)
+ * {
+ *     auto position = ff::Attributef::createExternal(
+ *         reinterpret_cast<const float*>(file->getData() + offset), count, 3, file);
+ * }
+ * @endcode
+ *
+ * 限制与注意：
+ * - 映射期间文件被其他进程修改或截断时，访问映射内存的结果未定义；
+ * - 空文件无法映射，open返回nullptr。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+
+namespace ff
+{
+	class MappedFile
+	{
+	public:
+		using Ptr = std::shared_ptr<MappedFile>;
+
+		//失败时返回nullptr
+		static Ptr open(const std::string& path) noexcept;
+
+		MappedFile() noexcept;
+
+		~MappedFile() noexcept;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const byte* getData() const noexcept { return m_data; }
+
+		uint64_t getSize() const noexcept { return m_size; }
+
+	private:
+		const byte*	m_data{ nullptr };
+		uint64_t	m_size{ 0 };
+
+#ifdef _WIN32
+		void*		m_file{ nullptr };
+		void*		m_mapping{ nullptr };
+#endif
+	};
+}
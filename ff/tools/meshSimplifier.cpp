@@ -0,0 +1,697 @@
+#include "meshSimplifier.h"
+
+namespace ff
+{
+	static constexpr uint32_t NoVertex = UINT32_MAX;
+	static constexpr uint32_t MultipleVertices = UINT32_MAX - 1;
+
+	//开放边界约束平面相对于面积的权重
+	static constexpr float BorderWeight = 10.0f;
+
+	namespace
+	{
+	//按起点分组的有向边，remap不为空时按代表顶点分组
+	struct EdgeLists
+	{
+		std::vector<uint32_t>	m_offsets{};
+		std::vector<uint32_t>	m_targets{};
+
+		void build(const std::vector<uint32_t>& indices, const std::vector<uint32_t>* remap, uint32_t vertexCount) noexcept
+		{
+			auto vertex = [remap](uint32_t v) { return remap != nullptr ? (*remap)[v] : v; };
+
+			m_offsets.assign(vertexCount + 1, 0);
+			for (auto v : indices)
+			{
+				m_offsets[vertex(v) + 1]++;
+			}
+			for (uint32_t i = 0; i < vertexCount; ++i)
+			{
+				m_offsets[i + 1] += m_offsets[i];
+			}
+
+			m_targets.resize(indices.size());
+			std::vector<uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (uint32_t e = 0; e < 3; ++e)
+				{
+					m_targets[cursor[vertex(indices[i + e])]++] = vertex(indices[i + (e + 1) % 3]);
+				}
+			}
+		}
+
+		//每个顶点的出边很少，直接线性查找
+		bool hasEdge(uint32_t a, uint32_t b) const noexcept
+		{
+			for (uint32_t i = m_offsets[a]; i < m_offsets[a + 1]; ++i)
+			{
+				if (m_targets[i] == b)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+	}
+
+	//记录唯一的一条开放边，出现第二条时标记为多条
+	static inline void recordOpenEdge(uint32_t& slot, uint32_t vertex) noexcept
+	{
+		slot = (slot == NoVertex || slot == vertex) ? vertex : MultipleVertices;
+	}
+
+	static inline bool isSingle(uint32_t slot) noexcept
+	{
+		return slot != NoVertex && slot != MultipleVertices;
+	}
+
+	MeshSimplifier::MeshSimplifier(const Geometry::Ptr& geometry) noexcept
+	{
+		auto position = geometry->getAttribute("position");
+		auto index = geometry->getIndex();
+		if (position == nullptr || index == nullptr)
+		{
+			return;
+		}
+
+		//位置归一化到包围盒最长边为1，误差与模型尺寸无关
+		m_vertexCount = position->getCount();
+		const auto& data = position->getData();
+		auto itemSize = position->getItemSize();
+
+		glm::vec3 minPoint(std::numeric_limits<float>::max());
+		glm::vec3 maxPoint(-std::numeric_limits<float>::max());
+		m_positions.resize(m_vertexCount);
+		for (uint32_t i = 0; i < m_vertexCount; ++i)
+		{
+			glm::vec3 point(data[i * itemSize], itemSize > 1 ? data[i * itemSize + 1] : 0.0f, itemSize > 2 ? data[i * itemSize + 2] : 0.0f);
+			m_positions[i] = point;
+			minPoint = glm::min(minPoint, point);
+			maxPoint = glm::max(maxPoint, point);
+		}
+
+		glm::vec3 extent = maxPoint - minPoint;
+		float scale = std::max(std::max(extent.x, extent.y), extent.z);
+		float inverseScale = scale > 0.0f ? 1.0f / scale : 1.0f;
+		for (auto& point : m_positions)
+		{
+			point = (point - minPoint) * inverseScale;
+		}
+
+		//丢弃越界与退化的三角形
+		const auto& indices = index->getData();
+		m_indices.reserve(indices.size() - indices.size() % 3);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+			if (a >= m_vertexCount || b >= m_vertexCount || c >= m_vertexCount || a == b || b == c || a == c)
+			{
+				continue;
+			}
+
+			m_indices.push_back(a);
+			m_indices.push_back(b);
+			m_indices.push_back(c);
+		}
+		m_originalTriangles = static_cast<uint32_t>(m_indices.size() / 3);
+
+		buildPositionRemap();
+		buildQuadrics(classifyVertices());
+
+		m_collapseTarget.resize(m_vertexCount);
+		m_collapseLocked.resize(m_vertexCount);
+	}
+
+	MeshSimplifier::~MeshSimplifier() noexcept {}
+
+	void MeshSimplifier::buildPositionRemap() noexcept
+	{
+		m_remap.resize(m_vertexCount);
+		m_wedge.resize(m_vertexCount);
+
+		//按坐标排序，相邻的相等坐标即为同一位置
+		std::vector<uint32_t> order(m_vertexCount);
+		for (uint32_t i = 0; i < m_vertexCount; ++i)
+		{
+			order[i] = i;
+		}
+
+		const auto& positions = m_positions;
+		std::sort(order.begin(), order.end(), [&positions](uint32_t a, uint32_t b) {
+			const auto& pa = positions[a];
+			const auto& pb = positions[b];
+			if (pa.x != pb.x) return pa.x < pb.x;
+			if (pa.y != pb.y) return pa.y < pb.y;
+			if (pa.z != pb.z) return pa.z < pb.z;
+			return a < b;
+		});
+
+		for (uint32_t begin = 0; begin < m_vertexCount;)
+		{
+			uint32_t end = begin + 1;
+			while (end < m_vertexCount && m_positions[order[end]] == m_positions[order[begin]])
+			{
+				++end;
+			}
+
+			//同一位置的顶点串成循环链表，以编号最小者为代表
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				m_remap[order[i]] = order[begin];
+				m_wedge[order[i]] = order[i + 1 < end ? i + 1 : begin];
+			}
+
+			begin = end;
+		}
+	}
+
+	std::vector<uint8_t> MeshSimplifier::classifyVertices() noexcept
+	{
+		//index空间与位置空间的有向边
+		EdgeLists edges;
+		EdgeLists positionEdges;
+		edges.build(m_indices, nullptr, m_vertexCount);
+		positionEdges.build(m_indices, &m_remap, m_vertexCount);
+
+		//没有反向边的边：位置空间中也没有反向边为开放边界，否则为属性缝线
+		std::vector<uint32_t> borderOut(m_vertexCount, NoVertex), borderIn(m_vertexCount, NoVertex);
+		std::vector<uint32_t> seamOut(m_vertexCount, NoVertex), seamIn(m_vertexCount, NoVertex);
+		std::vector<uint8_t> referenced(m_vertexCount, 0);
+		std::vector<uint8_t> openEdges(m_indices.size() / 3, 0);
+
+		for (size_t i = 0; i < m_indices.size(); i += 3)
+		{
+			for (uint32_t e = 0; e < 3; ++e)
+			{
+				uint32_t a = m_indices[i + e];
+				uint32_t b = m_indices[i + (e + 1) % 3];
+				referenced[a] = 1;
+
+				if (!positionEdges.hasEdge(m_remap[b], m_remap[a]))
+				{
+					recordOpenEdge(borderOut[a], b);
+					recordOpenEdge(borderIn[b], a);
+					openEdges[i / 3] |= 1 << e;
+				}
+				else if (!edges.hasEdge(b, a))
+				{
+					recordOpenEdge(seamOut[a], b);
+					recordOpenEdge(seamIn[b], a);
+					openEdges[i / 3] |= 1 << e;
+				}
+			}
+		}
+
+		m_kinds.assign(m_vertexCount, VertexKind::Locked);
+		m_openOut.assign(m_vertexCount, NoVertex);
+		m_openIn.assign(m_vertexCount, NoVertex);
+
+		for (uint32_t v = 0; v < m_vertexCount; ++v)
+		{
+			if (!referenced[v])
+			{
+				continue;
+			}
+
+			uint32_t twin = m_wedge[v];
+			if (twin == v)
+			{
+				//缝线在此终止的顶点保持锁定
+				if (seamOut[v] != NoVertex || seamIn[v] != NoVertex)
+				{
+					continue;
+				}
+
+				if (borderOut[v] == NoVertex && borderIn[v] == NoVertex)
+				{
+					m_kinds[v] = VertexKind::Manifold;
+				}
+				else if (isSingle(borderOut[v]) && isSingle(borderIn[v]))
+				{
+					m_kinds[v] = VertexKind::Border;
+					m_openOut[v] = borderOut[v];
+					m_openIn[v] = borderIn[v];
+				}
+			}
+			else if (m_wedge[twin] == v)
+			{
+				bool noBorder = borderOut[v] == NoVertex && borderIn[v] == NoVertex &&
+					borderOut[twin] == NoVertex && borderIn[twin] == NoVertex;
+				bool simpleSeam = isSingle(seamOut[v]) && isSingle(seamIn[v]) &&
+					isSingle(seamOut[twin]) && isSingle(seamIn[twin]);
+
+				if (noBorder && simpleSeam)
+				{
+					m_kinds[v] = VertexKind::Seam;
+					m_openOut[v] = seamOut[v];
+					m_openIn[v] = seamIn[v];
+				}
+			}
+		}
+
+		return openEdges;
+	}
+
+	void MeshSimplifier::buildQuadrics(const std::vector<uint8_t>& openEdges) noexcept
+	{
+		m_quadrics.assign(m_vertexCount, Quadric());
+
+		for (size_t i = 0; i < m_indices.size(); i += 3)
+		{
+			uint32_t corners[3] = { m_indices[i], m_indices[i + 1], m_indices[i + 2] };
+			const auto& p0 = m_positions[corners[0]];
+			const auto& p1 = m_positions[corners[1]];
+			const auto& p2 = m_positions[corners[2]];
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float length = glm::length(normal);
+			if (length <= 0.0f)
+			{
+				continue;
+			}
+			normal /= length;
+
+			//面积加权的三角形平面
+			Quadric face;
+			addPlane(face, normal, -glm::dot(normal, p0), length * 0.5f);
+			for (auto corner : corners)
+			{
+				addQuadric(m_quadrics[m_remap[corner]], face);
+			}
+
+			//开放边界与缝线上的边，加入垂直于三角形、经过该边的约束平面
+			for (uint32_t e = 0; e < 3; ++e)
+			{
+				uint32_t a = corners[e];
+				uint32_t b = corners[(e + 1) % 3];
+
+				if (!(openEdges[i / 3] & (1 << e)))
+				{
+					continue;
+				}
+
+				glm::vec3 edge = m_positions[b] - m_positions[a];
+				float edgeLength = glm::length(edge);
+				if (edgeLength <= 0.0f)
+				{
+					continue;
+				}
+
+				glm::vec3 edgeNormal = glm::normalize(glm::cross(edge, normal));
+
+				Quadric border;
+				addPlane(border, edgeNormal, -glm::dot(edgeNormal, m_positions[a]), edgeLength * edgeLength * BorderWeight);
+				addQuadric(m_quadrics[m_remap[a]], border);
+				addQuadric(m_quadrics[m_remap[b]], border);
+			}
+		}
+	}
+
+	bool MeshSimplifier::canCollapse(uint32_t from, uint32_t to, uint32_t& twinTo) const noexcept
+	{
+		twinTo = NoVertex;
+		if (m_remap[from] == m_remap[to])
+		{
+			return false;
+		}
+
+		switch (m_kinds[from])
+		{
+		case VertexKind::Manifold:
+			return true;
+		case VertexKind::Border:
+			return to == m_openOut[from] || to == m_openIn[from];
+		case VertexKind::Seam:
+		{
+			//缝线另一侧的方向相反：这一侧的出边对应另一侧的入边
+			uint32_t twin = m_wedge[from];
+			if (to == m_openOut[from])
+			{
+				twinTo = m_openIn[twin];
+			}
+			else if (to == m_openIn[from])
+			{
+				twinTo = m_openOut[twin];
+			}
+			else
+			{
+				return false;
+			}
+
+			return isSingle(twinTo) && m_remap[twinTo] == m_remap[to];
+		}
+		default:
+			return false;
+		}
+	}
+
+	float MeshSimplifier::collapseError(uint32_t from, uint32_t to) const noexcept
+	{
+		Quadric quadric = m_quadrics[m_remap[from]];
+		addQuadric(quadric, m_quadrics[m_remap[to]]);
+
+		float error = evaluate(quadric, m_positions[to]);
+		return quadric.m_weight > 0.0f ? std::max(error / quadric.m_weight, 0.0f) : 0.0f;
+	}
+
+	bool MeshSimplifier::hasTriangleFlip(uint32_t from, uint32_t to) const noexcept
+	{
+		uint32_t fromGroup = m_remap[from];
+		uint32_t toGroup = m_remap[to];
+		const auto& target = m_positions[to];
+
+		for (uint32_t i = m_adjacencyOffsets[fromGroup]; i < m_adjacencyOffsets[fromGroup + 1]; ++i)
+		{
+			size_t triangle = m_adjacency[i] * 3;
+			uint32_t corners[3] = { m_indices[triangle], m_indices[triangle + 1], m_indices[triangle + 2] };
+
+			//包含折叠边的三角形会被删除
+			if (m_remap[corners[0]] == toGroup || m_remap[corners[1]] == toGroup || m_remap[corners[2]] == toGroup)
+			{
+				continue;
+			}
+
+			glm::vec3 before[3];
+			glm::vec3 after[3];
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				before[c] = m_positions[corners[c]];
+				after[c] = m_remap[corners[c]] == fromGroup ? target : before[c];
+			}
+
+			glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+			glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+			//法线夹角超过约75度即视为翻转
+			if (glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void MeshSimplifier::relinkOpenEdges(uint32_t from, uint32_t to) noexcept
+	{
+		if (m_kinds[from] != VertexKind::Border && m_kinds[from] != VertexKind::Seam)
+		{
+			return;
+		}
+
+		//prev -> from -> to 变为 prev -> to，反方向同理
+		if (to == m_openOut[from])
+		{
+			uint32_t prev = m_openIn[from];
+			m_openIn[to] = prev;
+			if (isSingle(prev))
+			{
+				m_openOut[prev] = to;
+			}
+		}
+		else if (to == m_openIn[from])
+		{
+			uint32_t next = m_openOut[from];
+			m_openOut[to] = next;
+			if (isSingle(next))
+			{
+				m_openIn[next] = to;
+			}
+		}
+	}
+
+	uint32_t MeshSimplifier::simplifyPass(uint32_t targetTriangles, float maxError) noexcept
+	{
+		uint32_t triangleCount = static_cast<uint32_t>(m_indices.size() / 3);
+
+		//1 代表顶点到三角形的邻接表
+		m_adjacencyOffsets.assign(m_vertexCount + 1, 0);
+		for (auto v : m_indices)
+		{
+			m_adjacencyOffsets[m_remap[v] + 1]++;
+		}
+		for (uint32_t i = 0; i < m_vertexCount; ++i)
+		{
+			m_adjacencyOffsets[i + 1] += m_adjacencyOffsets[i];
+		}
+
+		m_adjacency.resize(m_indices.size());
+		std::vector<uint32_t> cursor(m_adjacencyOffsets.begin(), m_adjacencyOffsets.end() - 1);
+		for (uint32_t i = 0; i < m_indices.size(); ++i)
+		{
+			m_adjacency[cursor[m_remap[m_indices[i]]]++] = i / 3;
+		}
+
+		//2 每条边选择误差较小的折叠方向，内部边在两个三角形中各出现一次，只取a < b的一次
+		m_collapses.clear();
+		for (size_t i = 0; i < m_indices.size(); i += 3)
+		{
+			for (uint32_t e = 0; e < 3; ++e)
+			{
+				uint32_t a = m_indices[i + e];
+				uint32_t b = m_indices[i + (e + 1) % 3];
+
+				bool open = m_openOut[a] == b || m_openIn[b] == a;
+				if (a > b && !open)
+				{
+					continue;
+				}
+
+				uint32_t twin = NoVertex;
+				bool forward = canCollapse(a, b, twin);
+				bool backward = canCollapse(b, a, twin);
+				if (!forward && !backward)
+				{
+					continue;
+				}
+
+				float forwardError = forward ? collapseError(a, b) : std::numeric_limits<float>::max();
+				float backwardError = backward ? collapseError(b, a) : std::numeric_limits<float>::max();
+
+				if (forwardError <= backwardError)
+				{
+					m_collapses.push_back({ a, b, forwardError });
+				}
+				else
+				{
+					m_collapses.push_back({ b, a, backwardError });
+				}
+			}
+		}
+
+		if (m_collapses.empty())
+		{
+			return 0;
+		}
+
+		auto byError = [](const Collapse& a, const Collapse& b) {
+			return a.m_error < b.m_error;
+		};
+
+		//一轮里只做误差较小的一部分折叠，之后重新计算误差，保持全局的折叠顺序
+		//只有误差不超过本轮上限的候选才需要排序
+		uint32_t triangleGoal = triangleCount - targetTriangles;
+		size_t edgeGoal = std::max<size_t>(triangleGoal / 2, 1);
+		float errorGoal = std::numeric_limits<float>::max();
+		if (edgeGoal < m_collapses.size())
+		{
+			std::nth_element(m_collapses.begin(), m_collapses.begin() + edgeGoal, m_collapses.end(), byError);
+			errorGoal = m_collapses[edgeGoal].m_error * 1.5f;
+		}
+		float errorLimit = maxError * maxError;
+
+		auto candidateEnd = std::partition(m_collapses.begin(), m_collapses.end(), [&](const Collapse& collapse) {
+			return collapse.m_error <= errorGoal && collapse.m_error <= errorLimit;
+		});
+		std::sort(m_collapses.begin(), candidateEnd, byError);
+		m_collapses.erase(candidateEnd, m_collapses.end());
+
+		for (uint32_t i = 0; i < m_vertexCount; ++i)
+		{
+			m_collapseTarget[i] = i;
+		}
+		std::fill(m_collapseLocked.begin(), m_collapseLocked.end(), 0);
+
+		//3 按误差从小到大折叠，同一轮中被折叠顶点的一环邻域全部锁定，翻转检测使用的位置始终是最新的
+		uint32_t collapsed = 0;
+		uint32_t trianglesRemoved = 0;
+		for (const auto& collapse : m_collapses)
+		{
+			if (trianglesRemoved >= triangleGoal)
+			{
+				break;
+			}
+
+			uint32_t fromGroup = m_remap[collapse.m_from];
+			uint32_t toGroup = m_remap[collapse.m_to];
+			if (m_collapseLocked[fromGroup] || m_collapseLocked[toGroup])
+			{
+				continue;
+			}
+
+			uint32_t twinTo = NoVertex;
+			canCollapse(collapse.m_from, collapse.m_to, twinTo);
+
+			if (hasTriangleFlip(collapse.m_from, collapse.m_to))
+			{
+				continue;
+			}
+
+			//同一位置的所有楔形一起移动
+			m_collapseTarget[collapse.m_from] = collapse.m_to;
+			if (twinTo != NoVertex)
+			{
+				m_collapseTarget[m_wedge[collapse.m_from]] = twinTo;
+			}
+
+			addQuadric(m_quadrics[toGroup], m_quadrics[fromGroup]);
+
+			relinkOpenEdges(collapse.m_from, collapse.m_to);
+			if (twinTo != NoVertex)
+			{
+				relinkOpenEdges(m_wedge[collapse.m_from], twinTo);
+			}
+
+			for (uint32_t j = m_adjacencyOffsets[fromGroup]; j < m_adjacencyOffsets[fromGroup + 1]; ++j)
+			{
+				size_t triangle = m_adjacency[j] * 3;
+				m_collapseLocked[m_remap[m_indices[triangle]]] = 1;
+				m_collapseLocked[m_remap[m_indices[triangle + 1]]] = 1;
+				m_collapseLocked[m_remap[m_indices[triangle + 2]]] = 1;
+			}
+
+			m_maxError = std::max(m_maxError, collapse.m_error);
+			trianglesRemoved += m_kinds[collapse.m_from] == VertexKind::Border ? 1 : 2;
+			collapsed++;
+		}
+
+		//4 重写index，删除退化的三角形
+		size_t write = 0;
+		for (size_t i = 0; i < m_indices.size(); i += 3)
+		{
+			uint32_t a = m_collapseTarget[m_indices[i]];
+			uint32_t b = m_collapseTarget[m_indices[i + 1]];
+			uint32_t c = m_collapseTarget[m_indices[i + 2]];
+
+			if (m_remap[a] == m_remap[b] || m_remap[b] == m_remap[c] || m_remap[a] == m_remap[c])
+			{
+				continue;
+			}
+
+			m_indices[write++] = a;
+			m_indices[write++] = b;
+			m_indices[write++] = c;
+		}
+		m_indices.resize(write);
+
+		return collapsed;
+	}
+
+	std::vector<MeshSimplifier::Level> MeshSimplifier::buildLevels(const std::vector<LevelDesc>& descs) noexcept
+	{
+		std::vector<Level> levels;
+		levels.reserve(descs.size());
+
+		for (const auto& desc : descs)
+		{
+			uint32_t target = static_cast<uint32_t>(std::max(desc.m_ratio, 0.0f) * m_originalTriangles);
+
+			while (m_indices.size() / 3 > target)
+			{
+				if (simplifyPass(target, desc.m_maxError) == 0)
+				{
+					break;
+				}
+			}
+
+			Level level;
+			level.m_index = Attributei::create(m_indices, 1);
+			level.m_triangles = static_cast<uint32_t>(m_indices.size() / 3);
+			level.m_error = std::sqrt(m_maxError);
+			levels.push_back(level);
+		}
+
+		return levels;
+	}
+
+	std::vector<std::vector<MeshSimplifier::Level>> MeshSimplifier::buildLevels(
+		const std::vector<Geometry::Ptr>& geometries,
+		const std::vector<LevelDesc>& descs,
+		const JobSystem::Ptr& jobSystem) noexcept
+	{
+		std::vector<std::vector<Level>> results(geometries.size());
+
+		auto simplifyRange = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				results[i] = MeshSimplifier(geometries[i]).buildLevels(descs);
+			}
+		};
+
+		auto count = static_cast<uint32_t>(geometries.size());
+		if (jobSystem != nullptr)
+		{
+			jobSystem->parallelFor(count, 1, simplifyRange);
+		}
+		else
+		{
+			simplifyRange(0, count);
+		}
+
+		return results;
+	}
+
+	Geometry::Ptr MeshSimplifier::createLevelGeometry(const Geometry::Ptr& source, const Level& level) noexcept
+	{
+		auto geometry = Geometry::create();
+		for (const auto& iter : source->getAttributes())
+		{
+			geometry->setAttribute(iter.first, iter.second);
+		}
+		geometry->setIndex(level.m_index);
+
+		return geometry;
+	}
+
+	void MeshSimplifier::addPlane(Quadric& quadric, const glm::vec3& normal, float distance, float weight) noexcept
+	{
+		quadric.m_a00 += weight * normal.x * normal.x;
+		quadric.m_a11 += weight * normal.y * normal.y;
+		quadric.m_a22 += weight * normal.z * normal.z;
+		quadric.m_a10 += weight * normal.y * normal.x;
+		quadric.m_a20 += weight * normal.z * normal.x;
+		quadric.m_a21 += weight * normal.z * normal.y;
+		quadric.m_b0 += weight * normal.x * distance;
+		quadric.m_b1 += weight * normal.y * distance;
+		quadric.m_b2 += weight * normal.z * distance;
+		quadric.m_c += weight * distance * distance;
+		quadric.m_weight += weight;
+	}
+
+	void MeshSimplifier::addQuadric(Quadric& target, const Quadric& source) noexcept
+	{
+		target.m_a00 += source.m_a00;
+		target.m_a11 += source.m_a11;
+		target.m_a22 += source.m_a22;
+		target.m_a10 += source.m_a10;
+		target.m_a20 += source.m_a20;
+		target.m_a21 += source.m_a21;
+		target.m_b0 += source.m_b0;
+		target.m_b1 += source.m_b1;
+		target.m_b2 += source.m_b2;
+		target.m_c += source.m_c;
+		target.m_weight += source.m_weight;
+	}
+
+	float MeshSimplifier::evaluate(const Quadric& q, const glm::vec3& p) noexcept
+	{
+		float rx = q.m_b0 + q.m_a00 * p.x + q.m_a10 * p.y + q.m_a20 * p.z;
+		float ry = q.m_b1 + q.m_a10 * p.x + q.m_a11 * p.y + q.m_a21 * p.z;
+		float rz = q.m_b2 + q.m_a20 * p.x + q.m_a21 * p.y + q.m_a22 * p.z;
+
+		//p^T A p + 2 b^T p + c
+		return rx * p.x + ry * p.y + rz * p.z + q.m_b0 * p.x + q.m_b1 * p.y + q.m_b2 * p.z + q.m_c;
+	}
+}
@@ -0,0 +1,172 @@
+/**
+ * @class MeshSimplifier
+ * @brief 基于二次误差度量(Quadric Error Metrics)的网格简化，从带index的Geometry生成一串只替换index的LOD级别。
+ *
+ * 简介：
+ * - 只做半边折叠(把一个顶点合并到相邻顶点上)，不产生新顶点，所以每个级别只是一份新的index，
+ *   与原始Geometry共享所有顶点Attribute(共享同一份VBO)；
+ * - 每个顶点的二次误差由相邻三角形平面按面积加权累积，开放边界额外加入垂直于边界的约束平面，防止边界收缩；
+ * - 位置相同但其他属性(uv/normal)不同的顶点视为同一位置的多个“楔形”(wedge)：
+ *   - 恰好两个楔形、沿着一条缝线(seam)排列的顶点只能沿缝线折叠，并且两侧同时折叠，缝线两侧的uv/normal保持不变；
+ *   - 更复杂的情况(三个以上楔形、缝线与边界交叉、非流形边)直接锁定，不会被移动；
+ * - 折叠前检查相邻三角形是否翻转，翻转的折叠会被放弃；
+ * - 级别按顺序逐级简化，后一级从前一级继续，误差累积计算，每级在达到目标三角形数或下一次折叠超出误差上限时停止。
+ *
+ * 误差以原始网格包围盒最长边为单位，例如0.01表示简化后的表面与原始表面偏离约为模型尺寸的1%。
+ *
+ * 使用示例：
+ * @code
+ * auto levels = ff::MeshSimplifier::create(geometry)->buildLevels({ { 0.5f, 0.005f }, { 0.1f, 0.02f } });
+ * auto lod = ff::LOD::create();
+ * lod->addLevel(ff::Mesh::create(geometry, material), 200.0f);
+ * lod->addLevel(ff::Mesh::create(ff::MeshSimplifier::createLevelGeometry(geometry, levels[0]), material), 60.0f);
+ *
+ * //大量零件并行简化，jobSystem为nullptr时串行
+ * auto results = ff::MeshSimplifier::buildLevels(geometries, descs, jobSystem);
+ * @endcode
+ *
+ * 限制与注意：
+ * - 只处理三角形index，没有index或没有position的Geometry返回空结果；
+ * - 不使用uv/normal的数值参与误差计算，缝线以外的属性变化由顶点复用自然保持；
+ * - 一个MeshSimplifier实例非线程安全，多个实例可以在不同线程上同时运行。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+#include "../core/geometry.h"
+#include "jobSystem.h"
+
+namespace ff
+{
+	class MeshSimplifier
+	{
+	public:
+		//一个LOD级别的目标
+		struct LevelDesc
+		{
+			float	m_ratio{ 0.5f };		//目标三角形数占原始三角形数的比例
+			float	m_maxError{ 0.01f };	//允许的最大误差，先到达者为准
+		};
+
+		//简化的结果
+		struct Level
+		{
+			Attributei::Ptr	m_index{ nullptr };
+			uint32_t		m_triangles{ 0 };
+			float			m_error{ 0.0f };	//相对于原始网格的误差
+		};
+
+		using Ptr = std::shared_ptr<MeshSimplifier>;
+		static Ptr create(const Geometry::Ptr& geometry)
+		{
+			return std::make_shared<MeshSimplifier>(geometry);
+		}
+
+		MeshSimplifier(const Geometry::Ptr& geometry) noexcept;
+
+		~MeshSimplifier() noexcept;
+
+		//按descs的顺序逐级简化，每个desc对应一个结果
+		std::vector<Level> buildLevels(const std::vector<LevelDesc>& descs) noexcept;
+
+		//在jobSystem上并行简化多个Geometry，每个Geometry一个任务
+		static std::vector<std::vector<Level>> buildLevels(
+			const std::vector<Geometry::Ptr>& geometries,
+			const std::vector<LevelDesc>& descs,
+			const JobSystem::Ptr& jobSystem) noexcept;
+
+		//与source共享所有顶点Attribute，只替换index
+		static Geometry::Ptr createLevelGeometry(const Geometry::Ptr& source, const Level& level) noexcept;
+
+		uint32_t getOriginalTriangleCount() const noexcept { return m_originalTriangles; }
+
+	private:
+		enum class VertexKind : uint8_t
+		{
+			Manifold,	//内部顶点，可以向任意相邻顶点折叠
+			Border,		//开放边界上的顶点，只能沿边界折叠
+			Seam,		//属性缝线上的顶点，与另一侧的楔形一起沿缝线折叠
+			Locked		//不移动
+		};
+
+		//对称矩阵A(6个元素)、向量b、常数c，误差为 p^T A p + 2 b^T p + c，m_weight为累积的权重
+		struct Quadric
+		{
+			float	m_a00{ 0.0f }, m_a11{ 0.0f }, m_a22{ 0.0f };
+			float	m_a10{ 0.0f }, m_a20{ 0.0f }, m_a21{ 0.0f };
+			float	m_b0{ 0.0f }, m_b1{ 0.0f }, m_b2{ 0.0f };
+			float	m_c{ 0.0f };
+			float	m_weight{ 0.0f };
+		};
+
+		struct Collapse
+		{
+			uint32_t	m_from{ 0 };
+			uint32_t	m_to{ 0 };
+			float		m_error{ 0.0f };
+		};
+
+		//合并位置相同的顶点，得到m_remap与m_wedge
+		void buildPositionRemap() noexcept;
+
+		//返回每个三角形的开放边(边界与缝线)掩码，第e位表示第e条边 corner[e] -> corner[e + 1]
+		std::vector<uint8_t> classifyVertices() noexcept;
+
+		void buildQuadrics(const std::vector<uint8_t>& openEdges) noexcept;
+
+		//from折叠到to是否满足顶点类型的约束，Seam顶点通过twinTo返回另一侧的目标
+		bool canCollapse(uint32_t from, uint32_t to, uint32_t& twinTo) const noexcept;
+
+		float collapseError(uint32_t from, uint32_t to) const noexcept;
+
+		//做一轮折叠，返回折叠的次数
+		uint32_t simplifyPass(uint32_t targetTriangles, float maxError) noexcept;
+
+		bool hasTriangleFlip(uint32_t from, uint32_t to) const noexcept;
+
+		//沿开放边折叠之后，把from前后的开放边连接到to上
+		void relinkOpenEdges(uint32_t from, uint32_t to) noexcept;
+
+		static void addPlane(Quadric& quadric, const glm::vec3& normal, float distance, float weight) noexcept;
+
+		static void addQuadric(Quadric& target, const Quadric& source) noexcept;
+
+		static float evaluate(const Quadric& quadric, const glm::vec3& point) noexcept;
+
+	private:
+		uint32_t				m_vertexCount{ 0 };
+		uint32_t				m_originalTriangles{ 0 };
+
+		//归一化到[0, 1]范围的顶点位置
+		std::vector<glm::vec3>	m_positions{};
+
+		//当前的index
+		std::vector<uint32_t>	m_indices{};
+
+		//位置相同的顶点中的代表顶点，以及同一位置的下一个楔形(循环链表)
+		std::vector<uint32_t>	m_remap{};
+		std::vector<uint32_t>	m_wedge{};
+
+		std::vector<VertexKind>	m_kinds{};
+
+		//边界/缝线上，从本顶点出发与到达本顶点的开放边的另一端
+		std::vector<uint32_t>	m_openOut{};
+		std::vector<uint32_t>	m_openIn{};
+
+		//按代表顶点存放的二次误差
+		std::vector<Quadric>	m_quadrics{};
+
+		//代表顶点 -> 相邻三角形，每一轮重新建立
+		std::vector<uint32_t>	m_adjacencyOffsets{};
+		std::vector<uint32_t>	m_adjacency{};
+
+		std::vector<Collapse>	m_collapses{};
+		std::vector<uint32_t>	m_collapseTarget{};
+		std::vector<uint8_t>	m_collapseLocked{};
+
+		float					m_maxError{ 0.0f };	//已经发生的折叠中最大的误差(平方)
+	};
+}
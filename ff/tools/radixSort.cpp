@@ -0,0 +1,87 @@
+#include "radixSort.h"
+
+namespace ff
+{
+	namespace
+	{
+		const uint32_t RADIX_BITS = 8;
+		const uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+		const uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+		//少于这个数量时插入排序更快
+		const size_t INSERTION_SORT_LIMIT = 64;
+
+		void insertionSort(std::vector<SortEntry>& entries) noexcept
+		{
+			for (size_t i = 1; i < entries.size(); ++i)
+			{
+				SortEntry entry = entries[i];
+				size_t j = i;
+				while (j > 0 && entries[j - 1].m_key > entry.m_key)
+				{
+					entries[j] = entries[j - 1];
+					--j;
+				}
+				entries[j] = entry;
+			}
+		}
+	}
+
+	void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) noexcept
+	{
+		const size_t count = entries.size();
+		if (count <= INSERTION_SORT_LIMIT)
+		{
+			insertionSort(entries);
+			return;
+		}
+
+		scratch.resize(count);
+
+		//一次遍历统计所有趟的直方图
+		uint32_t histograms[RADIX_PASSES][RADIX_SIZE] = {};
+		for (const auto& entry : entries)
+		{
+			uint64_t key = entry.m_key;
+			for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+			{
+				histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+			}
+		}
+
+		SortEntry* src = entries.data();
+		SortEntry* dst = scratch.data();
+		for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+		{
+			uint32_t shift = pass * RADIX_BITS;
+			auto& histogram = histograms[pass];
+
+			//所有键在这一位上相同，顺序不会变化
+			if (histogram[(src[0].m_key >> shift) & (RADIX_SIZE - 1)] == count)
+			{
+				continue;
+			}
+
+			uint32_t offsets[RADIX_SIZE];
+			uint32_t sum = 0;
+			for (uint32_t digit = 0; digit < RADIX_SIZE; ++digit)
+			{
+				offsets[digit] = sum;
+				sum += histogram[digit];
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				dst[offsets[(src[i].m_key >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+			}
+
+			std::swap(src, dst);
+		}
+
+		//结果落在scratch中时交换两个缓冲区，不需要拷贝
+		if (src != entries.data())
+		{
+			entries.swap(scratch);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+/**
+ * @class SortEntry
+ * @brief 64位排序键与元素下标组成的排序项，配合 radixSort() 对渲染列表等大量元素按预先计算好的键排序。
+ *
+ * 简介：
+ * - 排序只移动16字节的排序项，不解引用元素本身，也不调用比较函数；
+ * - radixSort() 为LSD基数排序，每次处理8位，共8趟；所有键在某一位上相同时跳过这一趟，
+ *   键的高位常常是少数几个分组，实际趟数通常少于8；
+ * - 排序是稳定的：键相同的元素保持原来的先后顺序；
+ * - 元素很少时改用插入排序，结果相同。
+ *
+ * 使用示例：
+ * @code
+ * entries.clear();
+ * for (uint32_t i = 0; i < items.size(); ++i)
+ * {
+ *     entries.push_back({ items[i].m_sortKey, i });
+ * }
+ * ff::radixSort(entries, scratch);
+ * @endcode
+ *
+ * 限制与注意：
+ * - scratch为外部持有的缓冲区，容量足够时排序过程中不分配内存，建议跨帧复用；
+ * - 排序结束后结果在entries中，scratch的内容无意义。
+ *
+ * @author qiang.guo
+ * @date 2025-10-16
+ */
+
+#pragma once
+#include "../global/base.h"
+
+namespace ff
+{
+	struct SortEntry
+	{
+		uint64_t	m_key{ 0 };
+		uint32_t	m_index{ 0 };
+	};
+
+	//按m_key升序稳定排序，scratch容量不够时才会扩容
+	void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) noexcept;
+}